@@ -3,15 +3,20 @@
 
 #include "Luau/Config.h"
 #include "Luau/Module.h"
+#include "Luau/ModuleCache.h"
 #include "Luau/ModuleResolver.h"
 #include "Luau/RequireTracer.h"
 #include "Luau/Scope.h"
 #include "Luau/TypeInfer.h"
 #include "Luau/Variant.h"
 
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
-#include <optional>
 
 namespace Luau
 {
@@ -73,6 +78,10 @@ struct SourceNode
     bool dirtyModule = true;
     bool dirtyModuleForAutocomplete = true;
     double autocompleteLimitsMult = 1.0;
+
+    // identifies the source of the module and of everything it requires, used as a ModuleCache key
+    uint64_t sourceHash = 0;
+    uint64_t interfaceKey = 0;
 };
 
 struct FrontendOptions
@@ -104,6 +113,9 @@ struct FrontendModuleResolver : ModuleResolver
 
     Frontend* frontend;
     std::unordered_map<ModuleName, ModulePtr> modules;
+
+    // protects 'modules' while modules are checked concurrently (see Frontend::checkModules)
+    mutable std::mutex moduleMutex;
 };
 
 struct Frontend
@@ -115,6 +127,7 @@ struct Frontend
 
         size_t filesStrict = 0;
         size_t filesNonstrict = 0;
+        size_t filesCached = 0;
 
         double timeRead = 0;
         double timeParse = 0;
@@ -125,6 +138,14 @@ struct Frontend
     Frontend(FileResolver* fileResolver, ConfigResolver* configResolver, const FrontendOptions& options = {});
 
     CheckResult check(const ModuleName& name, std::optional<FrontendOptions> optionOverride = {}); // new shininess
+
+    /** Check multiple modules, producing the same results as calling check for each of them in order.
+     *
+     * When executeTask is provided, modules that don't depend on each other are checked concurrently in the tasks it is given.
+     * executeTask can run a task on any thread but must eventually run every task; checkModules waits for all of them to finish.
+     */
+    std::vector<CheckResult> checkModules(const std::vector<ModuleName>& names, std::optional<FrontendOptions> optionOverride = {},
+        std::function<void(std::function<void()> task)> executeTask = {});
     LintResult lint(const ModuleName& name, std::optional<LintOptions> enabledLintWarnings = {});
 
     LintResult lint(const SourceModule& module, std::optional<LintOptions> enabledLintWarnings = {});
@@ -157,8 +178,31 @@ struct Frontend
     ScopePtr getGlobalScope();
 
 private:
+    struct BuildQueueItem
+    {
+        ModuleName name;
+        SourceNode* sourceNode = nullptr;
+        SourceModule* sourceModule = nullptr;
+        Mode mode = Mode::NoCheck;
+        ScopePtr environmentScope;
+        std::vector<RequireCycle> requireCycles;
+        FrontendOptions options;
+        std::optional<uint64_t> interfaceKey;
+
+        // result of the check
+        ModulePtr module;
+        Stats stats;
+        std::exception_ptr exception;
+    };
+
     ModulePtr check(const SourceModule& sourceModule, Mode mode, const ScopePtr& environmentScope, std::vector<RequireCycle> requireCycles);
 
+    void prepareBuildQueue(
+        std::vector<BuildQueueItem>& items, const std::vector<ModuleName>& buildQueue, bool cycleDetected, const FrontendOptions& frontendOptions);
+    void checkBuildQueueItem(BuildQueueItem& item, TypeChecker& typeChecker);
+    void checkBuildQueueItemsParallel(std::vector<BuildQueueItem>& items, const std::function<void(std::function<void()> task)>& executeTask);
+    void recordItemResult(const BuildQueueItem& item);
+
     std::pair<SourceNode*, SourceModule*> getSourceNode(CheckResult& checkResult, const ModuleName& name);
     SourceModule parse(const ModuleName& name, std::string_view src, const ParseOptions& parseOptions);
 
@@ -173,11 +217,15 @@ private:
 
     ScopePtr globalScope;
 
+    std::unique_ptr<PersistentTypeIndex> persistentTypeIndex;
+    uint64_t globalEnvironmentKey = 0;
+
 public:
     SingletonTypes singletonTypes_;
     const NotNull<SingletonTypes> singletonTypes;
 
     FileResolver* fileResolver;
+    ModuleCache* moduleCache = nullptr; // optional, used to skip checking modules that didn't change since the interface was stored
     FrontendModuleResolver moduleResolver;
     FrontendModuleResolver moduleResolverForAutocomplete;
     TypeChecker typeChecker;
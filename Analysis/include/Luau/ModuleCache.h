@@ -0,0 +1,58 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/Module.h"
+#include "Luau/NotNull.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Luau
+{
+
+struct SingletonTypes;
+
+/** Persistent storage for the public interfaces of checked modules.
+ *
+ * Frontend stores the interface of every module that checks without errors and restores it on a later run when neither the
+ * source of the module nor the sources of its dependencies changed, skipping the typecheck.
+ *
+ * Frontend::checkModules can call these methods concurrently for different modules.
+ */
+struct ModuleCache
+{
+    virtual ~ModuleCache() {}
+
+    virtual std::optional<std::string> readModuleInterface(const ModuleName& name) = 0;
+    virtual void writeModuleInterface(const ModuleName& name, const std::string& data) = 0;
+};
+
+/** Names the persistent types that a module interface can refer to.
+ *
+ * Builtin and definition file types live outside of the module arenas, so they are stored by the path through the global
+ * scope that reaches them and found again in the global scope of the process that restores the interface.
+ */
+struct PersistentTypeIndex
+{
+    PersistentTypeIndex(const ScopePtr& globalScope, NotNull<SingletonTypes> singletonTypes);
+
+    std::unordered_map<TypeId, std::string> typeNames;
+    std::unordered_map<TypePackId, std::string> typePackNames;
+
+    std::unordered_map<std::string, TypeId> types;
+    std::unordered_map<std::string, TypePackId> typePacks;
+
+private:
+    void addType(TypeId ty, const std::string& name);
+    void addTypePack(TypePackId tp, const std::string& name);
+};
+
+// Returns std::nullopt when the interface refers to types that can't be stored, such as free types or unnamed persistent types
+std::optional<std::string> serializeModuleInterface(const Module& module, uint64_t key, const PersistentTypeIndex& index);
+
+// Returns nullptr when the data is malformed, was written for a different key or refers to persistent types that don't exist
+ModulePtr deserializeModuleInterface(std::string_view data, uint64_t key, const PersistentTypeIndex& index, const ScopePtr& parentScope);
+
+} // namespace Luau
@@ -52,7 +52,7 @@ struct BlockedTypePack
     BlockedTypePack();
     size_t index;
 
-    static size_t nextIndex;
+    static std::atomic<size_t> nextIndex;
 };
 
 struct TypePackVar
@@ -101,7 +101,7 @@ struct BlockedTypeVar
     BlockedTypeVar();
     int index;
 
-    static int nextIndex;
+    static std::atomic<int> nextIndex;
 };
 
 struct PrimitiveTypeVar
@@ -474,7 +474,7 @@ struct PendingExpansionTypeVar
     std::vector<TypePackId> packArguments;
     size_t index;
 
-    static size_t nextIndex;
+    static std::atomic<size_t> nextIndex;
 };
 
 // Anything!  All static checking is off.
@@ -3,6 +3,7 @@
 
 #include "Luau/Variant.h"
 
+#include <atomic>
 #include <string>
 
 namespace Luau
@@ -95,7 +96,7 @@ struct Free
     bool forwardedTypeAlias = false;
 
 private:
-    static int nextIndex;
+    static std::atomic<int> nextIndex;
 };
 
 template<typename Id>
@@ -126,7 +127,7 @@ struct Generic
     bool explicitName = false;
 
 private:
-    static int nextIndex;
+    static std::atomic<int> nextIndex;
 };
 
 struct Error
@@ -138,7 +139,7 @@ struct Error
     int index;
 
 private:
-    static int nextIndex;
+    static std::atomic<int> nextIndex;
 };
 
 template<typename Id, typename... Value>
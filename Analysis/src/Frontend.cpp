@@ -12,6 +12,7 @@
 #include "Luau/Scope.h"
 #include "Luau/StringUtils.h"
 #include "Luau/TimeTrace.h"
+#include "Luau/ToString.h"
 #include "Luau/TypeChecker2.h"
 #include "Luau/TypeInfer.h"
 #include "Luau/Variant.h"
@@ -19,11 +20,14 @@
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <stdexcept>
 
 LUAU_FASTINT(LuauTypeInferIterationLimit)
 LUAU_FASTINT(LuauTarjanChildLimit)
 LUAU_FASTFLAG(LuauInferInNoCheckMode)
+LUAU_FASTFLAG(LuauLowerBoundsCalculation)
 LUAU_FASTFLAG(LuauNoMoreGlobalSingletonTypes)
 LUAU_FASTFLAGVARIABLE(LuauKnowsTheDataModel3, false)
 LUAU_FASTFLAGVARIABLE(LuauAutocompleteDynamicLimits, false)
@@ -83,6 +87,9 @@ static void generateDocumentationSymbols(TypeId ty, const std::string& rootName)
 
 LoadDefinitionFileResult Frontend::loadDefinitionFile(std::string_view source, const std::string& packageName)
 {
+    // definitions add new global types that interfaces can refer to
+    persistentTypeIndex.reset();
+
     if (!FFlag::DebugLuauDeferredConstraintResolution)
         return Luau::loadDefinitionFile(typeChecker, typeChecker.globalScope, source, packageName);
 
@@ -389,6 +396,81 @@ double getTimestamp()
     return double(duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch()).count()) / 1e9;
 }
 
+// FNV-1a
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+
+    return hash;
+}
+
+uint64_t hashString(uint64_t hash, std::string_view str)
+{
+    uint64_t size = str.size();
+    hash = hashBytes(hash, &size, sizeof(size));
+    return hashBytes(hash, str.data(), str.size());
+}
+
+const uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+// must be bumped whenever a change to type inference can produce different interfaces for the same source
+const uint32_t kAnalyzerVersion = 1;
+
+uint64_t hashFlags(uint64_t hash)
+{
+    // flags are registered in static initialization order, so they are sorted by name to keep the hash stable across builds
+    std::vector<std::pair<std::string, int>> entries;
+
+    for (FValue<bool>* flag = FValue<bool>::list; flag; flag = flag->next)
+        entries.emplace_back(std::string("b") + flag->name, flag->value);
+
+    for (FValue<int>* flag = FValue<int>::list; flag; flag = flag->next)
+        entries.emplace_back(std::string("i") + flag->name, flag->value);
+
+    std::sort(entries.begin(), entries.end());
+
+    for (const auto& [name, value] : entries)
+    {
+        hash = hashString(hash, name);
+        hash = hashBytes(hash, &value, sizeof(value));
+    }
+
+    return hash;
+}
+
+uint64_t hashScope(uint64_t hash, const Scope& scope)
+{
+    ToStringOptions opts;
+    opts.exhaustive = true;
+    opts.maxTableLength = 0;
+    opts.maxTypeLength = 0;
+
+    // bindings are stored in hash maps, so they are sorted by name to keep the hash stable across runs
+    std::vector<std::pair<std::string, std::string>> entries;
+
+    for (const auto& [name, binding] : scope.bindings)
+        entries.emplace_back("b" + toString(name), toString(binding.typeId, opts));
+
+    for (const auto& [name, tf] : scope.exportedTypeBindings)
+        entries.emplace_back("e" + name, toString(tf.type, opts));
+
+    for (const auto& [name, tf] : scope.privateTypeBindings)
+        entries.emplace_back("p" + name, toString(tf.type, opts));
+
+    std::sort(entries.begin(), entries.end());
+
+    for (const auto& [name, type] : entries)
+    {
+        hash = hashString(hash, name);
+        hash = hashString(hash, type);
+    }
+
+    return hash;
+}
+
 } // namespace
 
 Frontend::Frontend(FileResolver* fileResolver, ConfigResolver* configResolver, const FrontendOptions& options)
@@ -440,8 +522,21 @@ CheckResult Frontend::check(const ModuleName& name, std::optional<FrontendOption
     std::vector<ModuleName> buildQueue;
     bool cycleDetected = parseGraph(buildQueue, checkResult, name, frontendOptions.forAutocomplete);
 
-    // Keep track of which AST nodes we've reported cycles in
-    std::unordered_set<AstNode*> reportedCycles;
+    if (!frontendOptions.forAutocomplete)
+    {
+        std::vector<BuildQueueItem> items;
+        prepareBuildQueue(items, buildQueue, cycleDetected, frontendOptions);
+
+        for (BuildQueueItem& item : items)
+        {
+            checkBuildQueueItem(item, typeChecker);
+            recordItemResult(item);
+
+            checkResult.errors.insert(checkResult.errors.end(), item.module->errors.begin(), item.module->errors.end());
+        }
+
+        return checkResult;
+    }
 
     double autocompleteTimeLimit = FInt::LuauAutocompleteCheckTimeoutMs / 1000.0;
 
@@ -476,112 +571,434 @@ CheckResult Frontend::check(const ModuleName& name, std::optional<FrontendOption
         // This is used by the type checker to replace the resulting type of cyclic modules with any
         sourceModule.cyclic = !requireCycles.empty();
 
-        if (frontendOptions.forAutocomplete)
+        // The autocomplete typecheck is always in strict mode with DM awareness
+        // to provide better type information for IDE features
+        typeCheckerForAutocomplete.requireCycles = requireCycles;
+
+        if (autocompleteTimeLimit != 0.0)
+            typeCheckerForAutocomplete.finishTime = TimeTrace::getClock() + autocompleteTimeLimit;
+        else
+            typeCheckerForAutocomplete.finishTime = std::nullopt;
+
+        if (FFlag::LuauAutocompleteDynamicLimits)
         {
-            // The autocomplete typecheck is always in strict mode with DM awareness
-            // to provide better type information for IDE features
-            typeCheckerForAutocomplete.requireCycles = requireCycles;
+            // TODO: This is a dirty ad hoc solution for autocomplete timeouts
+            // We are trying to dynamically adjust our existing limits to lower total typechecking time under the limit
+            // so that we'll have type information for the whole file at lower quality instead of a full abort in the middle
+            if (FInt::LuauTarjanChildLimit > 0)
+                typeCheckerForAutocomplete.instantiationChildLimit = std::max(1, int(FInt::LuauTarjanChildLimit * sourceNode.autocompleteLimitsMult));
+            else
+                typeCheckerForAutocomplete.instantiationChildLimit = std::nullopt;
 
-            if (autocompleteTimeLimit != 0.0)
-                typeCheckerForAutocomplete.finishTime = TimeTrace::getClock() + autocompleteTimeLimit;
+            if (FInt::LuauTypeInferIterationLimit > 0)
+                typeCheckerForAutocomplete.unifierIterationLimit =
+                    std::max(1, int(FInt::LuauTypeInferIterationLimit * sourceNode.autocompleteLimitsMult));
             else
-                typeCheckerForAutocomplete.finishTime = std::nullopt;
+                typeCheckerForAutocomplete.unifierIterationLimit = std::nullopt;
+        }
+
+        ModulePtr moduleForAutocomplete = typeCheckerForAutocomplete.check(sourceModule, Mode::Strict, environmentScope);
+        moduleResolverForAutocomplete.modules[moduleName] = moduleForAutocomplete;
+
+        double duration = getTimestamp() - timestamp;
+
+        if (moduleForAutocomplete->timeout)
+        {
+            checkResult.timeoutHits.push_back(moduleName);
 
             if (FFlag::LuauAutocompleteDynamicLimits)
-            {
-                // TODO: This is a dirty ad hoc solution for autocomplete timeouts
-                // We are trying to dynamically adjust our existing limits to lower total typechecking time under the limit
-                // so that we'll have type information for the whole file at lower quality instead of a full abort in the middle
-                if (FInt::LuauTarjanChildLimit > 0)
-                    typeCheckerForAutocomplete.instantiationChildLimit =
-                        std::max(1, int(FInt::LuauTarjanChildLimit * sourceNode.autocompleteLimitsMult));
-                else
-                    typeCheckerForAutocomplete.instantiationChildLimit = std::nullopt;
-
-                if (FInt::LuauTypeInferIterationLimit > 0)
-                    typeCheckerForAutocomplete.unifierIterationLimit =
-                        std::max(1, int(FInt::LuauTypeInferIterationLimit * sourceNode.autocompleteLimitsMult));
-                else
-                    typeCheckerForAutocomplete.unifierIterationLimit = std::nullopt;
-            }
+                sourceNode.autocompleteLimitsMult = sourceNode.autocompleteLimitsMult / 2.0;
+        }
+        else if (FFlag::LuauAutocompleteDynamicLimits && duration < autocompleteTimeLimit / 2.0)
+        {
+            sourceNode.autocompleteLimitsMult = std::min(sourceNode.autocompleteLimitsMult * 2.0, 1.0);
+        }
 
-            ModulePtr moduleForAutocomplete = typeCheckerForAutocomplete.check(sourceModule, Mode::Strict, environmentScope);
-            moduleResolverForAutocomplete.modules[moduleName] = moduleForAutocomplete;
+        stats.timeCheck += duration;
+        stats.filesStrict += 1;
 
-            double duration = getTimestamp() - timestamp;
+        sourceNode.dirtyModuleForAutocomplete = false;
+    }
 
-            if (moduleForAutocomplete->timeout)
-            {
-                checkResult.timeoutHits.push_back(moduleName);
+    return checkResult;
+}
 
-                if (FFlag::LuauAutocompleteDynamicLimits)
-                    sourceNode.autocompleteLimitsMult = sourceNode.autocompleteLimitsMult / 2.0;
-            }
-            else if (FFlag::LuauAutocompleteDynamicLimits && duration < autocompleteTimeLimit / 2.0)
+std::vector<CheckResult> Frontend::checkModules(
+    const std::vector<ModuleName>& names, std::optional<FrontendOptions> optionOverride, std::function<void(std::function<void()> task)> executeTask)
+{
+    LUAU_TIMETRACE_SCOPE("Frontend::checkModules", "Frontend");
+
+    FrontendOptions frontendOptions = optionOverride.value_or(options);
+
+    std::vector<CheckResult> results(names.size());
+
+    // autocomplete checks have time limits that are tuned for checking modules one at a time, and constraint resolution uses shared state
+    if (frontendOptions.forAutocomplete || FFlag::DebugLuauDeferredConstraintResolution)
+    {
+        for (size_t i = 0; i < names.size(); ++i)
+            results[i] = check(names[i], frontendOptions);
+
+        return results;
+    }
+
+    // modules are attributed to the first root that requires them, which matches the results of sequential check calls
+    std::vector<ModuleName> buildQueue;
+    std::vector<size_t> buildQueueRoot;
+    std::unordered_set<ModuleName> queued;
+    bool cycleDetected = false;
+
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        auto it = sourceNodes.find(names[i]);
+        if (it != sourceNodes.end() && !it->second.hasDirtyModule(/* forAutocomplete= */ false))
+        {
+            // No recheck required.
+            results[i] = check(names[i], frontendOptions);
+            continue;
+        }
+
+        std::vector<ModuleName> rootQueue;
+        cycleDetected |= parseGraph(rootQueue, results[i], names[i], /* forAutocomplete= */ false);
+
+        for (ModuleName& moduleName : rootQueue)
+        {
+            if (queued.insert(moduleName).second)
             {
-                sourceNode.autocompleteLimitsMult = std::min(sourceNode.autocompleteLimitsMult * 2.0, 1.0);
+                buildQueue.push_back(std::move(moduleName));
+                buildQueueRoot.push_back(i);
             }
+        }
+    }
+
+    std::vector<BuildQueueItem> items;
+    prepareBuildQueue(items, buildQueue, cycleDetected, frontendOptions);
+
+    // cyclic dependencies make the results depend on the order in which modules are checked, so we keep it sequential
+    // lower bounds calculation normalizes types in place, including the ones in the global scope shared by all tasks
+    if (!executeTask || cycleDetected || FFlag::LuauLowerBoundsCalculation)
+    {
+        for (BuildQueueItem& item : items)
+        {
+            checkBuildQueueItem(item, typeChecker);
+            recordItemResult(item);
+        }
+    }
+    else
+    {
+        checkBuildQueueItemsParallel(items, executeTask);
+    }
+
+    std::unordered_map<ModuleName, size_t> rootIndex;
+    for (size_t i = 0; i < buildQueue.size(); ++i)
+        rootIndex[buildQueue[i]] = buildQueueRoot[i];
+
+    for (BuildQueueItem& item : items)
+    {
+        CheckResult& checkResult = results[rootIndex[item.name]];
+        checkResult.errors.insert(checkResult.errors.end(), item.module->errors.begin(), item.module->errors.end());
+    }
+
+    // roots that were checked as a dependency of an earlier root report all their errors, just like a check of a clean module would
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        auto it = rootIndex.find(names[i]);
+
+        if (it != rootIndex.end() && it->second < i)
+            results[i] = check(names[i], frontendOptions);
+    }
+
+    return results;
+}
+
+void Frontend::prepareBuildQueue(
+    std::vector<BuildQueueItem>& items, const std::vector<ModuleName>& buildQueue, bool cycleDetected, const FrontendOptions& frontendOptions)
+{
+    // the global environment is hashed once per type index, since the index is reset whenever definitions are loaded
+    if (moduleCache && !persistentTypeIndex)
+    {
+        persistentTypeIndex = std::make_unique<PersistentTypeIndex>(typeChecker.globalScope, singletonTypes);
+
+        globalEnvironmentKey = hashBytes(kHashSeed, &kAnalyzerVersion, sizeof(kAnalyzerVersion));
+        globalEnvironmentKey = hashScope(globalEnvironmentKey, *typeChecker.globalScope);
+    }
+
+    // flags can be changed between checks, so unlike the global scope they are hashed for every build queue
+    uint64_t analyzerKey = moduleCache ? hashFlags(globalEnvironmentKey) : 0;
 
-            stats.timeCheck += duration;
-            stats.filesStrict += 1;
+    std::unordered_map<const Scope*, uint64_t> environmentKeys;
 
-            sourceNode.dirtyModuleForAutocomplete = false;
+    for (const ModuleName& moduleName : buildQueue)
+    {
+        LUAU_ASSERT(sourceNodes.count(moduleName));
+        SourceNode& sourceNode = sourceNodes[moduleName];
+
+        if (!sourceNode.hasDirtyModule(frontendOptions.forAutocomplete))
             continue;
+
+        LUAU_ASSERT(sourceModules.count(moduleName));
+        SourceModule& sourceModule = sourceModules[moduleName];
+
+        const Config& config = configResolver->getConfig(moduleName);
+
+        BuildQueueItem& item = items.emplace_back();
+        item.name = moduleName;
+        item.sourceNode = &sourceNode;
+        item.sourceModule = &sourceModule;
+        item.mode = sourceModule.mode.value_or(config.mode);
+        item.environmentScope = getModuleEnvironment(sourceModule, config, frontendOptions.forAutocomplete);
+        item.options = frontendOptions;
+
+        // in NoCheck mode we only need to compute the value of .cyclic for typeck
+        // in the future we could replace toposort with an algorithm that can flag cyclic nodes by itself
+        // however, for now getRequireCycles isn't expensive in practice on the cases we care about, and long term
+        // all correct programs must be acyclic so this code triggers rarely
+        if (cycleDetected)
+            item.requireCycles = getRequireCycles(fileResolver, sourceNodes, &sourceNode, item.mode == Mode::NoCheck);
+
+        // This is used by the type checker to replace the resulting type of cyclic modules with any
+        sourceModule.cyclic = !item.requireCycles.empty();
+
+        // the key covers everything the interface depends on; the queue is sorted topologically so the keys of all requires are known
+        uint64_t key = hashString(kHashSeed, moduleName);
+        key = hashBytes(key, &sourceNode.sourceHash, sizeof(sourceNode.sourceHash));
+        key = hashBytes(key, &item.mode, sizeof(item.mode));
+        key = hashString(key, sourceModule.environmentName.value_or(""));
+        key = hashBytes(key, &analyzerKey, sizeof(analyzerKey));
+
+        // named environments and config globals are layered on top of the global scope
+        for (const Scope* scope = item.environmentScope.get(); scope && scope != typeChecker.globalScope.get(); scope = scope->parent.get())
+        {
+            auto [it, inserted] = environmentKeys.try_emplace(scope, 0);
+            if (inserted)
+                it->second = hashScope(kHashSeed, *scope);
+
+            key = hashBytes(key, &it->second, sizeof(it->second));
+        }
+
+        std::vector<ModuleName> requireNames(sourceNode.requireSet.begin(), sourceNode.requireSet.end());
+        std::sort(requireNames.begin(), requireNames.end());
+
+        for (const ModuleName& require : requireNames)
+        {
+            auto it = sourceNodes.find(require);
+            uint64_t requireKey = it != sourceNodes.end() ? it->second.interfaceKey : 0;
+
+            key = hashString(key, require);
+            key = hashBytes(key, &requireKey, sizeof(requireKey));
+        }
+
+        sourceNode.interfaceKey = key;
+
+        // the interfaces of cyclic modules depend on the order in which they are checked
+        // autocomplete checks against its own global scope, which the type index and the environment key don't cover
+        if (moduleCache && !cycleDetected && !frontendOptions.retainFullTypeGraphs && !frontendOptions.forAutocomplete &&
+            !FFlag::DebugLuauDeferredConstraintResolution)
+            item.interfaceKey = key;
+    }
+}
+
+void Frontend::checkBuildQueueItem(BuildQueueItem& item, TypeChecker& typeChecker)
+{
+    LUAU_TIMETRACE_SCOPE("Frontend::checkBuildQueueItem", "Frontend");
+    LUAU_TIMETRACE_ARGUMENT("name", item.name.c_str());
+
+    const SourceModule& sourceModule = *item.sourceModule;
+    Mode mode = item.mode;
+
+    double timestamp = getTimestamp();
+
+    if (item.interfaceKey)
+    {
+        if (std::optional<std::string> data = moduleCache->readModuleInterface(item.name))
+        {
+            ScopePtr parentScope = item.environmentScope ? item.environmentScope : typeChecker.globalScope;
+
+            if (ModulePtr module = deserializeModuleInterface(*data, *item.interfaceKey, *persistentTypeIndex, parentScope))
+            {
+                item.stats.timeCheck += getTimestamp() - timestamp;
+                item.stats.filesStrict += mode == Mode::Strict;
+                item.stats.filesNonstrict += mode == Mode::Nonstrict;
+                item.stats.filesCached += 1;
+
+                item.module = std::move(module);
+                return;
+            }
         }
+    }
+
+    typeChecker.requireCycles = item.requireCycles;
 
-        typeChecker.requireCycles = requireCycles;
+    ModulePtr module = FFlag::DebugLuauDeferredConstraintResolution ? check(sourceModule, mode, item.environmentScope, item.requireCycles)
+                                                                    : typeChecker.check(sourceModule, mode, item.environmentScope);
 
-        ModulePtr module = FFlag::DebugLuauDeferredConstraintResolution ? check(sourceModule, mode, environmentScope, requireCycles)
-                                                                        : typeChecker.check(sourceModule, mode, environmentScope);
+    item.stats.timeCheck += getTimestamp() - timestamp;
+    item.stats.filesStrict += mode == Mode::Strict;
+    item.stats.filesNonstrict += mode == Mode::Nonstrict;
 
-        stats.timeCheck += getTimestamp() - timestamp;
-        stats.filesStrict += mode == Mode::Strict;
-        stats.filesNonstrict += mode == Mode::Nonstrict;
+    if (module == nullptr)
+        throw std::runtime_error("Frontend::check produced a nullptr module for " + item.name);
 
-        if (module == nullptr)
-            throw std::runtime_error("Frontend::check produced a nullptr module for " + moduleName);
+    if (!item.options.retainFullTypeGraphs)
+    {
+        // copyErrors needs to allocate into interfaceTypes as it copies
+        // types out of internalTypes, so we unfreeze it here.
+        unfreeze(module->interfaceTypes);
+        copyErrors(module->errors, module->interfaceTypes);
+        freeze(module->interfaceTypes);
+
+        module->internalTypes.clear();
+        module->astTypes.clear();
+        module->astExpectedTypes.clear();
+        module->astOriginalCallTypes.clear();
+        module->astResolvedTypes.clear();
+        module->astResolvedTypePacks.clear();
+        module->scopes.resize(1);
+    }
 
-        if (!frontendOptions.retainFullTypeGraphs)
+    if (mode != Mode::NoCheck)
+    {
+        for (const RequireCycle& cyc : item.requireCycles)
         {
-            // copyErrors needs to allocate into interfaceTypes as it copies
-            // types out of internalTypes, so we unfreeze it here.
-            unfreeze(module->interfaceTypes);
-            copyErrors(module->errors, module->interfaceTypes);
-            freeze(module->interfaceTypes);
-
-            module->internalTypes.clear();
-            module->astTypes.clear();
-            module->astExpectedTypes.clear();
-            module->astOriginalCallTypes.clear();
-            module->astResolvedTypes.clear();
-            module->astResolvedTypePacks.clear();
-            module->scopes.resize(1);
+            TypeError te{cyc.location, item.name, ModuleHasCyclicDependency{cyc.path}};
+
+            module->errors.push_back(te);
         }
+    }
+
+    ErrorVec parseErrors;
+
+    for (const ParseError& pe : sourceModule.parseErrors)
+        parseErrors.push_back(TypeError{pe.getLocation(), item.name, SyntaxError{pe.what()}});
+
+    module->errors.insert(module->errors.begin(), parseErrors.begin(), parseErrors.end());
+
+    // only interfaces of modules without errors are stored since the errors would have to be reported again
+    if (item.interfaceKey && module->errors.empty() && !module->timeout)
+    {
+        if (std::optional<std::string> data = serializeModuleInterface(*module, *item.interfaceKey, *persistentTypeIndex))
+            moduleCache->writeModuleInterface(item.name, *data);
+    }
+
+    item.module = std::move(module);
+}
+
+void Frontend::checkBuildQueueItemsParallel(std::vector<BuildQueueItem>& items, const std::function<void(std::function<void()> task)>& executeTask)
+{
+    // a module can be checked once all modules it requires from the same queue are checked; other dependencies are already up to date
+    std::unordered_map<ModuleName, size_t> itemIndex;
+    for (size_t i = 0; i < items.size(); ++i)
+        itemIndex[items[i].name] = i;
+
+    std::vector<size_t> remaining(items.size());
+    std::vector<std::vector<size_t>> dependents(items.size());
 
-        if (mode != Mode::NoCheck)
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        for (const ModuleName& dep : items[i].sourceNode->requireSet)
         {
-            for (const RequireCycle& cyc : requireCycles)
+            auto it = itemIndex.find(dep);
+
+            if (it != itemIndex.end() && it->second != i)
+            {
+                remaining[i]++;
+                dependents[it->second].push_back(i);
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<size_t> completed;
+
+    size_t inflight = 0;
+
+    auto submit = [&](size_t i) {
+        inflight++;
+
+        executeTask([&, i] {
+            BuildQueueItem& item = items[i];
+
+            try
+            {
+                // each task uses a separate type checker that shares the global scope with the frontend one
+                InternalErrorReporter iceReporter;
+                iceReporter.onInternalError = iceHandler.onInternalError;
+
+                TypeChecker taskTypeChecker(&moduleResolver, singletonTypes, &iceReporter);
+                taskTypeChecker.globalScope = typeChecker.globalScope;
+                taskTypeChecker.prepareModuleScope = typeChecker.prepareModuleScope;
+                taskTypeChecker.instantiationChildLimit = typeChecker.instantiationChildLimit;
+                taskTypeChecker.unifierIterationLimit = typeChecker.unifierIterationLimit;
+
+                checkBuildQueueItem(item, taskTypeChecker);
+            }
+            catch (...)
             {
-                TypeError te{cyc.location, moduleName, ModuleHasCyclicDependency{cyc.path}};
+                item.exception = std::current_exception();
+            }
 
-                module->errors.push_back(te);
+            {
+                std::unique_lock guard(mutex);
+                completed.push_back(i);
             }
+
+            cv.notify_one();
+        });
+    };
+
+    for (size_t i = 0; i < items.size(); ++i)
+        if (remaining[i] == 0)
+            submit(i);
+
+    std::vector<size_t> batch;
+
+    while (inflight > 0)
+    {
+        {
+            std::unique_lock guard(mutex);
+            cv.wait(guard, [&] {
+                return !completed.empty();
+            });
+
+            batch.swap(completed);
         }
 
-        ErrorVec parseErrors;
+        for (size_t i : batch)
+        {
+            inflight--;
 
-        for (const ParseError& pe : sourceModule.parseErrors)
-            parseErrors.push_back(TypeError{pe.getLocation(), moduleName, SyntaxError{pe.what()}});
+            // dependents of a failed module are never checked; the error is reported once all tasks finish
+            if (items[i].exception)
+                continue;
 
-        module->errors.insert(module->errors.begin(), parseErrors.begin(), parseErrors.end());
+            recordItemResult(items[i]);
 
-        checkResult.errors.insert(checkResult.errors.end(), module->errors.begin(), module->errors.end());
+            for (size_t dependent : dependents[i])
+                if (--remaining[dependent] == 0)
+                    submit(dependent);
+        }
 
-        moduleResolver.modules[moduleName] = std::move(module);
-        sourceNode.dirtyModule = false;
+        batch.clear();
     }
 
-    return checkResult;
+    for (BuildQueueItem& item : items)
+        if (item.exception)
+            std::rethrow_exception(item.exception);
+}
+
+void Frontend::recordItemResult(const BuildQueueItem& item)
+{
+    {
+        std::unique_lock guard(moduleResolver.moduleMutex);
+        moduleResolver.modules[item.name] = item.module;
+    }
+
+    item.sourceNode->dirtyModule = false;
+
+    stats.timeCheck += item.stats.timeCheck;
+    stats.filesStrict += item.stats.filesStrict;
+    stats.filesNonstrict += item.stats.filesNonstrict;
+    stats.filesCached += item.stats.filesCached;
 }
 
 bool Frontend::parseGraph(std::vector<ModuleName>& buildQueue, CheckResult& checkResult, const ModuleName& root, bool forAutocomplete)
@@ -921,6 +1338,8 @@ std::pair<SourceNode*, SourceModule*> Frontend::getSourceNode(CheckResult& check
     SourceModule result = parse(name, source->source, opts);
     result.type = source->type;
 
+    uint64_t sourceHash = hashString(kHashSeed, source->source);
+
     RequireTraceResult& require = requireTrace[name];
     require = traceRequires(fileResolver, result.root, name);
 
@@ -931,6 +1350,7 @@ std::pair<SourceNode*, SourceModule*> Frontend::getSourceNode(CheckResult& check
     sourceModule.environmentName = environmentName;
 
     sourceNode.name = name;
+    sourceNode.sourceHash = sourceHash;
     sourceNode.requireSet.clear();
     sourceNode.requireLocations.clear();
     sourceNode.dirtySourceModule = false;
@@ -1026,6 +1446,8 @@ std::optional<ModuleInfo> FrontendModuleResolver::resolveModuleInfo(const Module
 
 const ModulePtr FrontendModuleResolver::getModule(const ModuleName& moduleName) const
 {
+    std::unique_lock guard(moduleMutex);
+
     auto it = modules.find(moduleName);
     if (it != modules.end())
         return it->second;
@@ -1106,6 +1528,7 @@ void Frontend::clear()
     moduleResolver.modules.clear();
     moduleResolverForAutocomplete.modules.clear();
     requireTrace.clear();
+    persistentTypeIndex.reset();
 }
 
 } // namespace Luau
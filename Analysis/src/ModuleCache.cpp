@@ -0,0 +1,1131 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/ModuleCache.h"
+
+#include "Luau/Scope.h"
+#include "Luau/TypePack.h"
+#include "Luau/TypeVar.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace Luau
+{
+
+static const char kInterfaceMagic[] = "LUAUMI";
+static const uint8_t kInterfaceVersion = 1;
+
+enum class TypeTag : uint8_t
+{
+    Primitive,
+    Singleton,
+    Function,
+    Table,
+    Metatable,
+    Any,
+    Union,
+    Intersection,
+    Unknown,
+    Never,
+    Generic,
+    Error,
+};
+
+enum class TypePackTag : uint8_t
+{
+    Pack,
+    Variadic,
+    Generic,
+    Error,
+};
+
+enum class RecordKind : uint8_t
+{
+    Type,
+    TypePack,
+};
+
+static std::string childName(const std::string& parent, char kind, const std::string& name)
+{
+    // names are length-prefixed so that property names can't be confused with path separators
+    return parent + '/' + kind + std::to_string(name.size()) + ':' + name;
+}
+
+static std::string childName(const std::string& parent, char kind, size_t index)
+{
+    return parent + '/' + kind + std::to_string(index);
+}
+
+PersistentTypeIndex::PersistentTypeIndex(const ScopePtr& globalScope, NotNull<SingletonTypes> singletonTypes)
+{
+    // singleton types are registered first so that they always get the same short names
+    addType(singletonTypes->nilType, "nil");
+    addType(singletonTypes->numberType, "number");
+    addType(singletonTypes->stringType, "string");
+    addType(singletonTypes->booleanType, "boolean");
+    addType(singletonTypes->threadType, "thread");
+    addType(singletonTypes->trueType, "true");
+    addType(singletonTypes->falseType, "false");
+    addType(singletonTypes->anyType, "any");
+    addType(singletonTypes->unknownType, "unknown");
+    addType(singletonTypes->neverType, "never");
+    addType(singletonTypes->errorType, "error");
+
+    addTypePack(singletonTypes->anyTypePack, "...any");
+    addTypePack(singletonTypes->neverTypePack, "...never");
+    addTypePack(singletonTypes->uninhabitableTypePack, "uninhabitable");
+    addTypePack(singletonTypes->errorTypePack, "...error");
+
+    // the global scope is traversed in a fixed order so that every process assigns the same names to the same types
+    std::vector<std::pair<std::string, TypeId>> bindings;
+    for (const auto& [symbol, binding] : globalScope->bindings)
+        bindings.push_back({toString(symbol), binding.typeId});
+
+    std::sort(bindings.begin(), bindings.end());
+
+    for (const auto& [name, ty] : bindings)
+        addType(ty, childName("", 'b', name));
+
+    std::vector<std::pair<std::string, TypeId>> typeBindings;
+    for (const auto& [name, tf] : globalScope->exportedTypeBindings)
+        typeBindings.push_back({childName("", 'e', name), tf.type});
+    for (const auto& [name, tf] : globalScope->privateTypeBindings)
+        typeBindings.push_back({childName("", 't', name), tf.type});
+
+    std::sort(typeBindings.begin(), typeBindings.end());
+
+    for (const auto& [name, ty] : typeBindings)
+        addType(ty, name);
+}
+
+void PersistentTypeIndex::addType(TypeId ty, const std::string& name)
+{
+    ty = follow(ty);
+
+    if (!ty->persistent)
+        return;
+
+    if (!typeNames.try_emplace(ty, name).second)
+        return;
+
+    types[name] = ty;
+
+    if (const PrimitiveTypeVar* ptv = get<PrimitiveTypeVar>(ty))
+    {
+        if (ptv->metatable)
+            addType(*ptv->metatable, childName(name, 'm', 0));
+    }
+    else if (const FunctionTypeVar* ftv = get<FunctionTypeVar>(ty))
+    {
+        addTypePack(ftv->argTypes, childName(name, 'a', 0));
+        addTypePack(ftv->retTypes, childName(name, 'r', 0));
+    }
+    else if (const TableTypeVar* ttv = get<TableTypeVar>(ty))
+    {
+        for (const auto& [propName, prop] : ttv->props)
+            addType(prop.type, childName(name, 'p', propName));
+
+        if (ttv->indexer)
+        {
+            addType(ttv->indexer->indexType, childName(name, 'k', 0));
+            addType(ttv->indexer->indexResultType, childName(name, 'v', 0));
+        }
+    }
+    else if (const MetatableTypeVar* mtv = get<MetatableTypeVar>(ty))
+    {
+        addType(mtv->table, childName(name, 't', 0));
+        addType(mtv->metatable, childName(name, 'm', 0));
+    }
+    else if (const ClassTypeVar* ctv = get<ClassTypeVar>(ty))
+    {
+        for (const auto& [propName, prop] : ctv->props)
+            addType(prop.type, childName(name, 'p', propName));
+
+        if (ctv->parent)
+            addType(*ctv->parent, childName(name, 'c', 0));
+        if (ctv->metatable)
+            addType(*ctv->metatable, childName(name, 'm', 0));
+    }
+    else if (const UnionTypeVar* utv = get<UnionTypeVar>(ty))
+    {
+        for (size_t i = 0; i < utv->options.size(); ++i)
+            addType(utv->options[i], childName(name, 'u', i));
+    }
+    else if (const IntersectionTypeVar* itv = get<IntersectionTypeVar>(ty))
+    {
+        for (size_t i = 0; i < itv->parts.size(); ++i)
+            addType(itv->parts[i], childName(name, 'i', i));
+    }
+}
+
+void PersistentTypeIndex::addTypePack(TypePackId tp, const std::string& name)
+{
+    tp = follow(tp);
+
+    if (!tp->persistent)
+        return;
+
+    if (!typePackNames.try_emplace(tp, name).second)
+        return;
+
+    typePacks[name] = tp;
+
+    if (const TypePack* pack = get<TypePack>(tp))
+    {
+        for (size_t i = 0; i < pack->head.size(); ++i)
+            addType(pack->head[i], childName(name, 'h', i));
+
+        if (pack->tail)
+            addTypePack(*pack->tail, childName(name, 't', 0));
+    }
+    else if (const VariadicTypePack* vtp = get<VariadicTypePack>(tp))
+    {
+        addType(vtp->ty, childName(name, 'v', 0));
+    }
+}
+
+namespace
+{
+
+struct InterfaceWriter
+{
+    std::string data;
+
+    void writeByte(uint8_t value)
+    {
+        data.push_back(char(value));
+    }
+
+    void writeBool(bool value)
+    {
+        writeByte(value);
+    }
+
+    void writeVarInt(uint64_t value)
+    {
+        do
+        {
+            writeByte(uint8_t((value & 127) | ((value > 127) << 7)));
+            value >>= 7;
+        } while (value);
+    }
+
+    void writeInt(int value)
+    {
+        writeVarInt(uint32_t(value));
+    }
+
+    void writeString(const std::string& value)
+    {
+        writeVarInt(value.size());
+        data.append(value);
+    }
+
+    void writeOptionalString(const std::optional<std::string>& value)
+    {
+        writeBool(value.has_value());
+        if (value)
+            writeString(*value);
+    }
+
+    void writeLocation(const Location& location)
+    {
+        writeVarInt(location.begin.line);
+        writeVarInt(location.begin.column);
+        writeVarInt(location.end.line);
+        writeVarInt(location.end.column);
+    }
+
+    void writeLevel(const TypeLevel& level)
+    {
+        writeInt(level.level);
+        writeInt(level.subLevel);
+    }
+};
+
+struct InterfaceReader
+{
+    std::string_view data;
+    size_t offset = 0;
+    bool failed = false;
+
+    uint8_t readByte()
+    {
+        if (offset >= data.size())
+        {
+            failed = true;
+            return 0;
+        }
+
+        return uint8_t(data[offset++]);
+    }
+
+    bool readBool()
+    {
+        return readByte() != 0;
+    }
+
+    uint64_t readVarInt()
+    {
+        uint64_t result = 0;
+        unsigned shift = 0;
+
+        uint8_t byte;
+
+        do
+        {
+            byte = readByte();
+            result |= uint64_t(byte & 127) << shift;
+            shift += 7;
+        } while ((byte & 128) && shift < 64);
+
+        return result;
+    }
+
+    int readInt()
+    {
+        return int(uint32_t(readVarInt()));
+    }
+
+    // counts are validated against the remaining data so that malformed input can't trigger huge allocations
+    size_t readCount()
+    {
+        uint64_t count = readVarInt();
+
+        if (count > data.size() - std::min(offset, data.size()))
+        {
+            failed = true;
+            return 0;
+        }
+
+        return size_t(count);
+    }
+
+    std::string readString()
+    {
+        size_t length = readCount();
+
+        std::string result(data.substr(std::min(offset, data.size()), length));
+        offset += length;
+
+        return result;
+    }
+
+    std::optional<std::string> readOptionalString()
+    {
+        if (readBool())
+            return readString();
+
+        return std::nullopt;
+    }
+
+    Location readLocation()
+    {
+        unsigned beginLine = unsigned(readVarInt());
+        unsigned beginColumn = unsigned(readVarInt());
+        unsigned endLine = unsigned(readVarInt());
+        unsigned endColumn = unsigned(readVarInt());
+
+        return Location{Position{beginLine, beginColumn}, Position{endLine, endColumn}};
+    }
+
+    TypeLevel readLevel()
+    {
+        TypeLevel level;
+        level.level = readInt();
+        level.subLevel = readInt();
+        return level;
+    }
+};
+
+struct InterfaceSerializer
+{
+    const PersistentTypeIndex& index;
+    InterfaceWriter writer;
+
+    std::unordered_map<TypeId, size_t> typeIds;
+    std::unordered_map<TypePackId, size_t> typePackIds;
+
+    // types and type packs are written in the order they are discovered, which is the order in which they get their ids
+    std::queue<std::pair<RecordKind, const void*>> pending;
+
+    bool failed = false;
+
+    InterfaceSerializer(const PersistentTypeIndex& index)
+        : index(index)
+    {
+    }
+
+    void writeType(TypeId ty)
+    {
+        ty = follow(ty);
+
+        if (ty->persistent)
+        {
+            auto it = index.typeNames.find(ty);
+
+            if (it == index.typeNames.end())
+            {
+                failed = true;
+                return;
+            }
+
+            writer.writeVarInt(0);
+            writer.writeString(it->second);
+            return;
+        }
+
+        auto [it, inserted] = typeIds.try_emplace(ty, typeIds.size());
+
+        if (inserted)
+            pending.push({RecordKind::Type, ty});
+
+        writer.writeVarInt(it->second + 1);
+    }
+
+    void writeTypePack(TypePackId tp)
+    {
+        tp = follow(tp);
+
+        if (tp->persistent)
+        {
+            auto it = index.typePackNames.find(tp);
+
+            if (it == index.typePackNames.end())
+            {
+                failed = true;
+                return;
+            }
+
+            writer.writeVarInt(0);
+            writer.writeString(it->second);
+            return;
+        }
+
+        auto [it, inserted] = typePackIds.try_emplace(tp, typePackIds.size());
+
+        if (inserted)
+            pending.push({RecordKind::TypePack, tp});
+
+        writer.writeVarInt(it->second + 1);
+    }
+
+    void writeOptionalType(std::optional<TypeId> ty)
+    {
+        writer.writeBool(ty.has_value());
+        if (ty)
+            writeType(*ty);
+    }
+
+    void writeOptionalTypePack(std::optional<TypePackId> tp)
+    {
+        writer.writeBool(tp.has_value());
+        if (tp)
+            writeTypePack(*tp);
+    }
+
+    void writeTags(const Tags& tags)
+    {
+        writer.writeVarInt(tags.size());
+        for (const std::string& tag : tags)
+            writer.writeString(tag);
+    }
+
+    void writeProps(const TableTypeVar::Props& props)
+    {
+        writer.writeVarInt(props.size());
+
+        for (const auto& [name, prop] : props)
+        {
+            writer.writeString(name);
+            writeType(prop.type);
+            writer.writeBool(prop.deprecated);
+            writer.writeString(prop.deprecatedSuggestion);
+
+            writer.writeBool(prop.location.has_value());
+            if (prop.location)
+                writer.writeLocation(*prop.location);
+
+            writeTags(prop.tags);
+            writer.writeOptionalString(prop.documentationSymbol);
+        }
+    }
+
+    void writeTypeRecord(TypeId ty)
+    {
+        writer.writeBool(ty->normal);
+        writer.writeOptionalString(ty->documentationSymbol);
+
+        if (const PrimitiveTypeVar* ptv = get<PrimitiveTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Primitive));
+            writer.writeByte(uint8_t(ptv->type));
+            writeOptionalType(ptv->metatable);
+        }
+        else if (const SingletonTypeVar* stv = get<SingletonTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Singleton));
+
+            if (const BooleanSingleton* bs = get<BooleanSingleton>(stv))
+            {
+                writer.writeByte(0);
+                writer.writeBool(bs->value);
+            }
+            else if (const StringSingleton* ss = get<StringSingleton>(stv))
+            {
+                writer.writeByte(1);
+                writer.writeString(ss->value);
+            }
+            else
+            {
+                failed = true;
+            }
+        }
+        else if (const FunctionTypeVar* ftv = get<FunctionTypeVar>(ty))
+        {
+            // magic functions are native callbacks that only builtin (persistent) types can have
+            if (ftv->magicFunction || ftv->dcrMagicFunction)
+                failed = true;
+
+            writer.writeByte(uint8_t(TypeTag::Function));
+            writer.writeLevel(ftv->level);
+
+            writer.writeVarInt(ftv->generics.size());
+            for (TypeId generic : ftv->generics)
+                writeType(generic);
+
+            writer.writeVarInt(ftv->genericPacks.size());
+            for (TypePackId genericPack : ftv->genericPacks)
+                writeTypePack(genericPack);
+
+            writeTypePack(ftv->argTypes);
+            writeTypePack(ftv->retTypes);
+
+            writer.writeVarInt(ftv->argNames.size());
+            for (const std::optional<FunctionArgument>& arg : ftv->argNames)
+            {
+                writer.writeBool(arg.has_value());
+                if (arg)
+                {
+                    writer.writeString(arg->name);
+                    writer.writeLocation(arg->location);
+                }
+            }
+
+            writer.writeBool(ftv->definition.has_value());
+            if (ftv->definition)
+            {
+                writer.writeOptionalString(ftv->definition->definitionModuleName);
+                writer.writeLocation(ftv->definition->definitionLocation);
+                writer.writeBool(ftv->definition->varargLocation.has_value());
+                if (ftv->definition->varargLocation)
+                    writer.writeLocation(*ftv->definition->varargLocation);
+                writer.writeLocation(ftv->definition->originalNameLocation);
+            }
+
+            writer.writeBool(ftv->hasSelf);
+            writeTags(ftv->tags);
+            writer.writeBool(ftv->hasNoGenerics);
+        }
+        else if (const TableTypeVar* ttv = get<TableTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Table));
+            writeProps(ttv->props);
+
+            writer.writeBool(ttv->indexer.has_value());
+            if (ttv->indexer)
+            {
+                writeType(ttv->indexer->indexType);
+                writeType(ttv->indexer->indexResultType);
+            }
+
+            writer.writeByte(uint8_t(ttv->state));
+            writer.writeLevel(ttv->level);
+            writer.writeOptionalString(ttv->name);
+            writer.writeOptionalString(ttv->syntheticName);
+
+            writer.writeVarInt(ttv->instantiatedTypeParams.size());
+            for (TypeId param : ttv->instantiatedTypeParams)
+                writeType(param);
+
+            writer.writeVarInt(ttv->instantiatedTypePackParams.size());
+            for (TypePackId param : ttv->instantiatedTypePackParams)
+                writeTypePack(param);
+
+            writer.writeString(ttv->definitionModuleName);
+            writeTags(ttv->tags);
+            writeOptionalType(ttv->selfTy);
+        }
+        else if (const MetatableTypeVar* mtv = get<MetatableTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Metatable));
+            writeType(mtv->table);
+            writeType(mtv->metatable);
+            writer.writeOptionalString(mtv->syntheticName);
+        }
+        else if (get<AnyTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Any));
+        }
+        else if (const UnionTypeVar* utv = get<UnionTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Union));
+            writer.writeVarInt(utv->options.size());
+            for (TypeId option : utv->options)
+                writeType(option);
+        }
+        else if (const IntersectionTypeVar* itv = get<IntersectionTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Intersection));
+            writer.writeVarInt(itv->parts.size());
+            for (TypeId part : itv->parts)
+                writeType(part);
+        }
+        else if (get<UnknownTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Unknown));
+        }
+        else if (get<NeverTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Never));
+        }
+        else if (const GenericTypeVar* gtv = get<GenericTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Generic));
+            writer.writeLevel(gtv->level);
+            writer.writeString(gtv->name);
+            writer.writeBool(gtv->explicitName);
+        }
+        else if (get<ErrorTypeVar>(ty))
+        {
+            writer.writeByte(uint8_t(TypeTag::Error));
+        }
+        else
+        {
+            // free, blocked and constrained types only exist while a module is being checked; classes can only come from definition files
+            failed = true;
+        }
+    }
+
+    void writeTypePackRecord(TypePackId tp)
+    {
+        if (const TypePack* pack = get<TypePack>(tp))
+        {
+            writer.writeByte(uint8_t(TypePackTag::Pack));
+            writer.writeVarInt(pack->head.size());
+            for (TypeId ty : pack->head)
+                writeType(ty);
+            writeOptionalTypePack(pack->tail);
+        }
+        else if (const VariadicTypePack* vtp = get<VariadicTypePack>(tp))
+        {
+            writer.writeByte(uint8_t(TypePackTag::Variadic));
+            writeType(vtp->ty);
+            writer.writeBool(vtp->hidden);
+        }
+        else if (const GenericTypePack* gtp = get<GenericTypePack>(tp))
+        {
+            writer.writeByte(uint8_t(TypePackTag::Generic));
+            writer.writeLevel(gtp->level);
+            writer.writeString(gtp->name);
+            writer.writeBool(gtp->explicitName);
+        }
+        else if (get<Unifiable::Error>(tp))
+        {
+            writer.writeByte(uint8_t(TypePackTag::Error));
+        }
+        else
+        {
+            failed = true;
+        }
+    }
+
+    void writeRecords()
+    {
+        while (!pending.empty() && !failed)
+        {
+            auto [kind, ptr] = pending.front();
+            pending.pop();
+
+            writer.writeByte(uint8_t(kind));
+
+            if (kind == RecordKind::Type)
+                writeTypeRecord(static_cast<TypeId>(ptr));
+            else
+                writeTypePackRecord(static_cast<TypePackId>(ptr));
+        }
+    }
+};
+
+struct InterfaceDeserializer
+{
+    const PersistentTypeIndex& index;
+    InterfaceReader reader;
+    TypeArena& arena;
+
+    std::vector<TypeId> types;
+    std::vector<TypePackId> typePacks;
+
+    InterfaceDeserializer(const PersistentTypeIndex& index, std::string_view data, TypeArena& arena)
+        : index(index)
+        , arena(arena)
+    {
+        reader.data = data;
+    }
+
+    TypeId readType()
+    {
+        uint64_t id = reader.readVarInt();
+
+        if (id == 0)
+        {
+            auto it = index.types.find(reader.readString());
+
+            if (it != index.types.end())
+                return it->second;
+        }
+        else if (id <= types.size())
+        {
+            return types[id - 1];
+        }
+
+        reader.failed = true;
+        return index.types.at("error");
+    }
+
+    TypePackId readTypePack()
+    {
+        uint64_t id = reader.readVarInt();
+
+        if (id == 0)
+        {
+            auto it = index.typePacks.find(reader.readString());
+
+            if (it != index.typePacks.end())
+                return it->second;
+        }
+        else if (id <= typePacks.size())
+        {
+            return typePacks[id - 1];
+        }
+
+        reader.failed = true;
+        return index.typePacks.at("...error");
+    }
+
+    std::optional<TypeId> readOptionalType()
+    {
+        if (reader.readBool())
+            return readType();
+
+        return std::nullopt;
+    }
+
+    std::optional<TypePackId> readOptionalTypePack()
+    {
+        if (reader.readBool())
+            return readTypePack();
+
+        return std::nullopt;
+    }
+
+    Tags readTags()
+    {
+        Tags tags(reader.readCount());
+        for (std::string& tag : tags)
+            tag = reader.readString();
+        return tags;
+    }
+
+    TableTypeVar::Props readProps()
+    {
+        TableTypeVar::Props props;
+
+        size_t count = reader.readCount();
+
+        for (size_t i = 0; i < count && !reader.failed; ++i)
+        {
+            std::string name = reader.readString();
+
+            Property& prop = props[name];
+            prop.type = readType();
+            prop.deprecated = reader.readBool();
+            prop.deprecatedSuggestion = reader.readString();
+
+            if (reader.readBool())
+                prop.location = reader.readLocation();
+
+            prop.tags = readTags();
+            prop.documentationSymbol = reader.readOptionalString();
+        }
+
+        return props;
+    }
+
+    void readTypeRecord(TypeVar& tv)
+    {
+        tv.normal = reader.readBool();
+        tv.documentationSymbol = reader.readOptionalString();
+
+        switch (TypeTag(reader.readByte()))
+        {
+        case TypeTag::Primitive:
+        {
+            uint8_t type = reader.readByte();
+            if (type > PrimitiveTypeVar::Thread)
+                reader.failed = true;
+
+            PrimitiveTypeVar ptv{PrimitiveTypeVar::Type(type)};
+            ptv.metatable = readOptionalType();
+            tv = std::move(ptv);
+            break;
+        }
+        case TypeTag::Singleton:
+        {
+            if (reader.readByte() == 0)
+                tv = SingletonTypeVar{BooleanSingleton{reader.readBool()}};
+            else
+                tv = SingletonTypeVar{StringSingleton{reader.readString()}};
+            break;
+        }
+        case TypeTag::Function:
+        {
+            TypeLevel level = reader.readLevel();
+
+            std::vector<TypeId> generics(reader.readCount());
+            for (TypeId& generic : generics)
+                generic = readType();
+
+            std::vector<TypePackId> genericPacks(reader.readCount());
+            for (TypePackId& genericPack : genericPacks)
+                genericPack = readTypePack();
+
+            TypePackId argTypes = readTypePack();
+            TypePackId retTypes = readTypePack();
+
+            FunctionTypeVar ftv{level, std::move(generics), std::move(genericPacks), argTypes, retTypes};
+
+            ftv.argNames.resize(reader.readCount());
+            for (std::optional<FunctionArgument>& arg : ftv.argNames)
+            {
+                if (reader.readBool())
+                {
+                    std::string name = reader.readString();
+                    arg = FunctionArgument{name, reader.readLocation()};
+                }
+            }
+
+            if (reader.readBool())
+            {
+                FunctionDefinition definition;
+                definition.definitionModuleName = reader.readOptionalString();
+                definition.definitionLocation = reader.readLocation();
+                if (reader.readBool())
+                    definition.varargLocation = reader.readLocation();
+                definition.originalNameLocation = reader.readLocation();
+
+                ftv.definition = std::move(definition);
+            }
+
+            ftv.hasSelf = reader.readBool();
+            ftv.tags = readTags();
+            ftv.hasNoGenerics = reader.readBool();
+
+            tv = std::move(ftv);
+            break;
+        }
+        case TypeTag::Table:
+        {
+            TableTypeVar ttv;
+            ttv.props = readProps();
+
+            if (reader.readBool())
+            {
+                TypeId indexType = readType();
+                TypeId indexResultType = readType();
+                ttv.indexer = TableIndexer{indexType, indexResultType};
+            }
+
+            uint8_t state = reader.readByte();
+            if (state > uint8_t(TableState::Generic))
+                reader.failed = true;
+
+            ttv.state = TableState(state);
+            ttv.level = reader.readLevel();
+            ttv.name = reader.readOptionalString();
+            ttv.syntheticName = reader.readOptionalString();
+
+            ttv.instantiatedTypeParams.resize(reader.readCount());
+            for (TypeId& param : ttv.instantiatedTypeParams)
+                param = readType();
+
+            ttv.instantiatedTypePackParams.resize(reader.readCount());
+            for (TypePackId& param : ttv.instantiatedTypePackParams)
+                param = readTypePack();
+
+            ttv.definitionModuleName = reader.readString();
+            ttv.tags = readTags();
+            ttv.selfTy = readOptionalType();
+
+            tv = std::move(ttv);
+            break;
+        }
+        case TypeTag::Metatable:
+        {
+            TypeId table = readType();
+            TypeId metatable = readType();
+            tv = MetatableTypeVar{table, metatable, reader.readOptionalString()};
+            break;
+        }
+        case TypeTag::Any:
+            tv = AnyTypeVar{};
+            break;
+        case TypeTag::Union:
+        {
+            UnionTypeVar utv;
+            utv.options.resize(reader.readCount());
+            for (TypeId& option : utv.options)
+                option = readType();
+            tv = std::move(utv);
+            break;
+        }
+        case TypeTag::Intersection:
+        {
+            IntersectionTypeVar itv;
+            itv.parts.resize(reader.readCount());
+            for (TypeId& part : itv.parts)
+                part = readType();
+            tv = std::move(itv);
+            break;
+        }
+        case TypeTag::Unknown:
+            tv = UnknownTypeVar{};
+            break;
+        case TypeTag::Never:
+            tv = NeverTypeVar{};
+            break;
+        case TypeTag::Generic:
+        {
+            TypeLevel level = reader.readLevel();
+            GenericTypeVar gtv{level, reader.readString()};
+            gtv.explicitName = reader.readBool();
+            tv = std::move(gtv);
+            break;
+        }
+        case TypeTag::Error:
+            tv = ErrorTypeVar{};
+            break;
+        default:
+            reader.failed = true;
+        }
+    }
+
+    void readTypePackRecord(TypePackVar& tpv)
+    {
+        switch (TypePackTag(reader.readByte()))
+        {
+        case TypePackTag::Pack:
+        {
+            TypePack pack;
+            pack.head.resize(reader.readCount());
+            for (TypeId& ty : pack.head)
+                ty = readType();
+            pack.tail = readOptionalTypePack();
+            tpv = std::move(pack);
+            break;
+        }
+        case TypePackTag::Variadic:
+        {
+            TypeId ty = readType();
+            tpv = VariadicTypePack{ty, reader.readBool()};
+            break;
+        }
+        case TypePackTag::Generic:
+        {
+            TypeLevel level = reader.readLevel();
+            GenericTypePack gtp{level, reader.readString()};
+            gtp.explicitName = reader.readBool();
+            tpv = std::move(gtp);
+            break;
+        }
+        case TypePackTag::Error:
+            tpv = Unifiable::Error{};
+            break;
+        default:
+            reader.failed = true;
+        }
+    }
+
+    void readRecords()
+    {
+        size_t nextType = 0;
+        size_t nextTypePack = 0;
+
+        while (!reader.failed && (nextType < types.size() || nextTypePack < typePacks.size()))
+        {
+            RecordKind kind = RecordKind(reader.readByte());
+
+            if (kind == RecordKind::Type && nextType < types.size())
+                readTypeRecord(*asMutable(types[nextType++]));
+            else if (kind == RecordKind::TypePack && nextTypePack < typePacks.size())
+                readTypePackRecord(*asMutable(typePacks[nextTypePack++]));
+            else
+                reader.failed = true;
+        }
+    }
+};
+
+} // namespace
+
+std::optional<std::string> serializeModuleInterface(const Module& module, uint64_t key, const PersistentTypeIndex& index)
+{
+    ScopePtr moduleScope = module.getModuleScope();
+
+    InterfaceSerializer serializer{index};
+    InterfaceWriter& writer = serializer.writer;
+
+    writer.writeLocation(module.scopes.front().first);
+    serializer.writeTypePack(moduleScope->returnType);
+    serializer.writeOptionalTypePack(moduleScope->varargPack);
+
+    std::vector<std::pair<Name, const TypeFun*>> exportedTypeBindings;
+    for (const auto& [name, tf] : moduleScope->exportedTypeBindings)
+        exportedTypeBindings.push_back({name, &tf});
+
+    std::sort(exportedTypeBindings.begin(), exportedTypeBindings.end());
+
+    writer.writeVarInt(exportedTypeBindings.size());
+    for (const auto& [name, tf] : exportedTypeBindings)
+    {
+        writer.writeString(name);
+
+        writer.writeVarInt(tf->typeParams.size());
+        for (const GenericTypeDefinition& param : tf->typeParams)
+        {
+            serializer.writeType(param.ty);
+            serializer.writeOptionalType(param.defaultValue);
+        }
+
+        writer.writeVarInt(tf->typePackParams.size());
+        for (const GenericTypePackDefinition& param : tf->typePackParams)
+        {
+            serializer.writeTypePack(param.tp);
+            serializer.writeOptionalTypePack(param.defaultValue);
+        }
+
+        serializer.writeType(tf->type);
+    }
+
+    std::vector<std::pair<Name, TypeId>> declaredGlobals(module.declaredGlobals.begin(), module.declaredGlobals.end());
+    std::sort(declaredGlobals.begin(), declaredGlobals.end());
+
+    writer.writeVarInt(declaredGlobals.size());
+    for (const auto& [name, ty] : declaredGlobals)
+    {
+        writer.writeString(name);
+        serializer.writeType(ty);
+    }
+
+    serializer.writeRecords();
+
+    if (serializer.failed)
+        return std::nullopt;
+
+    // the number of records is only known once the whole interface has been traversed
+    InterfaceWriter header;
+    header.data.append(kInterfaceMagic);
+    header.writeByte(kInterfaceVersion);
+    header.writeVarInt(key);
+    header.writeByte(uint8_t(module.mode));
+    header.writeByte(uint8_t(module.type));
+    header.writeVarInt(serializer.typeIds.size());
+    header.writeVarInt(serializer.typePackIds.size());
+
+    return header.data + writer.data;
+}
+
+ModulePtr deserializeModuleInterface(std::string_view data, uint64_t key, const PersistentTypeIndex& index, const ScopePtr& parentScope)
+{
+    size_t magicSize = sizeof(kInterfaceMagic) - 1;
+
+    if (data.substr(0, magicSize) != kInterfaceMagic)
+        return nullptr;
+
+    ModulePtr module = std::make_shared<Module>();
+
+    InterfaceDeserializer deserializer{index, data.substr(magicSize), module->interfaceTypes};
+    InterfaceReader& reader = deserializer.reader;
+
+    if (reader.readByte() != kInterfaceVersion || reader.readVarInt() != key)
+        return nullptr;
+
+    uint8_t mode = reader.readByte();
+    uint8_t type = reader.readByte();
+
+    if (mode > uint8_t(Mode::Definition) || type > SourceCode::Local)
+        return nullptr;
+
+    module->mode = Mode(mode);
+    module->type = SourceCode::Type(type);
+
+    // all types are allocated up front since records can refer to types that come after them
+    size_t typeCount = reader.readCount();
+    size_t typePackCount = reader.readCount();
+
+    if (reader.failed)
+        return nullptr;
+
+    for (size_t i = 0; i < typeCount; ++i)
+        deserializer.types.push_back(module->interfaceTypes.addType(AnyTypeVar{}));
+
+    for (size_t i = 0; i < typePackCount; ++i)
+        deserializer.typePacks.push_back(module->interfaceTypes.addTypePack(TypePack{}));
+
+    ScopePtr moduleScope = std::make_shared<Scope>(parentScope);
+    module->scopes.push_back({reader.readLocation(), moduleScope});
+
+    moduleScope->returnType = deserializer.readTypePack();
+    moduleScope->varargPack = deserializer.readOptionalTypePack();
+
+    size_t exportedTypeCount = reader.readCount();
+    for (size_t i = 0; i < exportedTypeCount && !reader.failed; ++i)
+    {
+        Name name = reader.readString();
+        TypeFun tf;
+
+        tf.typeParams.resize(reader.readCount());
+        for (GenericTypeDefinition& param : tf.typeParams)
+        {
+            param.ty = deserializer.readType();
+            param.defaultValue = deserializer.readOptionalType();
+        }
+
+        tf.typePackParams.resize(reader.readCount());
+        for (GenericTypePackDefinition& param : tf.typePackParams)
+        {
+            param.tp = deserializer.readTypePack();
+            param.defaultValue = deserializer.readOptionalTypePack();
+        }
+
+        tf.type = deserializer.readType();
+
+        moduleScope->exportedTypeBindings[name] = std::move(tf);
+    }
+
+    size_t declaredGlobalCount = reader.readCount();
+    for (size_t i = 0; i < declaredGlobalCount && !reader.failed; ++i)
+    {
+        Name name = reader.readString();
+        module->declaredGlobals[name] = deserializer.readType();
+    }
+
+    deserializer.readRecords();
+
+    if (reader.failed || reader.offset != reader.data.size())
+        return nullptr;
+
+    freeze(module->interfaceTypes);
+
+    return module;
+}
+
+} // namespace Luau
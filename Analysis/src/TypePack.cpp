@@ -9,11 +9,11 @@ namespace Luau
 {
 
 BlockedTypePack::BlockedTypePack()
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
 {
 }
 
-size_t BlockedTypePack::nextIndex = 0;
+std::atomic<size_t> BlockedTypePack::nextIndex = 0;
 
 TypePackVar::TypePackVar(const TypePackVariant& tp)
     : ty(tp)
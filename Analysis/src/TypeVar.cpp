@@ -439,11 +439,11 @@ bool hasLength(TypeId ty, DenseHashSet<TypeId>& seen, int* recursionCount)
 }
 
 BlockedTypeVar::BlockedTypeVar()
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
 {
 }
 
-int BlockedTypeVar::nextIndex = 0;
+std::atomic<int> BlockedTypeVar::nextIndex = 0;
 
 PendingExpansionTypeVar::PendingExpansionTypeVar(
     std::optional<AstName> prefix, AstName name, std::vector<TypeId> typeArguments, std::vector<TypePackId> packArguments)
@@ -451,11 +451,11 @@ PendingExpansionTypeVar::PendingExpansionTypeVar(
     , name(name)
     , typeArguments(typeArguments)
     , packArguments(packArguments)
-    , index(++nextIndex)
+    , index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
 {
 }
 
-size_t PendingExpansionTypeVar::nextIndex = 0;
+std::atomic<size_t> PendingExpansionTypeVar::nextIndex = 0;
 
 FunctionTypeVar::FunctionTypeVar(TypePackId argTypes, TypePackId retTypes, std::optional<FunctionDefinition> defn, bool hasSelf)
     : argTypes(argTypes)
@@ -7,47 +7,47 @@ namespace Unifiable
 {
 
 Free::Free(TypeLevel level)
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
     , level(level)
 {
 }
 
 Free::Free(Scope* scope)
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
     , scope(scope)
 {
 }
 
-int Free::nextIndex = 0;
+std::atomic<int> Free::nextIndex = 0;
 
 Generic::Generic()
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
     , name("g" + std::to_string(index))
 {
 }
 
 Generic::Generic(TypeLevel level)
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
     , level(level)
     , name("g" + std::to_string(index))
 {
 }
 
 Generic::Generic(const Name& name)
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
     , name(name)
     , explicitName(true)
 {
 }
 
 Generic::Generic(Scope* scope)
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
     , scope(scope)
 {
 }
 
 Generic::Generic(TypeLevel level, const Name& name)
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
     , level(level)
     , name(name)
     , explicitName(true)
@@ -55,21 +55,21 @@ Generic::Generic(TypeLevel level, const Name& name)
 }
 
 Generic::Generic(Scope* scope, const Name& name)
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
     , scope(scope)
     , name(name)
     , explicitName(true)
 {
 }
 
-int Generic::nextIndex = 0;
+std::atomic<int> Generic::nextIndex = 0;
 
 Error::Error()
-    : index(++nextIndex)
+    : index(nextIndex.fetch_add(1, std::memory_order_relaxed) + 1)
 {
 }
 
-int Error::nextIndex = 0;
+std::atomic<int> Error::nextIndex = 0;
 
 } // namespace Unifiable
 } // namespace Luau
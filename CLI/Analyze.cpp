@@ -9,6 +9,12 @@
 #include "FileUtils.h"
 #include "Flags.h"
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+
 #ifdef CALLGRIND
 #include <valgrind/callgrind.h>
 #endif
@@ -67,13 +73,8 @@ static void reportWarning(ReportFormat format, const char* name, const Luau::Lin
     report(format, name, warning.location, Luau::LintWarning::getName(warning.code), warning.text.c_str());
 }
 
-static bool analyzeFile(Luau::Frontend& frontend, const char* name, ReportFormat format, bool annotate)
+static bool analyzeFile(Luau::Frontend& frontend, const char* name, ReportFormat format, bool annotate, const Luau::CheckResult& cr)
 {
-    Luau::CheckResult cr;
-
-    if (frontend.isDirty(name))
-        cr = frontend.check(name);
-
     if (!frontend.getSourceModule(name))
     {
         fprintf(stderr, "Error opening %s\n", name);
@@ -118,7 +119,9 @@ static void displayHelp(const char* argv0)
     printf("  --formatter=plain: report analysis errors in Luacheck-compatible format\n");
     printf("  --formatter=gnu: report analysis errors in GNU-compatible format\n");
     printf("  --mode=strict: default to strict mode when typechecking\n");
+    printf("  --cache=<dir>: store the interfaces of checked modules in dir and skip checking unchanged modules on the next run\n");
     printf("  --timetrace: record compiler time tracing information into trace.json\n");
+    printf("  -j<N>: use N worker threads for typechecking (defaults to the number of hardware threads)\n");
 }
 
 static int assertionHandler(const char* expr, const char* file, int line, const char* function)
@@ -127,6 +130,72 @@ static int assertionHandler(const char* expr, const char* file, int line, const
     return 1;
 }
 
+struct TaskScheduler
+{
+    TaskScheduler(unsigned threadCount)
+    {
+        for (unsigned i = 0; i < threadCount; i++)
+        {
+            workers.emplace_back([this] {
+                workerFunction();
+            });
+        }
+    }
+
+    ~TaskScheduler()
+    {
+        {
+            std::unique_lock guard(mtx);
+            stopped = true;
+        }
+
+        cv.notify_all();
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    void push(std::function<void()> task)
+    {
+        {
+            std::unique_lock guard(mtx);
+            tasks.push(std::move(task));
+        }
+
+        cv.notify_one();
+    }
+
+private:
+    void workerFunction()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock guard(mtx);
+                cv.wait(guard, [this] {
+                    return stopped || !tasks.empty();
+                });
+
+                if (tasks.empty())
+                    return;
+
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+
+            task();
+        }
+    }
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::queue<std::function<void()>> tasks;
+    std::vector<std::thread> workers;
+    bool stopped = false;
+};
+
 struct CliFileResolver : Luau::FileResolver
 {
     std::optional<Luau::SourceCode> readSource(const Luau::ModuleName& name) override
@@ -177,6 +246,49 @@ struct CliFileResolver : Luau::FileResolver
     }
 };
 
+struct CliModuleCache : Luau::ModuleCache
+{
+    std::string directory;
+
+    CliModuleCache(const std::string& directory)
+        : directory(directory)
+    {
+    }
+
+    std::optional<std::string> readModuleInterface(const Luau::ModuleName& name) override
+    {
+        return readFile(getPath(name));
+    }
+
+    void writeModuleInterface(const Luau::ModuleName& name, const std::string& data) override
+    {
+        // a partially written file is rejected when it's read, so failures are only reported by the next run rechecking the module
+        writeFile(getPath(name), data);
+    }
+
+    std::string getPath(const Luau::ModuleName& name) const
+    {
+        // module names are escaped so that every module gets a distinct file directly in the cache directory
+        std::string fileName;
+
+        for (char ch : name)
+        {
+            if (isalnum((unsigned char)ch) || ch == '.' || ch == '-' || ch == '_')
+            {
+                fileName += ch;
+            }
+            else
+            {
+                char escape[4];
+                snprintf(escape, sizeof(escape), "%%%02X", (unsigned char)ch);
+                fileName += escape;
+            }
+        }
+
+        return joinPaths(directory, fileName + ".luaui");
+    }
+};
+
 struct CliConfigResolver : Luau::ConfigResolver
 {
     Luau::Config defaultConfig;
@@ -235,6 +347,8 @@ int main(int argc, char** argv)
     ReportFormat format = ReportFormat::Default;
     Luau::Mode mode = Luau::Mode::Nonstrict;
     bool annotate = false;
+    unsigned threadCount = std::thread::hardware_concurrency();
+    std::optional<std::string> cacheDirectory;
 
     for (int i = 1; i < argc; ++i)
     {
@@ -253,6 +367,10 @@ int main(int argc, char** argv)
             FFlag::DebugLuauTimeTracing.value = true;
         else if (strncmp(argv[i], "--fflags=", 9) == 0)
             setLuauFlags(argv[i] + 9);
+        else if (strncmp(argv[i], "-j", 2) == 0)
+            threadCount = unsigned(atoi(argv[i] + 2));
+        else if (strncmp(argv[i], "--cache=", 8) == 0)
+            cacheDirectory = argv[i] + 8;
     }
 
 #if !defined(LUAU_ENABLE_TIME_TRACE)
@@ -270,6 +388,20 @@ int main(int argc, char** argv)
     CliConfigResolver configResolver(mode);
     Luau::Frontend frontend(&fileResolver, &configResolver, frontendOptions);
 
+    std::optional<CliModuleCache> moduleCache;
+
+    if (cacheDirectory)
+    {
+        if (!createDirectory(*cacheDirectory))
+        {
+            fprintf(stderr, "Error creating cache directory %s\n", cacheDirectory->c_str());
+            return 1;
+        }
+
+        moduleCache.emplace(*cacheDirectory);
+        frontend.moduleCache = &*moduleCache;
+    }
+
     Luau::registerBuiltinTypes(frontend.typeChecker);
     Luau::freeze(frontend.typeChecker.globalTypes);
 
@@ -279,10 +411,25 @@ int main(int argc, char** argv)
 
     std::vector<std::string> files = getSourceFiles(argc, argv);
 
+    std::vector<Luau::CheckResult> checkResults;
+
+    if (threadCount > 1)
+    {
+        TaskScheduler scheduler(threadCount);
+
+        checkResults = frontend.checkModules(files, std::nullopt, [&](std::function<void()> task) {
+            scheduler.push(std::move(task));
+        });
+    }
+    else
+    {
+        checkResults = frontend.checkModules(files);
+    }
+
     int failed = 0;
 
-    for (const std::string& path : files)
-        failed += !analyzeFile(frontend, path.c_str(), format, annotate);
+    for (size_t i = 0; i < files.size(); ++i)
+        failed += !analyzeFile(frontend, files[i].c_str(), format, annotate, checkResults[i]);
 
     if (!configResolver.configErrors.empty())
     {
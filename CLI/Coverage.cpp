@@ -3,13 +3,21 @@
 
 #include "lua.h"
 
+#include <algorithm>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <stdio.h>
+#include <string.h>
+
 struct Coverage
 {
     lua_State* L = nullptr;
     std::vector<int> functions;
+
+    // line execution counts for each source file, loaded with coverageLoad
+    std::unordered_map<std::string, std::vector<int>> lineHits;
 } gCoverage;
 
 void coverageInit(lua_State* L)
@@ -86,3 +94,47 @@ void coverageDump(const char* path)
 
     printf("Coverage dump written to %s (%d functions)\n", path, int(gCoverage.functions.size()));
 }
+
+bool coverageLoad(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    if (!f)
+        return false;
+
+    std::vector<int>* hits = nullptr;
+    char line[1024];
+
+    while (fgets(line, sizeof(line), f))
+    {
+        int lineno = 0;
+        int count = 0;
+
+        if (strncmp(line, "SF:", 3) == 0)
+        {
+            std::string source = line + 3;
+
+            while (!source.empty() && (source.back() == '\n' || source.back() == '\r'))
+                source.pop_back();
+
+            hits = &gCoverage.lineHits[source];
+        }
+        else if (hits && sscanf(line, "DA:%d,%d", &lineno, &count) == 2 && lineno >= 0)
+        {
+            if (size_t(lineno) >= hits->size())
+                hits->resize(lineno + 1, -1);
+
+            // nested functions report the lines they share with their parents separately
+            (*hits)[lineno] = std::max((*hits)[lineno], count);
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+const std::vector<int>* coverageLineHits(const char* source)
+{
+    auto it = gCoverage.lineHits.find(source);
+
+    return it == gCoverage.lineHits.end() ? nullptr : &it->second;
+}
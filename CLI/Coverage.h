@@ -1,6 +1,8 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #pragma once
 
+#include <vector>
+
 struct lua_State;
 
 void coverageInit(lua_State* L);
@@ -8,3 +10,7 @@ bool coverageActive();
 
 void coverageTrack(lua_State* L, int funcindex);
 void coverageDump(const char* path);
+
+// Line execution counts from a coverage dump can be used as a profile for CompileOptions::lineHits
+bool coverageLoad(const char* path);
+const std::vector<int>* coverageLineHits(const char* source);
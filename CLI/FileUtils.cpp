@@ -18,6 +18,7 @@
 #include <sys/stat.h>
 #endif
 
+#include <stdio.h>
 #include <string.h>
 
 #ifdef _WIN32
@@ -79,6 +80,56 @@ std::optional<std::string> readFile(const std::string& name)
     return result;
 }
 
+static void removeFile(const std::string& name)
+{
+#ifdef _WIN32
+    DeleteFileW(fromUtf8(name).c_str());
+#else
+    unlink(name.c_str());
+#endif
+}
+
+bool writeFile(const std::string& name, const std::string& data)
+{
+#ifdef _WIN32
+    FILE* file = _wfopen(fromUtf8(name).c_str(), L"wb");
+#else
+    FILE* file = fopen(name.c_str(), "wb");
+#endif
+
+    if (!file)
+        return false;
+
+    size_t written = fwrite(data.data(), 1, data.size(), file);
+
+    // fclose flushes the buffered data, so its result is needed to tell if the whole file was written
+    bool closed = fclose(file) == 0;
+
+    return written == data.size() && closed;
+}
+
+bool writeFileAtomic(const std::string& name, const std::string& data)
+{
+    std::string temp = name + ".tmp";
+
+    if (!writeFile(temp, data))
+    {
+        removeFile(temp);
+        return false;
+    }
+
+#ifdef _WIN32
+    bool renamed = MoveFileExW(fromUtf8(temp).c_str(), fromUtf8(name).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool renamed = rename(temp.c_str(), name.c_str()) == 0;
+#endif
+
+    if (!renamed)
+        removeFile(temp);
+
+    return renamed;
+}
+
 std::optional<std::string> readStdin()
 {
     std::string result;
@@ -207,6 +258,21 @@ bool traverseDirectory(const std::string& path, const std::function<void(const s
 }
 #endif
 
+bool isFile(const std::string& path)
+{
+#ifdef _WIN32
+    DWORD fileAttributes = GetFileAttributesW(fromUtf8(path).c_str());
+    if (fileAttributes == INVALID_FILE_ATTRIBUTES)
+        return false;
+    return (fileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0;
+#else
+    struct stat st = {};
+    if (stat(path.c_str(), &st) != 0)
+        return false;
+    return (st.st_mode & S_IFMT) == S_IFREG;
+#endif
+}
+
 bool isDirectory(const std::string& path)
 {
 #ifdef _WIN32
@@ -221,6 +287,31 @@ bool isDirectory(const std::string& path)
 #endif
 }
 
+bool createDirectory(const std::string& path)
+{
+    if (isDirectory(path))
+        return true;
+
+#ifdef _WIN32
+    return CreateDirectoryW(fromUtf8(path).c_str(), nullptr) != 0;
+#else
+    return mkdir(path.c_str(), 0777) == 0;
+#endif
+}
+
+bool createDirectories(const std::string& path)
+{
+    if (isDirectory(path))
+        return true;
+
+    std::optional<std::string> parent = getParentPath(path);
+
+    if (parent && !parent->empty() && !createDirectories(*parent))
+        return false;
+
+    return createDirectory(path);
+}
+
 std::string joinPaths(const std::string& lhs, const std::string& rhs)
 {
     std::string result = lhs;
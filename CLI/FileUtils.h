@@ -8,8 +8,14 @@
 
 std::optional<std::string> readFile(const std::string& name);
 std::optional<std::string> readStdin();
+bool writeFile(const std::string& name, const std::string& data);
+// writes the data to a temporary file next to the target and renames it, so that readers never observe a partially written file
+bool writeFileAtomic(const std::string& name, const std::string& data);
 
+bool isFile(const std::string& path);
 bool isDirectory(const std::string& path);
+bool createDirectory(const std::string& path);
+bool createDirectories(const std::string& path);
 bool traverseDirectory(const std::string& path, const std::function<void(const std::string& name)>& callback);
 
 std::string joinPaths(const std::string& lhs, const std::string& rhs);
@@ -0,0 +1,59 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "OpStats.h"
+
+#include "lua.h"
+
+#include "Luau/BytecodeBuilder.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <inttypes.h>
+#include <stdio.h>
+
+using OpPair = std::pair<std::string, std::string>;
+
+static void opstatsCallback(void* context, int op, int nextop, uint64_t count)
+{
+    std::map<OpPair, uint64_t>& counts = *static_cast<std::map<OpPair, uint64_t>*>(context);
+
+    counts[{Luau::BytecodeBuilder::getOpcodeName(uint8_t(op)), Luau::BytecodeBuilder::getOpcodeName(uint8_t(nextop))}] += count;
+}
+
+bool opstatsDump(lua_State* L, const char* path)
+{
+    std::map<OpPair, uint64_t> counts;
+
+    // each line has the number of times the second opcode was executed right after the first one
+    if (FILE* f = fopen(path, "r"))
+    {
+        uint64_t count = 0;
+        char op[64], nextop[64];
+
+        while (fscanf(f, "%" SCNu64 " %63s %63s", &count, op, nextop) == 3)
+            counts[{op, nextop}] += count;
+
+        fclose(f);
+    }
+
+    lua_getopstats(L, &counts, opstatsCallback);
+
+    std::vector<std::pair<OpPair, uint64_t>> sorted(counts.begin(), counts.end());
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& l, const auto& r) {
+        return l.second > r.second;
+    });
+
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return false;
+
+    for (const auto& [pair, count] : sorted)
+        fprintf(f, "%" PRIu64 " %s %s\n", count, pair.first.c_str(), pair.second.c_str());
+
+    fclose(f);
+    return true;
+}
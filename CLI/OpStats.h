@@ -0,0 +1,7 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+struct lua_State;
+
+// Adds opcode pair counts recorded by the VM to the counts stored in the file, so that several runs can be combined
+bool opstatsDump(lua_State* L, const char* path);
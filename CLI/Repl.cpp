@@ -7,15 +7,22 @@
 #include "Luau/Compiler.h"
 #include "Luau/BytecodeBuilder.h"
 #include "Luau/Parser.h"
+#include "Luau/CodeGen.h"
 
 #include "Coverage.h"
 #include "FileUtils.h"
 #include "Flags.h"
+#include "OpStats.h"
 #include "Profiler.h"
 
 #include "isocline.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef _WIN32
 #include <io.h>
@@ -84,14 +91,24 @@ struct GlobalOptions
 {
     int optimizationLevel = 1;
     int debugLevel = 1;
+    int bytecodeVersion = 0;
+    bool codegen = false;
 } globalOptions;
 
-static Luau::CompileOptions copts()
+static Luau::CompileOptions copts(const char* name = nullptr)
 {
     Luau::CompileOptions result = {};
     result.optimizationLevel = globalOptions.optimizationLevel;
     result.debugLevel = globalOptions.debugLevel;
     result.coverageLevel = coverageActive() ? 2 : 0;
+    result.typeInfoLevel = globalOptions.codegen ? 1 : 0;
+    result.bytecodeVersion = globalOptions.bytecodeVersion;
+
+    if (const std::vector<int>* hits = name ? coverageLineHits(name) : nullptr)
+    {
+        result.lineHits = hits->data();
+        result.lineHitsCount = int(hits->size());
+    }
 
     return result;
 }
@@ -599,11 +616,14 @@ static bool runFile(const char* name, lua_State* GL, bool repl)
 
     std::string chunkname = "=" + std::string(name);
 
-    std::string bytecode = Luau::compile(*source, copts());
+    std::string bytecode = Luau::compile(*source, copts(name));
     int status = 0;
 
     if (luau_load(L, chunkname.c_str(), bytecode.data(), bytecode.size(), 0) == 0)
     {
+        if (globalOptions.codegen)
+            Luau::CodeGen::compile(L, -1);
+
         if (coverageActive())
             coverageTrack(L, -1);
 
@@ -672,11 +692,11 @@ static bool compileFile(const char* name, CompileFormat format)
         if (format == CompileFormat::Text)
         {
             bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code | Luau::BytecodeBuilder::Dump_Source | Luau::BytecodeBuilder::Dump_Locals |
-                             Luau::BytecodeBuilder::Dump_Remarks);
+                             Luau::BytecodeBuilder::Dump_Remarks | Luau::BytecodeBuilder::Dump_Types);
             bcb.setDumpSource(*source);
         }
 
-        Luau::compileOrThrow(bcb, *source, copts());
+        Luau::compileOrThrow(bcb, *source, copts(name));
 
         switch (format)
         {
@@ -705,6 +725,302 @@ static bool compileFile(const char* name, CompileFormat format)
     }
 }
 
+struct BatchInput
+{
+    std::string path;
+    // path of the bytecode file relative to the output directory
+    std::string output;
+};
+
+std::string getBatchOutputPath(const std::string& relative)
+{
+    size_t dot = relative.find_last_of(".\\/");
+
+    if (dot == std::string::npos || relative[dot] != '.')
+        return relative + ".luauc";
+
+    return relative.substr(0, dot) + ".luauc";
+}
+
+bool isMappableRelativePath(const std::string& path)
+{
+    if (path.empty() || path[0] == '/' || path[0] == '\\' || path.find(':') != std::string::npos)
+        return false;
+
+    for (size_t start = 0; start <= path.size();)
+    {
+        size_t end = path.find_first_of("\\/", start);
+        if (end == std::string::npos)
+            end = path.size();
+
+        if (path.compare(start, end - start, "..") == 0)
+            return false;
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+static bool addBatchInput(std::vector<BatchInput>& inputs, const std::string& path)
+{
+    if (isDirectory(path))
+    {
+        // files in directories are mapped to the same location relative to the output directory
+        traverseDirectory(path, [&](const std::string& name) {
+            size_t dot = name.find_last_of(".\\/");
+            std::string ext = dot == std::string::npos ? "" : name.substr(dot);
+
+            if (ext == ".lua" || ext == ".luau")
+            {
+                std::string relative = name.substr(path.size());
+                relative.erase(0, relative.find_first_not_of("\\/"));
+
+                inputs.push_back({name, getBatchOutputPath(relative)});
+            }
+        });
+
+        return true;
+    }
+
+    // files that are listed directly keep their path, so it has to stay inside of the output directory
+    if (!isMappableRelativePath(path))
+    {
+        fprintf(stderr, "Error: %s can't be placed in the output directory; pass a relative path or its directory instead\n", path.c_str());
+        return false;
+    }
+
+    std::string relative = path;
+    while (relative.compare(0, 2, "./") == 0 || relative.compare(0, 2, ".\\") == 0)
+        relative.erase(0, 2);
+
+    inputs.push_back({path, getBatchOutputPath(relative)});
+    return true;
+}
+
+// FNV-1a
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+
+    return hash;
+}
+
+static uint64_t getBatchHash(const std::string& source, const Luau::CompileOptions& options)
+{
+    // the hash covers everything that affects the bytecode except for the compiler itself, which is only accounted for by the bytecode version
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    int settings[] = {options.optimizationLevel, options.debugLevel, options.coverageLevel, options.typeInfoLevel, options.bytecodeVersion,
+        LBC_VERSION_MAX, int(source.size())};
+
+    hash = hashBytes(hash, settings, sizeof(settings));
+    hash = hashBytes(hash, source.data(), source.size());
+
+    if (options.lineHits)
+        hash = hashBytes(hash, options.lineHits, options.lineHitsCount * sizeof(int));
+
+    return hash;
+}
+
+static const char* const kBatchManifestName = "manifest.txt";
+
+static std::unordered_map<std::string, uint64_t> loadBatchManifest(const std::string& path)
+{
+    std::unordered_map<std::string, uint64_t> result;
+
+    std::optional<std::string> data = readFile(path);
+    if (!data)
+        return result;
+
+    // each line has the hash of the inputs followed by the path of the output
+    for (size_t start = 0; start < data->size();)
+    {
+        size_t end = data->find('\n', start);
+        if (end == std::string::npos)
+            end = data->size();
+
+        std::string line = data->substr(start, end - start);
+        size_t space = line.find(' ');
+
+        if (space != std::string::npos)
+            result[line.substr(space + 1)] = strtoull(line.c_str(), nullptr, 16);
+
+        start = end + 1;
+    }
+
+    return result;
+}
+
+static bool saveBatchManifest(const std::string& path, const std::unordered_map<std::string, uint64_t>& manifest)
+{
+    std::vector<std::pair<std::string, uint64_t>> entries(manifest.begin(), manifest.end());
+    std::sort(entries.begin(), entries.end());
+
+    std::string data;
+
+    for (const auto& [output, hash] : entries)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%016llx ", (unsigned long long)hash);
+
+        data += buf;
+        data += output;
+        data += '\n';
+    }
+
+    return writeFileAtomic(path, data);
+}
+
+static bool compileBatchFile(const BatchInput& input, const std::string& outputDirectory, uint64_t& hash, bool& skipped, uint64_t cachedHash)
+{
+    std::optional<std::string> source = readFile(input.path);
+    if (!source)
+    {
+        fprintf(stderr, "Error opening %s\n", input.path.c_str());
+        return false;
+    }
+
+    Luau::CompileOptions options = copts(input.path.c_str());
+    std::string outputPath = joinPaths(outputDirectory, input.output);
+
+    hash = getBatchHash(*source, options);
+    skipped = hash == cachedHash && isFile(outputPath);
+
+    if (skipped)
+        return true;
+
+    try
+    {
+        Luau::BytecodeBuilder bcb;
+        Luau::compileOrThrow(bcb, *source, options);
+
+        if (!writeFileAtomic(outputPath, bcb.getBytecode()))
+        {
+            fprintf(stderr, "Error writing %s\n", outputPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+    catch (Luau::ParseErrors& e)
+    {
+        for (auto& error : e.getErrors())
+            reportError(input.path.c_str(), error);
+        return false;
+    }
+    catch (Luau::CompileError& e)
+    {
+        reportError(input.path.c_str(), e);
+        return false;
+    }
+}
+
+// compiles every input into its own file in the output directory; inputs that didn't change since the last run, according to the manifest in the
+// output directory, are skipped
+int compileBatch(const std::vector<std::string>& paths, const std::string& outputDirectory, unsigned threadCount)
+{
+    std::vector<BatchInput> inputs;
+
+    for (const std::string& path : paths)
+        if (!addBatchInput(inputs, path))
+            return 1;
+
+    // .lua and .luau files with the same name map to the same output, and workers writing it concurrently would race
+    std::unordered_map<std::string, const BatchInput*> outputs;
+
+    for (const BatchInput& input : inputs)
+    {
+        auto [it, inserted] = outputs.try_emplace(input.output, &input);
+
+        if (!inserted)
+        {
+            fprintf(stderr, "Error: %s and %s both compile to %s\n", it->second->path.c_str(), input.path.c_str(), input.output.c_str());
+            return 1;
+        }
+    }
+
+    std::unordered_set<std::string> directories;
+
+    for (const BatchInput& input : inputs)
+    {
+        std::string outputPath = joinPaths(outputDirectory, input.output);
+        std::optional<std::string> parent = getParentPath(outputPath);
+
+        if (parent && directories.insert(*parent).second && !createDirectories(*parent))
+        {
+            fprintf(stderr, "Error creating directory %s\n", parent->c_str());
+            return 1;
+        }
+    }
+
+    std::string manifestPath = joinPaths(outputDirectory, kBatchManifestName);
+    std::unordered_map<std::string, uint64_t> manifest = loadBatchManifest(manifestPath);
+
+    std::vector<uint64_t> cachedHashes(inputs.size());
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        auto it = manifest.find(inputs[i].output);
+        if (it != manifest.end())
+            cachedHashes[i] = it->second;
+    }
+
+    std::vector<uint64_t> hashes(inputs.size());
+    std::vector<char> skipped(inputs.size());
+    std::vector<char> succeeded(inputs.size());
+
+    // each worker takes the next input until there are none left; errors are reported as they happen
+    std::atomic<size_t> next = 0;
+
+    auto worker = [&] {
+        for (size_t i = next++; i < inputs.size(); i = next++)
+        {
+            bool skip = false;
+            succeeded[i] = compileBatchFile(inputs[i], outputDirectory, hashes[i], skip, cachedHashes[i]);
+            skipped[i] = skip;
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (unsigned i = 1; i < std::min(threadCount, unsigned(inputs.size())); ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : workers)
+        thread.join();
+
+    int failed = 0;
+    int compiled = 0;
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        // failed inputs are removed from the manifest so that the next run retries them even if a stale output exists
+        if (succeeded[i])
+            manifest[inputs[i].output] = hashes[i];
+        else
+            manifest.erase(inputs[i].output);
+
+        failed += !succeeded[i];
+        compiled += succeeded[i] && !skipped[i];
+    }
+
+    if (!saveBatchManifest(manifestPath, manifest))
+    {
+        fprintf(stderr, "Error writing %s\n", manifestPath.c_str());
+        return 1;
+    }
+
+    printf("Compiled %d files, %d up to date, %d failed\n", compiled, int(inputs.size()) - compiled - failed, failed);
+
+    return failed ? 1 : 0;
+}
+
 static void displayHelp(const char* argv0)
 {
     printf("Usage: %s [--mode] [options] [file list]\n", argv0);
@@ -714,13 +1030,20 @@ static void displayHelp(const char* argv0)
     printf("Available modes:\n");
     printf("  omitted: compile and run input files one by one\n");
     printf("  --compile[=format]: compile input files and output resulting formatted bytecode (binary or text)\n");
+    printf("  --compile=binary --output=<dir>: compile input files and directories on all cores into dir, skipping files that didn't change\n");
     printf("\n");
     printf("Available options:\n");
+    printf("  --bytecode=<n>: compile to bytecode version n; version 5 fuses common instruction pairs, version 6 builds strings in loops in buffers\n");
+    printf("  --codegen: execute code using native code generation\n");
     printf("  --coverage: collect code coverage while running the code and output results to coverage.out\n");
+    printf("  --filelist=<file>: read additional input files from file, one per line\n");
+    printf("  --pgo=<file>: use line execution counts from a coverage file to guide inlining and loop unrolling at -O2\n");
     printf("  -h, --help: Display this usage message.\n");
     printf("  -i, --interactive: Run an interactive REPL after executing the last script specified.\n");
     printf("  -O<n>: compile with optimization level n (default 1, n should be between 0 and 2).\n");
     printf("  -g<n>: compile with debug level n (default 1, n should be between 0 and 2).\n");
+    printf("  -j<N>: use N worker threads when compiling into an output directory (defaults to the number of hardware threads)\n");
+    printf("  --opstats: add opcode pair counts to opstats.out (requires a VM built with LUAU_OPSTATS)\n");
     printf("  --profile[=N]: profile the code using N Hz sampling (default 10000) and output results to profile.out\n");
     printf("  --timetrace: record compiler time tracing information into trace.json\n");
 }
@@ -741,7 +1064,11 @@ int replMain(int argc, char** argv)
     CompileFormat compileFormat{};
     int profile = 0;
     bool coverage = false;
+    bool opstats = false;
     bool interactive = false;
+    std::optional<std::string> outputDirectory;
+    std::vector<std::string> fileLists;
+    unsigned threadCount = std::thread::hardware_concurrency();
 
     // Set the mode if the user has explicitly specified one.
     int argStart = 1;
@@ -803,6 +1130,28 @@ int replMain(int argc, char** argv)
             }
             globalOptions.debugLevel = level;
         }
+        else if (strncmp(argv[i], "--bytecode=", 11) == 0)
+        {
+            int version = atoi(argv[i] + 11);
+            if (version < LBC_VERSION_TARGET || version > LBC_VERSION_MAX)
+            {
+                fprintf(stderr, "Error: Bytecode version must be between %d and %d inclusive.\n", LBC_VERSION_TARGET, LBC_VERSION_MAX);
+                return 1;
+            }
+            globalOptions.bytecodeVersion = version;
+        }
+        else if (strncmp(argv[i], "-j", 2) == 0)
+        {
+            threadCount = unsigned(atoi(argv[i] + 2));
+        }
+        else if (strncmp(argv[i], "--output=", 9) == 0)
+        {
+            outputDirectory = argv[i] + 9;
+        }
+        else if (strncmp(argv[i], "--filelist=", 11) == 0)
+        {
+            fileLists.push_back(argv[i] + 11);
+        }
         else if (strcmp(argv[i], "--profile") == 0)
         {
             profile = 10000; // default to 10 KHz
@@ -815,6 +1164,22 @@ int replMain(int argc, char** argv)
         {
             coverage = true;
         }
+        else if (strcmp(argv[i], "--opstats") == 0)
+        {
+            opstats = true;
+        }
+        else if (strncmp(argv[i], "--pgo=", 6) == 0)
+        {
+            if (!coverageLoad(argv[i] + 6))
+            {
+                fprintf(stderr, "Error opening profile %s\n", argv[i] + 6);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--codegen") == 0)
+        {
+            globalOptions.codegen = true;
+        }
         else if (strcmp(argv[i], "--timetrace") == 0)
         {
             FFlag::DebugLuauTimeTracing.value = true;
@@ -839,7 +1204,54 @@ int replMain(int argc, char** argv)
     }
 #endif
 
-    const std::vector<std::string> files = getSourceFiles(argc, argv);
+    if (globalOptions.codegen && !Luau::CodeGen::isSupported())
+    {
+        fprintf(stderr, "Warning: Native code generation is not supported in current configuration\n");
+        globalOptions.codegen = false;
+    }
+
+    if (outputDirectory && (mode != CliMode::Compile || compileFormat != CompileFormat::Binary))
+    {
+        fprintf(stderr, "Error: --output requires --compile=binary\n");
+        return 1;
+    }
+
+    std::vector<std::string> files;
+
+    if (outputDirectory)
+    {
+        // batch compilation maps files to output paths relative to the directories they were found in, so directories are expanded later
+        for (int i = 1; i < argc; ++i)
+            if (argv[i][0] != '-')
+                files.push_back(argv[i]);
+    }
+    else
+    {
+        files = getSourceFiles(argc, argv);
+    }
+
+    for (const std::string& list : fileLists)
+    {
+        std::optional<std::string> data = readFile(list);
+        if (!data)
+        {
+            fprintf(stderr, "Error opening %s\n", list.c_str());
+            return 1;
+        }
+
+        for (size_t start = 0; start < data->size();)
+        {
+            size_t end = data->find_first_of("\r\n", start);
+            if (end == std::string::npos)
+                end = data->size();
+
+            if (end > start)
+                files.push_back(data->substr(start, end - start));
+
+            start = end + 1;
+        }
+    }
+
     if (mode == CliMode::Unknown)
     {
         mode = files.empty() ? CliMode::Repl : CliMode::RunSourceFiles;
@@ -849,6 +1261,17 @@ int replMain(int argc, char** argv)
     {
     case CliMode::Compile:
     {
+        if (outputDirectory)
+        {
+            if (!createDirectories(*outputDirectory))
+            {
+                fprintf(stderr, "Error creating directory %s\n", outputDirectory->c_str());
+                return 1;
+            }
+
+            return compileBatch(files, *outputDirectory, std::max(threadCount, 1u));
+        }
+
 #ifdef _WIN32
         if (compileFormat == CompileFormat::Binary)
             _setmode(_fileno(stdout), _O_BINARY);
@@ -873,6 +1296,9 @@ int replMain(int argc, char** argv)
 
         setupState(L);
 
+        if (globalOptions.codegen)
+            Luau::CodeGen::create(L);
+
         if (profile)
             profilerStart(L, profile);
 
@@ -896,6 +1322,9 @@ int replMain(int argc, char** argv)
         if (coverage)
             coverageDump("coverage.out");
 
+        if (opstats && !opstatsDump(L, "opstats.out"))
+            fprintf(stderr, "Error writing opstats.out\n");
+
         return failed ? 1 : 0;
     }
     case CliMode::Unknown:
@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 
 using AddCompletionCallback = std::function<void(const std::string& completion, const std::string& display)>;
 
@@ -14,4 +15,8 @@ void setupState(lua_State* L);
 std::string runCode(lua_State* L, const std::string& source);
 void getCompletions(lua_State* L, const std::string& editBuffer, const AddCompletionCallback& addCompletionCallback);
 
+std::string getBatchOutputPath(const std::string& relative);
+bool isMappableRelativePath(const std::string& path);
+int compileBatch(const std::vector<std::string>& paths, const std::string& outputDirectory, unsigned threadCount);
+
 int replMain(int argc, char** argv);
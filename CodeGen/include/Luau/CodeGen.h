@@ -0,0 +1,21 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+struct lua_State;
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Returns true if native code generation is supported on the current platform and CPU
+bool isSupported();
+
+// Creates native code generation state for the VM; has to be called once per global state before 'compile'
+void create(lua_State* L);
+
+// Builds target function and all inner functions
+void compile(lua_State* L, int idx);
+
+} // namespace CodeGen
+} // namespace Luau
@@ -0,0 +1,664 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/CodeGen.h"
+
+#include "Luau/AssemblyBuilderX64.h"
+#include "Luau/Common.h"
+#include "Luau/CodeAllocator.h"
+#include "Luau/CodeBlockUnwind.h"
+#include "Luau/UnwindBuilder.h"
+#include "Luau/UnwindBuilderDwarf2.h"
+#include "Luau/UnwindBuilderWin.h"
+
+#include "EmitCommonX64.h"
+#include "EmitInstructionX64.h"
+#include "Fallbacks.h"
+
+#include "Luau/Bytecode.h"
+
+#include "lapi.h"
+#include "lstate.h"
+#include "lvm.h"
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h> // __cpuid
+#else
+#include <cpuid.h> // __cpuid
+#endif
+#endif
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Native code is placed in blocks of this size; all blocks share the same unwind information which describes the gateway frame
+constexpr size_t kBlockSize = 1024 * 1024;
+constexpr size_t kMaxTotalSize = 1024 * 1024 * 1024;
+
+using GateFn = int (*)(lua_State*, uintptr_t);
+
+struct NativeState
+{
+    NativeState()
+        : codeAllocator(kBlockSize, kMaxTotalSize)
+    {
+    }
+
+    CodeAllocator codeAllocator;
+    std::unique_ptr<UnwindBuilder> unwindBuilder;
+
+    // Gateway sets up the native frame and jumps to the target instruction; native code returns to the interpreter by jumping to the gate exit
+    GateFn gateEntry = nullptr;
+    uint8_t* gateExit = nullptr;
+};
+
+// Native code of a single function, stored in Proto::execdata
+struct NativeProto
+{
+    // Absolute native code addresses for each instruction; aux words are never entered
+    std::vector<uintptr_t> targets;
+
+    // Parameters that native code assumes to have the annotated type; since type annotations aren't enforced, the tags are checked on every
+    // entry and the interpreter runs the function instead when they don't match
+    std::vector<std::pair<uint8_t, uint8_t>> paramTags;
+};
+
+// Returns false if the instruction has to be executed by the interpreter
+// When 'needsFallback' is set, the instruction can exit to the interpreter through the 'fallback' label
+static bool emitInstruction(AssemblyBuilderX64& build, Proto* proto, const RegisterTypes& types, LuauOpcode op, const Instruction* pc, int i,
+    Label* labelarr, Label& fallback, bool& needsFallback)
+{
+    switch (op)
+    {
+    case LOP_NOP:
+        break;
+    case LOP_LOADNIL:
+        emitInstLoadNil(build, pc);
+        break;
+    case LOP_LOADB:
+        emitInstLoadB(build, pc, i, labelarr);
+        break;
+    case LOP_LOADN:
+        emitInstLoadN(build, pc);
+        break;
+    case LOP_LOADK:
+        emitInstLoadK(build, pc);
+        break;
+    case LOP_LOADKX:
+        emitInstLoadKX(build, pc);
+        break;
+    case LOP_MOVE:
+    case LOP_MOVE_MOVE:
+    case LOP_MOVE_CALL:
+        emitInstMove(build, pc);
+        break;
+    case LOP_GETGLOBAL:
+        emitCallFallback(build, (const void*)executeGETGLOBAL, pc);
+        break;
+    case LOP_SETGLOBAL:
+        emitCallFallback(build, (const void*)executeSETGLOBAL, pc);
+        break;
+    case LOP_GETUPVAL:
+    case LOP_GETUPVAL_CALL:
+        emitInstGetUpval(build, pc);
+        break;
+    case LOP_SETUPVAL:
+        emitCallFallback(build, (const void*)executeSETUPVAL, pc);
+        break;
+    case LOP_CLOSEUPVALS:
+        emitCallFallback(build, (const void*)executeCLOSEUPVALS, pc);
+        break;
+    case LOP_GETIMPORT:
+        emitInstGetImport(build, pc, i, labelarr);
+        break;
+    case LOP_GETTABLE:
+    case LOP_GETTABLE_GETTABLE:
+    case LOP_GETTABLE_ADD:
+        emitInstGetTable(build, pc, i, labelarr, types);
+        break;
+    case LOP_SETTABLE:
+        emitInstSetTable(build, pc, i, labelarr, types);
+        break;
+    case LOP_GETTABLEKS:
+        emitCallFallback(build, (const void*)executeGETTABLEKS, pc);
+        break;
+    case LOP_SETTABLEKS:
+        emitCallFallback(build, (const void*)executeSETTABLEKS, pc);
+        break;
+    case LOP_GETTABLEN:
+        emitInstGetTableN(build, pc, i, labelarr, types);
+        break;
+    case LOP_SETTABLEN:
+        emitInstSetTableN(build, pc, i, labelarr, types);
+        break;
+    case LOP_JUMP:
+        emitInstJump(build, pc, i, labelarr);
+        break;
+    case LOP_JUMPBACK:
+        emitInstJumpBack(build, pc, i, labelarr, fallback);
+        needsFallback = true;
+        break;
+    case LOP_JUMPX:
+        emitInstJumpX(build, pc, i, labelarr, fallback);
+        needsFallback = true;
+        break;
+    case LOP_JUMPIF:
+        emitInstJumpIf(build, pc, i, labelarr, /* not_ */ false);
+        break;
+    case LOP_JUMPIFNOT:
+        emitInstJumpIf(build, pc, i, labelarr, /* not_ */ true);
+        break;
+    case LOP_JUMPIFEQ:
+        emitInstJumpIfEq(build, pc, i, labelarr, /* not_ */ false);
+        break;
+    case LOP_JUMPIFNOTEQ:
+        emitInstJumpIfEq(build, pc, i, labelarr, /* not_ */ true);
+        break;
+    case LOP_JUMPIFLE:
+    case LOP_JUMPIFLT:
+    case LOP_JUMPIFNOTLE:
+    case LOP_JUMPIFNOTLT:
+        emitInstJumpIfCond(build, pc, i, labelarr, types);
+        break;
+    case LOP_JUMPXEQKNIL:
+        emitInstJumpXEqNil(build, pc, i, labelarr);
+        break;
+    case LOP_JUMPXEQKB:
+        emitInstJumpXEqB(build, pc, i, labelarr);
+        break;
+    case LOP_JUMPXEQKN:
+        emitInstJumpXEqN(build, pc, i, labelarr);
+        break;
+    case LOP_JUMPXEQKS:
+        emitInstJumpXEqS(build, pc, i, labelarr);
+        break;
+    case LOP_ADD:
+    case LOP_SUB:
+    case LOP_MUL:
+    case LOP_DIV:
+    case LOP_MOD:
+    case LOP_MUL_ADD:
+        emitInstBinary(build, pc, i, labelarr, types);
+        break;
+    case LOP_ADDK:
+    case LOP_SUBK:
+    case LOP_MULK:
+    case LOP_DIVK:
+    case LOP_MODK:
+    case LOP_ADDK_GETTABLE:
+        emitInstBinaryK(build, pc, i, labelarr, types);
+        break;
+    case LOP_POW:
+        emitInstPow(build, pc, i, labelarr);
+        break;
+    case LOP_POWK:
+        emitInstPowK(build, pc, proto->k, i, labelarr);
+        break;
+    case LOP_NOT:
+        emitInstNot(build, pc);
+        break;
+    case LOP_MINUS:
+        emitInstMinus(build, pc, i, labelarr);
+        break;
+    case LOP_AND:
+        emitInstAnd(build, pc);
+        break;
+    case LOP_ANDK:
+        emitInstAndK(build, pc);
+        break;
+    case LOP_OR:
+        emitInstOr(build, pc);
+        break;
+    case LOP_ORK:
+        emitInstOrK(build, pc);
+        break;
+    case LOP_CONCAT:
+        emitCallFallback(build, (const void*)executeCONCAT, pc);
+        break;
+    case LOP_CONCATACC:
+        emitCallFallback(build, (const void*)executeCONCATACC, pc);
+        break;
+    case LOP_FLUSHACC:
+        emitCallFallback(build, (const void*)executeFLUSHACC, pc);
+        break;
+    case LOP_LENGTH:
+        emitCallFallback(build, (const void*)executeLENGTH, pc);
+        break;
+    case LOP_NEWTABLE:
+        emitCallFallback(build, (const void*)executeNEWTABLE, pc);
+        break;
+    case LOP_DUPTABLE:
+        emitCallFallback(build, (const void*)executeDUPTABLE, pc);
+        break;
+    case LOP_FORNPREP:
+        emitInstForNPrep(build, pc, i, labelarr, fallback);
+        needsFallback = true;
+        break;
+    case LOP_FORNLOOP:
+        emitInstForNLoop(build, pc, i, labelarr, fallback);
+        needsFallback = true;
+        break;
+    case LOP_FASTCALL:
+        emitInstFastCall(build, pc, i, labelarr, (const void*)executeFASTCALL);
+        break;
+    case LOP_FASTCALL1:
+        emitInstFastCall(build, pc, i, labelarr, (const void*)executeFASTCALL1);
+        break;
+    case LOP_FASTCALL2:
+        emitInstFastCall(build, pc, i, labelarr, (const void*)executeFASTCALL2);
+        break;
+    case LOP_FASTCALL2K:
+        emitInstFastCall(build, pc, i, labelarr, (const void*)executeFASTCALL2K);
+        break;
+    default:
+        // calls, returns, closures, generic loops, varargs and debugger instructions are handled by the interpreter
+        return false;
+    }
+
+    return true;
+}
+
+static void emitExit(AssemblyBuilderX64& build, int pcpos, Label& exit)
+{
+    build.mov(eax, pcpos);
+    build.jmp(exit);
+}
+
+// Finds registers that instructions with native fast paths expect to hold numbers or tables
+static void gatherCheckedRegisters(Proto* proto, RegisterTypes& checked)
+{
+    for (int i = 0; i < proto->sizecode; i += getOpLength(LuauOpcode(LUAU_INSN_OP(proto->code[i]))))
+    {
+        const Instruction* pc = &proto->code[i];
+
+        switch (LUAU_INSN_OP(*pc))
+        {
+        case LOP_ADD:
+        case LOP_SUB:
+        case LOP_MUL:
+        case LOP_DIV:
+        case LOP_MOD:
+        case LOP_MUL_ADD:
+            checked.numbers.set(LUAU_INSN_B(*pc));
+            checked.numbers.set(LUAU_INSN_C(*pc));
+            break;
+        case LOP_ADDK:
+        case LOP_SUBK:
+        case LOP_MULK:
+        case LOP_DIVK:
+        case LOP_MODK:
+        case LOP_ADDK_GETTABLE:
+            checked.numbers.set(LUAU_INSN_B(*pc));
+            break;
+        case LOP_JUMPIFLE:
+        case LOP_JUMPIFLT:
+        case LOP_JUMPIFNOTLE:
+        case LOP_JUMPIFNOTLT:
+            checked.numbers.set(LUAU_INSN_A(*pc));
+            checked.numbers.set(pc[1] & 0xff);
+            break;
+        case LOP_GETTABLE:
+        case LOP_SETTABLE:
+        case LOP_GETTABLE_GETTABLE:
+        case LOP_GETTABLE_ADD:
+            checked.tables.set(LUAU_INSN_B(*pc));
+            checked.numbers.set(LUAU_INSN_C(*pc));
+            break;
+        case LOP_GETTABLEN:
+        case LOP_SETTABLEN:
+            checked.tables.set(LUAU_INSN_B(*pc));
+            break;
+        }
+    }
+}
+
+// Parameter types come from annotations in version 4 bytecode; the compiler only emits them for parameters that are never reassigned,
+// so a type that holds when native code is entered holds until native code exits
+static void getParamTypes(Proto* proto, RegisterTypes& types, std::vector<std::pair<uint8_t, uint8_t>>& paramTags)
+{
+    if (proto->sizetypeinfo < 2 || proto->typeinfo[0] != LBC_TYPE_FUNCTION)
+        return;
+
+    int count = proto->typeinfo[1];
+    LUAU_ASSERT(count == proto->numparams && proto->sizetypeinfo == 2 + count);
+
+    RegisterTypes checked;
+    gatherCheckedRegisters(proto, checked);
+
+    for (int i = 0; i < count; ++i)
+    {
+        uint8_t type = proto->typeinfo[2 + i];
+
+        if (type == LBC_TYPE_NUMBER && checked.numbers.test(i))
+        {
+            types.numbers.set(i);
+            paramTags.push_back({uint8_t(i), uint8_t(LUA_TNUMBER)});
+        }
+        else if (type == LBC_TYPE_TABLE && checked.tables.test(i))
+        {
+            types.tables.set(i);
+            paramTags.push_back({uint8_t(i), uint8_t(LUA_TTABLE)});
+        }
+    }
+}
+
+static void emitFunction(AssemblyBuilderX64& build, Proto* proto, const RegisterTypes& types, Label& exit, std::vector<Label>& instLabels)
+{
+    instLabels.resize(proto->sizecode);
+
+    std::vector<Label> fallbacks(proto->sizecode);
+    std::vector<bool> fallbackUsed(proto->sizecode);
+
+    Label* labelarr = instLabels.data();
+
+    for (int i = 0; i < proto->sizecode;)
+    {
+        const Instruction* pc = &proto->code[i];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(*pc));
+
+        build.setLabel(labelarr[i]);
+
+        bool needsFallback = false;
+
+        if (!emitInstruction(build, proto, types, op, pc, i, labelarr, fallbacks[i], needsFallback))
+            emitExit(build, i, exit);
+
+        fallbackUsed[i] = needsFallback;
+
+        int nexti = i + getOpLength(op);
+        LUAU_ASSERT(nexti <= proto->sizecode);
+
+        // aux words can't be jump targets, but they still need a location
+        for (int j = i + 1; j < nexti; ++j)
+            build.setLabel(labelarr[j]);
+
+        i = nexti;
+    }
+
+    // exits to the interpreter are placed out of line
+    for (int i = 0; i < proto->sizecode; ++i)
+    {
+        if (fallbackUsed[i])
+        {
+            build.setLabel(fallbacks[i]);
+            emitExit(build, i, exit);
+        }
+    }
+}
+
+static void gatherFunctions(std::vector<Proto*>& results, std::unordered_set<Proto*>& visited, Proto* proto)
+{
+    // Protos can be shared between several parents, so each one is only compiled once
+    if (!visited.insert(proto).second)
+        return;
+
+    // Skip protos that have been compiled before
+    if (!proto->execdata)
+        results.push_back(proto);
+
+    for (int i = 0; i < proto->sizep; i++)
+        gatherFunctions(results, visited, proto->p[i]);
+}
+
+static void onCloseState(lua_State* L)
+{
+    delete (NativeState*)L->global->ecb.context;
+    L->global->ecb = lua_ExecutionCallbacks();
+}
+
+static void onDestroyFunction(lua_State* L, Proto* proto)
+{
+    // native code itself is owned by the code allocator and is released together with the state
+    delete (NativeProto*)proto->execdata;
+    proto->execdata = nullptr;
+}
+
+static int onEnter(lua_State* L, Proto* proto)
+{
+    // breakpoints are implemented by patching the bytecode which native code doesn't observe
+    if (proto->debuginsn)
+        return 0;
+
+    NativeState* data = (NativeState*)L->global->ecb.context;
+
+    NativeProto* nativeProto = (NativeProto*)proto->execdata;
+    int pcpos = int(L->ci->savedpc - proto->code);
+    LUAU_ASSERT(unsigned(pcpos) < unsigned(proto->sizecode));
+
+    uintptr_t target = nativeProto->targets[pcpos];
+
+    if (!target)
+        return 0;
+
+    for (const auto& [reg, tag] : nativeProto->paramTags)
+        if (L->base[reg].tt != tag)
+            return 0;
+
+    int exitpos = data->gateEntry(L, target);
+    LUAU_ASSERT(unsigned(exitpos) < unsigned(proto->sizecode));
+
+    L->ci->savedpc = proto->code + exitpos;
+    return 1;
+}
+
+static bool getCpuFeaturesX64(bool& avx)
+{
+#if defined(_M_X64) || defined(__x86_64__)
+    int cpuinfo[4] = {};
+#ifdef _MSC_VER
+    __cpuid(cpuinfo, 1);
+#else
+    __cpuid(1, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+#endif
+
+    // AVX requires both CPU support and OS support for saving the extended register state
+    avx = (cpuinfo[2] & (1 << 28)) != 0 && (cpuinfo[2] & (1 << 27)) != 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool isSupported()
+{
+    if (!LUA_CUSTOM_EXECUTION)
+        return false;
+
+    if (sizeof(TValue) != 16)
+        return false;
+
+    bool avx = false;
+    if (!getCpuFeaturesX64(avx))
+        return false;
+
+    // All instructions used for arithmetic use the VEX encoding
+    return avx;
+}
+
+static void createGateway(NativeState& data)
+{
+    AssemblyBuilderX64 build(/* logText= */ false);
+    UnwindBuilder& unwind = *data.unwindBuilder.get();
+
+    unwind.start();
+
+    // Save the non-volatile registers that native code uses; on Windows, rdi and rsi are non-volatile as well
+#if defined(_WIN32)
+    build.push(rdi);
+    unwind.save(rdi);
+    build.push(rsi);
+    unwind.save(rsi);
+#endif
+    build.push(rbx);
+    unwind.save(rbx);
+    build.push(rbp);
+    unwind.save(rbp);
+    build.push(r12);
+    unwind.save(r12);
+    build.push(r13);
+    unwind.save(r13);
+    build.push(r14);
+    unwind.save(r14);
+    build.push(r15);
+    unwind.save(r15);
+
+    // Align the stack to 16 bytes; on Windows, we also reserve the shadow space for calls and the stack slot for the 5th argument
+#if defined(_WIN32)
+    int stackSize = 40;
+#else
+    int stackSize = 8;
+#endif
+
+    build.sub(rsp, stackSize);
+    unwind.allocStack(stackSize);
+
+    unwind.finish();
+
+    // Setup the native frame registers from the current call frame and jump to the target instruction
+    build.mov(rState, rArg1);
+    build.mov(rBase, qword[rState + offsetof(lua_State, base)]);
+    build.mov(rax, qword[rState + offsetof(lua_State, ci)]);
+    build.mov(rax, qword[rax + offsetof(CallInfo, func)]);
+    build.mov(rClosure, qword[rax + offsetof(TValue, value)]);
+    build.mov(rax, qword[rClosure + offsetof(Closure, l.p)]);
+    build.mov(rConstants, qword[rax + offsetof(Proto, k)]);
+    build.jmp(rArg2);
+
+    // Native code jumps here with the position of the next instruction for the interpreter in eax
+    Label exit;
+    build.setLabel(exit);
+
+    build.add(rsp, stackSize);
+    build.pop(r15);
+    build.pop(r14);
+    build.pop(r13);
+    build.pop(r12);
+    build.pop(rbp);
+    build.pop(rbx);
+#if defined(_WIN32)
+    build.pop(rsi);
+    build.pop(rdi);
+#endif
+    build.ret();
+
+    build.finalize();
+
+    uint8_t* codeStart = nullptr;
+    uint8_t* nativeData = nullptr;
+    size_t sizeNativeData = 0;
+
+    if (!data.codeAllocator.allocate(build.data.data(), build.data.size(), build.code.data(), build.code.size(), nativeData, sizeNativeData, codeStart))
+    {
+        LUAU_ASSERT(!"failed to create entry gateway");
+        return;
+    }
+
+    data.gateEntry = GateFn(codeStart);
+    data.gateExit = codeStart + exit.location;
+}
+
+void create(lua_State* L)
+{
+    LUAU_ASSERT(isSupported());
+
+    global_State* g = L->global;
+    LUAU_ASSERT(!g->ecb.context);
+
+    NativeState* data = new NativeState();
+
+#if defined(_WIN32)
+    data->unwindBuilder = std::make_unique<UnwindBuilderWin>();
+#else
+    data->unwindBuilder = std::make_unique<UnwindBuilderDwarf2>();
+#endif
+
+    data->codeAllocator.context = data->unwindBuilder.get();
+    data->codeAllocator.createBlockUnwindInfo = createBlockUnwindInfo;
+    data->codeAllocator.destroyBlockUnwindInfo = destroyBlockUnwindInfo;
+
+    createGateway(*data);
+
+    if (!data->gateEntry)
+    {
+        delete data;
+        return;
+    }
+
+    lua_ExecutionCallbacks* ecb = &g->ecb;
+
+    ecb->context = data;
+    ecb->close = onCloseState;
+    ecb->destroy = onDestroyFunction;
+    ecb->enter = onEnter;
+}
+
+void compile(lua_State* L, int idx)
+{
+    LUAU_ASSERT(lua_isLfunction(L, idx));
+    const TValue* func = luaA_toobject(L, idx);
+
+    // If initialization has failed, do not compile any functions
+    NativeState* data = (NativeState*)L->global->ecb.context;
+    if (!data)
+        return;
+
+    // native code is generated for the whole module, so functions loaded with luau_loadlazy are decoded first
+    luaV_materialize(L, clvalue(func)->l.p, clvalue(func)->env, /* recursive= */ true);
+    func = luaA_toobject(L, idx);
+
+    std::vector<Proto*> protos;
+    std::unordered_set<Proto*> visited;
+    gatherFunctions(protos, visited, clvalue(func)->l.p);
+
+    AssemblyBuilderX64 build(/* logText= */ false);
+
+    // All functions in the module share a single exit sequence that returns to the gateway
+    Label exit;
+    build.setLabel(exit);
+    build.mov64(rcx, int64_t(uintptr_t(data->gateExit)));
+    build.jmp(rcx);
+
+    std::vector<std::vector<Label>> labels(protos.size());
+    std::vector<std::unique_ptr<NativeProto>> nativeProtos(protos.size());
+
+    for (size_t i = 0; i < protos.size(); ++i)
+    {
+        nativeProtos[i] = std::make_unique<NativeProto>();
+
+        RegisterTypes types;
+        getParamTypes(protos[i], types, nativeProtos[i]->paramTags);
+
+        emitFunction(build, protos[i], types, exit, labels[i]);
+    }
+
+    build.finalize();
+
+    uint8_t* codeStart = nullptr;
+    uint8_t* nativeData = nullptr;
+    size_t sizeNativeData = 0;
+
+    // All functions are placed in a single allocation since the code allocator has page granularity
+    if (!data->codeAllocator.allocate(build.data.data(), build.data.size(), build.code.data(), build.code.size(), nativeData, sizeNativeData, codeStart))
+        return;
+
+    for (size_t i = 0; i < protos.size(); ++i)
+    {
+        Proto* p = protos[i];
+        NativeProto* nativeProto = nativeProtos[i].release();
+
+        nativeProto->targets.resize(p->sizecode);
+
+        for (int j = 0; j < p->sizecode; ++j)
+            nativeProto->targets[j] = uintptr_t(codeStart + labels[i][j].location);
+
+        p->execdata = nativeProto;
+    }
+}
+
+} // namespace CodeGen
+} // namespace Luau
@@ -0,0 +1,37 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "EmitCommonX64.h"
+
+#include "lstate.h"
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+void emitSetSavedPc(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    build.mov64(rax, int64_t(uintptr_t(pc)));
+    build.mov(rcx, qword[rState + offsetof(lua_State, ci)]);
+    build.mov(qword[rcx + offsetof(CallInfo, savedpc)], rax);
+}
+
+void emitCall(AssemblyBuilderX64& build, const void* func)
+{
+    build.mov64(rax, int64_t(uintptr_t(func)));
+    build.call(rax);
+
+    // the call could have reallocated the stack
+    build.mov(rBase, qword[rState + offsetof(lua_State, base)]);
+}
+
+void emitCallFallback(AssemblyBuilderX64& build, const void* func, const Instruction* pc)
+{
+    build.mov(rArg1, rState);
+    build.mov64(rArg2, int64_t(uintptr_t(pc)));
+    build.mov(rArg3, rBase);
+    build.mov(rArg4, rConstants);
+    emitCall(build, func);
+}
+
+} // namespace CodeGen
+} // namespace Luau
@@ -0,0 +1,101 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/AssemblyBuilderX64.h"
+
+#include "lobject.h"
+
+#include <stddef.h>
+
+// MS x64 ABI reminder:
+// Arguments: rcx, rdx, r8, r9 ('overlapped' with xmm0-xmm3)
+// Return: rax, xmm0
+// Nonvolatile: r12-r15, rdi, rsi, rbx, rbp
+// SIMD: only xmm6-xmm15 are non-volatile, all ymm upper parts are volatile
+
+// AMD64 ABI reminder:
+// Arguments: rdi, rsi, rdx, rcx, r8, r9 (xmm0-xmm7)
+// Return: rax, rdx, xmm0, xmm1
+// Nonvolatile: r12-r15, rbx, rbp
+// SIMD: all volatile
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Native code for a function only ever runs inside of the frame set up by the entry gateway, see CodeGen.cpp
+// Registers below are set up by the gateway; rBase has to be reloaded after each call that can reallocate the stack
+constexpr RegisterX64 rState = r15;     // lua_State* L
+constexpr RegisterX64 rBase = r14;      // StkId base
+constexpr RegisterX64 rConstants = r13; // TValue* k
+constexpr RegisterX64 rClosure = r12;   // Closure* cl
+
+constexpr unsigned kTValueSizeLog2 = 4;
+static_assert(sizeof(TValue) == (1 << kTValueSizeLog2), "TValue size has to be a power of two for array indexing");
+
+// Table::numarray is a bitfield that takes the low bit of the byte it shares with lsizenode, which directly precedes nodemask8
+constexpr unsigned kTableNumArrayOffset = offsetof(Table, nodemask8) - 1;
+constexpr uint8_t kTableNumArrayMask = 1;
+
+#if defined(_WIN32)
+constexpr RegisterX64 rArg1 = rcx;
+constexpr RegisterX64 rArg2 = rdx;
+constexpr RegisterX64 rArg3 = r8;
+constexpr RegisterX64 rArg4 = r9;
+constexpr OperandX64 sArg5 = qword[rsp + 32]; // passed on the stack after the 32 byte shadow space
+#else
+constexpr RegisterX64 rArg1 = rdi;
+constexpr RegisterX64 rArg2 = rsi;
+constexpr RegisterX64 rArg3 = rdx;
+constexpr RegisterX64 rArg4 = rcx;
+constexpr RegisterX64 rArg5 = r8;
+#endif
+
+inline OperandX64 luauReg(int ri)
+{
+    return xmmword[rBase + ri * int(sizeof(TValue))];
+}
+
+inline OperandX64 luauRegValue(int ri)
+{
+    return qword[rBase + ri * int(sizeof(TValue)) + int(offsetof(TValue, value))];
+}
+
+inline OperandX64 luauRegValueBoolean(int ri)
+{
+    return dword[rBase + ri * int(sizeof(TValue)) + int(offsetof(TValue, value))];
+}
+
+inline OperandX64 luauRegTag(int ri)
+{
+    return dword[rBase + ri * int(sizeof(TValue)) + int(offsetof(TValue, tt))];
+}
+
+inline OperandX64 luauConstant(int ki)
+{
+    return xmmword[rConstants + ki * int(sizeof(TValue))];
+}
+
+inline OperandX64 luauConstantValue(int ki)
+{
+    return qword[rConstants + ki * int(sizeof(TValue)) + int(offsetof(TValue, value))];
+}
+
+inline OperandX64 luauConstantTag(int ki)
+{
+    return dword[rConstants + ki * int(sizeof(TValue)) + int(offsetof(TValue, tt))];
+}
+
+// Saves the instruction pointer for error reporting and stack traces; has to be done before calls that can throw or call into Lua
+void emitSetSavedPc(AssemblyBuilderX64& build, const Instruction* pc);
+
+// Calls a C function; all volatile registers are clobbered and the stack base is reloaded after the call
+void emitCall(AssemblyBuilderX64& build, const void* func);
+
+// Calls a fallback implementation of an instruction with signature 'const Instruction* (lua_State*, const Instruction*, StkId, TValue*)'
+// Fallbacks save the instruction pointer themselves; the returned pointer to the next instruction is placed in rax
+void emitCallFallback(AssemblyBuilderX64& build, const void* func, const Instruction* pc);
+
+} // namespace CodeGen
+} // namespace Luau
@@ -0,0 +1,872 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "EmitInstructionX64.h"
+
+#include "Luau/AssemblyBuilderX64.h"
+
+#include "EmitCommonX64.h"
+#include "Fallbacks.h"
+
+#include "Luau/Bytecode.h"
+
+#include "lgc.h"
+#include "lstate.h"
+#include "lvm.h"
+
+#include <math.h>
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Jumps to 'target' if values are equal as numbers
+// ucomisd reports unordered comparisons (NaN) as 'equal' with CF set, so both flags have to be checked
+static void jumpIfNumberEqual(AssemblyBuilderX64& build, OperandX64 lhs, OperandX64 rhs, Label& target)
+{
+    Label skip;
+
+    build.vmovsd(xmm0, lhs);
+    build.vucomisd(xmm0, rhs);
+    build.jcc(Condition::NotEqual, skip);
+    build.jcc(Condition::Below, skip);
+    build.jmp(target);
+    build.setLabel(skip);
+}
+
+static void jumpIfNumberNotEqual(AssemblyBuilderX64& build, OperandX64 lhs, OperandX64 rhs, Label& target)
+{
+    build.vmovsd(xmm0, lhs);
+    build.vucomisd(xmm0, rhs);
+    build.jcc(Condition::NotEqual, target);
+    build.jcc(Condition::Below, target);
+}
+
+// Jumps to 'target' if the value is truthy (not nil and not false)
+static void jumpIfTruthy(AssemblyBuilderX64& build, int ri, Label& target, Label& fallthrough)
+{
+    build.cmp(luauRegTag(ri), LUA_TNIL);
+    build.jcc(Condition::Equal, fallthrough);
+    build.cmp(luauRegTag(ri), LUA_TBOOLEAN);
+    build.jcc(Condition::NotEqual, target);
+    build.cmp(luauRegValueBoolean(ri), 0);
+    build.jcc(Condition::NotEqual, target);
+}
+
+// Jumps to 'target' if the value is falsy (nil or false)
+static void jumpIfFalsy(AssemblyBuilderX64& build, int ri, Label& target, Label& fallthrough)
+{
+    build.cmp(luauRegTag(ri), LUA_TNIL);
+    build.jcc(Condition::Equal, target);
+    build.cmp(luauRegTag(ri), LUA_TBOOLEAN);
+    build.jcc(Condition::NotEqual, fallthrough);
+    build.cmp(luauRegValueBoolean(ri), 0);
+    build.jcc(Condition::Equal, target);
+}
+
+static void jumpIfTagIsNot(AssemblyBuilderX64& build, int ri, lua_Type tag, Label& target)
+{
+    build.cmp(luauRegTag(ri), tag);
+    build.jcc(Condition::NotEqual, target);
+}
+
+// Returns false if the register is known to hold a number and no check was emitted
+static bool jumpIfNotNumber(AssemblyBuilderX64& build, const RegisterTypes& types, int ri, Label& target)
+{
+    if (types.numbers.test(ri))
+        return false;
+
+    jumpIfTagIsNot(build, ri, LUA_TNUMBER, target);
+    return true;
+}
+
+// Exits to the interpreter if the interrupt handler is set; the interpreter will call it when it executes the instruction
+static void checkInterrupt(AssemblyBuilderX64& build, Label& fallback)
+{
+    build.mov(rax, qword[rState + offsetof(lua_State, global)]);
+    build.cmp(qword[rax + offsetof(global_State, cb.interrupt)], 0);
+    build.jcc(Condition::NotEqual, fallback);
+}
+
+// Loads table pointer into 'table' and checks that the value at zero-based 'index' in the array part can be accessed without metamethods
+static void checkArrayAccess(AssemblyBuilderX64& build, RegisterX64 table, RegisterX64 index, int rb, Label& fallback, const RegisterTypes& types)
+{
+    if (!types.tables.test(rb))
+        jumpIfTagIsNot(build, rb, LUA_TTABLE, fallback);
+
+    build.mov(table, luauRegValue(rb));
+    build.cmp(dword[table + offsetof(Table, sizearray)], index);
+    build.jcc(Condition::BelowEqual, fallback);
+    build.cmp(qword[table + offsetof(Table, metatable)], 0);
+    build.jcc(Condition::NotEqual, fallback);
+
+    // packed number arrays store doubles instead of TValues and are handled by the fallback
+    build.test(byte[table + kTableNumArrayOffset], kTableNumArrayMask);
+    build.jcc(Condition::NotZero, fallback);
+}
+
+// Checks that a value can be stored in the table without a write barrier or a readonly violation
+static void checkArrayStore(AssemblyBuilderX64& build, RegisterX64 table, int ra, Label& fallback)
+{
+    Label skip;
+
+    build.cmp(byte[table + offsetof(Table, readonly)], 0);
+    build.jcc(Condition::NotEqual, fallback);
+
+    // storing a collectable value into a black table requires a barrier which is handled by the slow path
+    build.cmp(luauRegTag(ra), LUA_TSTRING);
+    build.jcc(Condition::Less, skip);
+    build.test(byte[table + offsetof(Table, marked)], bitmask(BLACKBIT));
+    build.jcc(Condition::NotZero, fallback);
+    build.setLabel(skip);
+}
+
+static void emitArithSlow(AssemblyBuilderX64& build, const Instruction* pc, int ra, OperandX64 rb, OperandX64 rc, TMS tm)
+{
+    emitSetSavedPc(build, pc + 1);
+
+    build.mov(rArg1, rState);
+    build.lea(rArg2, luauReg(ra));
+    build.lea(rArg3, rb);
+    build.lea(rArg4, rc);
+#if defined(_WIN32)
+    build.mov(sArg5, tm);
+#else
+    build.mov(rArg5, tm);
+#endif
+    emitCall(build, (const void*)luaV_doarith);
+}
+
+void emitInstLoadNil(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    int ra = LUAU_INSN_A(*pc);
+
+    build.mov(luauRegTag(ra), LUA_TNIL);
+}
+
+void emitInstLoadB(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+
+    build.mov(luauRegValueBoolean(ra), LUAU_INSN_B(*pc));
+    build.mov(luauRegTag(ra), LUA_TBOOLEAN);
+
+    if (int target = LUAU_INSN_C(*pc))
+        build.jmp(labelarr[pcpos + 1 + target]);
+}
+
+void emitInstLoadN(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    int ra = LUAU_INSN_A(*pc);
+
+    build.vmovsd(xmm0, build.f64(double(LUAU_INSN_D(*pc))));
+    build.vmovsd(luauRegValue(ra), xmm0);
+    build.mov(luauRegTag(ra), LUA_TNUMBER);
+}
+
+void emitInstLoadK(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    build.vmovups(xmm0, luauConstant(LUAU_INSN_D(*pc)));
+    build.vmovups(luauReg(LUAU_INSN_A(*pc)), xmm0);
+}
+
+void emitInstLoadKX(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    uint32_t aux = pc[1];
+
+    build.vmovups(xmm0, luauConstant(aux));
+    build.vmovups(luauReg(LUAU_INSN_A(*pc)), xmm0);
+}
+
+void emitInstMove(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    build.vmovups(xmm0, luauReg(LUAU_INSN_B(*pc)));
+    build.vmovups(luauReg(LUAU_INSN_A(*pc)), xmm0);
+}
+
+void emitInstGetUpval(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int up = LUAU_INSN_B(*pc);
+
+    Label direct;
+
+    // upvalue reference is either an UpVal object or the value itself (for values that are captured by value)
+    build.lea(rcx, qword[rClosure + int(offsetof(Closure, l.uprefs)) + up * int(sizeof(TValue))]);
+    build.cmp(dword[rcx + offsetof(TValue, tt)], LUA_TUPVAL);
+    build.jcc(Condition::NotEqual, direct);
+    build.mov(rcx, qword[rcx + offsetof(TValue, value)]);
+    build.mov(rcx, qword[rcx + offsetof(UpVal, v)]);
+    build.setLabel(direct);
+
+    build.vmovups(xmm0, xmmword[rcx]);
+    build.vmovups(luauReg(ra), xmm0);
+}
+
+void emitInstGetImport(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int k = LUAU_INSN_D(*pc);
+
+    Label slow;
+
+    // fast-path: import resolution was successful and closure environment is "safe" for import
+    build.cmp(luauConstantTag(k), LUA_TNIL);
+    build.jcc(Condition::Equal, slow);
+    build.mov(rax, qword[rClosure + offsetof(Closure, env)]);
+    build.cmp(byte[rax + offsetof(Table, safeenv)], 0);
+    build.jcc(Condition::Equal, slow);
+
+    build.vmovups(xmm0, luauConstant(k));
+    build.vmovups(luauReg(ra), xmm0);
+    build.jmp(labelarr[pcpos + 2]);
+
+    build.setLabel(slow);
+    emitCallFallback(build, (const void*)executeGETIMPORT, pc);
+}
+
+void emitInstJump(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    build.jmp(labelarr[pcpos + 1 + LUAU_INSN_D(*pc)]);
+}
+
+void emitInstJumpBack(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, Label& fallback)
+{
+    checkInterrupt(build, fallback);
+
+    build.jmp(labelarr[pcpos + 1 + LUAU_INSN_D(*pc)]);
+}
+
+void emitInstJumpX(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, Label& fallback)
+{
+    checkInterrupt(build, fallback);
+
+    build.jmp(labelarr[pcpos + 1 + LUAU_INSN_E(*pc)]);
+}
+
+void emitInstJumpIf(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, bool not_)
+{
+    int ra = LUAU_INSN_A(*pc);
+
+    Label& target = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+    Label& exit = labelarr[pcpos + 1];
+
+    if (not_)
+        jumpIfFalsy(build, ra, target, exit);
+    else
+        jumpIfTruthy(build, ra, target, exit);
+}
+
+void emitInstJumpIfEq(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, bool not_)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = pc[1];
+
+    Label& target = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+    Label& exit = labelarr[pcpos + 2];
+
+    Label checkNumber, checkString, slow;
+
+    // values of different types are never equal
+    build.mov(eax, luauRegTag(ra));
+    build.cmp(eax, luauRegTag(rb));
+    build.jcc(Condition::NotEqual, not_ ? target : exit);
+
+    build.cmp(eax, LUA_TNIL);
+    build.jcc(Condition::Equal, not_ ? exit : target);
+
+    build.cmp(eax, LUA_TBOOLEAN);
+    build.jcc(Condition::NotEqual, checkNumber);
+    build.mov(ecx, luauRegValueBoolean(ra));
+    build.cmp(ecx, luauRegValueBoolean(rb));
+    build.jcc(not_ ? Condition::NotEqual : Condition::Equal, target);
+    build.jmp(exit);
+
+    build.setLabel(checkNumber);
+    build.cmp(eax, LUA_TNUMBER);
+    build.jcc(Condition::NotEqual, checkString);
+
+    if (not_)
+        jumpIfNumberNotEqual(build, luauRegValue(ra), luauRegValue(rb), target);
+    else
+        jumpIfNumberEqual(build, luauRegValue(ra), luauRegValue(rb), target);
+
+    build.jmp(exit);
+
+    // strings are interned so they can be compared by reference
+    build.setLabel(checkString);
+    build.cmp(eax, LUA_TSTRING);
+    build.jcc(Condition::NotEqual, slow);
+    build.mov(rcx, luauRegValue(ra));
+    build.cmp(rcx, luauRegValue(rb));
+    build.jcc(not_ ? Condition::NotEqual : Condition::Equal, target);
+    build.jmp(exit);
+
+    // slow-path: tables and userdata values can have __eq metamethods
+    build.setLabel(slow);
+    emitSetSavedPc(build, pc + 1);
+    build.mov(rArg1, rState);
+    build.lea(rArg2, luauReg(ra));
+    build.lea(rArg3, luauReg(rb));
+    emitCall(build, (const void*)luaV_equalval);
+
+    build.test(eax, eax);
+    build.jcc(not_ ? Condition::Zero : Condition::NotZero, target);
+}
+
+void emitInstJumpIfCond(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = pc[1];
+    LuauOpcode op = LuauOpcode(LUAU_INSN_OP(*pc));
+
+    Label& target = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+    Label& exit = labelarr[pcpos + 2];
+
+    Label slow;
+
+    // fast-path: number
+    bool checked = jumpIfNotNumber(build, types, ra, slow);
+    checked |= jumpIfNotNumber(build, types, rb, slow);
+
+    // compare 'rb' against 'ra' so that unordered comparisons (NaN) set CF and fail both 'a <= b' and 'a < b'
+    build.vmovsd(xmm0, luauRegValue(rb));
+    build.vucomisd(xmm0, luauRegValue(ra));
+
+    switch (op)
+    {
+    case LOP_JUMPIFLE:
+        build.jcc(Condition::AboveEqual, target);
+        break;
+    case LOP_JUMPIFLT:
+        build.jcc(Condition::Above, target);
+        break;
+    case LOP_JUMPIFNOTLE:
+        build.jcc(Condition::Below, target);
+        break;
+    case LOP_JUMPIFNOTLT:
+        build.jcc(Condition::BelowEqual, target);
+        break;
+    default:
+        LUAU_ASSERT(!"Unsupported condition");
+    }
+
+    build.jmp(exit);
+
+    if (!checked)
+        return;
+
+    // slow-path: strings and values with metamethods
+    build.setLabel(slow);
+    emitSetSavedPc(build, pc + 1);
+    build.mov(rArg1, rState);
+    build.lea(rArg2, luauReg(ra));
+    build.lea(rArg3, luauReg(rb));
+
+    bool le = op == LOP_JUMPIFLE || op == LOP_JUMPIFNOTLE;
+    bool not_ = op == LOP_JUMPIFNOTLE || op == LOP_JUMPIFNOTLT;
+
+    emitCall(build, le ? (const void*)luaV_lessequal : (const void*)luaV_lessthan);
+
+    build.test(eax, eax);
+    build.jcc(not_ ? Condition::Zero : Condition::NotZero, target);
+}
+
+void emitInstJumpXEqNil(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+    bool not_ = (pc[1] & 0x80000000) != 0;
+
+    Label& target = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+
+    build.cmp(luauRegTag(ra), LUA_TNIL);
+    build.jcc(not_ ? Condition::NotEqual : Condition::Equal, target);
+}
+
+void emitInstJumpXEqB(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+    uint32_t aux = pc[1];
+    bool not_ = (aux & 0x80000000) != 0;
+
+    Label& target = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+    Label& exit = labelarr[pcpos + 2];
+
+    jumpIfTagIsNot(build, ra, LUA_TBOOLEAN, not_ ? target : exit);
+
+    build.cmp(luauRegValueBoolean(ra), int(aux & 1));
+    build.jcc(not_ ? Condition::NotEqual : Condition::Equal, target);
+}
+
+void emitInstJumpXEqN(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+    uint32_t aux = pc[1];
+    bool not_ = (aux & 0x80000000) != 0;
+
+    Label& target = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+    Label& exit = labelarr[pcpos + 2];
+
+    jumpIfTagIsNot(build, ra, LUA_TNUMBER, not_ ? target : exit);
+
+    if (not_)
+        jumpIfNumberNotEqual(build, luauRegValue(ra), luauConstantValue(aux & 0xffffff), target);
+    else
+        jumpIfNumberEqual(build, luauRegValue(ra), luauConstantValue(aux & 0xffffff), target);
+}
+
+void emitInstJumpXEqS(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+    uint32_t aux = pc[1];
+    bool not_ = (aux & 0x80000000) != 0;
+
+    Label& target = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+    Label& exit = labelarr[pcpos + 2];
+
+    jumpIfTagIsNot(build, ra, LUA_TSTRING, not_ ? target : exit);
+
+    build.mov(rax, luauRegValue(ra));
+    build.cmp(rax, luauConstantValue(aux & 0xffffff));
+    build.jcc(not_ ? Condition::NotEqual : Condition::Equal, target);
+}
+
+static TMS getArithTM(LuauOpcode op)
+{
+    switch (op)
+    {
+    case LOP_ADD:
+    case LOP_ADDK:
+    case LOP_ADDK_GETTABLE:
+        return TM_ADD;
+    case LOP_SUB:
+    case LOP_SUBK:
+        return TM_SUB;
+    case LOP_MUL:
+    case LOP_MULK:
+    case LOP_MUL_ADD:
+        return TM_MUL;
+    case LOP_DIV:
+    case LOP_DIVK:
+        return TM_DIV;
+    case LOP_MOD:
+    case LOP_MODK:
+        return TM_MOD;
+    case LOP_POW:
+    case LOP_POWK:
+        return TM_POW;
+    default:
+        LUAU_ASSERT(!"Unsupported binary op");
+        return TM_ADD;
+    }
+}
+
+static void emitArith(AssemblyBuilderX64& build, int ra, OperandX64 lhs, OperandX64 rhs, TMS tm)
+{
+    build.vmovsd(xmm0, lhs);
+
+    switch (tm)
+    {
+    case TM_ADD:
+        build.vaddsd(xmm0, xmm0, rhs);
+        break;
+    case TM_SUB:
+        build.vsubsd(xmm0, xmm0, rhs);
+        break;
+    case TM_MUL:
+        build.vmulsd(xmm0, xmm0, rhs);
+        break;
+    case TM_DIV:
+        build.vdivsd(xmm0, xmm0, rhs);
+        break;
+    case TM_MOD:
+        // a - floor(a / b) * b, matching luai_nummod
+        build.vmovsd(xmm1, rhs);
+        build.vdivsd(xmm2, xmm0, xmm1);
+        build.vroundsd(xmm2, xmm2, xmm2, 9); // floor
+        build.vmulsd(xmm2, xmm2, xmm1);
+        build.vsubsd(xmm0, xmm0, xmm2);
+        break;
+    default:
+        LUAU_ASSERT(!"Unsupported binary op");
+    }
+
+    build.vmovsd(luauRegValue(ra), xmm0);
+    build.mov(luauRegTag(ra), LUA_TNUMBER);
+}
+
+void emitInstBinary(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int rc = LUAU_INSN_C(*pc);
+    TMS tm = getArithTM(LuauOpcode(LUAU_INSN_OP(*pc)));
+
+    Label slow;
+
+    // fast-path: number
+    bool checked = jumpIfNotNumber(build, types, rb, slow);
+    checked |= jumpIfNotNumber(build, types, rc, slow);
+
+    emitArith(build, ra, luauRegValue(rb), luauRegValue(rc), tm);
+    build.jmp(labelarr[pcpos + 1]);
+
+    if (!checked)
+        return;
+
+    // slow-path: vectors and values with metamethods
+    build.setLabel(slow);
+    emitArithSlow(build, pc, ra, luauReg(rb), luauReg(rc), tm);
+}
+
+void emitInstBinaryK(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int kc = LUAU_INSN_C(*pc);
+    TMS tm = getArithTM(LuauOpcode(LUAU_INSN_OP(*pc)));
+
+    Label slow;
+
+    // fast-path: number; arithmetic constants are always numbers
+    bool checked = jumpIfNotNumber(build, types, rb, slow);
+
+    emitArith(build, ra, luauRegValue(rb), luauConstantValue(kc), tm);
+    build.jmp(labelarr[pcpos + 1]);
+
+    if (!checked)
+        return;
+
+    // slow-path: vectors and values with metamethods
+    build.setLabel(slow);
+    emitArithSlow(build, pc, ra, luauReg(rb), luauConstant(kc), tm);
+}
+
+void emitInstPow(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int rc = LUAU_INSN_C(*pc);
+
+    Label slow;
+
+    // fast-path: number
+    jumpIfTagIsNot(build, rb, LUA_TNUMBER, slow);
+    jumpIfTagIsNot(build, rc, LUA_TNUMBER, slow);
+
+    // pow takes arguments in xmm0/xmm1 on all supported ABIs
+    build.vmovsd(xmm0, luauRegValue(rb));
+    build.vmovsd(xmm1, luauRegValue(rc));
+    emitCall(build, (const void*)(double (*)(double, double))pow);
+    build.vmovsd(luauRegValue(ra), xmm0);
+    build.mov(luauRegTag(ra), LUA_TNUMBER);
+    build.jmp(labelarr[pcpos + 1]);
+
+    // slow-path: values with metamethods
+    build.setLabel(slow);
+    emitArithSlow(build, pc, ra, luauReg(rb), luauReg(rc), TM_POW);
+}
+
+void emitInstPowK(AssemblyBuilderX64& build, const Instruction* pc, const TValue* k, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int kc = LUAU_INSN_C(*pc);
+    double kv = nvalue(&k[kc]);
+
+    Label slow;
+
+    // fast-path: number
+    jumpIfTagIsNot(build, rb, LUA_TNUMBER, slow);
+
+    // pow is very slow so we specialize this for ^2, ^0.5 and ^3 like the interpreter does
+    build.vmovsd(xmm0, luauRegValue(rb));
+
+    if (kv == 2.0)
+    {
+        build.vmulsd(xmm0, xmm0, xmm0);
+    }
+    else if (kv == 0.5)
+    {
+        build.vsqrtsd(xmm0, xmm0, xmm0);
+    }
+    else if (kv == 3.0)
+    {
+        build.vmulsd(xmm1, xmm0, xmm0);
+        build.vmulsd(xmm0, xmm1, xmm0);
+    }
+    else
+    {
+        build.vmovsd(xmm1, luauConstantValue(kc));
+        emitCall(build, (const void*)(double (*)(double, double))pow);
+    }
+
+    build.vmovsd(luauRegValue(ra), xmm0);
+    build.mov(luauRegTag(ra), LUA_TNUMBER);
+    build.jmp(labelarr[pcpos + 1]);
+
+    // slow-path: values with metamethods
+    build.setLabel(slow);
+    emitArithSlow(build, pc, ra, luauReg(rb), luauConstant(kc), TM_POW);
+}
+
+void emitInstNot(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+
+    Label isTruthy, isFalsy, exit;
+
+    jumpIfFalsy(build, rb, isFalsy, isTruthy);
+
+    build.setLabel(isTruthy);
+    build.mov(luauRegValueBoolean(ra), 0);
+    build.jmp(exit);
+
+    build.setLabel(isFalsy);
+    build.mov(luauRegValueBoolean(ra), 1);
+
+    build.setLabel(exit);
+    build.mov(luauRegTag(ra), LUA_TBOOLEAN);
+}
+
+void emitInstMinus(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+
+    Label slow;
+
+    // fast-path: number
+    jumpIfTagIsNot(build, rb, LUA_TNUMBER, slow);
+
+    // negation flips the sign bit
+    build.mov(rax, luauRegValue(rb));
+    build.mov64(rcx, int64_t(1ull << 63));
+    build.xor_(rax, rcx);
+    build.mov(luauRegValue(ra), rax);
+    build.mov(luauRegTag(ra), LUA_TNUMBER);
+    build.jmp(labelarr[pcpos + 1]);
+
+    // slow-path: vectors and values with metamethods
+    build.setLabel(slow);
+    emitArithSlow(build, pc, ra, luauReg(rb), luauReg(rb), TM_UNM);
+}
+
+// Copies 'lhs' to ra if it's falsy for AND (or truthy for OR), otherwise copies 'rhs'
+static void emitAndOr(AssemblyBuilderX64& build, int ra, int rb, OperandX64 rhs, bool and_)
+{
+    Label isFalsy, isTruthy, exit;
+
+    jumpIfFalsy(build, rb, isFalsy, isTruthy);
+
+    build.setLabel(isTruthy);
+    build.vmovups(xmm0, and_ ? rhs : luauReg(rb));
+    build.jmp(exit);
+
+    build.setLabel(isFalsy);
+    build.vmovups(xmm0, and_ ? luauReg(rb) : rhs);
+
+    build.setLabel(exit);
+    build.vmovups(luauReg(ra), xmm0);
+}
+
+void emitInstAnd(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    emitAndOr(build, LUAU_INSN_A(*pc), LUAU_INSN_B(*pc), luauReg(LUAU_INSN_C(*pc)), /* and_= */ true);
+}
+
+void emitInstAndK(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    emitAndOr(build, LUAU_INSN_A(*pc), LUAU_INSN_B(*pc), luauConstant(LUAU_INSN_C(*pc)), /* and_= */ true);
+}
+
+void emitInstOr(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    emitAndOr(build, LUAU_INSN_A(*pc), LUAU_INSN_B(*pc), luauReg(LUAU_INSN_C(*pc)), /* and_= */ false);
+}
+
+void emitInstOrK(AssemblyBuilderX64& build, const Instruction* pc)
+{
+    emitAndOr(build, LUAU_INSN_A(*pc), LUAU_INSN_B(*pc), luauConstant(LUAU_INSN_C(*pc)), /* and_= */ false);
+}
+
+void emitInstGetTableN(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int c = LUAU_INSN_C(*pc);
+
+    Label slow;
+
+    // fast-path: array lookup
+    build.mov(ecx, c);
+    checkArrayAccess(build, rax, ecx, rb, slow, types);
+
+    build.mov(rax, qword[rax + offsetof(Table, array)]);
+    build.vmovups(xmm0, xmmword[rax + c * int(sizeof(TValue))]);
+    build.vmovups(luauReg(ra), xmm0);
+    build.jmp(labelarr[pcpos + 1]);
+
+    build.setLabel(slow);
+    emitCallFallback(build, (const void*)executeGETTABLEN, pc);
+}
+
+void emitInstSetTableN(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int c = LUAU_INSN_C(*pc);
+
+    Label slow;
+
+    // fast-path: array assign
+    build.mov(ecx, c);
+    checkArrayAccess(build, rax, ecx, rb, slow, types);
+    checkArrayStore(build, rax, ra, slow);
+
+    build.mov(rax, qword[rax + offsetof(Table, array)]);
+    build.vmovups(xmm0, luauReg(ra));
+    build.vmovups(xmmword[rax + c * int(sizeof(TValue))], xmm0);
+    build.jmp(labelarr[pcpos + 1]);
+
+    build.setLabel(slow);
+    emitCallFallback(build, (const void*)executeSETTABLEN, pc);
+}
+
+// Converts the number in 'rc' to a zero-based array index in ecx, jumping to 'slow' if it's not a number with an exact integer value
+static void loadArrayIndex(AssemblyBuilderX64& build, int rc, Label& slow, const RegisterTypes& types)
+{
+    jumpIfNotNumber(build, types, rc, slow);
+
+    build.vcvttsd2si(ecx, luauRegValue(rc));
+    build.vcvtsi2sd(xmm1, xmm1, ecx);
+    build.vucomisd(xmm1, luauRegValue(rc));
+    build.jcc(Condition::NotEqual, slow);
+    build.jcc(Condition::Below, slow);
+
+    // 32-bit operations zero-extend the result, so the index can be used in 64-bit addressing directly
+    build.sub(ecx, 1);
+}
+
+void emitInstGetTable(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int rc = LUAU_INSN_C(*pc);
+
+    Label slow;
+
+    // fast-path: array lookup
+    loadArrayIndex(build, rc, slow, types);
+    checkArrayAccess(build, rax, ecx, rb, slow, types);
+
+    build.mov(rax, qword[rax + offsetof(Table, array)]);
+    build.shl(rcx, kTValueSizeLog2);
+    build.vmovups(xmm0, xmmword[rax + rcx]);
+    build.vmovups(luauReg(ra), xmm0);
+    build.jmp(labelarr[pcpos + 1]);
+
+    build.setLabel(slow);
+    emitCallFallback(build, (const void*)executeGETTABLE, pc);
+}
+
+void emitInstSetTable(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int rc = LUAU_INSN_C(*pc);
+
+    Label slow;
+
+    // fast-path: array assign
+    loadArrayIndex(build, rc, slow, types);
+    checkArrayAccess(build, rax, ecx, rb, slow, types);
+    checkArrayStore(build, rax, ra, slow);
+
+    build.mov(rax, qword[rax + offsetof(Table, array)]);
+    build.shl(rcx, kTValueSizeLog2);
+    build.vmovups(xmm0, luauReg(ra));
+    build.vmovups(xmmword[rax + rcx], xmm0);
+    build.jmp(labelarr[pcpos + 1]);
+
+    build.setLabel(slow);
+    emitCallFallback(build, (const void*)executeSETTABLE, pc);
+}
+
+// Jumps to 'exit' if the loop described by limit/step/index in xmm0/xmm1/xmm2 has finished
+// Note: make sure the loop condition is exactly the same as in the interpreter so that we handle NaN/etc. consistently
+static void jumpIfForNLoopFinished(AssemblyBuilderX64& build, Label& exit)
+{
+    Label reverse, done;
+
+    // step > 0 ? idx <= limit : limit <= idx
+    build.vxorpd(xmm3, xmm3, xmm3);
+    build.vucomisd(xmm1, xmm3);
+    build.jcc(Condition::BelowEqual, reverse);
+
+    build.vucomisd(xmm0, xmm2);
+    build.jcc(Condition::Below, exit);
+    build.jmp(done);
+
+    build.setLabel(reverse);
+    build.vucomisd(xmm2, xmm0);
+    build.jcc(Condition::Below, exit);
+
+    build.setLabel(done);
+}
+
+void emitInstForNPrep(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, Label& fallback)
+{
+    int ra = LUAU_INSN_A(*pc);
+
+    Label& exit = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+
+    // slow-path: arguments that are not numbers are converted or rejected by the interpreter
+    jumpIfTagIsNot(build, ra + 0, LUA_TNUMBER, fallback);
+    jumpIfTagIsNot(build, ra + 1, LUA_TNUMBER, fallback);
+    jumpIfTagIsNot(build, ra + 2, LUA_TNUMBER, fallback);
+
+    build.vmovsd(xmm0, luauRegValue(ra + 0));
+    build.vmovsd(xmm1, luauRegValue(ra + 1));
+    build.vmovsd(xmm2, luauRegValue(ra + 2));
+
+    jumpIfForNLoopFinished(build, exit);
+}
+
+void emitInstForNLoop(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, Label& fallback)
+{
+    int ra = LUAU_INSN_A(*pc);
+
+    Label& loop = labelarr[pcpos + 1 + LUAU_INSN_D(*pc)];
+    Label& exit = labelarr[pcpos + 1];
+
+    checkInterrupt(build, fallback);
+
+    build.vmovsd(xmm0, luauRegValue(ra + 0));
+    build.vmovsd(xmm1, luauRegValue(ra + 1));
+    build.vmovsd(xmm2, luauRegValue(ra + 2));
+    build.vaddsd(xmm2, xmm2, xmm1);
+    build.vmovsd(luauRegValue(ra + 2), xmm2);
+
+    jumpIfForNLoopFinished(build, exit);
+
+    build.jmp(loop);
+}
+
+void emitInstFastCall(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const void* fallbackFunc)
+{
+    // when the builtin succeeds, all FASTCALL variants continue after the CALL instruction which is located at pcpos + C + 1
+    int skip = LUAU_INSN_C(*pc);
+    int target = pcpos + skip + 2;
+
+    LUAU_ASSERT(LUAU_INSN_OP(pc[skip + 1]) == LOP_CALL);
+
+    emitCallFallback(build, fallbackFunc, pc);
+
+    build.mov64(rcx, int64_t(uintptr_t(pc + (target - pcpos))));
+    build.cmp(rax, rcx);
+    build.jcc(Condition::Equal, labelarr[target]);
+}
+
+} // namespace CodeGen
+} // namespace Luau
@@ -0,0 +1,66 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include <bitset>
+
+#include <stdint.h>
+
+typedef uint32_t Instruction;
+typedef struct lua_TValue TValue;
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+class AssemblyBuilderX64;
+struct Label;
+
+// Registers that are known to hold a number or a table whenever native code of the function runs, so their tags don't need to be checked
+struct RegisterTypes
+{
+    std::bitset<256> numbers;
+    std::bitset<256> tables;
+};
+
+// Each function below lowers a single instruction at 'pcpos'; 'pc' points to the instruction inside of the function bytecode
+// 'labelarr' contains a label for each instruction of the function and is used for jumps
+// 'fallback' exits native code so that the interpreter can execute the instruction instead
+void emitInstLoadNil(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstLoadB(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstLoadN(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstLoadK(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstLoadKX(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstMove(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstGetUpval(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstGetImport(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstJump(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstJumpBack(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, Label& fallback);
+void emitInstJumpX(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, Label& fallback);
+void emitInstJumpIf(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, bool not_);
+void emitInstJumpIfEq(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, bool not_);
+void emitInstJumpIfCond(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types);
+void emitInstJumpXEqNil(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstJumpXEqB(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstJumpXEqN(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstJumpXEqS(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstBinary(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types);
+void emitInstBinaryK(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types);
+void emitInstPow(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstPowK(AssemblyBuilderX64& build, const Instruction* pc, const TValue* k, int pcpos, Label* labelarr);
+void emitInstNot(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstMinus(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr);
+void emitInstAnd(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstAndK(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstOr(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstOrK(AssemblyBuilderX64& build, const Instruction* pc);
+void emitInstGetTableN(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types);
+void emitInstSetTableN(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types);
+void emitInstGetTable(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types);
+void emitInstSetTable(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const RegisterTypes& types);
+void emitInstForNPrep(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, Label& fallback);
+void emitInstForNLoop(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, Label& fallback);
+void emitInstFastCall(AssemblyBuilderX64& build, const Instruction* pc, int pcpos, Label* labelarr, const void* fallbackFunc);
+
+} // namespace CodeGen
+} // namespace Luau
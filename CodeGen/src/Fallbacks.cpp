@@ -0,0 +1,546 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+// This code is based on Lua 5.x implementation licensed under MIT License; see lua_LICENSE.txt for details
+#include "Fallbacks.h"
+
+#include "Luau/Bytecode.h"
+
+#include "lbuiltins.h"
+#include "lfunc.h"
+#include "lgc.h"
+#include "lstate.h"
+#include "ltable.h"
+#include "lvm.h"
+
+// The code below mirrors the corresponding instruction implementations in lvmexecute.cpp; the macros match the interpreter macros
+// Unlike the interpreter, fallbacks don't keep 'cl' in a local so it's loaded from the current call frame when needed
+#define VM_PROTECT(x) \
+    { \
+        L->ci->savedpc = pc; \
+        { \
+            x; \
+        }; \
+        base = L->base; \
+    }
+
+#define VM_PROTECT_PC() L->ci->savedpc = pc
+
+#define VM_REG(i) (LUAU_ASSERT(unsigned(i) < unsigned(L->top - base)), &base[i])
+#define VM_KV(i) (LUAU_ASSERT(unsigned(i) < unsigned(clvalue(L->ci->func)->l.p->sizek)), &k[i])
+#define VM_UV(i) (LUAU_ASSERT(unsigned(i) < unsigned(clvalue(L->ci->func)->nupvalues)), &clvalue(L->ci->func)->l.uprefs[i])
+
+// note: code shared with a bytecode image is read-only, so it keeps the slot predictions from the compiler
+#define VM_PATCH_C(pc, slot) \
+    (cl->l.p->sharedcode ? void() : void(*const_cast<Instruction*>(pc) = ((uint8_t(slot) << 24) | (0x00ffffffu & *(pc)))))
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+const Instruction* executeGETGLOBAL(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Closure* cl = clvalue(L->ci->func);
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    uint32_t aux = *pc++;
+    TValue* kv = VM_KV(aux);
+    LUAU_ASSERT(ttisstring(kv));
+
+    // fast-path: value is in expected slot
+    Table* h = cl->env;
+    int slot = LUAU_INSN_C(insn) & h->nodemask8;
+    LuaNode* n = &h->node[slot];
+
+    if (LUAU_LIKELY(ttisstring(gkey(n)) && tsvalue(gkey(n)) == tsvalue(kv)) && !ttisnil(gval(n)))
+    {
+        setobj2s(L, ra, gval(n));
+        return pc;
+    }
+    else
+    {
+        // slow-path, may invoke Lua calls via __index metamethod
+        TValue g;
+        sethvalue(L, &g, h);
+        L->cachedslot = slot;
+        VM_PROTECT(luaV_gettable(L, &g, kv, ra));
+        // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+        VM_PATCH_C(pc - 2, L->cachedslot);
+        return pc;
+    }
+}
+
+const Instruction* executeSETGLOBAL(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Closure* cl = clvalue(L->ci->func);
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    uint32_t aux = *pc++;
+    TValue* kv = VM_KV(aux);
+    LUAU_ASSERT(ttisstring(kv));
+
+    // fast-path: value is in expected slot
+    Table* h = cl->env;
+    int slot = LUAU_INSN_C(insn) & h->nodemask8;
+    LuaNode* n = &h->node[slot];
+
+    if (LUAU_LIKELY(ttisstring(gkey(n)) && tsvalue(gkey(n)) == tsvalue(kv) && !ttisnil(gval(n)) && !h->readonly))
+    {
+        setobj2t(L, gval(n), ra);
+        luaC_barriert(L, h, ra);
+        return pc;
+    }
+    else
+    {
+        // slow-path, may invoke Lua calls via __newindex metamethod
+        TValue g;
+        sethvalue(L, &g, h);
+        L->cachedslot = slot;
+        VM_PROTECT(luaV_settable(L, &g, kv, ra));
+        // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+        VM_PATCH_C(pc - 2, L->cachedslot);
+        return pc;
+    }
+}
+
+const Instruction* executeSETUPVAL(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    TValue* ur = VM_UV(LUAU_INSN_B(insn));
+    UpVal* uv = upvalue(ur);
+
+    setobj(L, uv->v, ra);
+    luaC_barrier(L, uv, ra);
+    return pc;
+}
+
+const Instruction* executeCLOSEUPVALS(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+
+    if (L->openupval && L->openupval->v >= ra)
+        luaF_close(L, ra);
+    return pc;
+}
+
+const Instruction* executeGETIMPORT(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Closure* cl = clvalue(L->ci->func);
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    TValue* kv = VM_KV(LUAU_INSN_D(insn));
+
+    // fast-path: import resolution was successful and closure environment is "safe" for import
+    if (!ttisnil(kv) && cl->env->safeenv)
+    {
+        setobj2s(L, ra, kv);
+        pc++; // skip over AUX
+        return pc;
+    }
+    else
+    {
+        uint32_t aux = *pc++;
+
+        VM_PROTECT(luaV_getimport(L, cl->env, k, aux, /* propagatenil= */ false));
+        ra = VM_REG(LUAU_INSN_A(insn)); // previous call may change the stack
+
+        setobj2s(L, ra, L->top - 1);
+        L->top--;
+        return pc;
+    }
+}
+
+const Instruction* executeGETTABLEKS(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Closure* cl = clvalue(L->ci->func);
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    StkId rb = VM_REG(LUAU_INSN_B(insn));
+    uint32_t aux = *pc++;
+    TValue* kv = VM_KV(aux);
+    LUAU_ASSERT(ttisstring(kv));
+
+    // fast-path: built-in table
+    if (ttistable(rb))
+    {
+        Table* h = hvalue(rb);
+
+        int slot = LUAU_INSN_C(insn) & h->nodemask8;
+        LuaNode* n = &h->node[slot];
+
+        // fast-path: value is in expected slot
+        if (LUAU_LIKELY(ttisstring(gkey(n)) && tsvalue(gkey(n)) == tsvalue(kv) && !ttisnil(gval(n))))
+        {
+            setobj2s(L, ra, gval(n));
+            return pc;
+        }
+        // fast-path: value is in the slot recorded by the inline cache, or in the __index table of the cached metatable
+        else if (const TValue* res = luaV_icget(L, luaV_ic(cl->l.p, pc - 2), h, tsvalue(kv)))
+        {
+            setobj2s(L, ra, res);
+            return pc;
+        }
+        else if (!h->metatable)
+        {
+            // fast-path: value is not in expected slot, but the table lookup doesn't involve metatable
+            const TValue* res = luaH_getstr(h, tsvalue(kv));
+
+            if (res != luaO_nilobject)
+            {
+                int cachedslot = gval2slot(h, res);
+                // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+                VM_PATCH_C(pc - 2, cachedslot);
+                luaV_icsetslot(L, cl->l.p, luaV_ic(cl->l.p, pc - 2), h, cachedslot);
+            }
+
+            setobj2s(L, ra, res);
+            return pc;
+        }
+        // fast-path: value is in the __index table of the metatable, which the inline cache remembers for future lookups
+        else if (const TValue* res = luaV_icfill(L, cl->l.p, luaV_ic(cl->l.p, pc - 2), h, h->metatable, tsvalue(kv)))
+        {
+            setobj2s(L, ra, res);
+            return pc;
+        }
+        else
+        {
+            // slow-path, may invoke Lua calls via __index metamethod
+            L->cachedslot = slot;
+            VM_PROTECT(luaV_gettable(L, rb, kv, ra));
+            // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+            VM_PATCH_C(pc - 2, L->cachedslot);
+            return pc;
+        }
+    }
+    else if (ttisvector(rb))
+    {
+        // fast-path: quick case-insensitive comparison with "X"/"Y"/"Z"
+        const char* name = getstr(tsvalue(kv));
+        int ic = (name[0] | ' ') - 'x';
+
+#if LUA_VECTOR_SIZE == 4
+        // 'w' is before 'x' in ascii, so ic is -1 when indexing with 'w'
+        if (ic == -1)
+            ic = 3;
+#endif
+
+        if (unsigned(ic) < LUA_VECTOR_SIZE && name[1] == '\0')
+        {
+            const float* v = rb->value.v; // silences ubsan when indexing v[]
+            setnvalue(ra, v[ic]);
+            return pc;
+        }
+
+        // fall through to slow path
+    }
+
+    // slow-path, may invoke Lua calls via __index metamethod
+    VM_PROTECT(luaV_gettable(L, rb, kv, ra));
+    return pc;
+}
+
+const Instruction* executeSETTABLEKS(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Closure* cl = clvalue(L->ci->func);
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    StkId rb = VM_REG(LUAU_INSN_B(insn));
+    uint32_t aux = *pc++;
+    TValue* kv = VM_KV(aux);
+    LUAU_ASSERT(ttisstring(kv));
+
+    // fast-path: built-in table
+    if (ttistable(rb))
+    {
+        Table* h = hvalue(rb);
+
+        int slot = LUAU_INSN_C(insn) & h->nodemask8;
+        LuaNode* n = &h->node[slot];
+
+        // fast-path: value is in expected slot
+        if (LUAU_LIKELY(ttisstring(gkey(n)) && tsvalue(gkey(n)) == tsvalue(kv) && !ttisnil(gval(n)) && !h->readonly))
+        {
+            setobj2t(L, gval(n), ra);
+            luaC_barriert(L, h, ra);
+            return pc;
+        }
+        // fast-path: value is in the slot recorded by the inline cache
+        else if (TValue* icv = luaV_icslot(luaV_ic(cl->l.p, pc - 2), h, tsvalue(kv)); icv && !h->readonly)
+        {
+            setobj2t(L, icv, ra);
+            luaC_barriert(L, h, ra);
+            return pc;
+        }
+        else if (fastnotm(h->metatable, TM_NEWINDEX) && !h->readonly)
+        {
+            VM_PROTECT_PC(); // set may fail
+
+            TValue* res = luaH_setstr(L, h, tsvalue(kv));
+            int cachedslot = gval2slot(h, res);
+            // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+            VM_PATCH_C(pc - 2, cachedslot);
+            luaV_icsetslot(L, cl->l.p, luaV_ic(cl->l.p, pc - 2), h, cachedslot);
+            setobj2t(L, res, ra);
+            luaC_barriert(L, h, ra);
+            return pc;
+        }
+        else
+        {
+            // slow-path, may invoke Lua calls via __newindex metamethod
+            L->cachedslot = slot;
+            VM_PROTECT(luaV_settable(L, rb, kv, ra));
+            // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+            VM_PATCH_C(pc - 2, L->cachedslot);
+            return pc;
+        }
+    }
+
+    // slow-path, may invoke Lua calls via __newindex metamethod
+    VM_PROTECT(luaV_settable(L, rb, kv, ra));
+    return pc;
+}
+
+const Instruction* executeGETTABLE(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    StkId rb = VM_REG(LUAU_INSN_B(insn));
+    StkId rc = VM_REG(LUAU_INSN_C(insn));
+
+    // slow-path: handles out of bounds array lookups, non-integer numeric keys, non-array table lookup, __index MT calls
+    // native code handles the array fast-path
+    VM_PROTECT(luaV_gettable(L, rb, rc, ra));
+    return pc;
+}
+
+const Instruction* executeSETTABLE(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    StkId rb = VM_REG(LUAU_INSN_B(insn));
+    StkId rc = VM_REG(LUAU_INSN_C(insn));
+
+    // slow-path: handles out of bounds array assignments, non-integer numeric keys, non-array table access, __newindex MT calls
+    // native code handles the array fast-path
+    VM_PROTECT(luaV_settable(L, rb, rc, ra));
+    return pc;
+}
+
+const Instruction* executeGETTABLEN(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    StkId rb = VM_REG(LUAU_INSN_B(insn));
+    int c = LUAU_INSN_C(insn);
+
+    // slow-path: handles out of bounds array lookups
+    // native code handles the array fast-path
+    TValue n;
+    setnvalue(&n, c + 1);
+    VM_PROTECT(luaV_gettable(L, rb, &n, ra));
+    return pc;
+}
+
+const Instruction* executeSETTABLEN(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    StkId rb = VM_REG(LUAU_INSN_B(insn));
+    int c = LUAU_INSN_C(insn);
+
+    // slow-path: handles out of bounds array assignments
+    // native code handles the array fast-path
+    TValue n;
+    setnvalue(&n, c + 1);
+    VM_PROTECT(luaV_settable(L, rb, &n, ra));
+    return pc;
+}
+
+const Instruction* executeNEWTABLE(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    int b = LUAU_INSN_B(insn);
+    uint32_t aux = *pc++;
+
+    sethvalue(L, ra, luaH_new(L, aux, b == 0 ? 0 : (1 << (b - 1))));
+    VM_PROTECT(luaC_checkGC(L));
+    return pc;
+}
+
+const Instruction* executeDUPTABLE(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    TValue* kv = VM_KV(LUAU_INSN_D(insn));
+
+    sethvalue(L, ra, luaH_clone(L, hvalue(kv)));
+    VM_PROTECT(luaC_checkGC(L));
+    return pc;
+}
+
+const Instruction* executeCONCAT(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    int b = LUAU_INSN_B(insn);
+    int c = LUAU_INSN_C(insn);
+
+    // This call may realloc the stack! So we need to query args further down
+    VM_PROTECT(luaV_concat(L, c - b + 1, c));
+
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+
+    setobjs2s(L, ra, base + b);
+    VM_PROTECT(luaC_checkGC(L));
+    return pc;
+}
+
+const Instruction* executeCONCATACC(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    uint32_t aux = *pc++;
+
+    // This call may realloc the stack! So we need to query args further down
+    VM_PROTECT(luaV_concatacc(L, LUAU_INSN_A(insn), LUAU_INSN_B(insn), LUAU_INSN_C(insn), aux));
+    VM_PROTECT(luaC_checkGC(L));
+    return pc;
+}
+
+const Instruction* executeFLUSHACC(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+
+    VM_PROTECT(luaV_flushacc(L, LUAU_INSN_A(insn), LUAU_INSN_B(insn)));
+    VM_PROTECT(luaC_checkGC(L));
+    return pc;
+}
+
+const Instruction* executeLENGTH(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    StkId ra = VM_REG(LUAU_INSN_A(insn));
+    StkId rb = VM_REG(LUAU_INSN_B(insn));
+
+    // fast-path #1: tables
+    if (ttistable(rb))
+    {
+        Table* h = hvalue(rb);
+
+        if (fastnotm(h->metatable, TM_LEN))
+        {
+            setnvalue(ra, cast_num(luaH_getn(h)));
+            return pc;
+        }
+    }
+    // fast-path #2: strings (not very important but easy to do)
+    else if (ttisstring(rb))
+    {
+        TString* ts = tsvalue(rb);
+        setnvalue(ra, cast_num(ts->len));
+        return pc;
+    }
+
+    // slow-path, may invoke C/Lua via metamethods
+    VM_PROTECT(luaV_dolen(L, ra, rb));
+    return pc;
+}
+
+// Calls the builtin and returns the pointer to the instruction after CALL on success or 'pc' if the fallback code needs to run
+static const Instruction* callFastFunction(lua_State* L, const Instruction* pc, int bfid, int skip, StkId ra, TValue* arg0, StkId args, int nparams)
+{
+    Closure* cl = clvalue(L->ci->func);
+
+    Instruction call = pc[skip];
+    int nresults = LUAU_INSN_C(call) - 1;
+
+    luau_FastFunction f = luauF_table[bfid];
+
+    if (cl->env->safeenv && f)
+    {
+        VM_PROTECT_PC();
+
+        int n = f(L, ra, arg0, nresults, args, nparams);
+
+        if (n >= 0)
+        {
+            L->top = (nresults == LUA_MULTRET) ? ra + n : L->ci->top;
+
+            pc += skip + 1; // skip instructions that compute function as well as CALL
+            LUAU_ASSERT(unsigned(pc - cl->l.p->code) < unsigned(cl->l.p->sizecode));
+            return pc;
+        }
+    }
+
+    // continue execution through the fallback code
+    return pc;
+}
+
+const Instruction* executeFASTCALL(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    int bfid = LUAU_INSN_A(insn);
+    int skip = LUAU_INSN_C(insn);
+
+    Instruction call = pc[skip];
+    LUAU_ASSERT(LUAU_INSN_OP(call) == LOP_CALL);
+
+    StkId ra = VM_REG(LUAU_INSN_A(call));
+
+    int nparams = LUAU_INSN_B(call) - 1;
+    nparams = (nparams == LUA_MULTRET) ? int(L->top - ra - 1) : nparams;
+
+    return callFastFunction(L, pc, bfid, skip, ra, ra + 1, ra + 2, nparams);
+}
+
+const Instruction* executeFASTCALL1(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    int bfid = LUAU_INSN_A(insn);
+    TValue* arg = VM_REG(LUAU_INSN_B(insn));
+    int skip = LUAU_INSN_C(insn);
+
+    Instruction call = pc[skip];
+    LUAU_ASSERT(LUAU_INSN_OP(call) == LOP_CALL);
+
+    StkId ra = VM_REG(LUAU_INSN_A(call));
+
+    return callFastFunction(L, pc, bfid, skip, ra, arg, NULL, 1);
+}
+
+const Instruction* executeFASTCALL2(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    int bfid = LUAU_INSN_A(insn);
+    int skip = LUAU_INSN_C(insn) - 1;
+    uint32_t aux = *pc++;
+    TValue* arg1 = VM_REG(LUAU_INSN_B(insn));
+    TValue* arg2 = VM_REG(aux);
+
+    Instruction call = pc[skip];
+    LUAU_ASSERT(LUAU_INSN_OP(call) == LOP_CALL);
+
+    StkId ra = VM_REG(LUAU_INSN_A(call));
+
+    return callFastFunction(L, pc, bfid, skip, ra, arg1, arg2, 2);
+}
+
+const Instruction* executeFASTCALL2K(lua_State* L, const Instruction* pc, StkId base, TValue* k)
+{
+    Instruction insn = *pc++;
+    int bfid = LUAU_INSN_A(insn);
+    int skip = LUAU_INSN_C(insn) - 1;
+    uint32_t aux = *pc++;
+    TValue* arg1 = VM_REG(LUAU_INSN_B(insn));
+    TValue* arg2 = VM_KV(aux);
+
+    Instruction call = pc[skip];
+    LUAU_ASSERT(LUAU_INSN_OP(call) == LOP_CALL);
+
+    StkId ra = VM_REG(LUAU_INSN_A(call));
+
+    return callFastFunction(L, pc, bfid, skip, ra, arg1, arg2, 2);
+}
+
+} // namespace CodeGen
+} // namespace Luau
@@ -0,0 +1,36 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "lobject.h"
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Fallbacks implement the complete semantics of an instruction, including the slow paths, and return the pointer to the next instruction
+// They are called from native code for instructions that are too complex to generate inline code for
+const Instruction* executeGETGLOBAL(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeSETGLOBAL(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeSETUPVAL(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeCLOSEUPVALS(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeGETIMPORT(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeGETTABLEKS(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeSETTABLEKS(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeGETTABLE(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeSETTABLE(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeGETTABLEN(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeSETTABLEN(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeNEWTABLE(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeDUPTABLE(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeCONCAT(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeCONCATACC(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeFLUSHACC(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeLENGTH(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeFASTCALL(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeFASTCALL1(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeFASTCALL2(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+const Instruction* executeFASTCALL2K(lua_State* L, const Instruction* pc, StkId base, TValue* k);
+
+} // namespace CodeGen
+} // namespace Luau
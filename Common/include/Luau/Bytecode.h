@@ -44,6 +44,9 @@
 // Version 1: Baseline version for the open-source release. Supported until 0.521.
 // Version 2: Adds Proto::linedefined. Currently supported.
 // Version 3: Adds FORGPREP/JUMPXEQK* and enhances AUX encoding for FORGLOOP. Removes FORGLOOP_NEXT/INEXT and JUMPIFEQK/JUMPIFNOTEQK. Currently supported.
+// Version 4: Adds type information for function parameters. Currently supported, only emitted when type information is requested.
+// Version 5: Adds fused instructions (MOVE_MOVE and others). Currently supported, only emitted when the compiler targets this version.
+// Version 6: Adds CONCATACC/FLUSHACC for strings that are built up in loops. Currently supported, only emitted when the compiler targets this version.
 
 // Bytecode opcode, part of the instruction header
 enum LuauOpcode
@@ -388,6 +391,41 @@ enum LuauOpcode
     LOP_JUMPXEQKN,
     LOP_JUMPXEQKS,
 
+    // Fused instructions combine an instruction with the instruction that follows it, so that the interpreter can run both with a single dispatch.
+    // Each one behaves exactly like the instruction named first, with the same operands, and requires the next instruction to be the one named
+    // second (or a fused instruction that starts with it); the next instruction is still executed and can be a jump target.
+    // MOVE_MOVE, MOVE_CALL: see MOVE
+    LOP_MOVE_MOVE,
+    LOP_MOVE_CALL,
+
+    // GETUPVAL_CALL: see GETUPVAL
+    LOP_GETUPVAL_CALL,
+
+    // GETTABLE_GETTABLE, GETTABLE_ADD: see GETTABLE
+    LOP_GETTABLE_GETTABLE,
+    LOP_GETTABLE_ADD,
+
+    // ADDK_GETTABLE: see ADDK
+    LOP_ADDK_GETTABLE,
+
+    // MUL_ADD: see MUL
+    LOP_MUL_ADD,
+
+    // CONCATACC: append strings between B+1 and C (inclusive) to the string in A, using a string accumulator in registers AUX and AUX+1
+    // The accumulator holds a growable buffer and the length of the string that A would contain; while it's active, A is stale and may only be
+    // read by CONCATACC and FLUSHACC with the same accumulator. When any value isn't a string or a number, the accumulator is flushed into A and
+    // the instruction behaves like CONCAT with A copied into B, so B is clobbered.
+    // A: target register, source of the first string
+    // B: scratch register, followed by the strings to append
+    // C: source register end
+    // AUX: accumulator register
+    LOP_CONCATACC,
+
+    // FLUSHACC: if the string accumulator in registers B and B+1 is active, put its string into A and reset the accumulator
+    // A: target register
+    // B: accumulator register
+    LOP_FLUSHACC,
+
     // Enum entry for number of opcodes, not a valid opcode by itself!
     LOP__COUNT
 };
@@ -407,13 +445,50 @@ enum LuauOpcode
 // E encoding: one signed 24-bit value
 #define LUAU_INSN_E(insn) (int32_t(insn) >> 8)
 
+// Number of 32-bit words used by the instruction: 2 for instructions that are followed by an auxiliary word, 1 for the rest
+inline int getOpLength(LuauOpcode op)
+{
+    switch (op)
+    {
+    case LOP_GETGLOBAL:
+    case LOP_SETGLOBAL:
+    case LOP_GETIMPORT:
+    case LOP_GETTABLEKS:
+    case LOP_SETTABLEKS:
+    case LOP_NAMECALL:
+    case LOP_JUMPIFEQ:
+    case LOP_JUMPIFLE:
+    case LOP_JUMPIFLT:
+    case LOP_JUMPIFNOTEQ:
+    case LOP_JUMPIFNOTLE:
+    case LOP_JUMPIFNOTLT:
+    case LOP_NEWTABLE:
+    case LOP_SETLIST:
+    case LOP_FORGLOOP:
+    case LOP_LOADKX:
+    case LOP_FASTCALL2:
+    case LOP_FASTCALL2K:
+    case LOP_JUMPXEQKNIL:
+    case LOP_JUMPXEQKB:
+    case LOP_JUMPXEQKN:
+    case LOP_JUMPXEQKS:
+    case LOP_CONCATACC:
+        return 2;
+
+    default:
+        return 1;
+    }
+}
+
 // Bytecode tags, used internally for bytecode encoded as a string
 enum LuauBytecodeTag
 {
     // Bytecode version; runtime supports [MIN, MAX], compiler emits TARGET by default but may emit a higher version when flags are enabled
     LBC_VERSION_MIN = 3,
-    LBC_VERSION_MAX = 3,
+    LBC_VERSION_MAX = 6,
     LBC_VERSION_TARGET = 3,
+    // Debug info sidecar version; sidecars hold line info, local and upvalue names of bytecode built with BytecodeBuilder::enableDebugInfoSidecar
+    LBC_DEBUGINFO_VERSION = 1,
     // Types of constant table entries
     LBC_CONSTANT_NIL = 0,
     LBC_CONSTANT_BOOLEAN,
@@ -517,6 +592,21 @@ enum LuauBuiltinFunction
 
     // bit32.extract(_, k, k)
     LBF_BIT32_EXTRACTK,
+
+    // buffer.read*/write*; signed and unsigned writes of the same width store the same bytes, so they share an id
+    LBF_BUFFER_READI8,
+    LBF_BUFFER_READU8,
+    LBF_BUFFER_WRITEU8,
+    LBF_BUFFER_READI16,
+    LBF_BUFFER_READU16,
+    LBF_BUFFER_WRITEU16,
+    LBF_BUFFER_READI32,
+    LBF_BUFFER_READU32,
+    LBF_BUFFER_WRITEU32,
+    LBF_BUFFER_READF32,
+    LBF_BUFFER_WRITEF32,
+    LBF_BUFFER_READF64,
+    LBF_BUFFER_WRITEF64,
 };
 
 // Capture type, used in LOP_CAPTURE
@@ -526,3 +616,23 @@ enum LuauCaptureType
     LCT_REF,
     LCT_UPVAL,
 };
+
+// Type information for function parameters, encoded after the function header in version 4
+// The encoding is LBC_TYPE_FUNCTION, followed by the number of parameters, followed by the type of each parameter
+enum LuauBytecodeType
+{
+    LBC_TYPE_NIL = 0,
+    LBC_TYPE_BOOLEAN,
+    LBC_TYPE_NUMBER,
+    LBC_TYPE_STRING,
+    LBC_TYPE_TABLE,
+    LBC_TYPE_FUNCTION,
+    LBC_TYPE_THREAD,
+    LBC_TYPE_USERDATA,
+    LBC_TYPE_VECTOR,
+
+    LBC_TYPE_ANY = 15,
+    LBC_TYPE_OPTIONAL_BIT = 1 << 7,
+
+    LBC_TYPE_INVALID = 256,
+};
@@ -51,6 +51,18 @@ public:
 
     void setMainFunction(uint32_t fid);
 
+    // type information is serialized with each function, so it needs to be enabled before the first function is built
+    void enableTypeInfo();
+    void setFunctionTypeInfo(std::string value);
+
+    // versions above LBC_VERSION_TARGET allow instructions that older runtimes can't load; like type information, this affects the
+    // serialization of each function, so it needs to be set before the first function is built
+    void setTargetVersion(uint8_t version);
+
+    // line info, local and upvalue names are written to a separate blob (see getDebugInfo) instead of the bytecode; this needs to be enabled before
+    // the first function is built
+    void enableDebugInfoSidecar();
+
     int32_t addConstantNil();
     int32_t addConstantBoolean(bool value);
     int32_t addConstantNumber(double value);
@@ -74,6 +86,11 @@ public:
     void foldJumps();
     void expandJumps();
 
+    void optimizeRegisters();
+
+    // replaces common instruction pairs with fused instructions; requires target version 5
+    void fuseInstructions();
+
     void setDebugFunctionName(StringRef name);
     void setDebugFunctionLineDefined(int line);
     void setDebugLine(int line);
@@ -92,6 +109,7 @@ public:
         Dump_Source = 1 << 2,
         Dump_Locals = 1 << 3,
         Dump_Remarks = 1 << 4,
+        Dump_Types = 1 << 5,
     };
 
     void setDumpFlags(uint32_t flags)
@@ -108,6 +126,12 @@ public:
         return bytecode;
     }
 
+    const std::string& getDebugInfo() const
+    {
+        LUAU_ASSERT(!bytecode.empty()); // did you forget to call finalize?
+        return debugInfo;
+    }
+
     std::string dumpFunction(uint32_t id) const;
     std::string dumpEverything() const;
 
@@ -121,6 +145,10 @@ public:
 
     static uint8_t getVersion();
 
+    static uint32_t getBytecodeHash(const std::string& bytecode);
+
+    static const char* getOpcodeName(uint8_t op);
+
 private:
     struct Constant
     {
@@ -162,6 +190,7 @@ private:
     struct Function
     {
         std::string data;
+        std::string debugdata;
 
         uint8_t maxstacksize = 0;
         uint8_t numparams = 0;
@@ -171,6 +200,8 @@ private:
         unsigned int debugname = 0;
         int debuglinedefined = 0;
 
+        std::string typeinfo;
+
         std::string dump;
         std::string dumpname;
     };
@@ -223,6 +254,10 @@ private:
     std::vector<TableShape> tableShapes;
 
     bool hasLongJumps = false;
+    bool hasTypeInfo = false;
+    bool hasDebugSidecar = false;
+
+    uint8_t targetVersion = 0;
 
     DenseHashMap<ConstantKey, int32_t, ConstantKeyHash> constantMap;
     DenseHashMap<TableShape, int32_t, TableShapeHash> tableShapeMap;
@@ -234,12 +269,14 @@ private:
     std::vector<DebugUpval> debugUpvals;
 
     DenseHashMap<StringRef, unsigned int, StringRefHash> stringTable;
+    DenseHashMap<StringRef, unsigned int, StringRefHash> debugStringTable;
 
     std::vector<std::pair<uint32_t, uint32_t>> debugRemarks;
     std::string debugRemarkBuffer;
 
     BytecodeEncoder* encoder = nullptr;
     std::string bytecode;
+    std::string debugInfo;
 
     uint32_t dumpFlags = 0;
     std::vector<std::string> dumpSource;
@@ -248,15 +285,20 @@ private:
 
     void validate() const;
 
+    uint8_t getEncodedVersion() const;
+
     std::string dumpCurrentFunction() const;
     void dumpInstruction(const uint32_t* opcode, std::string& output, int targetLabel) const;
+    void dumpTypeInfo(const std::string& typeinfo, std::string& output) const;
 
     void writeFunction(std::string& ss, uint32_t id) const;
     void writeLineInfo(std::string& ss) const;
-    void writeStringTable(std::string& ss) const;
+    void writeDebugInfo(std::string& ss) const;
+    void writeStringTable(std::string& ss, const DenseHashMap<StringRef, unsigned int, StringRefHash>& table) const;
 
     int32_t addConstant(const ConstantKey& key, const Constant& value);
     unsigned int addStringTableEntry(StringRef value);
+    unsigned int addDebugStringTableEntry(StringRef value);
 };
 
 } // namespace Luau
@@ -6,9 +6,13 @@
 #include "Luau/StringUtils.h"
 #include "Luau/Common.h"
 
+#include <vector>
+
 namespace Luau
 {
 class AstNameTable;
+class AstExprCall;
+class AstStatBlock;
 struct ParseResult;
 class BytecodeBuilder;
 class BytecodeEncoder;
@@ -37,6 +41,32 @@ struct CompileOptions
 
     // null-terminated array of globals that are mutable; disables the import optimization for fields accessed through these
     const char** mutableGlobals = nullptr;
+
+    // 0 - no type information
+    // 1 - parameter types from type annotations; used by native code generation to remove type checks
+    int typeInfoLevel = 0;
+
+    // execution counts for each source line as reported by lua_getcoverage, indexed by line number with -1 for lines without coverage data
+    // on optimization level 2, hot call sites and loops get larger inlining and unrolling budgets, and code that never ran isn't inlined or unrolled
+    const int* lineHits = nullptr;
+    int lineHitsCount = 0;
+
+    // bytecode version to emit; 0 emits the version that all supported runtimes can load
+    // version 5 fuses common instruction pairs into single instructions that the interpreter runs with one dispatch
+    // version 6 builds strings that are appended to in loops in a buffer on optimization level 2
+    int bytecodeVersion = 0;
+};
+
+// A module that the compiled module requires; on optimization level 2, constants and small functions exported by modules that return a frozen
+// table (`return table.freeze(t)`) are inlined into the code that reads them through a local, so the result has to be recompiled when they change
+struct RequiredModule
+{
+    // require call in the compiled module, as identified by traceRequires; the module's exports are used through the local it initializes
+    AstExprCall* call = nullptr;
+
+    // parsed source of the required module and the name table it was parsed with; both need to stay alive until compilation finishes
+    AstStatBlock* root = nullptr;
+    const AstNameTable* names = nullptr;
 };
 
 class CompileError : public std::exception
@@ -58,7 +88,8 @@ private:
 };
 
 // compiles bytecode into bytecode builder using either a pre-parsed AST or parsing it from source; throws on errors
-void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, const AstNameTable& names, const CompileOptions& options = {});
+void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, const AstNameTable& names, const CompileOptions& options = {},
+    const std::vector<RequiredModule>& requiredModules = {});
 void compileOrThrow(BytecodeBuilder& bytecode, const std::string& source, const CompileOptions& options = {}, const ParseOptions& parseOptions = {});
 
 // compiles bytecode into a bytecode blob, that either contains the valid bytecode or an encoded error that luau_load can decode
@@ -33,6 +33,20 @@ struct lua_CompileOptions
 
     // null-terminated array of globals that are mutable; disables the import optimization for fields accessed through these
     const char** mutableGlobals;
+
+    // 0 - no type information
+    // 1 - parameter types from type annotations; used by native code generation to remove type checks
+    int typeInfoLevel; // default=0
+
+    // execution counts for each source line as reported by lua_getcoverage, indexed by line number with -1 for lines without coverage data
+    // on optimization level 2, hot call sites and loops get larger inlining and unrolling budgets, and code that never ran isn't inlined or unrolled
+    const int* lineHits;
+    int lineHitsCount;
+
+    // bytecode version to emit; 0 emits the version that all supported runtimes can load
+    // version 5 fuses common instruction pairs into single instructions that the interpreter runs with one dispatch
+    // version 6 builds strings that are appended to in loops in a buffer on optimization level 2
+    int bytecodeVersion; // default=0
 };
 
 // compile source to bytecode; when source compilation fails, the resulting bytecode contains the encoded error. use free() to destroy
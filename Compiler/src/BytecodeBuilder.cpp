@@ -4,6 +4,7 @@
 #include "Luau/StringUtils.h"
 
 #include <algorithm>
+#include <bitset>
 #include <string.h>
 
 namespace Luau
@@ -17,6 +18,9 @@ static const uint32_t kMaxClosureCount = 1 << 15;
 
 static const int kMaxJumpDistance = 1 << 23;
 
+// how far back the register optimizer searches for the instruction that computed the source of a MOVE
+static const uint32_t kMaxCoalesceDistance = 16;
+
 static int log2(int v)
 {
     LUAU_ASSERT(v);
@@ -53,39 +57,6 @@ static void writeVarInt(std::string& ss, unsigned int value)
     } while (value);
 }
 
-static int getOpLength(LuauOpcode op)
-{
-    switch (op)
-    {
-    case LOP_GETGLOBAL:
-    case LOP_SETGLOBAL:
-    case LOP_GETIMPORT:
-    case LOP_GETTABLEKS:
-    case LOP_SETTABLEKS:
-    case LOP_NAMECALL:
-    case LOP_JUMPIFEQ:
-    case LOP_JUMPIFLE:
-    case LOP_JUMPIFLT:
-    case LOP_JUMPIFNOTEQ:
-    case LOP_JUMPIFNOTLE:
-    case LOP_JUMPIFNOTLT:
-    case LOP_NEWTABLE:
-    case LOP_SETLIST:
-    case LOP_FORGLOOP:
-    case LOP_LOADKX:
-    case LOP_FASTCALL2:
-    case LOP_FASTCALL2K:
-    case LOP_JUMPXEQKNIL:
-    case LOP_JUMPXEQKB:
-    case LOP_JUMPXEQKN:
-    case LOP_JUMPXEQKS:
-        return 2;
-
-    default:
-        return 1;
-    }
-}
-
 inline bool isJumpD(LuauOpcode op)
 {
     switch (op)
@@ -215,6 +186,7 @@ BytecodeBuilder::BytecodeBuilder(BytecodeEncoder* encoder)
     , tableShapeMap(TableShape())
     , protoMap(~0u)
     , stringTable({nullptr, 0})
+    , debugStringTable({nullptr, 0})
     , encoder(encoder)
 {
     LUAU_ASSERT(stringTable.find(StringRef{"", 0}) == nullptr);
@@ -265,12 +237,18 @@ void BytecodeBuilder::endFunction(uint8_t maxstacksize, uint8_t numupvalues)
 
     writeFunction(func.data, currentFunction);
 
-    currentFunction = ~0u;
+    if (hasDebugSidecar)
+    {
+        writeVarInt(func.debugdata, uint32_t(insns.size()));
+        writeDebugInfo(func.debugdata);
+    }
 
     // this call is indirect to make sure we only gain link time dependency on dumpCurrentFunction when needed
     if (dumpFunctionPtr)
         func.dump = (this->*dumpFunctionPtr)();
 
+    currentFunction = ~0u;
+
     insns.clear();
     lines.clear();
     constants.clear();
@@ -323,6 +301,20 @@ unsigned int BytecodeBuilder::addStringTableEntry(StringRef value)
     return index;
 }
 
+unsigned int BytecodeBuilder::addDebugStringTableEntry(StringRef value)
+{
+    // names that are only used by debug info go to the sidecar string table when it's enabled
+    if (!hasDebugSidecar)
+        return addStringTableEntry(value);
+
+    unsigned int& index = debugStringTable[value];
+
+    if (index == 0)
+        index = uint32_t(debugStringTable.size());
+
+    return index;
+}
+
 int32_t BytecodeBuilder::addConstantNil()
 {
     Constant c = {Constant::Type_Nil};
@@ -508,6 +500,35 @@ bool BytecodeBuilder::patchSkipC(size_t jumpLabel, size_t targetLabel)
     return true;
 }
 
+void BytecodeBuilder::enableTypeInfo()
+{
+    LUAU_ASSERT(functions.empty());
+
+    hasTypeInfo = true;
+}
+
+void BytecodeBuilder::enableDebugInfoSidecar()
+{
+    LUAU_ASSERT(functions.empty());
+
+    hasDebugSidecar = true;
+}
+
+void BytecodeBuilder::setFunctionTypeInfo(std::string value)
+{
+    LUAU_ASSERT(hasTypeInfo);
+
+    functions[currentFunction].typeinfo = std::move(value);
+}
+
+void BytecodeBuilder::setTargetVersion(uint8_t version)
+{
+    LUAU_ASSERT(functions.empty());
+    LUAU_ASSERT(version >= LBC_VERSION_MIN && version <= LBC_VERSION_MAX);
+
+    targetVersion = version;
+}
+
 void BytecodeBuilder::setDebugFunctionName(StringRef name)
 {
     unsigned int index = addStringTableEntry(name);
@@ -530,7 +551,7 @@ void BytecodeBuilder::setDebugLine(int line)
 
 void BytecodeBuilder::pushDebugLocal(StringRef name, uint8_t reg, uint32_t startpc, uint32_t endpc)
 {
-    unsigned int index = addStringTableEntry(name);
+    unsigned int index = addDebugStringTableEntry(name);
 
     DebugLocal local;
     local.name = index;
@@ -543,7 +564,7 @@ void BytecodeBuilder::pushDebugLocal(StringRef name, uint8_t reg, uint32_t start
 
 void BytecodeBuilder::pushDebugUpval(StringRef name)
 {
-    unsigned int index = addStringTableEntry(name);
+    unsigned int index = addDebugStringTableEntry(name);
 
     DebugUpval upval;
     upval.name = index;
@@ -590,12 +611,12 @@ void BytecodeBuilder::finalize()
     bytecode.reserve(capacity);
 
     // assemble final bytecode blob
-    uint8_t version = getVersion();
+    uint8_t version = getEncodedVersion();
     LUAU_ASSERT(version >= LBC_VERSION_MIN && version <= LBC_VERSION_MAX);
 
     bytecode = char(version);
 
-    writeStringTable(bytecode);
+    writeStringTable(bytecode, stringTable);
 
     writeVarInt(bytecode, uint32_t(functions.size()));
 
@@ -604,6 +625,28 @@ void BytecodeBuilder::finalize()
 
     LUAU_ASSERT(mainFunction < functions.size());
     writeVarInt(bytecode, mainFunction);
+
+    if (hasDebugSidecar)
+    {
+        // sidecar layout: version, hash of the bytecode it belongs to, string table, offset of each function's entry, then the entries
+        debugInfo = char(LBC_DEBUGINFO_VERSION);
+        writeInt(debugInfo, getBytecodeHash(bytecode));
+
+        writeStringTable(debugInfo, debugStringTable);
+
+        writeVarInt(debugInfo, uint32_t(functions.size()));
+
+        uint32_t entryOffset = 0;
+
+        for (const Function& func : functions)
+        {
+            writeInt(debugInfo, entryOffset);
+            entryOffset += uint32_t(func.debugdata.size());
+        }
+
+        for (const Function& func : functions)
+            debugInfo += func.debugdata;
+    }
 }
 
 void BytecodeBuilder::writeFunction(std::string& ss, uint32_t id) const
@@ -617,6 +660,12 @@ void BytecodeBuilder::writeFunction(std::string& ss, uint32_t id) const
     writeByte(ss, func.numupvalues);
     writeByte(ss, func.isvararg);
 
+    if (getEncodedVersion() >= 4)
+    {
+        writeVarInt(ss, uint32_t(func.typeinfo.size()));
+        ss.append(func.typeinfo);
+    }
+
     // instructions
     writeVarInt(ss, uint32_t(insns.size()));
 
@@ -697,6 +746,19 @@ void BytecodeBuilder::writeFunction(std::string& ss, uint32_t id) const
     writeVarInt(ss, func.debuglinedefined);
     writeVarInt(ss, func.debugname);
 
+    if (hasDebugSidecar)
+    {
+        writeByte(ss, 0);
+        writeByte(ss, 0);
+    }
+    else
+    {
+        writeDebugInfo(ss);
+    }
+}
+
+void BytecodeBuilder::writeDebugInfo(std::string& ss) const
+{
     bool hasLines = true;
 
     for (int line : lines)
@@ -829,11 +891,11 @@ void BytecodeBuilder::writeLineInfo(std::string& ss) const
     }
 }
 
-void BytecodeBuilder::writeStringTable(std::string& ss) const
+void BytecodeBuilder::writeStringTable(std::string& ss, const DenseHashMap<StringRef, unsigned int, StringRefHash>& table) const
 {
-    std::vector<StringRef> strings(stringTable.size());
+    std::vector<StringRef> strings(table.size());
 
-    for (auto& p : stringTable)
+    for (auto& p : table)
     {
         LUAU_ASSERT(p.second > 0 && p.second <= strings.size());
         strings[p.second - 1] = p.first;
@@ -871,15 +933,37 @@ uint32_t BytecodeBuilder::getImportId(int32_t id0, int32_t id1, int32_t id2)
 
 uint32_t BytecodeBuilder::getStringHash(StringRef key)
 {
-    // This hashing algorithm should match luaS_hash defined in VM/lstring.cpp for short inputs; we can't use that code directly to keep compiler and
-    // VM independent in terms of compilation/linking. The resulting string hashes are embedded into bytecode binary and result in a better initial
-    // guess for the field hashes which improves performance during initial code execution. We omit the long string processing here for simplicity, as
-    // it doesn't really matter on long identifiers.
+    // This hashing algorithm should match luaS_hash defined in VM/lstring.cpp; we can't use that code directly to keep compiler and VM independent
+    // in terms of compilation/linking. The resulting string hashes are embedded into bytecode binary and result in a better initial guess for the
+    // field hashes which improves performance during initial code execution.
     const char* str = key.data;
     size_t len = key.length;
 
+    unsigned int a = 0, b = 0;
     unsigned int h = unsigned(len);
 
+    // hash prefix in 12b chunks (using aligned reads) with ARX based hash (LuaJIT v2.1, lookup3)
+    // note that we stop at length<32 to maintain compatibility with Lua 5.1
+    while (len >= 32)
+    {
+#define rol(x, s) ((x >> s) | (x << (32 - s)))
+#define mix(u, v, w) a ^= h, a -= rol(h, u), b ^= a, b -= rol(a, v), h ^= b, h -= rol(b, w)
+
+        // should compile into fast unaligned reads
+        uint32_t block[3];
+        memcpy(block, str, 12);
+
+        a += block[0];
+        b += block[1];
+        h += block[2];
+        mix(14, 11, 25);
+        str += 12;
+        len -= 12;
+
+#undef mix
+#undef rol
+    }
+
     // original Lua 5.1 hash for compatibility (exact match when len<32)
     for (size_t i = len; i > 0; --i)
         h ^= (h << 5) + (h >> 2) + (uint8_t)str[i - 1];
@@ -1059,116 +1143,1105 @@ void BytecodeBuilder::expandJumps()
     lines.swap(newlines);
 }
 
-std::string BytecodeBuilder::getError(const std::string& message)
+// register effects of a single instruction; used by optimizeRegisters
+struct RegisterEffects
 {
-    // 0 acts as a special marker for error bytecode (it's equal to LBC_VERSION_TARGET for valid bytecode blobs)
-    std::string result;
-    result += char(0);
-    result += message;
+    std::bitset<256> uses;
+    std::bitset<256> defs;     // registers that are always written
+    std::bitset<256> clobbers; // registers that may be written; includes defs
+};
 
-    return result;
-}
+// basic block of the control flow graph built by optimizeRegisters; instructions are [start, end) indices in the instruction offset list
+struct RegisterBlock
+{
+    uint32_t start = 0;
+    uint32_t end = 0;
 
-uint8_t BytecodeBuilder::getVersion()
+    int successors[2] = {-1, -1};
+
+    std::bitset<256> liveIn;
+    std::bitset<256> liveOut;
+};
+
+static void addRegisterRange(std::bitset<256>& set, int start, int count)
 {
-    // This function usually returns LBC_VERSION_TARGET but may sometimes return a higher number (within LBC_VERSION_MIN/MAX) under fast flags
-    return LBC_VERSION_TARGET;
+    for (int i = start; i < start + count && i < 256; ++i)
+        set.set(i);
 }
 
-#ifdef LUAU_ASSERTENABLED
-void BytecodeBuilder::validate() const
+static void addRegisterTail(std::bitset<256>& set, int start)
 {
-#define VREG(v) LUAU_ASSERT(unsigned(v) < func.maxstacksize)
-#define VREGRANGE(v, count) LUAU_ASSERT(unsigned(v + (count < 0 ? 0 : count)) <= func.maxstacksize)
-#define VUPVAL(v) LUAU_ASSERT(unsigned(v) < func.numupvalues)
-#define VCONST(v, kind) LUAU_ASSERT(unsigned(v) < constants.size() && constants[v].type == Constant::Type_##kind)
-#define VCONSTANY(v) LUAU_ASSERT(unsigned(v) < constants.size())
-#define VJUMP(v) LUAU_ASSERT(size_t(i + 1 + v) < insns.size() && insnvalid[i + 1 + v])
-
-    LUAU_ASSERT(currentFunction != ~0u);
+    addRegisterRange(set, start, 256 - start);
+}
 
-    const Function& func = functions[currentFunction];
+static void getRegisterEffects(const std::vector<uint32_t>& insns, size_t pc, RegisterEffects& effects)
+{
+    uint32_t insn = insns[pc];
+    LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
 
-    // first pass: tag instruction offsets so that we can validate jumps
-    std::vector<uint8_t> insnvalid(insns.size(), false);
+    int a = LUAU_INSN_A(insn);
+    int b = LUAU_INSN_B(insn);
+    int c = LUAU_INSN_C(insn);
 
-    for (size_t i = 0; i < insns.size();)
+    switch (op)
     {
-        uint8_t op = LUAU_INSN_OP(insns[i]);
+    case LOP_NOP:
+    case LOP_JUMP:
+    case LOP_JUMPBACK:
+    case LOP_JUMPX:
+    case LOP_COVERAGE:
+    case LOP_CLOSEUPVALS: // registers captured by reference are never optimized
+        break;
 
-        insnvalid[i] = true;
+    case LOP_LOADNIL:
+    case LOP_LOADB:
+    case LOP_LOADN:
+    case LOP_LOADK:
+    case LOP_LOADKX:
+    case LOP_GETGLOBAL:
+    case LOP_GETUPVAL:
+    case LOP_GETIMPORT:
+    case LOP_NEWCLOSURE:
+    case LOP_DUPCLOSURE:
+    case LOP_NEWTABLE:
+    case LOP_DUPTABLE:
+        effects.defs.set(a);
+        break;
 
-        i += getOpLength(LuauOpcode(op));
-        LUAU_ASSERT(i <= insns.size());
-    }
+    case LOP_MOVE:
+    case LOP_GETTABLEKS:
+    case LOP_GETTABLEN:
+    case LOP_ADDK:
+    case LOP_SUBK:
+    case LOP_MULK:
+    case LOP_DIVK:
+    case LOP_MODK:
+    case LOP_POWK:
+    case LOP_ANDK:
+    case LOP_ORK:
+    case LOP_NOT:
+    case LOP_MINUS:
+    case LOP_LENGTH:
+        effects.uses.set(b);
+        effects.defs.set(a);
+        break;
 
-    std::vector<uint8_t> openCaptures;
+    case LOP_GETTABLE:
+    case LOP_ADD:
+    case LOP_SUB:
+    case LOP_MUL:
+    case LOP_DIV:
+    case LOP_MOD:
+    case LOP_POW:
+    case LOP_AND:
+    case LOP_OR:
+        effects.uses.set(b);
+        effects.uses.set(c);
+        effects.defs.set(a);
+        break;
 
-    // second pass: validate the rest of the bytecode
-    for (size_t i = 0; i < insns.size();)
-    {
-        uint32_t insn = insns[i];
-        uint8_t op = LUAU_INSN_OP(insn);
+    case LOP_SETGLOBAL:
+    case LOP_SETUPVAL:
+    case LOP_JUMPIF:
+    case LOP_JUMPIFNOT:
+    case LOP_JUMPXEQKNIL:
+    case LOP_JUMPXEQKB:
+    case LOP_JUMPXEQKN:
+    case LOP_JUMPXEQKS:
+        effects.uses.set(a);
+        break;
 
-        switch (op)
-        {
-        case LOP_LOADNIL:
-            VREG(LUAU_INSN_A(insn));
-            break;
+    case LOP_SETTABLEKS:
+    case LOP_SETTABLEN:
+        effects.uses.set(a);
+        effects.uses.set(b);
+        break;
 
-        case LOP_LOADB:
-            VREG(LUAU_INSN_A(insn));
-            LUAU_ASSERT(LUAU_INSN_B(insn) == 0 || LUAU_INSN_B(insn) == 1);
-            VJUMP(LUAU_INSN_C(insn));
-            break;
+    case LOP_SETTABLE:
+        effects.uses.set(a);
+        effects.uses.set(b);
+        effects.uses.set(c);
+        break;
 
-        case LOP_LOADN:
-            VREG(LUAU_INSN_A(insn));
-            break;
+    case LOP_JUMPIFEQ:
+    case LOP_JUMPIFLE:
+    case LOP_JUMPIFLT:
+    case LOP_JUMPIFNOTEQ:
+    case LOP_JUMPIFNOTLE:
+    case LOP_JUMPIFNOTLT:
+        effects.uses.set(a);
+        effects.uses.set(insns[pc + 1] & 0xff);
+        break;
 
-        case LOP_LOADK:
-            VREG(LUAU_INSN_A(insn));
-            VCONSTANY(LUAU_INSN_D(insn));
-            break;
+    case LOP_NAMECALL:
+        effects.uses.set(b);
+        effects.defs.set(a);
+        effects.defs.set(a + 1);
+        break;
 
-        case LOP_MOVE:
-            VREG(LUAU_INSN_A(insn));
-            VREG(LUAU_INSN_B(insn));
-            break;
+    case LOP_CALL:
+        // callee frame starts right after the function register, so everything above it is overwritten
+        if (b)
+            addRegisterRange(effects.uses, a, b);
+        else
+            addRegisterTail(effects.uses, a);
 
-        case LOP_GETGLOBAL:
-        case LOP_SETGLOBAL:
-            VREG(LUAU_INSN_A(insn));
-            VCONST(insns[i + 1], String);
-            break;
+        if (c)
+            addRegisterRange(effects.defs, a, c - 1);
 
-        case LOP_GETUPVAL:
-        case LOP_SETUPVAL:
-            VREG(LUAU_INSN_A(insn));
-            VUPVAL(LUAU_INSN_B(insn));
-            break;
+        addRegisterTail(effects.clobbers, a);
+        break;
 
-        case LOP_CLOSEUPVALS:
-            VREG(LUAU_INSN_A(insn));
-            while (openCaptures.size() && openCaptures.back() >= LUAU_INSN_A(insn))
-                openCaptures.pop_back();
-            break;
+    case LOP_RETURN:
+        if (b)
+            addRegisterRange(effects.uses, a, b - 1);
+        else
+            addRegisterTail(effects.uses, a);
+        break;
 
-        case LOP_GETIMPORT:
-            VREG(LUAU_INSN_A(insn));
-            VCONST(LUAU_INSN_D(insn), Import);
-            // TODO: check insn[i + 1] for conformance with 10-bit import encoding
-            break;
+    case LOP_CONCAT:
+        addRegisterRange(effects.uses, b, c - b + 1);
+        effects.defs.set(a);
+        break;
 
-        case LOP_GETTABLE:
-        case LOP_SETTABLE:
-            VREG(LUAU_INSN_A(insn));
-            VREG(LUAU_INSN_B(insn));
-            VREG(LUAU_INSN_C(insn));
-            break;
+    case LOP_CONCATACC:
+    {
+        // the target is only written when the accumulator isn't active, and the scratch register is only written on the slow path
+        int acc = insns[pc + 1] & 0xff;
 
-        case LOP_GETTABLEKS:
-        case LOP_SETTABLEKS:
+        effects.uses.set(a);
+        addRegisterRange(effects.uses, b + 1, c - b);
+        addRegisterRange(effects.uses, acc, 2);
+        effects.clobbers.set(a);
+        addRegisterRange(effects.clobbers, b, c - b + 1);
+        addRegisterRange(effects.clobbers, acc, 2);
+        break;
+    }
+
+    case LOP_FLUSHACC:
+        effects.uses.set(a);
+        addRegisterRange(effects.uses, b, 2);
+        effects.clobbers.set(a);
+        effects.clobbers.set(b);
+        break;
+
+    case LOP_SETLIST:
+        effects.uses.set(a);
+
+        if (c)
+            addRegisterRange(effects.uses, b, c - 1);
+        else
+            addRegisterTail(effects.uses, b);
+        break;
+
+    case LOP_FORNPREP:
+    case LOP_FORNLOOP:
+    case LOP_FORGPREP:
+    case LOP_FORGPREP_INEXT:
+    case LOP_FORGPREP_NEXT:
+        addRegisterRange(effects.uses, a, 3);
+        addRegisterRange(effects.clobbers, a, 3);
+        break;
+
+    case LOP_FORGLOOP:
+        // generator call is placed after the loop state, and its results are copied to the loop variables
+        addRegisterRange(effects.uses, a, 3);
+        addRegisterTail(effects.clobbers, a + 2);
+        break;
+
+    case LOP_GETVARARGS:
+        if (b)
+            addRegisterRange(effects.defs, a, b - 1);
+        else
+            addRegisterTail(effects.clobbers, a);
+        break;
+
+    case LOP_PREPVARARGS:
+        addRegisterRange(effects.uses, 0, a);
+        break;
+
+    case LOP_CAPTURE:
+        if (a == LCT_VAL || a == LCT_REF)
+            effects.uses.set(b);
+        break;
+
+    case LOP_FASTCALL:
+    case LOP_FASTCALL1:
+    case LOP_FASTCALL2:
+    case LOP_FASTCALL2K:
+    {
+        // builtins read arguments from the CALL that follows and write results in its place when the fast path succeeds
+        RegisterEffects call;
+        getRegisterEffects(insns, pc + c + 1, call);
+
+        effects.uses = call.uses;
+        effects.clobbers = call.clobbers;
+
+        if (op != LOP_FASTCALL)
+            effects.uses.set(b);
+
+        if (op == LOP_FASTCALL2)
+            effects.uses.set(insns[pc + 1] & 0xff);
+        break;
+    }
+
+    default:
+        // BREAK and unknown instructions are treated as barriers that read and write everything
+        effects.uses.set();
+        effects.clobbers.set();
+        break;
+    }
+
+    effects.clobbers |= effects.defs;
+}
+
+// instructions that only write their target register and have no other observable effects, so they can be removed when the target is dead
+// allocations are kept so that code that deliberately creates garbage behaves the same way
+static bool isRemovableDef(uint32_t insn)
+{
+    switch (LUAU_INSN_OP(insn))
+    {
+    case LOP_LOADNIL:
+    case LOP_LOADN:
+    case LOP_LOADK:
+    case LOP_LOADKX:
+    case LOP_MOVE:
+    case LOP_GETUPVAL:
+    case LOP_AND:
+    case LOP_OR:
+    case LOP_ANDK:
+    case LOP_ORK:
+    case LOP_NOT:
+        return true;
+
+    case LOP_LOADB:
+        return LUAU_INSN_C(insn) == 0;
+
+    default:
+        return false;
+    }
+}
+
+// instructions that write a single target register in A that can be changed to a different register
+static bool isRetargetableDef(uint32_t insn)
+{
+    switch (LUAU_INSN_OP(insn))
+    {
+    case LOP_LOADNIL:
+    case LOP_LOADN:
+    case LOP_LOADK:
+    case LOP_LOADKX:
+    case LOP_MOVE:
+    case LOP_GETGLOBAL:
+    case LOP_GETUPVAL:
+    case LOP_GETIMPORT:
+    case LOP_GETTABLE:
+    case LOP_GETTABLEKS:
+    case LOP_GETTABLEN:
+    case LOP_DUPCLOSURE:
+    case LOP_NEWTABLE:
+    case LOP_DUPTABLE:
+    case LOP_ADD:
+    case LOP_SUB:
+    case LOP_MUL:
+    case LOP_DIV:
+    case LOP_MOD:
+    case LOP_POW:
+    case LOP_ADDK:
+    case LOP_SUBK:
+    case LOP_MULK:
+    case LOP_DIVK:
+    case LOP_MODK:
+    case LOP_POWK:
+    case LOP_AND:
+    case LOP_OR:
+    case LOP_ANDK:
+    case LOP_ORK:
+    case LOP_CONCAT:
+    case LOP_NOT:
+    case LOP_MINUS:
+    case LOP_LENGTH:
+        return true;
+
+    case LOP_LOADB:
+        return LUAU_INSN_C(insn) == 0;
+
+    default:
+        return false;
+    }
+}
+
+// instructions that can't invoke metamethods or call functions, so they can't change the value of imported globals
+static bool isImportTransparent(LuauOpcode op)
+{
+    switch (op)
+    {
+    case LOP_NOP:
+    case LOP_COVERAGE:
+    case LOP_LOADNIL:
+    case LOP_LOADB:
+    case LOP_LOADN:
+    case LOP_LOADK:
+    case LOP_LOADKX:
+    case LOP_MOVE:
+    case LOP_GETUPVAL:
+    case LOP_SETUPVAL:
+    case LOP_GETIMPORT:
+    case LOP_NEWCLOSURE:
+    case LOP_DUPCLOSURE:
+    case LOP_CAPTURE:
+    case LOP_NEWTABLE:
+    case LOP_DUPTABLE:
+    case LOP_AND:
+    case LOP_OR:
+    case LOP_ANDK:
+    case LOP_ORK:
+    case LOP_NOT:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// instructions that can't allocate, invoke metamethods or call functions, so garbage collection can't observe registers while they run
+static bool isCollectorTransparent(LuauOpcode op)
+{
+    switch (op)
+    {
+    case LOP_NOP:
+    case LOP_COVERAGE:
+    case LOP_LOADNIL:
+    case LOP_LOADB:
+    case LOP_LOADN:
+    case LOP_LOADK:
+    case LOP_LOADKX:
+    case LOP_MOVE:
+    case LOP_GETUPVAL:
+    case LOP_AND:
+    case LOP_OR:
+    case LOP_ANDK:
+    case LOP_ORK:
+    case LOP_NOT:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+static uint32_t replaceA(uint32_t insn, uint8_t value)
+{
+    return (insn & ~0xff00u) | (uint32_t(value) << 8);
+}
+
+static uint32_t replaceB(uint32_t insn, uint8_t value)
+{
+    return (insn & ~0xff0000u) | (uint32_t(value) << 16);
+}
+
+static uint32_t replaceC(uint32_t insn, uint8_t value)
+{
+    return (insn & ~0xff000000u) | (uint32_t(value) << 24);
+}
+
+// replaces registers that are read as standalone values (and not as a part of a register range) according to the mapping
+static void renameRegisterReads(std::vector<uint32_t>& insns, size_t pc, const uint8_t* mapping)
+{
+    uint32_t insn = insns[pc];
+
+    uint8_t a = mapping[LUAU_INSN_A(insn)];
+    uint8_t b = mapping[LUAU_INSN_B(insn)];
+    uint8_t c = mapping[LUAU_INSN_C(insn)];
+
+    switch (LUAU_INSN_OP(insn))
+    {
+    case LOP_MOVE:
+    case LOP_GETTABLEKS:
+    case LOP_GETTABLEN:
+    case LOP_NAMECALL:
+    case LOP_ADDK:
+    case LOP_SUBK:
+    case LOP_MULK:
+    case LOP_DIVK:
+    case LOP_MODK:
+    case LOP_POWK:
+    case LOP_ANDK:
+    case LOP_ORK:
+    case LOP_NOT:
+    case LOP_MINUS:
+    case LOP_LENGTH:
+        insns[pc] = replaceB(insn, b);
+        break;
+
+    case LOP_GETTABLE:
+    case LOP_ADD:
+    case LOP_SUB:
+    case LOP_MUL:
+    case LOP_DIV:
+    case LOP_MOD:
+    case LOP_POW:
+    case LOP_AND:
+    case LOP_OR:
+        insns[pc] = replaceC(replaceB(insn, b), c);
+        break;
+
+    case LOP_SETGLOBAL:
+    case LOP_SETUPVAL:
+    case LOP_JUMPIF:
+    case LOP_JUMPIFNOT:
+    case LOP_JUMPXEQKNIL:
+    case LOP_JUMPXEQKB:
+    case LOP_JUMPXEQKN:
+    case LOP_JUMPXEQKS:
+        insns[pc] = replaceA(insn, a);
+        break;
+
+    case LOP_SETTABLEKS:
+    case LOP_SETTABLEN:
+        insns[pc] = replaceB(replaceA(insn, a), b);
+        break;
+
+    case LOP_SETTABLE:
+        insns[pc] = replaceC(replaceB(replaceA(insn, a), b), c);
+        break;
+
+    case LOP_JUMPIFEQ:
+    case LOP_JUMPIFLE:
+    case LOP_JUMPIFLT:
+    case LOP_JUMPIFNOTEQ:
+    case LOP_JUMPIFNOTLE:
+    case LOP_JUMPIFNOTLT:
+        insns[pc] = replaceA(insn, a);
+        insns[pc + 1] = mapping[insns[pc + 1] & 0xff];
+        break;
+
+    default:
+        break;
+    }
+}
+
+void BytecodeBuilder::optimizeRegisters()
+{
+    // jump trampolines and local debug info refer to instruction and register positions that this pass would have to preserve
+    if (hasLongJumps || !debugLocals.empty())
+        return;
+
+    // collect instruction offsets; instructions between FASTCALL and the matching CALL are fixed since FASTCALL skips over them by offset
+    std::vector<uint32_t> offsets;
+    std::vector<bool> removed(insns.size());
+    std::vector<bool> fixed(insns.size());
+    std::bitset<256> pinned;
+
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint32_t insn = insns[i];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+
+        offsets.push_back(uint32_t(i));
+
+        if (isFastCall(op))
+        {
+            for (int j = 1; j <= LUAU_INSN_C(insn) + 1; ++j)
+                fixed[i + j] = true;
+        }
+
+        // registers captured by reference can be read and written by other closures at any call
+        if (op == LOP_CAPTURE && LUAU_INSN_A(insn) == LCT_REF)
+            pinned.set(LUAU_INSN_B(insn));
+
+        i += getOpLength(op);
+    }
+
+    // build basic blocks: every jump target and every instruction after a branch starts a new block
+    std::vector<bool> leader(insns.size() + 1);
+    leader[0] = true;
+
+    for (uint32_t pc : offsets)
+    {
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insns[pc]));
+        int target = getJumpTarget(insns[pc], pc);
+
+        if (target >= 0 || op == LOP_RETURN)
+            leader[pc + getOpLength(op)] = true;
+
+        if (target >= 0)
+            leader[target] = true;
+    }
+
+    std::vector<RegisterBlock> blocks;
+    std::vector<int> blockAt(insns.size(), -1);
+
+    for (uint32_t i = 0; i < offsets.size(); ++i)
+    {
+        if (leader[offsets[i]])
+        {
+            if (!blocks.empty())
+                blocks.back().end = i;
+
+            blocks.push_back(RegisterBlock());
+            blocks.back().start = i;
+        }
+
+        blockAt[offsets[i]] = int(blocks.size()) - 1;
+    }
+
+    blocks.back().end = uint32_t(offsets.size());
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        RegisterBlock& block = blocks[i];
+
+        uint32_t pc = offsets[block.end - 1];
+        uint32_t insn = insns[pc];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+        int target = getJumpTarget(insn, pc);
+
+        bool fallthrough = op != LOP_RETURN && op != LOP_JUMP && op != LOP_JUMPBACK && op != LOP_JUMPX && op != LOP_FORGPREP &&
+                           op != LOP_FORGPREP_INEXT && op != LOP_FORGPREP_NEXT;
+
+        if (fallthrough && i + 1 < blocks.size())
+            block.successors[0] = int(i + 1);
+
+        if (target >= 0)
+        {
+            LUAU_ASSERT(size_t(target) < insns.size() && blockAt[target] >= 0);
+            block.successors[1] = blockAt[target];
+        }
+    }
+
+    auto computeLiveness = [&]() {
+        for (RegisterBlock& block : blocks)
+        {
+            block.liveIn.reset();
+            block.liveOut.reset();
+        }
+
+        bool changed = true;
+
+        while (changed)
+        {
+            changed = false;
+
+            for (size_t i = blocks.size(); i > 0; --i)
+            {
+                RegisterBlock& block = blocks[i - 1];
+
+                std::bitset<256> live;
+
+                for (int succ : block.successors)
+                    if (succ >= 0)
+                        live |= blocks[succ].liveIn;
+
+                block.liveOut = live;
+
+                for (uint32_t j = block.end; j > block.start; --j)
+                {
+                    uint32_t pc = offsets[j - 1];
+
+                    if (removed[pc])
+                        continue;
+
+                    RegisterEffects effects;
+                    getRegisterEffects(insns, pc, effects);
+
+                    live = (live & ~effects.defs) | effects.uses;
+                }
+
+                if (live != block.liveIn)
+                {
+                    block.liveIn = live;
+                    changed = true;
+                }
+            }
+        }
+    };
+
+    // looks for the instruction that computes the source of the MOVE at offsets[index] and retargets it to the MOVE target
+    auto coalesceMove = [&](const RegisterBlock& block, uint32_t index) {
+        uint8_t target = LUAU_INSN_A(insns[offsets[index]]);
+        uint8_t source = LUAU_INSN_B(insns[offsets[index]]);
+
+        for (uint32_t k = index; k > block.start && index - k < kMaxCoalesceDistance; --k)
+        {
+            uint32_t pc = offsets[k - 1];
+
+            if (removed[pc])
+                continue;
+
+            if (fixed[pc])
+                return false;
+
+            if (isRetargetableDef(insns[pc]) && LUAU_INSN_A(insns[pc]) == source)
+            {
+                insns[pc] = replaceA(insns[pc], target);
+                return true;
+            }
+
+            // both registers must be left untouched between the definition and the MOVE
+            RegisterEffects effects;
+            getRegisterEffects(insns, pc, effects);
+
+            if (effects.uses.test(target) || effects.clobbers.test(target) || effects.uses.test(source) || effects.clobbers.test(source))
+                return false;
+        }
+
+        return false;
+    };
+
+    // forward pass over each block: propagate register copies into the instructions that read them and reuse loaded imports
+    for (RegisterBlock& block : blocks)
+    {
+        uint8_t copies[256];
+        for (int r = 0; r < 256; ++r)
+            copies[r] = uint8_t(r);
+
+        std::vector<uint8_t> copied;
+        std::vector<std::pair<uint32_t, uint8_t>> imports;
+        std::bitset<256> nils;
+
+        for (uint32_t j = block.start; j < block.end; ++j)
+        {
+            uint32_t pc = offsets[j];
+
+            if (removed[pc])
+                continue;
+
+            if (!fixed[pc])
+                renameRegisterReads(insns, pc, copies);
+
+            LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insns[pc]));
+
+            if (op == LOP_GETIMPORT && !fixed[pc])
+            {
+                uint8_t target = LUAU_INSN_A(insns[pc]);
+
+                for (auto& import : imports)
+                {
+                    if (import.first == insns[pc + 1] && import.second != target)
+                    {
+                        insns[pc] = LOP_MOVE | (uint32_t(target) << 8) | (uint32_t(import.second) << 16);
+                        removed[pc + 1] = true;
+
+                        op = LOP_MOVE;
+                        break;
+                    }
+                }
+            }
+
+            // repeated nil stores to the same register are redundant
+            if (op == LOP_LOADNIL && nils.test(LUAU_INSN_A(insns[pc])) && !fixed[pc])
+            {
+                removed[pc] = true;
+                continue;
+            }
+
+            RegisterEffects effects;
+            getRegisterEffects(insns, pc, effects);
+
+            nils &= ~effects.clobbers;
+
+            if (op == LOP_LOADNIL)
+                nils.set(LUAU_INSN_A(insns[pc]));
+
+            // forget copies where either side was overwritten
+            for (size_t k = 0; k < copied.size();)
+            {
+                uint8_t r = copied[k];
+
+                if (effects.clobbers.test(r) || effects.clobbers.test(copies[r]))
+                {
+                    copies[r] = r;
+                    copied[k] = copied.back();
+                    copied.pop_back();
+                }
+                else
+                {
+                    k++;
+                }
+            }
+
+            if (!isImportTransparent(op))
+            {
+                imports.clear();
+            }
+            else
+            {
+                for (size_t k = 0; k < imports.size();)
+                {
+                    if (effects.clobbers.test(imports[k].second))
+                    {
+                        imports[k] = imports.back();
+                        imports.pop_back();
+                    }
+                    else
+                    {
+                        k++;
+                    }
+                }
+            }
+
+            uint8_t a = LUAU_INSN_A(insns[pc]);
+            uint8_t b = LUAU_INSN_B(insns[pc]);
+
+            if (op == LOP_GETIMPORT && !pinned.test(a))
+                imports.push_back({insns[pc + 1], a});
+
+            if (op == LOP_MOVE && a != b && !pinned.test(a) && !pinned.test(b))
+            {
+                copies[a] = b;
+                copied.push_back(a);
+            }
+        }
+    }
+
+    // backward pass over each block: merge temporaries into the registers they are moved to and remove writes to dead registers
+    // removing instructions can make other writes dead, so this repeats until nothing changes
+    bool changed = true;
+
+    while (changed)
+    {
+        changed = false;
+
+        computeLiveness();
+
+        for (RegisterBlock& block : blocks)
+        {
+            std::bitset<256> live = block.liveOut;
+
+            // registers that are written later in the block with no chance for garbage collection to observe the register in between
+            std::bitset<256> overwritten;
+
+            for (uint32_t j = block.end; j > block.start; --j)
+            {
+                uint32_t pc = offsets[j - 1];
+
+                if (removed[pc])
+                    continue;
+
+                uint32_t insn = insns[pc];
+                LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+                uint8_t a = LUAU_INSN_A(insn);
+                uint8_t b = LUAU_INSN_B(insn);
+
+                // removing a store keeps the previous value of the register alive, so stores are only removed when the register is overwritten
+                // before garbage collection could observe the difference; this keeps explicit nil assignments that release references intact
+                bool dead = !live.test(a) && overwritten.test(a);
+
+                if (!fixed[pc] && isRemovableDef(insn) && !pinned.test(a) && (dead || (op == LOP_MOVE && a == b)))
+                {
+                    for (int k = 0; k < getOpLength(op); ++k)
+                        removed[pc + k] = true;
+
+                    changed = true;
+                    continue;
+                }
+
+                // when the moved temporary is dead, the instruction that computed it can write to the target register directly
+                if (op == LOP_MOVE && !fixed[pc] && a != b && !pinned.test(a) && !pinned.test(b) && !live.test(b) && coalesceMove(block, j - 1))
+                {
+                    removed[pc] = true;
+
+                    changed = true;
+                    continue;
+                }
+
+                RegisterEffects effects;
+                getRegisterEffects(insns, pc, effects);
+
+                live = (live & ~effects.defs) | effects.uses;
+
+                if (isCollectorTransparent(op))
+                    overwritten |= effects.defs;
+                else
+                    overwritten.reset();
+            }
+        }
+    }
+
+    // compact the instruction stream and update jump offsets, jump records and remarks
+    std::vector<uint32_t> remap(insns.size() + 1);
+    std::vector<uint32_t> newinsns;
+    std::vector<int> newlines;
+
+    newinsns.reserve(insns.size());
+    newlines.reserve(insns.size());
+
+    for (size_t i = 0; i < insns.size(); ++i)
+    {
+        remap[i] = uint32_t(newinsns.size());
+
+        if (!removed[i])
+        {
+            newinsns.push_back(insns[i]);
+            newlines.push_back(lines[i]);
+        }
+    }
+
+    remap[insns.size()] = uint32_t(newinsns.size());
+
+    if (newinsns.size() == insns.size())
+        return;
+
+    for (uint32_t pc : offsets)
+    {
+        if (removed[pc])
+            continue;
+
+        uint32_t insn = insns[pc];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+        int target = getJumpTarget(insn, pc);
+
+        if (target < 0)
+            continue;
+
+        int offset = int(remap[target]) - int(remap[pc]) - 1;
+        uint32_t& newinsn = newinsns[remap[pc]];
+
+        if (isJumpD(op))
+        {
+            LUAU_ASSERT(int16_t(offset) == offset);
+
+            newinsn &= 0xffff;
+            newinsn |= uint16_t(offset) << 16;
+        }
+        else if (isSkipC(op))
+        {
+            LUAU_ASSERT(uint8_t(offset) == offset);
+
+            newinsn = replaceC(newinsn, uint8_t(offset));
+        }
+        else
+        {
+            // instructions covered by FASTCALL are never removed
+            LUAU_ASSERT(isFastCall(op) && offset == LUAU_INSN_C(insn) + 1);
+        }
+    }
+
+    for (Jump& jump : jumps)
+    {
+        jump.source = remap[jump.source];
+        jump.target = remap[jump.target];
+    }
+
+    for (auto& remark : debugRemarks)
+        remark.first = remap[remark.first];
+
+    insns.swap(newinsns);
+    lines.swap(newlines);
+}
+
+struct FusedInstruction
+{
+    LuauOpcode op;
+    LuauOpcode first;
+    LuauOpcode second;
+};
+
+// the pairs were chosen based on the opcode pair frequencies in the benchmark suite, see lua_getopstats
+static const FusedInstruction kFusedInstructions[] = {
+    {LOP_MOVE_MOVE, LOP_MOVE, LOP_MOVE},
+    {LOP_MOVE_CALL, LOP_MOVE, LOP_CALL},
+    {LOP_GETUPVAL_CALL, LOP_GETUPVAL, LOP_CALL},
+    {LOP_GETTABLE_GETTABLE, LOP_GETTABLE, LOP_GETTABLE},
+    {LOP_GETTABLE_ADD, LOP_GETTABLE, LOP_ADD},
+    {LOP_ADDK_GETTABLE, LOP_ADDK, LOP_GETTABLE},
+    {LOP_MUL_ADD, LOP_MUL, LOP_ADD},
+};
+
+static const FusedInstruction* getFusedInstruction(uint8_t op)
+{
+    for (const FusedInstruction& fused : kFusedInstructions)
+        if (fused.op == op)
+            return &fused;
+
+    return nullptr;
+}
+
+void BytecodeBuilder::fuseInstructions()
+{
+    LUAU_ASSERT(targetVersion >= 5);
+
+    for (size_t i = 0; i + 1 < insns.size(); i += getOpLength(LuauOpcode(LUAU_INSN_OP(insns[i]))))
+    {
+        // breakpoints are set on the first instruction of a line, and fused instructions run the next instruction without checking for one
+        if (lines[i] != lines[i + 1])
+            continue;
+
+        uint8_t op = LUAU_INSN_OP(insns[i]);
+        uint8_t next = LUAU_INSN_OP(insns[i + 1]);
+
+        for (const FusedInstruction& fused : kFusedInstructions)
+        {
+            if (fused.first == op && fused.second == next)
+            {
+                // operands stay the same; the next instruction may be fused as well, which is fine since it still starts with the same instruction
+                insns[i] = (insns[i] & ~0xff) | fused.op;
+                break;
+            }
+        }
+    }
+}
+
+std::string BytecodeBuilder::getError(const std::string& message)
+{
+    // 0 acts as a special marker for error bytecode (it's equal to LBC_VERSION_TARGET for valid bytecode blobs)
+    std::string result;
+    result += char(0);
+    result += message;
+
+    return result;
+}
+
+uint8_t BytecodeBuilder::getVersion()
+{
+    // This function usually returns LBC_VERSION_TARGET but may sometimes return a higher number (within LBC_VERSION_MIN/MAX) under fast flags
+    return LBC_VERSION_TARGET;
+}
+
+uint32_t BytecodeBuilder::getBytecodeHash(const std::string& bytecode)
+{
+    // FNV-1a; 0 is reserved for functions that don't have a sidecar, so the runtime computes the same hash with the same adjustment
+    uint32_t hash = 2166136261;
+
+    for (char ch : bytecode)
+    {
+        hash ^= uint8_t(ch);
+        hash *= 16777619;
+    }
+
+    return hash ? hash : 1;
+}
+
+uint8_t BytecodeBuilder::getEncodedVersion() const
+{
+    return std::max(targetVersion, hasTypeInfo ? uint8_t(4) : getVersion());
+}
+
+const char* BytecodeBuilder::getOpcodeName(uint8_t op)
+{
+    static const char* const kNames[] = {
+        "NOP", "BREAK", "LOADNIL", "LOADB", "LOADN", "LOADK", "MOVE", "GETGLOBAL", "SETGLOBAL", "GETUPVAL", "SETUPVAL", "CLOSEUPVALS", "GETIMPORT",
+        "GETTABLE", "SETTABLE", "GETTABLEKS", "SETTABLEKS", "GETTABLEN", "SETTABLEN", "NEWCLOSURE", "NAMECALL", "CALL", "RETURN", "JUMP", "JUMPBACK",
+        "JUMPIF", "JUMPIFNOT", "JUMPIFEQ", "JUMPIFLE", "JUMPIFLT", "JUMPIFNOTEQ", "JUMPIFNOTLE", "JUMPIFNOTLT", "ADD", "SUB", "MUL", "DIV", "MOD",
+        "POW", "ADDK", "SUBK", "MULK", "DIVK", "MODK", "POWK", "AND", "OR", "ANDK", "ORK", "CONCAT", "NOT", "MINUS", "LENGTH", "NEWTABLE", "DUPTABLE",
+        "SETLIST", "FORNPREP", "FORNLOOP", "FORGLOOP", "FORGPREP_INEXT", "DEP_FORGLOOP_INEXT", "FORGPREP_NEXT", "DEP_FORGLOOP_NEXT", "GETVARARGS",
+        "DUPCLOSURE", "PREPVARARGS", "LOADKX", "JUMPX", "FASTCALL", "COVERAGE", "CAPTURE", "DEP_JUMPIFEQK", "DEP_JUMPIFNOTEQK", "FASTCALL1",
+        "FASTCALL2", "FASTCALL2K", "FORGPREP", "JUMPXEQKNIL", "JUMPXEQKB", "JUMPXEQKN", "JUMPXEQKS", "MOVE_MOVE", "MOVE_CALL", "GETUPVAL_CALL",
+        "GETTABLE_GETTABLE", "GETTABLE_ADD", "ADDK_GETTABLE", "MUL_ADD", "CONCATACC", "FLUSHACC",
+    };
+
+    static_assert(sizeof(kNames) / sizeof(kNames[0]) == LOP__COUNT, "Opcode names must match LuauOpcode");
+
+    return op < LOP__COUNT ? kNames[op] : "UNKNOWN";
+}
+
+#ifdef LUAU_ASSERTENABLED
+void BytecodeBuilder::validate() const
+{
+#define VREG(v) LUAU_ASSERT(unsigned(v) < func.maxstacksize)
+#define VREGRANGE(v, count) LUAU_ASSERT(unsigned(v + (count < 0 ? 0 : count)) <= func.maxstacksize)
+#define VUPVAL(v) LUAU_ASSERT(unsigned(v) < func.numupvalues)
+#define VCONST(v, kind) LUAU_ASSERT(unsigned(v) < constants.size() && constants[v].type == Constant::Type_##kind)
+#define VCONSTANY(v) LUAU_ASSERT(unsigned(v) < constants.size())
+#define VJUMP(v) LUAU_ASSERT(size_t(i + 1 + v) < insns.size() && insnvalid[i + 1 + v])
+
+    LUAU_ASSERT(currentFunction != ~0u);
+
+    const Function& func = functions[currentFunction];
+
+    // first pass: tag instruction offsets so that we can validate jumps
+    std::vector<uint8_t> insnvalid(insns.size(), false);
+
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint8_t op = LUAU_INSN_OP(insns[i]);
+
+        insnvalid[i] = true;
+
+        i += getOpLength(LuauOpcode(op));
+        LUAU_ASSERT(i <= insns.size());
+    }
+
+    std::vector<uint8_t> openCaptures;
+
+    // second pass: validate the rest of the bytecode
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint32_t insn = insns[i];
+        uint8_t op = LUAU_INSN_OP(insn);
+
+        // fused instructions have the operands of the first instruction of the pair and have to be followed by the second one
+        if (const FusedInstruction* fused = getFusedInstruction(op))
+        {
+            LUAU_ASSERT(i + 1 < insns.size());
+
+            uint8_t next = LUAU_INSN_OP(insns[i + 1]);
+            const FusedInstruction* nextFused = getFusedInstruction(next);
+            LUAU_ASSERT((nextFused ? nextFused->first : next) == fused->second);
+
+            op = fused->first;
+        }
+
+        switch (op)
+        {
+        case LOP_LOADNIL:
+            VREG(LUAU_INSN_A(insn));
+            break;
+
+        case LOP_LOADB:
+            VREG(LUAU_INSN_A(insn));
+            LUAU_ASSERT(LUAU_INSN_B(insn) == 0 || LUAU_INSN_B(insn) == 1);
+            VJUMP(LUAU_INSN_C(insn));
+            break;
+
+        case LOP_LOADN:
+            VREG(LUAU_INSN_A(insn));
+            break;
+
+        case LOP_LOADK:
+            VREG(LUAU_INSN_A(insn));
+            VCONSTANY(LUAU_INSN_D(insn));
+            break;
+
+        case LOP_MOVE:
+            VREG(LUAU_INSN_A(insn));
+            VREG(LUAU_INSN_B(insn));
+            break;
+
+        case LOP_GETGLOBAL:
+        case LOP_SETGLOBAL:
+            VREG(LUAU_INSN_A(insn));
+            VCONST(insns[i + 1], String);
+            break;
+
+        case LOP_GETUPVAL:
+        case LOP_SETUPVAL:
+            VREG(LUAU_INSN_A(insn));
+            VUPVAL(LUAU_INSN_B(insn));
+            break;
+
+        case LOP_CLOSEUPVALS:
+            VREG(LUAU_INSN_A(insn));
+            while (openCaptures.size() && openCaptures.back() >= LUAU_INSN_A(insn))
+                openCaptures.pop_back();
+            break;
+
+        case LOP_GETIMPORT:
+            VREG(LUAU_INSN_A(insn));
+            VCONST(LUAU_INSN_D(insn), Import);
+            // TODO: check insn[i + 1] for conformance with 10-bit import encoding
+            break;
+
+        case LOP_GETTABLE:
+        case LOP_SETTABLE:
+            VREG(LUAU_INSN_A(insn));
+            VREG(LUAU_INSN_B(insn));
+            VREG(LUAU_INSN_C(insn));
+            break;
+
+        case LOP_GETTABLEKS:
+        case LOP_SETTABLEKS:
             VREG(LUAU_INSN_A(insn));
             VREG(LUAU_INSN_B(insn));
             VCONST(insns[i + 1], String);
@@ -1302,6 +2375,21 @@ void BytecodeBuilder::validate() const
             LUAU_ASSERT(LUAU_INSN_B(insn) <= LUAU_INSN_C(insn));
             break;
 
+        case LOP_CONCATACC:
+            VREG(LUAU_INSN_A(insn));
+            VREG(LUAU_INSN_B(insn));
+            VREG(LUAU_INSN_C(insn));
+            LUAU_ASSERT(LUAU_INSN_B(insn) < LUAU_INSN_C(insn));
+            VREG(insns[i + 1]);
+            VREG(insns[i + 1] + 1);
+            break;
+
+        case LOP_FLUSHACC:
+            VREG(LUAU_INSN_A(insn));
+            VREG(LUAU_INSN_B(insn));
+            VREG(LUAU_INSN_B(insn) + 1);
+            break;
+
         case LOP_NOT:
         case LOP_MINUS:
         case LOP_LENGTH:
@@ -1794,6 +2882,42 @@ void BytecodeBuilder::dumpInstruction(const uint32_t* code, std::string& result,
         code++;
         break;
 
+    case LOP_MOVE_MOVE:
+        formatAppend(result, "MOVE_MOVE R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn));
+        break;
+
+    case LOP_MOVE_CALL:
+        formatAppend(result, "MOVE_CALL R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn));
+        break;
+
+    case LOP_GETUPVAL_CALL:
+        formatAppend(result, "GETUPVAL_CALL R%d %d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn));
+        break;
+
+    case LOP_GETTABLE_GETTABLE:
+        formatAppend(result, "GETTABLE_GETTABLE R%d R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn), LUAU_INSN_C(insn));
+        break;
+
+    case LOP_GETTABLE_ADD:
+        formatAppend(result, "GETTABLE_ADD R%d R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn), LUAU_INSN_C(insn));
+        break;
+
+    case LOP_ADDK_GETTABLE:
+        formatAppend(result, "ADDK_GETTABLE R%d R%d K%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn), LUAU_INSN_C(insn));
+        break;
+
+    case LOP_MUL_ADD:
+        formatAppend(result, "MUL_ADD R%d R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn), LUAU_INSN_C(insn));
+        break;
+
+    case LOP_CONCATACC:
+        formatAppend(result, "CONCATACC R%d R%d R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn), LUAU_INSN_C(insn), *code);
+        break;
+
+    case LOP_FLUSHACC:
+        formatAppend(result, "FLUSHACC R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn));
+        break;
+
     default:
         LUAU_ASSERT(!"Unsupported opcode");
     }
@@ -1825,6 +2949,14 @@ std::string BytecodeBuilder::dumpCurrentFunction() const
         }
     }
 
+    if (dumpFlags & Dump_Types)
+    {
+        const std::string& typeinfo = functions[currentFunction].typeinfo;
+
+        if (!typeinfo.empty())
+            dumpTypeInfo(typeinfo, result);
+    }
+
     std::vector<int> labels(insns.size(), -1);
 
     // annotate valid jump targets with 0
@@ -1899,6 +3031,59 @@ std::string BytecodeBuilder::dumpCurrentFunction() const
     return result;
 }
 
+static const char* getBaseTypeString(uint8_t type)
+{
+    switch (type & ~LBC_TYPE_OPTIONAL_BIT)
+    {
+    case LBC_TYPE_NIL:
+        return "nil";
+    case LBC_TYPE_BOOLEAN:
+        return "boolean";
+    case LBC_TYPE_NUMBER:
+        return "number";
+    case LBC_TYPE_STRING:
+        return "string";
+    case LBC_TYPE_TABLE:
+        return "table";
+    case LBC_TYPE_FUNCTION:
+        return "function";
+    case LBC_TYPE_THREAD:
+        return "thread";
+    case LBC_TYPE_USERDATA:
+        return "userdata";
+    case LBC_TYPE_VECTOR:
+        return "vector";
+    case LBC_TYPE_ANY:
+        return "any";
+    }
+
+    LUAU_ASSERT(!"Unhandled type in getBaseTypeString");
+    return nullptr;
+}
+
+void BytecodeBuilder::dumpTypeInfo(const std::string& typeinfo, std::string& output) const
+{
+    LUAU_ASSERT(typeinfo.size() >= 2 && uint8_t(typeinfo[0]) == LBC_TYPE_FUNCTION);
+    LUAU_ASSERT(typeinfo.size() == 2 + uint8_t(typeinfo[1]));
+
+    output += "function(";
+
+    for (size_t i = 2; i < typeinfo.size(); ++i)
+    {
+        uint8_t type = uint8_t(typeinfo[i]);
+
+        if (i > 2)
+            output += ", ";
+
+        output += getBaseTypeString(type);
+
+        if (type & LBC_TYPE_OPTIONAL_BIT)
+            output += "?";
+    }
+
+    output += ")\n";
+}
+
 void BytecodeBuilder::setDumpSource(const std::string& source)
 {
     dumpSource.clear();
@@ -9,7 +9,12 @@
 #include "Builtins.h"
 #include "ConstantFolding.h"
 #include "CostModel.h"
+#include "LoopInvariants.h"
+#include "ModuleExports.h"
+#include "ScalarReplacement.h"
+#include "StringAppends.h"
 #include "TableShape.h"
+#include "Types.h"
 #include "ValueTracking.h"
 
 #include <algorithm>
@@ -25,6 +30,9 @@ LUAU_FASTINTVARIABLE(LuauCompileInlineThreshold, 25)
 LUAU_FASTINTVARIABLE(LuauCompileInlineThresholdMaxBoost, 300)
 LUAU_FASTINTVARIABLE(LuauCompileInlineDepth, 5)
 
+LUAU_FASTINTVARIABLE(LuauCompileProfileHotBoost, 400)
+LUAU_FASTINTVARIABLE(LuauCompileProfileHotFraction, 16)
+
 LUAU_FASTFLAG(LuauInterpolatedStringBaseSupport)
 
 namespace Luau
@@ -36,6 +44,12 @@ static const uint32_t kMaxRegisterCount = 255;
 static const uint32_t kMaxUpvalueCount = 200;
 static const uint32_t kMaxLocalCount = 200;
 
+// loop invariants are only hoisted when the registers they occupy are unlikely to be needed by the loop body
+static const uint32_t kMaxInvariantRegisterTop = 128;
+
+// each string accumulator takes two registers, so the number of locals that a loop builds in buffers is limited
+static const size_t kMaxStringAccumulators = 4;
+
 static const uint8_t kInvalidReg = 255;
 
 CompileError::CompileError(const Location& location, const std::string& message)
@@ -100,6 +114,12 @@ struct Compiler
         , locstants(nullptr)
         , tableShapes(nullptr)
         , builtins(nullptr)
+        , localTables(nullptr)
+        , scalarTables(nullptr)
+        , invariants(nullptr)
+        , accumulators(nullptr)
+        , typeAliases(AstName())
+        , requiredModules(nullptr)
     {
         // preallocate some buffers that are very likely to grow anyway; this works around std::vector's inefficient growth policy for small arrays
         localStack.reserve(16);
@@ -176,6 +196,13 @@ struct Compiler
             return getFunctionExpr(expr->expr);
         else if (AstExprTypeAssertion* expr = node->as<AstExprTypeAssertion>())
             return getFunctionExpr(expr->expr);
+        else if (AstExprIndexName* expr = node->as<AstExprIndexName>())
+        {
+            // required modules only export functions that can be inlined, see analyzeRequiredModules
+            AstExpr* value = getRequiredField(requiredModules, variables, expr);
+
+            return value ? getFunctionExpr(value) : nullptr;
+        }
         else
             return node->as<AstExprFunction>();
     }
@@ -238,11 +265,22 @@ struct Compiler
                 bytecode.pushDebugUpval(sref(l->name));
         }
 
+        if (options.typeInfoLevel >= 1)
+            bytecode.setFunctionTypeInfo(getFunctionTypeInfo(func, typeAliases, variables));
+
+        // register optimizations move values between registers, which local variable debug info can't describe
+        if (options.optimizationLevel >= 2 && options.debugLevel <= 1)
+            bytecode.optimizeRegisters();
+
         if (options.optimizationLevel >= 1)
             bytecode.foldJumps();
 
         bytecode.expandJumps();
 
+        // fusion keeps instruction offsets intact, so it can run after jumps are finalized
+        if (options.bytecodeVersion >= 5)
+            bytecode.fuseInstructions();
+
         popLocals(0);
 
         bytecode.endFunction(uint8_t(stackSize), uint8_t(upvals.size()));
@@ -471,6 +509,33 @@ struct Compiler
         }
     }
 
+    enum class ProfileHeat
+    {
+        Unknown,
+        Cold,
+        Warm,
+        Hot,
+    };
+
+    // the profile marks lines that never ran as cold and lines that ran within a fraction of the hottest line as hot
+    ProfileHeat getProfileHeat(AstNode* node)
+    {
+        int line = node->location.begin.line + 1;
+
+        if (line >= options.lineHitsCount || options.lineHits[line] < 0)
+            return ProfileHeat::Unknown;
+
+        int hits = options.lineHits[line];
+
+        if (hits == 0)
+            return ProfileHeat::Cold;
+
+        if (int64_t(hits) * FInt::LuauCompileProfileHotFraction >= maxLineHits)
+            return ProfileHeat::Hot;
+
+        return ProfileHeat::Warm;
+    }
+
     bool tryCompileInlinedCall(AstExprCall* expr, AstExprFunction* func, uint8_t target, uint8_t targetCount, bool multRet, int thresholdBase,
         int thresholdMaxBoost, int depthLimit)
     {
@@ -499,6 +564,17 @@ struct Compiler
                 return false;
             }
 
+        ProfileHeat heat = getProfileHeat(expr);
+
+        if (heat == ProfileHeat::Cold)
+        {
+            bytecode.addDebugRemark("inlining failed: call site is cold");
+            return false;
+        }
+
+        if (heat == ProfileHeat::Hot)
+            thresholdBase = thresholdBase * FInt::LuauCompileProfileHotBoost / 100;
+
         // we can't inline multret functions because the caller expects L->top to be adjusted:
         // - inlined return compiles to a JUMP, and we don't have an instruction that adjusts L->top arbitrarily
         // - even if we did, right now all L->top adjustments are immediately consumed by the next instruction, and for now we want to preserve that
@@ -572,6 +648,13 @@ struct Compiler
                 // all remaining function arguments have been allocated and assigned to
                 break;
             }
+            else if (const ScalarTable* table = scalarTables.find(var);
+                     table && arg && arg->is<AstExprTable>() && isScalarConstructor(arg->as<AstExprTable>(), constants))
+            {
+                // table constructors passed to arguments that are only used to access fields don't need to be allocated
+                uint8_t reg = compileScalarTable(arg->as<AstExprTable>(), *table);
+                pushLocal(var, reg, /* scalar= */ true);
+            }
             else if (Variable* vv = variables.find(var); vv && vv->written)
             {
                 // if the argument is mutated, we need to allocate a fresh register even if it's a constant
@@ -621,7 +704,7 @@ struct Compiler
         }
 
         // fold constant values updated above into expressions in the function body
-        foldConstants(constants, variables, locstants, builtinsFold, func->body);
+        foldConstants(constants, variables, locstants, builtinsFold, &requiredModules, func->body);
 
         bool usedFallthrough = false;
 
@@ -662,7 +745,7 @@ struct Compiler
             if (Constant* var = locstants.find(func->args.data[i]))
                 var->type = Constant::Type_Unknown;
 
-        foldConstants(constants, variables, locstants, builtinsFold, func->body);
+        foldConstants(constants, variables, locstants, builtinsFold, &requiredModules, func->body);
     }
 
     void compileExprCall(AstExprCall* expr, uint8_t target, uint8_t targetCount, bool targetTop = false, bool multRet = false)
@@ -1966,6 +2049,20 @@ struct Compiler
             return;
         }
 
+        // Optimization: loads hoisted out of the loop are already in a register
+        if (int reg = getExprInvariantReg(node); reg >= 0)
+        {
+            bytecode.emitABC(LOP_MOVE, target, uint8_t(reg), 0);
+            return;
+        }
+
+        // Optimization: fields of tables replaced with registers are read directly
+        if (int reg = getExprScalarReg(node); reg >= 0)
+        {
+            bytecode.emitABC(LOP_MOVE, target, uint8_t(reg), 0);
+            return;
+        }
+
         if (AstExprGroup* expr = node->as<AstExprGroup>())
         {
             compileExpr(expr->expr, target, targetTemp);
@@ -2078,6 +2175,9 @@ struct Compiler
         if (int reg = getExprLocalReg(node); reg >= 0)
             return uint8_t(reg);
 
+        if (int reg = getExprInvariantReg(node); reg >= 0)
+            return uint8_t(reg);
+
         // note: the register is owned by the parent scope
         uint8_t reg = allocReg(node, 1);
 
@@ -2241,6 +2341,14 @@ struct Compiler
 
             return result;
         }
+        else if (int reg = getExprScalarReg(node); reg >= 0)
+        {
+            LValue result = {LValue::Kind_Local};
+            result.reg = uint8_t(reg);
+            result.location = node->location;
+
+            return result;
+        }
         else if (AstExprIndexName* expr = node->as<AstExprIndexName>())
         {
             LValue result = {LValue::Kind_IndexName};
@@ -2339,11 +2447,200 @@ struct Compiler
         {
             // note: this can't check expr->upvalue because upvalues may be upgraded to locals during inlining
             Local* l = locals.find(expr->local);
+            LUAU_ASSERT(!l || !l->allocated || !l->scalar);
 
             return l && l->allocated ? l->reg : -1;
         }
         else
+            return getExprScalarReg(node);
+    }
+
+    // register that holds the field of a table replaced with registers (see ScalarTable)
+    int getExprScalarReg(AstExpr* node)
+    {
+        AstExprIndexName* expr = node->as<AstExprIndexName>();
+        AstExprLocal* object = expr ? expr->expr->as<AstExprLocal>() : nullptr;
+        Local* l = object ? locals.find(object->local) : nullptr;
+
+        if (!l || !l->allocated || !l->scalar)
             return -1;
+
+        const ScalarTable* table = scalarTables.find(object->local);
+        LUAU_ASSERT(table);
+
+        for (size_t i = 0; i < table->fields.size(); ++i)
+            if (table->fields[i] == expr->index.value)
+                return l->reg + int(i);
+
+        LUAU_ASSERT(!"Field access wasn't tracked");
+        return -1;
+    }
+
+    // Optimization: tables that don't escape the function are replaced with a register for each field they use
+    uint8_t compileScalarTable(AstExprTable* expr, const ScalarTable& table)
+    {
+        uint8_t reg = allocReg(expr, unsigned(table.fields.size()));
+
+        std::vector<bool> assigned(table.fields.size());
+
+        for (const AstExprTable::Item& item : expr->items)
+        {
+            Constant key = getConstant(item.key);
+            LUAU_ASSERT(key.type == Constant::Type_String);
+
+            auto it = std::find(table.fields.begin(), table.fields.end(), std::string(key.valueString, key.stringLength));
+
+            if (it != table.fields.end())
+            {
+                compileExpr(item.value, uint8_t(reg + (it - table.fields.begin())));
+                assigned[it - table.fields.begin()] = true;
+            }
+            else if (!isConstant(item.value) && !getExprLocal(item.value))
+            {
+                // fields that are never accessed are still evaluated for side effects
+                RegScope rsi(this);
+                compileExprAuto(item.value, rsi);
+            }
+        }
+
+        for (size_t i = 0; i < table.fields.size(); ++i)
+            if (!assigned[i])
+                bytecode.emitABC(LOP_LOADNIL, uint8_t(reg + i), 0, 0);
+
+        return reg;
+    }
+
+    int getExprInvariantReg(AstExpr* node)
+    {
+        const uint8_t* reg = invariants.find(node);
+
+        return reg && *reg != kInvalidReg ? *reg : -1;
+    }
+
+    // Optimization: loads that produce the same value on every iteration are computed once before the loop
+    std::vector<LoopInvariant> hoistLoopInvariants(AstNode* node, AstStat* body, AstExpr* condition)
+    {
+        std::vector<LoopInvariant> loads;
+
+        if (options.optimizationLevel < 2)
+            return loads;
+
+        // imports are not hoisted: GETIMPORT needs to look the value up again once the environment becomes unsafe, for example after loadstring
+        findLoopInvariants(loads, body, condition, localTables, constants);
+
+        // loads that an outer loop already hoisted don't need to be reloaded, and fields of tables replaced with registers aren't loaded
+        loads.erase(std::remove_if(loads.begin(), loads.end(),
+                        [&](const LoopInvariant& load) {
+                            return getExprInvariantReg(load.expr) >= 0 || getExprScalarReg(load.expr) >= 0;
+                        }),
+            loads.end());
+
+        if (loads.empty() || regTop + loads.size() > kMaxInvariantRegisterTop)
+            return {};
+
+        uint8_t regs = allocReg(node, unsigned(loads.size()));
+
+        for (size_t i = 0; i < loads.size(); ++i)
+        {
+            compileExpr(loads[i].expr, uint8_t(regs + i));
+
+            for (AstExpr* use : loads[i].uses)
+                invariants[use] = uint8_t(regs + i);
+        }
+
+        return loads;
+    }
+
+    void restoreLoopInvariants(const std::vector<LoopInvariant>& loads)
+    {
+        for (const LoopInvariant& load : loads)
+            for (AstExpr* use : load.uses)
+                invariants[use] = kInvalidReg;
+    }
+
+    int getStringAccumulatorReg(AstLocal* local)
+    {
+        const uint8_t* reg = accumulators.find(local);
+
+        return reg && *reg != kInvalidReg ? *reg : -1;
+    }
+
+    // Optimization: strings that the loop appends to are built in a buffer, and the result is only created once the loop exits
+    std::vector<AstLocal*> startStringAccumulators(AstNode* node, AstStat* body, AstExpr* condition)
+    {
+        std::vector<AstLocal*> result;
+
+        if (options.optimizationLevel < 2 || options.debugLevel > 1 || options.bytecodeVersion < 6)
+            return result;
+
+        findStringAppends(result, body, condition);
+
+        // locals that an outer loop already builds in a buffer keep using its accumulator; captured locals can be read during any call
+        result.erase(std::remove_if(result.begin(), result.end(),
+                         [&](AstLocal* local) {
+                             const Local* l = locals.find(local);
+
+                             return !l || !l->allocated || l->captured || getStringAccumulatorReg(local) >= 0;
+                         }),
+            result.end());
+
+        if (result.size() > kMaxStringAccumulators)
+            result.resize(kMaxStringAccumulators);
+
+        if (result.empty() || regTop + result.size() * 2 > kMaxInvariantRegisterTop)
+            return {};
+
+        uint8_t regs = allocReg(node, unsigned(result.size() * 2));
+
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            bytecode.emitABC(LOP_LOADNIL, uint8_t(regs + i * 2), 0, 0);
+
+            accumulators[result[i]] = uint8_t(regs + i * 2);
+        }
+
+        return result;
+    }
+
+    // called at the label that all loop exits jump to
+    void finishStringAccumulators(const std::vector<AstLocal*>& result)
+    {
+        for (AstLocal* local : result)
+        {
+            bytecode.emitABC(LOP_FLUSHACC, uint8_t(getLocalReg(local)), uint8_t(getStringAccumulatorReg(local)), 0);
+
+            accumulators[local] = kInvalidReg;
+        }
+    }
+
+    bool compileStringAppend(AstStat* stat, AstExpr* value, bool compound)
+    {
+        AstLocal* local = getStringAppendTarget(stat);
+        int acc = local ? getStringAccumulatorReg(local) : -1;
+
+        if (acc < 0)
+            return false;
+
+        RegScope rs(this);
+
+        std::vector<AstExpr*> args = {value};
+
+        if (!compound)
+            args = {value->as<AstExprBinary>()->right};
+
+        // unroll the tree of concats down the right hand side to be able to do multiple ops
+        unrollConcats(args);
+
+        // the first register is only written if the accumulator falls back to CONCAT
+        uint8_t regs = allocReg(stat, unsigned(1 + args.size()));
+
+        for (size_t i = 0; i < args.size(); ++i)
+            compileExprTemp(args[i], uint8_t(regs + 1 + i));
+
+        bytecode.emitABC(LOP_CONCATACC, uint8_t(getLocalReg(local)), regs, uint8_t(regs + args.size()));
+        bytecode.emitAux(acc);
+
+        return true;
     }
 
     bool isStatBreak(AstStat* node)
@@ -2448,6 +2745,11 @@ struct Compiler
         if (isConstantFalse(stat->condition))
             return;
 
+        RegScope rs(this);
+
+        std::vector<LoopInvariant> hoisted = hoistLoopInvariants(stat, stat->body, stat->condition);
+        std::vector<AstLocal*> appends = startStringAccumulators(stat, stat->body, stat->condition);
+
         size_t oldJumps = loopJumps.size();
         size_t oldLocals = localStack.size();
 
@@ -2472,6 +2774,8 @@ struct Compiler
 
         size_t endLabel = bytecode.emitLabel();
 
+        finishStringAccumulators(appends);
+
         patchJump(stat, backLabel, loopLabel);
         patchJumps(stat, elseJump, endLabel);
 
@@ -2479,10 +2783,17 @@ struct Compiler
         loopJumps.resize(oldJumps);
 
         loops.pop_back();
+
+        restoreLoopInvariants(hoisted);
     }
 
     void compileStatRepeat(AstStatRepeat* stat)
     {
+        RegScope rs(this);
+
+        std::vector<LoopInvariant> hoisted = hoistLoopInvariants(stat, stat->body, stat->condition);
+        std::vector<AstLocal*> appends = startStringAccumulators(stat, stat->body, stat->condition);
+
         size_t oldJumps = loopJumps.size();
         size_t oldLocals = localStack.size();
 
@@ -2494,8 +2805,6 @@ struct Compiler
         // this is necessary because condition can access locals declared inside the repeat..until body
         AstStatBlock* body = stat->body;
 
-        RegScope rs(this);
-
         for (size_t i = 0; i < body->body.size; ++i)
             compileStat(body->body.data[i]);
 
@@ -2537,12 +2846,16 @@ struct Compiler
             patchJumps(stat, skipJump, skipLabel);
         }
 
+        finishStringAccumulators(appends);
+
         popLocals(oldLocals);
 
         patchLoopJumps(stat, oldJumps, endLabel, contLabel);
         loopJumps.resize(oldJumps);
 
         loops.pop_back();
+
+        restoreLoopInvariants(hoisted);
     }
 
     void compileInlineReturn(AstStatReturn* stat, bool fallthrough)
@@ -2627,6 +2940,16 @@ struct Compiler
         if (options.optimizationLevel >= 1 && options.debugLevel <= 1 && areLocalsRedundant(stat))
             return;
 
+        // Optimization: tables that don't escape the function are replaced with a register for each field
+        if (const ScalarTable* table = stat->vars.size == 1 ? scalarTables.find(stat->vars.data[0]) : nullptr)
+        {
+            LUAU_ASSERT(stat->values.size == 1 && stat->values.data[0]->is<AstExprTable>());
+
+            uint8_t reg = compileScalarTable(stat->values.data[0]->as<AstExprTable>(), *table);
+            pushLocal(stat->vars.data[0], reg, /* scalar= */ true);
+            return;
+        }
+
         // Optimization: for 1-1 local assignments, we can reuse the register *if* neither local is mutated
         if (options.optimizationLevel >= 1 && stat->vars.size == 1 && stat->values.size == 1)
         {
@@ -2671,6 +2994,17 @@ struct Compiler
             return false;
         }
 
+        ProfileHeat heat = getProfileHeat(stat);
+
+        if (heat == ProfileHeat::Cold)
+        {
+            bytecode.addDebugRemark("loop unroll failed: loop is cold");
+            return false;
+        }
+
+        if (heat == ProfileHeat::Hot)
+            thresholdBase = thresholdBase * FInt::LuauCompileProfileHotBoost / 100;
+
         if (tripCount > thresholdBase)
         {
             bytecode.addDebugRemark("loop unroll failed: too many iterations (%d)", tripCount);
@@ -2722,7 +3056,7 @@ struct Compiler
             locstants[var].type = Constant::Type_Number;
             locstants[var].valueNumber = from + iv * step;
 
-            foldConstants(constants, variables, locstants, builtinsFold, stat);
+            foldConstants(constants, variables, locstants, builtinsFold, &requiredModules, stat);
 
             size_t iterJumps = loopJumps.size();
 
@@ -2750,7 +3084,7 @@ struct Compiler
         // clean up fold state in case we need to recompile - normally we compile the loop body once, but due to inlining we may need to do it again
         locstants[var].type = Constant::Type_Unknown;
 
-        foldConstants(constants, variables, locstants, builtinsFold, stat);
+        foldConstants(constants, variables, locstants, builtinsFold, &requiredModules, stat);
     }
 
     void compileStatFor(AstStatFor* stat)
@@ -2762,6 +3096,9 @@ struct Compiler
             if (tryCompileUnrolledFor(stat, FInt::LuauCompileLoopUnrollThreshold, FInt::LuauCompileLoopUnrollThresholdMaxBoost))
                 return;
 
+        std::vector<LoopInvariant> hoisted = hoistLoopInvariants(stat, stat->body, nullptr);
+        std::vector<AstLocal*> appends = startStringAccumulators(stat, stat->body, nullptr);
+
         size_t oldLocals = localStack.size();
         size_t oldJumps = loopJumps.size();
 
@@ -2813,6 +3150,8 @@ struct Compiler
 
         size_t endLabel = bytecode.emitLabel();
 
+        finishStringAccumulators(appends);
+
         patchJump(stat, forLabel, endLabel);
         patchJump(stat, backLabel, loopLabel);
 
@@ -2820,12 +3159,17 @@ struct Compiler
         loopJumps.resize(oldJumps);
 
         loops.pop_back();
+
+        restoreLoopInvariants(hoisted);
     }
 
     void compileStatForIn(AstStatForIn* stat)
     {
         RegScope rs(this);
 
+        std::vector<LoopInvariant> hoisted = hoistLoopInvariants(stat, stat->body, nullptr);
+        std::vector<AstLocal*> appends = startStringAccumulators(stat, stat->body, nullptr);
+
         size_t oldLocals = localStack.size();
         size_t oldJumps = loopJumps.size();
 
@@ -2894,6 +3238,8 @@ struct Compiler
 
         size_t endLabel = bytecode.emitLabel();
 
+        finishStringAccumulators(appends);
+
         patchJump(stat, skipLabel, backLabel);
         patchJump(stat, backLabel, loopLabel);
 
@@ -2901,6 +3247,8 @@ struct Compiler
         loopJumps.resize(oldJumps);
 
         loops.pop_back();
+
+        restoreLoopInvariants(hoisted);
     }
 
     struct Assignment
@@ -2992,6 +3340,9 @@ struct Compiler
 
     void compileStatAssign(AstStatAssign* stat)
     {
+        if (compileStringAppend(stat, stat->values.size == 1 ? stat->values.data[0] : nullptr, /* compound= */ false))
+            return;
+
         RegScope rs(this);
 
         // Optimization: one to one assignments don't require complex conflict resolution machinery
@@ -3094,6 +3445,9 @@ struct Compiler
 
     void compileStatCompoundAssign(AstStatCompoundAssign* stat)
     {
+        if (compileStringAppend(stat, stat->value, /* compound= */ true))
+            return;
+
         RegScope rs(this);
 
         LValue var = compileLValue(stat->var, rs);
@@ -3328,7 +3682,7 @@ struct Compiler
             getUpval(local);
     }
 
-    void pushLocal(AstLocal* local, uint8_t reg)
+    void pushLocal(AstLocal* local, uint8_t reg, bool scalar = false)
     {
         if (localStack.size() >= kMaxLocalCount)
             CompileError::raise(
@@ -3342,6 +3696,7 @@ struct Compiler
 
         l.reg = reg;
         l.allocated = true;
+        l.scalar = scalar;
         l.debugpc = bytecode.getDebugPC();
     }
 
@@ -3502,6 +3857,43 @@ struct Compiler
         }
     };
 
+    // checks that an exported function of a required module behaves the same way when it's inlined into the current module
+    struct ExportedFunctionVisitor : AstVisitor
+    {
+        const DenseHashMap<AstName, Global>& globals;
+        const AstNameTable& names;
+        const DenseHashMap<AstName, Global>& moduleGlobals;
+        bool result = true;
+
+        ExportedFunctionVisitor(
+            const DenseHashMap<AstName, Global>& globals, const AstNameTable& names, const DenseHashMap<AstName, Global>& moduleGlobals)
+            : globals(globals)
+            , names(names)
+            , moduleGlobals(moduleGlobals)
+        {
+        }
+
+        bool visit(AstExprGlobal* node) override
+        {
+            // inlined code reads globals from the environment of the current module, so neither module may change them; since the modules
+            // have separate name tables, the inlined code is compiled as if the globals had the default state, which excludes mutable globals
+            AstName name = names.get(node->name.value);
+
+            if (getGlobalState(moduleGlobals, node->name) != Global::Default || getGlobalState(globals, name) == Global::Written)
+                result = false;
+
+            return false;
+        }
+
+        bool visit(AstExprFunction* node) override
+        {
+            // closures need the bytecode of the required module, which isn't part of the current module
+            result = false;
+
+            return false;
+        }
+    };
+
     struct FunctionVisitor : AstVisitor
     {
         Compiler* self;
@@ -3663,6 +4055,7 @@ struct Compiler
         uint8_t reg = 0;
         bool allocated = false;
         bool captured = false;
+        bool scalar = false; // fields of the table are stored in registers starting from reg, see ScalarTable
         uint32_t debugpc = 0;
     };
 
@@ -3715,11 +4108,19 @@ struct Compiler
     DenseHashMap<AstLocal*, Constant> locstants;
     DenseHashMap<AstExprTable*, TableShape> tableShapes;
     DenseHashMap<AstExprCall*, int> builtins;
+    DenseHashSet<AstLocal*> localTables;
+    DenseHashMap<AstLocal*, ScalarTable> scalarTables;
+    DenseHashMap<AstExpr*, uint8_t> invariants;
+    DenseHashMap<AstLocal*, uint8_t> accumulators;
+    DenseHashMap<AstName, AstStatTypeAlias*> typeAliases;
+    DenseHashMap<AstExprCall*, ModuleExports> requiredModules;
     const DenseHashMap<AstExprCall*, int>* builtinsFold = nullptr;
 
     unsigned int regTop = 0;
     unsigned int stackSize = 0;
 
+    int maxLineHits = 0;
+
     bool getfenvUsed = false;
     bool setfenvUsed = false;
 
@@ -3732,7 +4133,99 @@ struct Compiler
     std::vector<std::unique_ptr<char[]>> interpStrings;
 };
 
-void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, const AstNameTable& names, const CompileOptions& inputOptions)
+// required modules are analyzed on their own to find constants and functions that they export; function bodies are compiled into a separate
+// bytecode builder to compute the information that the inliner needs, and the analysis results for their AST are added to the compiler state so
+// that the inlined code can be compiled as part of the current module; note that names of the current module are used to look up the exports
+static void analyzeRequiredModules(Compiler& compiler, const AstNameTable& names, const std::vector<RequiredModule>& requiredModules)
+{
+    CompileOptions options = compiler.options;
+    options.typeInfoLevel = 0;
+    options.lineHits = nullptr;
+    options.lineHitsCount = 0;
+    options.bytecodeVersion = 0;
+
+    for (const RequiredModule& module : requiredModules)
+    {
+        LUAU_ASSERT(module.call && module.root && module.names);
+
+        BytecodeBuilder bytecode;
+        Compiler dep(bytecode, options);
+
+        assignMutable(dep.globals, *module.names, options.mutableGlobals);
+        trackValues(dep.globals, dep.variables, module.root);
+
+        Compiler::FenvVisitor fenvVisitor(dep.getfenvUsed, dep.setfenvUsed);
+        module.root->visit(&fenvVisitor);
+
+        if (dep.getfenvUsed || dep.setfenvUsed)
+            continue;
+
+        dep.builtinsFold = &dep.builtins;
+
+        analyzeBuiltins(dep.builtins, dep.globals, dep.variables, options, module.root);
+        foldConstants(dep.constants, dep.variables, dep.locstants, dep.builtinsFold, &dep.requiredModules, module.root);
+        predictTableShapes(dep.tableShapes, module.root);
+
+        ModuleExports exports;
+        if (!trackModuleExports(exports, dep.globals, dep.variables, names, module.root))
+            continue;
+
+        // fields with other values are read at runtime as usual
+        ModuleExports result;
+
+        for (auto [name, value] : exports.fields)
+        {
+            if (const Constant* cv = dep.constants.find(value); cv && cv->type != Constant::Type_Unknown)
+            {
+                result.fields[name] = value;
+            }
+            else if (AstExprFunction* func = dep.getFunctionExpr(value); func && !func->self && !func->vararg)
+            {
+                Compiler::ExportedFunctionVisitor visitor(compiler.globals, names, dep.globals);
+                func->body->visit(&visitor);
+
+                if (!visitor.result)
+                    continue;
+
+                // since the function can't have closures, it can be compiled without compiling any other function first
+                if (!dep.functions.contains(func))
+                    dep.compileFunction(func);
+
+                const Compiler::Function* f = dep.functions.find(func);
+
+                // upvalues refer to locals of the required module that the current module can't access
+                if (!f->canInline || !f->upvals.empty())
+                    continue;
+
+                compiler.functions[func] = *f;
+                result.fields[name] = value;
+            }
+        }
+
+        if (result.fields.empty())
+            continue;
+
+        for (auto& [local, v] : dep.variables)
+            compiler.variables[local] = v;
+
+        for (auto& [expr, cv] : dep.constants)
+            compiler.constants[expr] = cv;
+
+        for (auto& [local, cv] : dep.locstants)
+            compiler.locstants[local] = cv;
+
+        for (auto& [expr, bfid] : dep.builtins)
+            compiler.builtins[expr] = bfid;
+
+        for (auto& [expr, shape] : dep.tableShapes)
+            compiler.tableShapes[expr] = shape;
+
+        compiler.requiredModules[module.call] = std::move(result);
+    }
+}
+
+void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, const AstNameTable& names, const CompileOptions& inputOptions,
+    const std::vector<RequiredModule>& requiredModules)
 {
     LUAU_TIMETRACE_SCOPE("compileOrThrow", "Compiler");
 
@@ -3747,6 +4240,13 @@ void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, c
 
     AstStatBlock* root = parseResult.root;
 
+    // versions that the runtime doesn't support are clamped to the supported range
+    if (options.bytecodeVersion > LBC_VERSION_TARGET)
+    {
+        options.bytecodeVersion = std::min(options.bytecodeVersion, int(LBC_VERSION_MAX));
+        bytecode.setTargetVersion(uint8_t(options.bytecodeVersion));
+    }
+
     Compiler compiler(bytecode, options);
 
     // since access to some global objects may result in values that change over time, we block imports from non-readonly tables
@@ -3755,6 +4255,17 @@ void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, c
     // this pass analyzes mutability of locals/globals and associates locals with their initial values
     trackValues(compiler.globals, compiler.variables, root);
 
+    // this visitor tracks calls to getfenv/setfenv and disables some optimizations when they are found
+    if (options.optimizationLevel >= 1 && (names.get("getfenv").value || names.get("setfenv").value))
+    {
+        Compiler::FenvVisitor fenvVisitor(compiler.getfenvUsed, compiler.setfenvUsed);
+        root->visit(&fenvVisitor);
+    }
+
+    // values from required modules are folded into the bytecode, so it's only valid as long as the required modules don't change
+    if (options.optimizationLevel >= 2 && options.coverageLevel == 0 && !compiler.getfenvUsed && !compiler.setfenvUsed)
+        analyzeRequiredModules(compiler, names, requiredModules);
+
     // builtin folding is enabled on optimization level 2 since we can't deoptimize folding at runtime
     if (options.optimizationLevel >= 2)
         compiler.builtinsFold = &compiler.builtins;
@@ -3765,19 +4276,30 @@ void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, c
         analyzeBuiltins(compiler.builtins, compiler.globals, compiler.variables, options, root);
 
         // this pass analyzes constantness of expressions
-        foldConstants(compiler.constants, compiler.variables, compiler.locstants, compiler.builtinsFold, root);
+        foldConstants(compiler.constants, compiler.variables, compiler.locstants, compiler.builtinsFold, &compiler.requiredModules, root);
 
         // this pass analyzes table assignments to estimate table shapes for initially empty tables
         predictTableShapes(compiler.tableShapes, root);
     }
 
-    // this visitor tracks calls to getfenv/setfenv and disables some optimizations when they are found
-    if (options.optimizationLevel >= 1 && (names.get("getfenv").value || names.get("setfenv").value))
+    // this pass tracks local tables that can only change through the code of the function that declared them
+    if (options.optimizationLevel >= 2)
+        trackLocalTables(compiler.localTables, compiler.globals, compiler.variables, root);
+
+    // this pass tracks tables that are only used through their fields; the tables don't exist at runtime, so they are not visible to debuggers
+    if (options.optimizationLevel >= 2 && options.debugLevel <= 1)
+        trackScalarTables(compiler.scalarTables, compiler.variables, compiler.constants, root);
+
+    // type information is only derived from annotations; it isn't checked, so the runtime may only use it as a hint
+    if (options.typeInfoLevel >= 1)
     {
-        Compiler::FenvVisitor fenvVisitor(compiler.getfenvUsed, compiler.setfenvUsed);
-        root->visit(&fenvVisitor);
+        trackTypeAliases(compiler.typeAliases, root);
+        bytecode.enableTypeInfo();
     }
 
+    for (int i = 0; i < options.lineHitsCount; ++i)
+        compiler.maxLineHits = std::max(compiler.maxLineHits, options.lineHits[i]);
+
     // gathers all functions with the invariant that all function references are to functions earlier in the list
     // for example, function foo() return function() end end will result in two vector entries, [0] = anonymous and [1] = foo
     std::vector<AstExprFunction*> functions;
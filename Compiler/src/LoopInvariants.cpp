@@ -0,0 +1,402 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "LoopInvariants.h"
+
+#include "Builtins.h"
+
+#include "Luau/StringUtils.h"
+
+namespace Luau
+{
+namespace Compile
+{
+
+// conservative limit for the number of registers that hold hoisted values of a single loop
+static const size_t kMaxLoopInvariants = 8;
+
+static AstLocal* getIndexedLocal(AstExpr* node)
+{
+    if (AstExprLocal* expr = node->as<AstExprLocal>())
+        return expr->local;
+
+    return nullptr;
+}
+
+struct LocalTableVisitor : AstVisitor
+{
+    const DenseHashMap<AstName, Global>& globals;
+    const DenseHashMap<AstLocal*, Variable>& variables;
+
+    DenseHashMap<AstLocal*, AstExprFunction*> owners;
+    DenseHashSet<AstLocal*> escaped;
+
+    AstExprFunction* function = nullptr;
+
+    LocalTableVisitor(const DenseHashMap<AstName, Global>& globals, const DenseHashMap<AstLocal*, Variable>& variables)
+        : globals(globals)
+        , variables(variables)
+        , owners(nullptr)
+        , escaped(nullptr)
+    {
+    }
+
+    void store(AstExpr* var)
+    {
+        AstExpr* object = nullptr;
+
+        if (AstExprIndexName* index = var->as<AstExprIndexName>())
+        {
+            object = index->expr;
+        }
+        else if (AstExprIndexExpr* index = var->as<AstExprIndexExpr>())
+        {
+            object = index->expr;
+            index->index->visit(this);
+        }
+        else if (!var->is<AstExprLocal>() && !var->is<AstExprGlobal>())
+        {
+            var->visit(this);
+            return;
+        }
+
+        if (AstLocal* local = object ? getIndexedLocal(object) : nullptr)
+        {
+            // stores from nested functions can happen during any call
+            if (AstExprFunction** owner = owners.find(local); owner && *owner != function)
+                escaped.insert(local);
+        }
+        else if (object)
+        {
+            object->visit(this);
+        }
+    }
+
+    bool visit(AstExprFunction* node) override
+    {
+        AstExprFunction* outer = function;
+
+        function = node;
+        node->body->visit(this);
+        function = outer;
+
+        return false;
+    }
+
+    bool visit(AstStatLocal* node) override
+    {
+        for (size_t i = 0; i < node->vars.size && i < node->values.size; ++i)
+        {
+            AstLocal* local = node->vars.data[i];
+
+            if (node->values.data[i]->is<AstExprTable>())
+                if (const Variable* v = variables.find(local); v && !v->written)
+                    owners[local] = function;
+        }
+
+        return true;
+    }
+
+    bool visit(AstExprLocal* node) override
+    {
+        // any reference other than the ones handled below may let the table leave the function
+        escaped.insert(node->local);
+
+        return false;
+    }
+
+    bool visit(AstExprIndexName* node) override
+    {
+        return !getIndexedLocal(node->expr);
+    }
+
+    bool visit(AstExprIndexExpr* node) override
+    {
+        if (!getIndexedLocal(node->expr))
+            return true;
+
+        node->index->visit(this);
+        return false;
+    }
+
+    bool visit(AstExprUnary* node) override
+    {
+        return !(node->op == AstExprUnary::Len && getIndexedLocal(node->expr));
+    }
+
+    bool visit(AstExprCall* node) override
+    {
+        if (node->self)
+        {
+            // the method receives the table and can keep or change it
+            AstExprIndexName* func = node->func->as<AstExprIndexName>();
+            LUAU_ASSERT(func);
+
+            if (AstLocal* local = getIndexedLocal(func->expr))
+                escaped.insert(local);
+
+            return true;
+        }
+
+        // builtins that inspect the table without keeping or changing it
+        Builtin builtin = getBuiltin(node->func, globals, variables);
+
+        if (!builtin.isGlobal("pairs") && !builtin.isGlobal("ipairs") && !builtin.isGlobal("next") && !builtin.isGlobal("rawget") &&
+            !builtin.isGlobal("rawlen") && !builtin.isGlobal("type") && !builtin.isGlobal("typeof"))
+            return true;
+
+        node->func->visit(this);
+
+        for (size_t i = 0; i < node->args.size; ++i)
+            if (!getIndexedLocal(node->args.data[i]))
+                node->args.data[i]->visit(this);
+
+        return false;
+    }
+
+    bool visit(AstStatAssign* node) override
+    {
+        for (size_t i = 0; i < node->vars.size; ++i)
+            store(node->vars.data[i]);
+
+        for (size_t i = 0; i < node->values.size; ++i)
+            node->values.data[i]->visit(this);
+
+        return false;
+    }
+
+    bool visit(AstStatCompoundAssign* node) override
+    {
+        store(node->var);
+        node->value->visit(this);
+
+        return false;
+    }
+
+    bool visit(AstStatFunction* node) override
+    {
+        store(node->name);
+        node->func->visit(this);
+
+        return false;
+    }
+};
+
+struct LoopInvariantVisitor : AstVisitor
+{
+    std::vector<LoopInvariant>& result;
+
+    const DenseHashSet<AstLocal*>& tables;
+    const DenseHashMap<AstExpr*, Constant>& constants;
+
+    DenseHashMap<std::string, size_t> keys;
+    std::vector<AstLocal*> objects; // table local for each result entry
+
+    DenseHashSet<AstLocal*> declared; // locals declared in the loop get new values on every iteration
+    DenseHashSet<AstLocal*> stored;   // tables modified in the loop
+
+    LoopInvariantVisitor(
+        std::vector<LoopInvariant>& result, const DenseHashSet<AstLocal*>& tables, const DenseHashMap<AstExpr*, Constant>& constants)
+        : result(result)
+        , tables(tables)
+        , constants(constants)
+        , keys("")
+        , declared(nullptr)
+        , stored(nullptr)
+    {
+    }
+
+    bool addTableField(AstExpr* expr, AstExpr* object, const Constant& key)
+    {
+        AstLocal* local = getIndexedLocal(object);
+        if (!local || !tables.contains(local))
+            return false;
+
+        std::string name = format("%p.", local);
+
+        if (key.type == Constant::Type_String)
+            name += "s" + std::string(key.valueString, key.stringLength);
+        else if (key.type == Constant::Type_Number)
+            name += format("n%.17g", key.valueNumber);
+        else
+            return false;
+
+        if (size_t* index = keys.find(name))
+        {
+            result[*index].uses.push_back(expr);
+        }
+        else
+        {
+            keys[name] = result.size();
+            result.push_back({expr, {expr}});
+            objects.push_back(local);
+        }
+
+        return true;
+    }
+
+    void store(AstExpr* var)
+    {
+        AstExpr* object = nullptr;
+
+        if (AstExprIndexName* index = var->as<AstExprIndexName>())
+        {
+            object = index->expr;
+        }
+        else if (AstExprIndexExpr* index = var->as<AstExprIndexExpr>())
+        {
+            object = index->expr;
+            index->index->visit(this);
+        }
+        else if (!var->is<AstExprLocal>() && !var->is<AstExprGlobal>())
+        {
+            var->visit(this);
+            return;
+        }
+
+        if (AstLocal* local = object ? getIndexedLocal(object) : nullptr)
+            stored.insert(local);
+        else if (object)
+            object->visit(this);
+    }
+
+    bool visit(AstExprFunction* node) override
+    {
+        // nested functions are compiled separately and can't use the registers of the loop
+        return false;
+    }
+
+    bool visit(AstExprIndexName* node) override
+    {
+        Constant key;
+        key.type = Constant::Type_String;
+        key.valueString = node->index.value;
+        key.stringLength = unsigned(strlen(node->index.value));
+
+        return !addTableField(node, node->expr, key);
+    }
+
+    bool visit(AstExprIndexExpr* node) override
+    {
+        if (const Constant* key = constants.find(node->index))
+            if (addTableField(node, node->expr, *key))
+                return false;
+
+        return true;
+    }
+
+    bool visit(AstExprCall* node) override
+    {
+        if (node->self)
+        {
+            // the object is loaded once and passed as self, the method is looked up with NAMECALL
+            AstExprIndexName* func = node->func->as<AstExprIndexName>();
+            LUAU_ASSERT(func);
+
+            // the method can change the table
+            if (AstLocal* local = getIndexedLocal(func->expr); local && tables.contains(local))
+                stored.insert(local);
+            else
+                func->expr->visit(this);
+        }
+        else
+        {
+            node->func->visit(this);
+        }
+
+        for (size_t i = 0; i < node->args.size; ++i)
+            node->args.data[i]->visit(this);
+
+        return false;
+    }
+
+    bool visit(AstStatLocal* node) override
+    {
+        for (size_t i = 0; i < node->vars.size; ++i)
+            declared.insert(node->vars.data[i]);
+
+        return true;
+    }
+
+    bool visit(AstStatLocalFunction* node) override
+    {
+        declared.insert(node->name);
+
+        return false;
+    }
+
+    bool visit(AstStatFor* node) override
+    {
+        declared.insert(node->var);
+
+        return true;
+    }
+
+    bool visit(AstStatForIn* node) override
+    {
+        for (size_t i = 0; i < node->vars.size; ++i)
+            declared.insert(node->vars.data[i]);
+
+        return true;
+    }
+
+    bool visit(AstStatAssign* node) override
+    {
+        for (size_t i = 0; i < node->vars.size; ++i)
+            store(node->vars.data[i]);
+
+        for (size_t i = 0; i < node->values.size; ++i)
+            node->values.data[i]->visit(this);
+
+        return false;
+    }
+
+    bool visit(AstStatCompoundAssign* node) override
+    {
+        store(node->var);
+        node->value->visit(this);
+
+        return false;
+    }
+
+    bool visit(AstStatFunction* node) override
+    {
+        store(node->name);
+
+        return false;
+    }
+};
+
+void trackLocalTables(DenseHashSet<AstLocal*>& tables, const DenseHashMap<AstName, Global>& globals,
+    const DenseHashMap<AstLocal*, Variable>& variables, AstNode* root)
+{
+    LocalTableVisitor visitor{globals, variables};
+    root->visit(&visitor);
+
+    for (const auto& item : visitor.owners)
+        if (!visitor.escaped.contains(item.first))
+            tables.insert(item.first);
+}
+
+void findLoopInvariants(std::vector<LoopInvariant>& result, AstStat* body, AstExpr* condition, const DenseHashSet<AstLocal*>& tables,
+    const DenseHashMap<AstExpr*, Constant>& constants)
+{
+    std::vector<LoopInvariant> loads;
+
+    LoopInvariantVisitor visitor{loads, tables, constants};
+    body->visit(&visitor);
+
+    if (condition)
+        condition->visit(&visitor);
+
+    for (size_t i = 0; i < loads.size() && result.size() < kMaxLoopInvariants; ++i)
+    {
+        AstLocal* object = visitor.objects[i];
+
+        if (visitor.declared.contains(object) || visitor.stored.contains(object))
+            continue;
+
+        result.push_back(std::move(loads[i]));
+    }
+}
+
+} // namespace Compile
+} // namespace Luau
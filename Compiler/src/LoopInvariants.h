@@ -0,0 +1,30 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "ConstantFolding.h"
+
+#include <vector>
+
+namespace Luau
+{
+namespace Compile
+{
+
+struct LoopInvariant
+{
+    AstExpr* expr = nullptr;     // first load of the value in the loop
+    std::vector<AstExpr*> uses; // all loads of the value in the loop, including expr
+};
+
+// tracks locals initialized with a table constructor that are never reassigned or passed anywhere and are only modified by the function
+// that declares them; such tables have no metatable, so reads can't run user code and can only observe stores visible in that function
+void trackLocalTables(DenseHashSet<AstLocal*>& tables, const DenseHashMap<AstName, Global>& globals,
+    const DenseHashMap<AstLocal*, Variable>& variables, AstNode* root);
+
+// finds loads in the loop body and condition that produce the same value on every iteration: constant fields of local tables from
+// trackLocalTables that aren't modified or redeclared in the loop
+void findLoopInvariants(std::vector<LoopInvariant>& result, AstStat* body, AstExpr* condition, const DenseHashSet<AstLocal*>& tables,
+    const DenseHashMap<AstExpr*, Constant>& constants);
+
+} // namespace Compile
+} // namespace Luau
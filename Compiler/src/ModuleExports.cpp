@@ -0,0 +1,229 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "ModuleExports.h"
+
+#include "Luau/Lexer.h"
+
+#include <string.h>
+
+namespace Luau
+{
+namespace Compile
+{
+
+struct ModuleTableVisitor : AstVisitor
+{
+    AstLocal* table;
+
+    // statements at the top level of the module that assign fields of the table
+    DenseHashSet<AstStat*> assignments;
+
+    bool escaped = false;
+
+    ModuleTableVisitor(AstLocal* table)
+        : table(table)
+        , assignments(nullptr)
+    {
+    }
+
+    bool isField(AstExpr* node)
+    {
+        AstExprIndexName* expr = node->as<AstExprIndexName>();
+        AstExprLocal* object = expr ? expr->expr->as<AstExprLocal>() : nullptr;
+
+        return object && object->local == table;
+    }
+
+    bool visit(AstExprLocal* node) override
+    {
+        // any other use of the table, such as passing it to a function, may change it
+        if (node->local == table)
+            escaped = true;
+
+        return false;
+    }
+
+    bool visit(AstExprIndexName* node) override
+    {
+        // reading a field doesn't change the table
+        return !isField(node);
+    }
+
+    bool visit(AstExprCall* node) override
+    {
+        // method calls pass the table as self
+        if (node->self && isField(node->func))
+            escaped = true;
+
+        return true;
+    }
+
+    bool visit(AstStatAssign* node) override
+    {
+        for (size_t i = 0; i < node->vars.size; ++i)
+        {
+            if (isField(node->vars.data[i]))
+                escaped |= !assignments.contains(node);
+            else
+                node->vars.data[i]->visit(this);
+        }
+
+        for (size_t i = 0; i < node->values.size; ++i)
+            node->values.data[i]->visit(this);
+
+        return false;
+    }
+
+    bool visit(AstStatCompoundAssign* node) override
+    {
+        if (isField(node->var))
+            escaped = true;
+
+        return true;
+    }
+
+    bool visit(AstStatFunction* node) override
+    {
+        if (isField(node->name))
+            escaped |= !assignments.contains(node);
+        else
+            node->name->visit(this);
+
+        node->func->visit(this);
+
+        return false;
+    }
+};
+
+struct ModuleReturnVisitor : AstVisitor
+{
+    bool found = false;
+
+    bool visit(AstExprFunction* node) override
+    {
+        // returns from nested functions don't end the module
+        return false;
+    }
+
+    bool visit(AstStatReturn* node) override
+    {
+        found = true;
+
+        return false;
+    }
+};
+
+static AstExpr* getFrozenTable(const DenseHashMap<AstName, Global>& globals, AstExpr* node)
+{
+    AstExprCall* call = node->as<AstExprCall>();
+    if (!call || call->self || call->args.size != 1)
+        return nullptr;
+
+    AstExprIndexName* func = call->func->as<AstExprIndexName>();
+    AstExprGlobal* lib = func ? func->expr->as<AstExprGlobal>() : nullptr;
+
+    if (!lib || lib->name != "table" || func->index != "freeze" || getGlobalState(globals, lib->name) != Global::Default)
+        return nullptr;
+
+    return call->args.data[0];
+}
+
+static void addField(ModuleExports& exports, const AstNameTable& names, const char* name, size_t length, AstExpr* value)
+{
+    if (AstName key = names.getWithType(name, length).first; key.value)
+        exports.fields[key] = value;
+}
+
+static bool addConstructorFields(ModuleExports& exports, const AstNameTable& names, AstExprTable* expr)
+{
+    for (const AstExprTable::Item& item : expr->items)
+    {
+        if (item.kind == AstExprTable::Item::List)
+            continue;
+
+        // fields with keys that aren't known at compile time may replace any other field
+        AstExprConstantString* key = item.key->as<AstExprConstantString>();
+        if (!key)
+            return false;
+
+        addField(exports, names, key->value.data, key->value.size, item.value);
+    }
+
+    return true;
+}
+
+bool trackModuleExports(ModuleExports& exports, const DenseHashMap<AstName, Global>& globals, const DenseHashMap<AstLocal*, Variable>& variables,
+    const AstNameTable& names, AstStatBlock* root)
+{
+    if (root->body.size == 0)
+        return false;
+
+    AstStatReturn* ret = root->body.data[root->body.size - 1]->as<AstStatReturn>();
+    AstExpr* frozen = ret && ret->list.size == 1 ? getFrozenTable(globals, ret->list.data[0]) : nullptr;
+
+    if (!frozen)
+        return false;
+
+    // the module can return something else from an earlier statement
+    ModuleReturnVisitor returns;
+
+    for (size_t i = 0; i + 1 < root->body.size; ++i)
+        root->body.data[i]->visit(&returns);
+
+    if (returns.found)
+        return false;
+
+    if (AstExprTable* expr = frozen->as<AstExprTable>())
+        return addConstructorFields(exports, names, expr);
+
+    AstExprLocal* local = frozen->as<AstExprLocal>();
+    const Variable* v = local ? variables.find(local->local) : nullptr;
+
+    if (!v || v->written || !v->init || !v->init->is<AstExprTable>() || !addConstructorFields(exports, names, v->init->as<AstExprTable>()))
+        return false;
+
+    ModuleTableVisitor visitor(local->local);
+
+    // since top level statements run in order before the table is frozen, the last assignment to each field determines its value
+    for (size_t i = 0; i + 1 < root->body.size; ++i)
+    {
+        AstStat* stat = root->body.data[i];
+
+        if (AstStatAssign* assign = stat->as<AstStatAssign>(); assign && assign->vars.size == 1 && assign->values.size == 1)
+        {
+            if (visitor.isField(assign->vars.data[0]))
+            {
+                visitor.assignments.insert(stat);
+                AstName key = assign->vars.data[0]->as<AstExprIndexName>()->index;
+                addField(exports, names, key.value, strlen(key.value), assign->values.data[0]);
+            }
+        }
+        else if (AstStatFunction* func = stat->as<AstStatFunction>(); func && visitor.isField(func->name))
+        {
+            visitor.assignments.insert(stat);
+            AstName key = func->name->as<AstExprIndexName>()->index;
+            addField(exports, names, key.value, strlen(key.value), func->func);
+        }
+
+        stat->visit(&visitor);
+    }
+
+    return !visitor.escaped;
+}
+
+AstExpr* getRequiredField(const DenseHashMap<AstExprCall*, ModuleExports>& modules, const DenseHashMap<AstLocal*, Variable>& variables,
+    AstExprIndexName* expr)
+{
+    AstExprLocal* object = expr->expr->as<AstExprLocal>();
+    const Variable* v = object ? variables.find(object->local) : nullptr;
+
+    if (!v || v->written || !v->init || !v->init->is<AstExprCall>())
+        return nullptr;
+
+    const ModuleExports* exports = modules.find(v->init->as<AstExprCall>());
+    AstExpr* const* value = exports ? exports->fields.find(expr->index) : nullptr;
+
+    return value ? *value : nullptr;
+}
+
+} // namespace Compile
+} // namespace Luau
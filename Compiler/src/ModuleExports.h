@@ -0,0 +1,29 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "ValueTracking.h"
+
+namespace Luau
+{
+namespace Compile
+{
+
+struct ModuleExports
+{
+    DenseHashMap<AstName, AstExpr*> fields{AstName()}; // final value of each field of the table that the module returns
+};
+
+// tracks the fields of the table that the module returns as `table.freeze(t)`, where t is a table constructor or a local initialized with one
+// that is only used to read fields and to assign them in statements at the top level of the module; since the table can't change after it's
+// returned, code that requires the module observes these values; returns false if the module doesn't return a table like that
+// fields are keyed by names from the name table of the module that requires it, and fields that it never names are skipped
+bool trackModuleExports(ModuleExports& exports, const DenseHashMap<AstName, Global>& globals, const DenseHashMap<AstLocal*, Variable>& variables,
+    const AstNameTable& names, AstStatBlock* root);
+
+// returns the value of the field that the expression reads from a module, if it reads from a local that is initialized with a require call
+// of one of the modules and that is never reassigned
+AstExpr* getRequiredField(const DenseHashMap<AstExprCall*, ModuleExports>& modules, const DenseHashMap<AstLocal*, Variable>& variables,
+    AstExprIndexName* expr);
+
+} // namespace Compile
+} // namespace Luau
@@ -0,0 +1,150 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "ScalarReplacement.h"
+
+#include <algorithm>
+
+namespace Luau
+{
+namespace Compile
+{
+
+// conservative limit for the number of registers that hold the fields of a single table
+static const size_t kMaxScalarFields = 8;
+
+struct ScalarTableVisitor : AstVisitor
+{
+    DenseHashMap<AstLocal*, ScalarTable>& tables;
+
+    const DenseHashMap<AstLocal*, Variable>& variables;
+    const DenseHashMap<AstExpr*, Constant>& constants;
+
+    DenseHashMap<AstLocal*, AstExprFunction*> owners;
+    DenseHashSet<AstLocal*> escaped;
+
+    AstExprFunction* function = nullptr;
+
+    ScalarTableVisitor(DenseHashMap<AstLocal*, ScalarTable>& tables, const DenseHashMap<AstLocal*, Variable>& variables,
+        const DenseHashMap<AstExpr*, Constant>& constants)
+        : tables(tables)
+        , variables(variables)
+        , constants(constants)
+        , owners(nullptr)
+        , escaped(nullptr)
+    {
+    }
+
+    void track(AstLocal* local)
+    {
+        // parameters are only tracked as variables when they are assigned to
+        if (const Variable* v = variables.find(local); !v || !v->written)
+        {
+            owners[local] = function;
+            tables[local] = ScalarTable();
+        }
+    }
+
+    bool visit(AstExprFunction* node) override
+    {
+        AstExprFunction* outer = function;
+
+        function = node;
+
+        for (size_t i = 0; i < node->args.size; ++i)
+            track(node->args.data[i]);
+
+        node->body->visit(this);
+        function = outer;
+
+        return false;
+    }
+
+    bool visit(AstStatLocal* node) override
+    {
+        if (node->vars.size == 1 && node->values.size == 1)
+            if (AstExprTable* table = node->values.data[0]->as<AstExprTable>(); table && isScalarConstructor(table, constants))
+                track(node->vars.data[0]);
+
+        return true;
+    }
+
+    bool visit(AstExprLocal* node) override
+    {
+        // any reference other than a field access may let the table leave the function
+        escaped.insert(node->local);
+
+        return false;
+    }
+
+    bool visit(AstExprIndexName* node) override
+    {
+        AstExprLocal* expr = node->expr->as<AstExprLocal>();
+        AstExprFunction** owner = expr ? owners.find(expr->local) : nullptr;
+
+        if (!owner)
+            return true;
+
+        // fields can't be kept in registers of another function
+        if (*owner != function)
+        {
+            escaped.insert(expr->local);
+            return false;
+        }
+
+        std::vector<std::string>& fields = tables[expr->local].fields;
+
+        if (std::find(fields.begin(), fields.end(), node->index.value) == fields.end())
+            fields.push_back(node->index.value);
+
+        return false;
+    }
+
+    bool visit(AstExprCall* node) override
+    {
+        if (!node->self)
+            return true;
+
+        // method calls pass the table as self
+        AstExprIndexName* func = node->func->as<AstExprIndexName>();
+        LUAU_ASSERT(func);
+
+        func->expr->visit(this);
+
+        for (size_t i = 0; i < node->args.size; ++i)
+            node->args.data[i]->visit(this);
+
+        return false;
+    }
+};
+
+void trackScalarTables(DenseHashMap<AstLocal*, ScalarTable>& tables, const DenseHashMap<AstLocal*, Variable>& variables,
+    const DenseHashMap<AstExpr*, Constant>& constants, AstNode* root)
+{
+    DenseHashMap<AstLocal*, ScalarTable> candidates(nullptr);
+
+    ScalarTableVisitor visitor{candidates, variables, constants};
+    root->visit(&visitor);
+
+    // tables without field accesses are left alone since they are most likely allocated on purpose, e.g. to create garbage
+    for (const auto& item : candidates)
+        if (!visitor.escaped.contains(item.first) && !item.second.fields.empty() && item.second.fields.size() <= kMaxScalarFields)
+            tables[item.first] = item.second;
+}
+
+bool isScalarConstructor(AstExprTable* expr, const DenseHashMap<AstExpr*, Constant>& constants)
+{
+    for (const AstExprTable::Item& item : expr->items)
+    {
+        if (item.kind == AstExprTable::Item::List)
+            return false;
+
+        const Constant* key = constants.find(item.key);
+
+        if (!key || key->type != Constant::Type_String)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace Compile
+} // namespace Luau
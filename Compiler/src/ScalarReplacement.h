@@ -0,0 +1,29 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "ConstantFolding.h"
+
+#include <string>
+#include <vector>
+
+namespace Luau
+{
+namespace Compile
+{
+
+struct ScalarTable
+{
+    std::vector<std::string> fields; // names of the fields the code accesses; each one is kept in its own register, in this order
+};
+
+// tracks locals initialized with a table constructor that only has constant string keys, and function parameters, that are never
+// reassigned and are only used to read and write fields with constant names in the function that declares them; such tables can't be
+// observed by any other code, so their fields can be kept in registers instead of allocating the table
+void trackScalarTables(DenseHashMap<AstLocal*, ScalarTable>& tables, const DenseHashMap<AstLocal*, Variable>& variables,
+    const DenseHashMap<AstExpr*, Constant>& constants, AstNode* root);
+
+// returns true if every item of the table constructor has a constant string key
+bool isScalarConstructor(AstExprTable* expr, const DenseHashMap<AstExpr*, Constant>& constants);
+
+} // namespace Compile
+} // namespace Luau
@@ -0,0 +1,148 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "StringAppends.h"
+
+#include "Luau/DenseHash.h"
+
+namespace Luau
+{
+namespace Compile
+{
+
+struct StringAppendVisitor : AstVisitor
+{
+    DenseHashMap<AstLocal*, bool> appends; // true if all uses of the local so far are appends
+    std::vector<AstLocal*> order;          // locals in the order of their first use, so that register allocation is deterministic
+
+    DenseHashSet<AstLocal*> declared;
+
+    int functions = 0;
+
+    StringAppendVisitor()
+        : appends(nullptr)
+        , declared(nullptr)
+    {
+    }
+
+    void use(AstLocal* local, bool append)
+    {
+        if (bool* ok = appends.find(local))
+        {
+            *ok = *ok && append;
+        }
+        else
+        {
+            appends[local] = append;
+            order.push_back(local);
+        }
+    }
+
+    bool append(AstStat* node)
+    {
+        // functions declared in the loop can run after it exits, so their appends are regular uses
+        AstLocal* local = functions == 0 ? getStringAppendTarget(node) : nullptr;
+        if (!local)
+            return false;
+
+        use(local, true);
+
+        // the appended strings can't refer to the target
+        if (AstStatCompoundAssign* stat = node->as<AstStatCompoundAssign>())
+            stat->value->visit(this);
+        else
+            node->as<AstStatAssign>()->values.data[0]->as<AstExprBinary>()->right->visit(this);
+
+        return true;
+    }
+
+    bool visit(AstExprLocal* node) override
+    {
+        use(node->local, false);
+
+        return false;
+    }
+
+    bool visit(AstExprFunction* node) override
+    {
+        functions++;
+        node->body->visit(this);
+        functions--;
+
+        return false;
+    }
+
+    bool visit(AstStatAssign* node) override
+    {
+        return !append(node);
+    }
+
+    bool visit(AstStatCompoundAssign* node) override
+    {
+        return !append(node);
+    }
+
+    bool visit(AstStatLocal* node) override
+    {
+        for (size_t i = 0; i < node->vars.size; ++i)
+            declared.insert(node->vars.data[i]);
+
+        return true;
+    }
+
+    bool visit(AstStatLocalFunction* node) override
+    {
+        declared.insert(node->name);
+
+        return true;
+    }
+
+    bool visit(AstStatFor* node) override
+    {
+        declared.insert(node->var);
+
+        return true;
+    }
+
+    bool visit(AstStatForIn* node) override
+    {
+        for (size_t i = 0; i < node->vars.size; ++i)
+            declared.insert(node->vars.data[i]);
+
+        return true;
+    }
+};
+
+AstLocal* getStringAppendTarget(AstStat* node)
+{
+    if (AstStatCompoundAssign* stat = node->as<AstStatCompoundAssign>())
+    {
+        if (AstExprLocal* var = stat->var->as<AstExprLocal>(); var && !var->upvalue && stat->op == AstExprBinary::Concat)
+            return var->local;
+    }
+    else if (AstStatAssign* stat = node->as<AstStatAssign>(); stat && stat->vars.size == 1 && stat->values.size == 1)
+    {
+        AstExprLocal* var = stat->vars.data[0]->as<AstExprLocal>();
+        AstExprBinary* value = stat->values.data[0]->as<AstExprBinary>();
+
+        if (var && !var->upvalue && value && value->op == AstExprBinary::Concat)
+            if (AstExprLocal* first = value->left->as<AstExprLocal>(); first && first->local == var->local)
+                return var->local;
+    }
+
+    return nullptr;
+}
+
+void findStringAppends(std::vector<AstLocal*>& result, AstStat* body, AstExpr* condition)
+{
+    StringAppendVisitor visitor;
+    body->visit(&visitor);
+
+    if (condition)
+        condition->visit(&visitor);
+
+    for (AstLocal* local : visitor.order)
+        if (visitor.appends[local] && !visitor.declared.contains(local))
+            result.push_back(local);
+}
+
+} // namespace Compile
+} // namespace Luau
@@ -0,0 +1,21 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/Ast.h"
+
+#include <vector>
+
+namespace Luau
+{
+namespace Compile
+{
+
+// returns the local that the statement appends strings to, when it has the form 'local = local .. a .. b' or 'local ..= a'
+AstLocal* getStringAppendTarget(AstStat* node);
+
+// finds locals declared outside of the loop that the loop body and condition only use as targets of appends (see getStringAppendTarget), and
+// that functions declared in the loop don't use; no code in the loop can observe the strings that such locals hold until the loop exits
+void findStringAppends(std::vector<AstLocal*>& result, AstStat* body, AstExpr* condition);
+
+} // namespace Compile
+} // namespace Luau
@@ -0,0 +1,151 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Types.h"
+
+#include "Luau/Bytecode.h"
+
+namespace Luau
+{
+namespace Compile
+{
+
+struct TypeAliasVisitor : AstVisitor
+{
+    DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases;
+
+    TypeAliasVisitor(DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases)
+        : typeAliases(typeAliases)
+    {
+    }
+
+    bool visit(AstStatTypeAlias* node) override
+    {
+        // aliases in different scopes can share the name, in which case we can't tell which one a reference refers to
+        if (typeAliases.contains(node->name))
+            typeAliases[node->name] = nullptr;
+        else
+            typeAliases[node->name] = node;
+
+        return false;
+    }
+
+    bool visit(AstType* node) override
+    {
+        return false;
+    }
+};
+
+static LuauBytecodeType getPrimitiveType(AstName name)
+{
+    if (name == "nil")
+        return LBC_TYPE_NIL;
+    else if (name == "boolean")
+        return LBC_TYPE_BOOLEAN;
+    else if (name == "number")
+        return LBC_TYPE_NUMBER;
+    else if (name == "string")
+        return LBC_TYPE_STRING;
+    else if (name == "thread")
+        return LBC_TYPE_THREAD;
+    else if (name == "vector")
+        return LBC_TYPE_VECTOR;
+    else
+        return LBC_TYPE_ANY;
+}
+
+static LuauBytecodeType getType(AstType* ty, const DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases, bool resolveAliases)
+{
+    if (AstTypeReference* ref = ty->as<AstTypeReference>())
+    {
+        // types exported from other modules are unknown at compile time
+        if (ref->prefix)
+            return LBC_TYPE_ANY;
+
+        if (AstStatTypeAlias* const* alias = typeAliases.find(ref->name))
+        {
+            // aliases are only resolved one level deep, which avoids dealing with recursive aliases
+            if (*alias && resolveAliases)
+                return getType((*alias)->type, typeAliases, /* resolveAliases= */ false);
+
+            return LBC_TYPE_ANY;
+        }
+
+        return getPrimitiveType(ref->name);
+    }
+    else if (ty->is<AstTypeTable>())
+    {
+        return LBC_TYPE_TABLE;
+    }
+    else if (ty->is<AstTypeFunction>())
+    {
+        return LBC_TYPE_FUNCTION;
+    }
+    else if (ty->is<AstTypeSingletonBool>())
+    {
+        return LBC_TYPE_BOOLEAN;
+    }
+    else if (ty->is<AstTypeSingletonString>())
+    {
+        return LBC_TYPE_STRING;
+    }
+    else if (AstTypeUnion* un = ty->as<AstTypeUnion>())
+    {
+        bool optional = false;
+        LuauBytecodeType type = LBC_TYPE_INVALID;
+
+        for (AstType* option : un->types)
+        {
+            LuauBytecodeType et = getType(option, typeAliases, resolveAliases);
+
+            if (et == LBC_TYPE_NIL)
+            {
+                optional = true;
+                continue;
+            }
+
+            if (type == LBC_TYPE_INVALID)
+                type = et;
+            else if (type != et)
+                return LBC_TYPE_ANY;
+        }
+
+        if (type == LBC_TYPE_INVALID)
+            return LBC_TYPE_NIL;
+
+        return LuauBytecodeType(type | (optional && type != LBC_TYPE_ANY ? LBC_TYPE_OPTIONAL_BIT : 0));
+    }
+
+    return LBC_TYPE_ANY;
+}
+
+void trackTypeAliases(DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases, AstNode* root)
+{
+    TypeAliasVisitor visitor{typeAliases};
+    root->visit(&visitor);
+}
+
+std::string getFunctionTypeInfo(
+    AstExprFunction* func, const DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases, const DenseHashMap<AstLocal*, Variable>& variables)
+{
+    std::string typeinfo;
+
+    typeinfo.push_back(LBC_TYPE_FUNCTION);
+    typeinfo.push_back(uint8_t(func->self != nullptr) + uint8_t(func->args.size));
+
+    if (func->self)
+        typeinfo.push_back(LBC_TYPE_ANY);
+
+    for (AstLocal* arg : func->args)
+    {
+        const Variable* v = variables.find(arg);
+
+        if (arg->annotation && !(v && v->written))
+            typeinfo.push_back(getType(arg->annotation, typeAliases, /* resolveAliases= */ true));
+        else
+            typeinfo.push_back(LBC_TYPE_ANY);
+    }
+
+    return typeinfo;
+}
+
+} // namespace Compile
+} // namespace Luau
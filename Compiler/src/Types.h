@@ -0,0 +1,22 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "ValueTracking.h"
+
+#include <string>
+
+namespace Luau
+{
+namespace Compile
+{
+
+// collects type aliases declared in the module; aliases that are declared more than once are mapped to nullptr
+void trackTypeAliases(DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases, AstNode* root);
+
+// builds the type information block of the function from the parameter type annotations (see LuauBytecodeType)
+// parameters that are assigned to in the function body are encoded as 'any' so that the types hold for the entire function
+std::string getFunctionTypeInfo(
+    AstExprFunction* func, const DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases, const DenseHashMap<AstLocal*, Variable>& variables);
+
+} // namespace Compile
+} // namespace Luau
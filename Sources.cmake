@@ -42,14 +42,24 @@ target_sources(Luau.Compiler PRIVATE
     Compiler/src/BuiltinFolding.cpp
     Compiler/src/ConstantFolding.cpp
     Compiler/src/CostModel.cpp
+    Compiler/src/LoopInvariants.cpp
+    Compiler/src/ModuleExports.cpp
+    Compiler/src/ScalarReplacement.cpp
+    Compiler/src/StringAppends.cpp
     Compiler/src/TableShape.cpp
+    Compiler/src/Types.cpp
     Compiler/src/ValueTracking.cpp
     Compiler/src/lcode.cpp
     Compiler/src/Builtins.h
     Compiler/src/BuiltinFolding.h
     Compiler/src/ConstantFolding.h
     Compiler/src/CostModel.h
+    Compiler/src/LoopInvariants.h
+    Compiler/src/ModuleExports.h
+    Compiler/src/ScalarReplacement.h
+    Compiler/src/StringAppends.h
     Compiler/src/TableShape.h
+    Compiler/src/Types.h
     Compiler/src/ValueTracking.h
 )
 
@@ -58,6 +68,7 @@ target_sources(Luau.CodeGen PRIVATE
     CodeGen/include/Luau/AssemblyBuilderX64.h
     CodeGen/include/Luau/CodeAllocator.h
     CodeGen/include/Luau/CodeBlockUnwind.h
+    CodeGen/include/Luau/CodeGen.h
     CodeGen/include/Luau/Condition.h
     CodeGen/include/Luau/Label.h
     CodeGen/include/Luau/OperandX64.h
@@ -69,8 +80,16 @@ target_sources(Luau.CodeGen PRIVATE
     CodeGen/src/AssemblyBuilderX64.cpp
     CodeGen/src/CodeAllocator.cpp
     CodeGen/src/CodeBlockUnwind.cpp
+    CodeGen/src/CodeGen.cpp
+    CodeGen/src/EmitCommonX64.cpp
+    CodeGen/src/EmitInstructionX64.cpp
+    CodeGen/src/Fallbacks.cpp
     CodeGen/src/UnwindBuilderDwarf2.cpp
     CodeGen/src/UnwindBuilderWin.cpp
+
+    CodeGen/src/EmitCommonX64.h
+    CodeGen/src/EmitInstructionX64.h
+    CodeGen/src/Fallbacks.h
 )
 
 # Luau.Analysis Sources
@@ -97,6 +116,7 @@ target_sources(Luau.Analysis PRIVATE
     Analysis/include/Luau/Linter.h
     Analysis/include/Luau/LValue.h
     Analysis/include/Luau/Module.h
+    Analysis/include/Luau/ModuleCache.h
     Analysis/include/Luau/ModuleResolver.h
     Analysis/include/Luau/Normalize.h
     Analysis/include/Luau/Predicate.h
@@ -146,6 +166,7 @@ target_sources(Luau.Analysis PRIVATE
     Analysis/src/Linter.cpp
     Analysis/src/LValue.cpp
     Analysis/src/Module.cpp
+    Analysis/src/ModuleCache.cpp
     Analysis/src/Normalize.cpp
     Analysis/src/Quantify.cpp
     Analysis/src/RequireTracer.cpp
@@ -179,7 +200,10 @@ target_sources(Luau.VM PRIVATE
     VM/src/laux.cpp
     VM/src/lbaselib.cpp
     VM/src/lbitlib.cpp
+    VM/src/lbuffer.cpp
+    VM/src/lbuflib.cpp
     VM/src/lbuiltins.cpp
+    VM/src/lclone.cpp
     VM/src/lcorolib.cpp
     VM/src/ldblib.cpp
     VM/src/ldebug.cpp
@@ -206,6 +230,7 @@ target_sources(Luau.VM PRIVATE
     VM/src/lvmload.cpp
     VM/src/lvmutils.cpp
     VM/src/lapi.h
+    VM/src/lbuffer.h
     VM/src/lbuiltins.h
     VM/src/lbytecode.h
     VM/src/lcommon.h
@@ -238,6 +263,8 @@ if(TARGET Luau.Repl.CLI)
         CLI/FileUtils.cpp
         CLI/Flags.h
         CLI/Flags.cpp
+        CLI/OpStats.h
+        CLI/OpStats.cpp
         CLI/Profiler.h
         CLI/Profiler.cpp
         CLI/Repl.cpp
@@ -350,6 +377,8 @@ if(TARGET Luau.CLI.Test)
         CLI/FileUtils.cpp
         CLI/Flags.h
         CLI/Flags.cpp
+        CLI/OpStats.h
+        CLI/OpStats.cpp
         CLI/Profiler.h
         CLI/Profiler.cpp
         CLI/Repl.cpp
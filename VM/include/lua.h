@@ -85,11 +85,13 @@ enum lua_Type
     LUA_TFUNCTION,
     LUA_TUSERDATA,
     LUA_TTHREAD,
+    LUA_TBUFFER,
 
     // values below this line are used in GCObject tags but may never show up in TValue type tags
     LUA_TPROTO,
     LUA_TUPVAL,
     LUA_TDEADKEY,
+    LUA_TSHAPE,
 
     // the count of TValue type tags
     LUA_T_COUNT = LUA_TPROTO
@@ -162,6 +164,7 @@ LUA_API void* lua_touserdata(lua_State* L, int idx);
 LUA_API void* lua_touserdatatagged(lua_State* L, int idx, int tag);
 LUA_API int lua_userdatatag(lua_State* L, int idx);
 LUA_API lua_State* lua_tothread(lua_State* L, int idx);
+LUA_API void* lua_tobuffer(lua_State* L, int idx, size_t* len);
 LUA_API const void* lua_topointer(lua_State* L, int idx);
 
 /*
@@ -188,6 +191,9 @@ LUA_API void lua_pushlightuserdata(lua_State* L, void* p);
 LUA_API void* lua_newuserdatatagged(lua_State* L, size_t sz, int tag);
 LUA_API void* lua_newuserdatadtor(lua_State* L, size_t sz, void (*dtor)(void*));
 
+// buffer contents are zero-initialized and stay at the same address for the lifetime of the buffer, so native code can read and write them in place
+LUA_API void* lua_newbuffer(lua_State* L, size_t sz);
+
 /*
 ** get functions (Lua -> stack)
 */
@@ -220,6 +226,15 @@ LUA_API int lua_setfenv(lua_State* L, int idx);
 ** `load' and `call' functions (load and run Luau bytecode)
 */
 LUA_API int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size, int env);
+
+// functions loaded with luau_loadlazy keep a copy of the bytecode and are only decoded when they are first called or inspected by the debug API,
+// which makes loading cheaper for scripts that don't run most of their functions; imports are resolved when the function is decoded
+LUA_API int luau_loadlazy(lua_State* L, const char* chunkname, const char* data, size_t size, int env);
+
+// bytecode images can be loaded by any number of states without copying the code of their functions; the image data must be 4-byte aligned
+// and must outlive all functions loaded from it. the code is never modified, so breakpoints and coverage aren't supported for these functions
+LUA_API char* luau_buildimage(const char* data, size_t size, size_t* outsize); // returns a malloc'd image, or NULL if bytecode is malformed
+LUA_API int luau_loadimage(lua_State* L, const char* chunkname, const char* data, size_t size, int env);
 LUA_API void lua_call(lua_State* L, int nargs, int nresults);
 LUA_API int lua_pcall(lua_State* L, int nargs, int nresults, int errfunc);
 
@@ -285,6 +300,34 @@ enum lua_GCOp
     LUA_GCSETGOAL,
     LUA_GCSETSTEPMUL,
     LUA_GCSETSTEPSIZE,
+
+    /*
+    ** switch the collector to incremental or generational mode; returns the previous mode (LUA_GCINC or LUA_GCGEN)
+    **
+    ** in generational mode, objects that survive a collection become old and are only revisited by major collections, while
+    ** minor collections only process objects allocated since the last collection. this reduces the total GC work for applications
+    ** that allocate many short-lived objects, but each collection runs to completion in a single step instead of being incremental.
+    */
+    LUA_GCINC,
+    LUA_GCGEN,
+
+    /*
+    ** tune generational mode parameters (specified in percentages)
+    **
+    ** minor multiplier controls how much the heap can grow before a minor collection runs; by default 20% of heap size
+    ** major multiplier controls how much the heap can grow compared to its size after the last major collection before a major
+    ** collection runs instead of a minor one; by default 100%, which means a major collection happens when the heap doubles
+    */
+    LUA_GCSETGENMINORMUL,
+    LUA_GCSETGENMAJORMUL,
+
+    /*
+    ** set the maximum number of empty pages that the allocator keeps around for reuse; returns the previous limit
+    **
+    ** caching pages reduces allocation traffic for workloads that repeatedly allocate and free many objects, at the cost of
+    ** retaining up to ~16 KB of memory per cached page. setting the limit to 0 disables the cache and releases cached pages.
+    */
+    LUA_GCSETPAGECACHE,
 };
 
 LUA_API int lua_gc(lua_State* L, int what, int data);
@@ -297,6 +340,9 @@ LUA_API int lua_gc(lua_State* L, int what, int data);
 LUA_API void lua_setmemcat(lua_State* L, int category);
 LUA_API size_t lua_totalbytes(lua_State* L, int category);
 
+// page cache statistics: number of page allocations served from the cache, allocations that needed a new page, and pages in the cache
+LUA_API void lua_pagecachestats(lua_State* L, size_t* hits, size_t* misses, int* pages);
+
 /*
 ** miscellaneous functions
 */
@@ -316,6 +362,10 @@ LUA_API void lua_setuserdatadtor(lua_State* L, int tag, void (*dtor)(lua_State*,
 
 LUA_API void lua_clonefunction(lua_State* L, int idx);
 
+// creates a state with copies of all objects that are reachable from the registry, globals, type metatables and stack of the main thread
+// returns NULL if a thread of the state is running or suspended, or if it has userdata with destructors
+LUA_API lua_State* lua_clonestate(lua_State* L);
+
 /*
 ** reference system, can be used to pin objects
 */
@@ -350,6 +400,7 @@ LUA_API void lua_unref(lua_State* L, int ref);
 #define lua_isboolean(L, n) (lua_type(L, (n)) == LUA_TBOOLEAN)
 #define lua_isvector(L, n) (lua_type(L, (n)) == LUA_TVECTOR)
 #define lua_isthread(L, n) (lua_type(L, (n)) == LUA_TTHREAD)
+#define lua_isbuffer(L, n) (lua_type(L, (n)) == LUA_TBUFFER)
 #define lua_isnone(L, n) (lua_type(L, (n)) == LUA_TNONE)
 #define lua_isnoneornil(L, n) (lua_type(L, (n)) <= LUA_TNIL)
 
@@ -390,6 +441,11 @@ typedef void (*lua_Coverage)(void* context, const char* function, int linedefine
 
 LUA_API void lua_getcoverage(lua_State* L, int funcindex, void* context, lua_Coverage callback);
 
+typedef void (*lua_OpStats)(void* context, int op, int nextop, uint64_t count);
+
+// reports how many times the interpreter executed each pair of opcodes back to back; only recorded when the VM is built with LUAI_OPSTATS
+LUA_API void lua_getopstats(lua_State* L, void* context, lua_OpStats callback);
+
 // Warning: this function is not thread-safe since it stores the result in a shared global array! Only use for debugging.
 LUA_API const char* lua_debugtrace(lua_State* L);
 
@@ -428,6 +484,10 @@ struct lua_Callbacks
     void (*debugstep)(lua_State* L, lua_Debug* ar);      // gets called after each instruction in single step mode
     void (*debuginterrupt)(lua_State* L, lua_Debug* ar); // gets called when thread execution is interrupted by break in another thread
     void (*debugprotectederror)(lua_State* L);           // gets called when protected call results in an error
+
+    // gets called when line info or local names of a function are first needed, if the function was loaded while this was set and its bytecode has
+    // no debug info of its own; returns the sidecar of the bytecode with the given hash (or NULL), which only needs to stay valid during the call
+    const char* (*debuginfo)(lua_State* L, const char* chunkname, unsigned int hash, size_t* size);
 };
 typedef struct lua_Callbacks lua_Callbacks;
 
@@ -104,11 +104,26 @@
 #define LUA_MINSTRTABSIZE 32
 #endif
 
+// number of string table buckets moved to the new array on each string insertion while the table is being resized (must be positive)
+#ifndef LUAI_STRTABREHASHSTEP
+#define LUAI_STRTABREHASHSTEP 4
+#endif
+
+// maximum number of string keys that tables can keep in a shape before they switch to a regular hash (must be below 256)
+#ifndef LUAI_MAXSHAPEKEYS
+#define LUAI_MAXSHAPEKEYS 16
+#endif
+
 // maximum number of captures supported by pattern matching
 #ifndef LUA_MAXCAPTURES
 #define LUA_MAXCAPTURES 32
 #endif
 
+// enables callbacks to redirect code execution from Luau VM to a custom implementation
+#ifndef LUA_CUSTOM_EXECUTION
+#define LUA_CUSTOM_EXECUTION 1
+#endif
+
 // }==================================================================
 
 /*
@@ -36,6 +36,8 @@ LUALIB_API unsigned luaL_optunsigned(lua_State* L, int numArg, unsigned def);
 LUALIB_API const float* luaL_checkvector(lua_State* L, int narg);
 LUALIB_API const float* luaL_optvector(lua_State* L, int narg, const float* def);
 
+LUALIB_API void* luaL_checkbuffer(lua_State* L, int narg, size_t* len);
+
 LUALIB_API void luaL_checkstack(lua_State* L, int sz, const char* msg);
 LUALIB_API void luaL_checktype(lua_State* L, int narg, int t);
 LUALIB_API void luaL_checkany(lua_State* L, int narg);
@@ -123,6 +125,9 @@ LUALIB_API int luaopen_bit32(lua_State* L);
 #define LUA_UTF8LIBNAME "utf8"
 LUALIB_API int luaopen_utf8(lua_State* L);
 
+#define LUA_BUFFERLIBNAME "buffer"
+LUALIB_API int luaopen_buffer(lua_State* L);
+
 #define LUA_MATHLIBNAME "math"
 LUALIB_API int luaopen_math(lua_State* L);
 
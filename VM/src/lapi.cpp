@@ -7,8 +7,10 @@
 #include "ltable.h"
 #include "lfunc.h"
 #include "lgc.h"
+#include "lmem.h"
 #include "ldo.h"
 #include "ludata.h"
+#include "lbuffer.h"
 #include "lvm.h"
 #include "lnumutils.h"
 
@@ -486,6 +488,8 @@ int lua_objlen(lua_State* L, int idx)
         return tsvalue(o)->len;
     case LUA_TUSERDATA:
         return uvalue(o)->len;
+    case LUA_TBUFFER:
+        return bufvalue(o)->len;
     case LUA_TTABLE:
         return luaH_getn(hvalue(o));
     default:
@@ -536,6 +540,21 @@ lua_State* lua_tothread(lua_State* L, int idx)
     return (!ttisthread(o)) ? NULL : thvalue(o);
 }
 
+void* lua_tobuffer(lua_State* L, int idx, size_t* len)
+{
+    StkId o = index2addr(L, idx);
+
+    if (!ttisbuffer(o))
+        return NULL;
+
+    Buffer* b = bufvalue(o);
+
+    if (len)
+        *len = b->len;
+
+    return b->data;
+}
+
 const void* lua_topointer(lua_State* L, int idx)
 {
     StkId o = index2addr(L, idx);
@@ -549,6 +568,8 @@ const void* lua_topointer(lua_State* L, int idx)
         return thvalue(o);
     case LUA_TUSERDATA:
         return uvalue(o)->data;
+    case LUA_TBUFFER:
+        return bufvalue(o)->data;
     case LUA_TLIGHTUSERDATA:
         return pvalue(o);
     default:
@@ -722,7 +743,8 @@ int lua_rawget(lua_State* L, int idx)
     luaC_threadbarrier(L);
     StkId t = index2addr(L, idx);
     api_check(L, ttistable(t));
-    setobj2s(L, L->top - 1, luaH_get(hvalue(t), L->top - 1));
+    TValue tmp;
+    setobj2s(L, L->top - 1, luaH_getvalue(hvalue(t), L->top - 1, &tmp));
     return ttype(L->top - 1);
 }
 
@@ -731,7 +753,8 @@ int lua_rawgeti(lua_State* L, int idx, int n)
     luaC_threadbarrier(L);
     StkId t = index2addr(L, idx);
     api_check(L, ttistable(t));
-    setobj2s(L, L->top, luaH_getnum(hvalue(t), n));
+    TValue tmp;
+    setobj2s(L, L->top, luaH_getnumvalue(hvalue(t), n, &tmp));
     api_incr_top(L);
     return ttype(L->top - 1);
 }
@@ -865,8 +888,11 @@ void lua_rawset(lua_State* L, int idx)
     api_check(L, ttistable(t));
     if (hvalue(t)->readonly)
         luaG_readonlyerror(L);
-    setobj2t(L, luaH_set(L, hvalue(t), L->top - 2), L->top - 1);
-    luaC_barriert(L, hvalue(t), L->top - 1);
+    if (!hvalue(t)->numarray || !ttisnumber(L->top - 2) || !luaH_setpacked(L, hvalue(t), L->top - 2, L->top - 1))
+    {
+        setobj2t(L, luaH_set(L, hvalue(t), L->top - 2), L->top - 1);
+        luaC_barriert(L, hvalue(t), L->top - 1);
+    }
     L->top -= 2;
     return;
 }
@@ -878,8 +904,13 @@ void lua_rawseti(lua_State* L, int idx, int n)
     api_check(L, ttistable(o));
     if (hvalue(o)->readonly)
         luaG_readonlyerror(L);
-    setobj2t(L, luaH_setnum(L, hvalue(o), n), L->top - 1);
-    luaC_barriert(L, hvalue(o), L->top - 1);
+    TValue key;
+    setnvalue(&key, n);
+    if (!hvalue(o)->numarray || !luaH_setpacked(L, hvalue(o), &key, L->top - 1))
+    {
+        setobj2t(L, luaH_setnum(L, hvalue(o), n), L->top - 1);
+        luaC_barriert(L, hvalue(o), L->top - 1);
+    }
     L->top--;
     return;
 }
@@ -1172,6 +1203,32 @@ int lua_gc(lua_State* L, int what, int data)
         g->gcstepsize = data << 10;
         break;
     }
+    case LUA_GCINC:
+    case LUA_GCGEN:
+    {
+        res = g->gckind == KGC_GEN ? LUA_GCGEN : LUA_GCINC;
+        luaC_changemode(L, what == LUA_GCGEN ? KGC_GEN : KGC_INC);
+        break;
+    }
+    case LUA_GCSETGENMINORMUL:
+    {
+        res = g->gcgenminormul;
+        g->gcgenminormul = data;
+        break;
+    }
+    case LUA_GCSETGENMAJORMUL:
+    {
+        res = g->gcgenmajormul;
+        g->gcgenmajormul = data;
+        break;
+    }
+    case LUA_GCSETPAGECACHE:
+    {
+        res = g->pagecachelimit;
+        g->pagecachelimit = data < 0 ? 0 : data;
+        luaM_trimpagecache(L, g->pagecachelimit);
+        break;
+    }
     default:
         res = -1; // invalid option
     }
@@ -1235,6 +1292,16 @@ void* lua_newuserdatatagged(lua_State* L, size_t sz, int tag)
     return u->data;
 }
 
+void* lua_newbuffer(lua_State* L, size_t sz)
+{
+    luaC_checkGC(L);
+    luaC_threadbarrier(L);
+    Buffer* b = luaB_newbuffer(L, sz);
+    setbufvalue(L, L->top, b);
+    api_incr_top(L);
+    return b->data;
+}
+
 void* lua_newuserdatadtor(lua_State* L, size_t sz, void (*dtor)(void*))
 {
     luaC_checkGC(L);
@@ -1248,7 +1315,7 @@ void* lua_newuserdatadtor(lua_State* L, size_t sz, void (*dtor)(void*))
     return u->data;
 }
 
-static const char* aux_upvalue(StkId fi, int n, TValue** val)
+static const char* aux_upvalue(lua_State* L, StkId fi, int n, TValue** val)
 {
     Closure* f;
     if (!ttisfunction(fi))
@@ -1264,6 +1331,13 @@ static const char* aux_upvalue(StkId fi, int n, TValue** val)
     else
     {
         Proto* p = f->l.p;
+
+        // upvalue names are decoded with the rest of the function
+        if (p->lazy)
+            luaV_materialize(L, p, f->env, /* recursive= */ false);
+
+        luaV_checkdebuginfo(L, p);
+
         if (!(1 <= n && n <= p->sizeupvalues))
             return NULL;
         TValue* r = &f->l.uprefs[n - 1];
@@ -1276,7 +1350,7 @@ const char* lua_getupvalue(lua_State* L, int funcindex, int n)
 {
     luaC_threadbarrier(L);
     TValue* val;
-    const char* name = aux_upvalue(index2addr(L, funcindex), n, &val);
+    const char* name = aux_upvalue(L, index2addr(L, funcindex), n, &val);
     if (name)
     {
         setobj2s(L, L->top, val);
@@ -1290,9 +1364,10 @@ const char* lua_setupvalue(lua_State* L, int funcindex, int n)
     api_checknelems(L, 1);
     StkId fi = index2addr(L, funcindex);
     TValue* val;
-    const char* name = aux_upvalue(fi, n, &val);
+    const char* name = aux_upvalue(L, fi, n, &val);
     if (name)
     {
+        fi = index2addr(L, funcindex); // decoding the function can reallocate the stack
         L->top--;
         setobj(L, val, L->top);
         luaC_barrier(L, clvalue(fi), L->top);
@@ -1392,3 +1467,15 @@ size_t lua_totalbytes(lua_State* L, int category)
     api_check(L, category < LUA_MEMORY_CATEGORIES);
     return category < 0 ? L->global->totalbytes : L->global->memcatbytes[category];
 }
+
+void lua_pagecachestats(lua_State* L, size_t* hits, size_t* misses, int* pages)
+{
+    global_State* g = L->global;
+
+    if (hits)
+        *hits = g->pagecachehits;
+    if (misses)
+        *misses = g->pagecachemisses;
+    if (pages)
+        *pages = g->pagecachesize;
+}
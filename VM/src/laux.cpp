@@ -241,6 +241,14 @@ const float* luaL_optvector(lua_State* L, int narg, const float* def)
     return luaL_opt(L, luaL_checkvector, narg, def);
 }
 
+void* luaL_checkbuffer(lua_State* L, int narg, size_t* len)
+{
+    void* b = lua_tobuffer(L, narg, len);
+    if (!b)
+        tag_error(L, narg, LUA_TBUFFER);
+    return b;
+}
+
 int luaL_getmetafield(lua_State* L, int obj, const char* event)
 {
     if (!lua_getmetatable(L, obj)) // no metatable?
@@ -0,0 +1,13 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "lobject.h"
+
+// buffers are limited to 1 GB so that offsets and lengths fit into int and double arithmetic on them is exact
+#define MAX_BUFFER_SIZE (1 << 30)
+
+// the allocation is never smaller than the header with an empty payload, since freed objects keep a free list link after the GC header
+#define sizebuffer(len) (offsetof(Buffer, data) + ((len) < sizeof(L_Umaxalign) ? sizeof(L_Umaxalign) : (len)))
+
+LUAI_FUNC Buffer* luaB_newbuffer(lua_State* L, size_t s);
+LUAI_FUNC void luaB_freebuffer(lua_State* L, Buffer* buf, struct lua_Page* page);
@@ -0,0 +1,213 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lualib.h"
+
+#include "lcommon.h"
+#include "lbuffer.h"
+
+#include <string.h>
+
+// buffer contents are stored in little-endian order; all platforms that Luau supports are little-endian, so reads and writes are plain copies
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "buffer library requires a little-endian platform"
+#endif
+
+static bool isoutofbounds(int offset, size_t len, size_t accessize)
+{
+    return offset < 0 || size_t(offset) + accessize > len;
+}
+
+static int buffer_create(lua_State* L)
+{
+    int size = luaL_checkinteger(L, 1);
+
+    luaL_argcheck(L, size >= 0 && size <= MAX_BUFFER_SIZE, 1, "invalid size");
+
+    lua_newbuffer(L, size);
+    return 1;
+}
+
+static int buffer_fromstring(lua_State* L)
+{
+    size_t len = 0;
+    const char* val = luaL_checklstring(L, 1, &len);
+
+    void* data = lua_newbuffer(L, len);
+    memcpy(data, val, len);
+    return 1;
+}
+
+static int buffer_tostring(lua_State* L)
+{
+    size_t len = 0;
+    void* data = luaL_checkbuffer(L, 1, &len);
+
+    lua_pushlstring(L, (char*)data, len);
+    return 1;
+}
+
+static int buffer_len(lua_State* L)
+{
+    size_t len = 0;
+    luaL_checkbuffer(L, 1, &len);
+
+    lua_pushnumber(L, double(unsigned(len)));
+    return 1;
+}
+
+template<typename T>
+static int buffer_readnumber(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+
+    if (isoutofbounds(offset, len, sizeof(T)))
+        luaL_error(L, "buffer access out of bounds");
+
+    T val;
+    memcpy(&val, (char*)buf + offset, sizeof(T));
+
+    lua_pushnumber(L, double(val));
+    return 1;
+}
+
+template<typename T>
+static int buffer_writeinteger(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+
+    // values are truncated to the width of the type, so negative numbers can be written into unsigned types and vice versa
+    T val = T(luaL_checkunsigned(L, 3));
+
+    if (isoutofbounds(offset, len, sizeof(T)))
+        luaL_error(L, "buffer access out of bounds");
+
+    memcpy((char*)buf + offset, &val, sizeof(T));
+    return 0;
+}
+
+template<typename T>
+static int buffer_writefloat(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+    T val = T(luaL_checknumber(L, 3));
+
+    if (isoutofbounds(offset, len, sizeof(T)))
+        luaL_error(L, "buffer access out of bounds");
+
+    memcpy((char*)buf + offset, &val, sizeof(T));
+    return 0;
+}
+
+static int buffer_readstring(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+    int size = luaL_checkinteger(L, 3);
+
+    luaL_argcheck(L, size >= 0, 3, "size cannot be negative");
+
+    if (isoutofbounds(offset, len, size))
+        luaL_error(L, "buffer access out of bounds");
+
+    lua_pushlstring(L, (char*)buf + offset, size);
+    return 1;
+}
+
+static int buffer_writestring(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+    size_t size = 0;
+    const char* val = luaL_checklstring(L, 3, &size);
+    int count = luaL_optinteger(L, 4, int(size));
+
+    luaL_argcheck(L, count >= 0, 4, "count cannot be negative");
+    luaL_argcheck(L, size_t(count) <= size, 4, "string length overflow");
+
+    if (isoutofbounds(offset, len, count))
+        luaL_error(L, "buffer access out of bounds");
+
+    memcpy((char*)buf + offset, val, count);
+    return 0;
+}
+
+static int buffer_copy(lua_State* L)
+{
+    size_t tlen = 0;
+    void* tbuf = luaL_checkbuffer(L, 1, &tlen);
+    int toffset = luaL_checkinteger(L, 2);
+
+    size_t slen = 0;
+    void* sbuf = luaL_checkbuffer(L, 3, &slen);
+    int soffset = luaL_optinteger(L, 4, 0);
+
+    int size = luaL_optinteger(L, 5, soffset >= 0 && size_t(soffset) <= slen ? int(slen - soffset) : 0);
+
+    luaL_argcheck(L, size >= 0, 5, "count cannot be negative");
+
+    if (isoutofbounds(soffset, slen, size) || isoutofbounds(toffset, tlen, size))
+        luaL_error(L, "buffer access out of bounds");
+
+    // source and target can be the same buffer, so the ranges may overlap
+    memmove((char*)tbuf + toffset, (char*)sbuf + soffset, size);
+    return 0;
+}
+
+static int buffer_fill(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+    unsigned value = luaL_checkunsigned(L, 3);
+    int size = luaL_optinteger(L, 4, offset >= 0 && size_t(offset) <= len ? int(len - offset) : 0);
+
+    luaL_argcheck(L, size >= 0, 4, "count cannot be negative");
+
+    if (isoutofbounds(offset, len, size))
+        luaL_error(L, "buffer access out of bounds");
+
+    memset((char*)buf + offset, value & 0xff, size);
+    return 0;
+}
+
+static const luaL_Reg bufferlib[] = {
+    {"create", buffer_create},
+    {"fromstring", buffer_fromstring},
+    {"tostring", buffer_tostring},
+    {"len", buffer_len},
+    {"readi8", buffer_readnumber<int8_t>},
+    {"readu8", buffer_readnumber<uint8_t>},
+    {"readi16", buffer_readnumber<int16_t>},
+    {"readu16", buffer_readnumber<uint16_t>},
+    {"readi32", buffer_readnumber<int32_t>},
+    {"readu32", buffer_readnumber<uint32_t>},
+    {"readf32", buffer_readnumber<float>},
+    {"readf64", buffer_readnumber<double>},
+    {"writei8", buffer_writeinteger<int8_t>},
+    {"writeu8", buffer_writeinteger<uint8_t>},
+    {"writei16", buffer_writeinteger<int16_t>},
+    {"writeu16", buffer_writeinteger<uint16_t>},
+    {"writei32", buffer_writeinteger<int32_t>},
+    {"writeu32", buffer_writeinteger<uint32_t>},
+    {"writef32", buffer_writefloat<float>},
+    {"writef64", buffer_writefloat<double>},
+    {"readstring", buffer_readstring},
+    {"writestring", buffer_writestring},
+    {"copy", buffer_copy},
+    {"fill", buffer_fill},
+    {NULL, NULL},
+};
+
+int luaopen_buffer(lua_State* L)
+{
+    luaL_register(L, LUA_BUFFERLIBNAME, bufferlib);
+
+    return 1;
+}
@@ -10,6 +10,7 @@
 #include "ldo.h"
 
 #include <math.h>
+#include <string.h>
 
 #ifdef _MSC_VER
 #include <intrin.h>
@@ -974,7 +975,8 @@ static int luauF_rawget(lua_State* L, StkId res, TValue* arg0, int nresults, Stk
 {
     if (nparams >= 2 && nresults <= 1 && ttistable(arg0))
     {
-        setobj2s(L, res, luaH_get(hvalue(arg0), args));
+        TValue tmp;
+        setobj2s(L, res, luaH_getvalue(hvalue(arg0), args, &tmp));
         return 1;
     }
 
@@ -997,8 +999,11 @@ static int luauF_rawset(lua_State* L, StkId res, TValue* arg0, int nresults, Stk
             return -1;
 
         setobj2s(L, res, arg0);
-        setobj2t(L, luaH_set(L, hvalue(arg0), args), args + 1);
-        luaC_barriert(L, hvalue(arg0), args + 1);
+        if (!hvalue(arg0)->numarray || !ttisnumber(args) || !luaH_setpacked(L, hvalue(arg0), args, args + 1))
+        {
+            setobj2t(L, luaH_set(L, hvalue(arg0), args), args + 1);
+            luaC_barriert(L, hvalue(arg0), args + 1);
+        }
         return 1;
     }
 
@@ -1013,8 +1018,14 @@ static int luauF_tinsert(lua_State* L, StkId res, TValue* arg0, int nresults, St
             return -1;
 
         int pos = luaH_getn(hvalue(arg0)) + 1;
-        setobj2t(L, luaH_setnum(L, hvalue(arg0), pos), args);
-        luaC_barriert(L, hvalue(arg0), args);
+
+        TValue key;
+        setnvalue(&key, pos);
+        if (!hvalue(arg0)->numarray || !luaH_setpacked(L, hvalue(arg0), &key, args))
+        {
+            setobj2t(L, luaH_setnum(L, hvalue(arg0), pos), args);
+            luaC_barriert(L, hvalue(arg0), args);
+        }
         return 0;
     }
 
@@ -1035,9 +1046,18 @@ static int luauF_tunpack(lua_State* L, StkId res, TValue* arg0, int nresults, St
 
         if (n >= 0 && n <= t->sizearray && cast_int(L->stack_last - res) >= n && n + nparams <= LUAI_MAXCSTACK)
         {
-            TValue* array = t->array;
-            for (int i = 0; i < n; ++i)
-                setobj2s(L, res + i, array + i);
+            if (t->numarray)
+            {
+                double* array = t->narray;
+                for (int i = 0; i < n; ++i)
+                    setnumarrayvalue(res + i, array[i]);
+            }
+            else
+            {
+                TValue* array = t->array;
+                for (int i = 0; i < n; ++i)
+                    setobj2s(L, res + i, array + i);
+            }
             expandstacklimit(L, res + n);
             return n;
         }
@@ -1193,6 +1213,68 @@ static int luauF_extractk(lua_State* L, StkId res, TValue* arg0, int nresults, S
     return -1;
 }
 
+// offsets are truncated like luaL_checkinteger does; accesses that are out of bounds fall back to the library function to report the error
+static bool checkbufferaccess(const TValue* buf, const TValue* offset, size_t size, int& result)
+{
+    double d = nvalue(offset);
+    luai_num2int(result, d);
+
+    return result >= 0 && unsigned(result) + size <= bufvalue(buf)->len;
+}
+
+template<typename T>
+static int luauF_readnumber(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
+{
+    int offset;
+
+    if (nparams >= 2 && nresults <= 1 && ttisbuffer(arg0) && ttisnumber(args) && checkbufferaccess(arg0, args, sizeof(T), offset))
+    {
+        T val;
+        memcpy(&val, bufvalue(arg0)->data + offset, sizeof(T));
+        setnvalue(res, double(val));
+        return 1;
+    }
+
+    return -1;
+}
+
+template<typename T>
+static int luauF_writeinteger(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
+{
+    int offset;
+
+    if (nparams >= 3 && nresults <= 0 && ttisbuffer(arg0) && ttisnumber(args) && ttisnumber(args + 1) &&
+        checkbufferaccess(arg0, args, sizeof(T), offset))
+    {
+        double v = nvalue(args + 1);
+
+        unsigned u;
+        luai_num2unsigned(u, v);
+
+        T val = T(u);
+        memcpy(bufvalue(arg0)->data + offset, &val, sizeof(T));
+        return 0;
+    }
+
+    return -1;
+}
+
+template<typename T>
+static int luauF_writefloat(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
+{
+    int offset;
+
+    if (nparams >= 3 && nresults <= 0 && ttisbuffer(arg0) && ttisnumber(args) && ttisnumber(args + 1) &&
+        checkbufferaccess(arg0, args, sizeof(T), offset))
+    {
+        T val = T(nvalue(args + 1));
+        memcpy(bufvalue(arg0)->data + offset, &val, sizeof(T));
+        return 0;
+    }
+
+    return -1;
+}
+
 luau_FastFunction luauF_table[256] = {
     NULL,
     luauF_assert,
@@ -1268,4 +1350,18 @@ luau_FastFunction luauF_table[256] = {
     luauF_rawlen,
 
     luauF_extractk,
+
+    luauF_readnumber<int8_t>,
+    luauF_readnumber<uint8_t>,
+    luauF_writeinteger<uint8_t>,
+    luauF_readnumber<int16_t>,
+    luauF_readnumber<uint16_t>,
+    luauF_writeinteger<uint16_t>,
+    luauF_readnumber<int32_t>,
+    luauF_readnumber<uint32_t>,
+    luauF_writeinteger<uint32_t>,
+    luauF_readnumber<float>,
+    luauF_writefloat<float>,
+    luauF_readnumber<double>,
+    luauF_writefloat<double>,
 };
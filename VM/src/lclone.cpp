@@ -0,0 +1,547 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+
+#include "lstate.h"
+#include "lfunc.h"
+#include "lgc.h"
+#include "lmem.h"
+#include "lstring.h"
+#include "ltable.h"
+#include "ludata.h"
+#include "lbuffer.h"
+#include "ldebug.h"
+#include "ldo.h"
+#include "lvm.h"
+
+#include <string.h>
+
+/*
+** State cloning copies every object that is reachable from the roots of a state (registry, globals, metatables of basic types and
+** the stack of the main thread) into a new state.
+**
+** Objects are copied in two steps so that the object graph can have cycles without recursion: cloneobj allocates the copy of an
+** object and queues the source object, and fillobj later copies the contents of a queued object, cloning the objects it refers to.
+*/
+
+struct CloneState
+{
+    lua_State* from;
+    lua_State* L;
+
+    Table* map;   // light userdata with the address of a source object -> its copy
+    Table* queue; // source objects that have been allocated but not filled, as light userdata
+    int queuesize;
+};
+
+static GCObject* cloneobj(CloneState* cs, GCObject* o);
+
+static void clonevalue(CloneState* cs, TValue* to, const TValue* from)
+{
+    *to = *from;
+
+    if (iscollectable(from))
+        to->value.gc = cloneobj(cs, gcvalue(from));
+}
+
+static TString* clonestr(CloneState* cs, TString* ts)
+{
+    return ts ? gco2ts(cloneobj(cs, obj2gco(ts))) : NULL;
+}
+
+static Table* clonetable(CloneState* cs, Table* h)
+{
+    return h ? gco2h(cloneobj(cs, obj2gco(h))) : NULL;
+}
+
+static void checkthread(CloneState* cs, lua_State* th)
+{
+    // suspended coroutines would need their call frames to be relocated
+    if (th->ci != th->base_ci || th->status != LUA_OK || th->openupval)
+        luaG_runerror(cs->L, "can't clone a thread that is running or suspended");
+}
+
+static GCObject* allocobj(CloneState* cs, GCObject* o)
+{
+    lua_State* L = cs->L;
+
+    switch (o->gch.tt)
+    {
+    case LUA_TSTRING:
+    {
+        TString* ts = gco2ts(o);
+        TString* res = luaS_newlstr(L, getstr(ts), ts->len);
+        res->atom = ts->atom;
+
+        if (testbit(ts->marked, FIXEDBIT))
+            luaS_fix(res);
+
+        return obj2gco(res);
+    }
+    case LUA_TTABLE:
+    {
+        Table* h = gco2h(o);
+        Table* t = luaH_new(L, h->numarray ? 0 : h->sizearray, h->shaped ? tslots(h)->size : h->node == &luaH_dummynode ? 0 : sizenode(h));
+
+        // luaH_new only creates packed number arrays for tables without a preallocated array part
+        if (h->numarray && h->sizearray)
+            luaH_resizearray(L, t, h->sizearray);
+
+        return obj2gco(t);
+    }
+    case LUA_TFUNCTION:
+    {
+        Closure* cl = gco2cl(o);
+
+        if (cl->isC)
+        {
+            // upvalues are filled in later, but a failed clone can release the closure before that
+            Closure* c = luaF_newCclosure(L, cl->nupvalues, L->gt);
+            for (int i = 0; i < c->nupvalues; ++i)
+                setnilvalue(&c->c.upvals[i]);
+            return obj2gco(c);
+        }
+
+        Proto* p = gco2p(cloneobj(cs, obj2gco(cl->l.p)));
+        return obj2gco(luaF_newLclosure(L, cl->nupvalues, L->gt, p));
+    }
+    case LUA_TUSERDATA:
+    {
+        Udata* u = gco2u(o);
+
+        // the copy would share the resources that the destructor releases
+        if (u->tag == UTAG_IDTOR || (u->tag < LUA_UTAG_LIMIT && cs->from->global->udatagc[u->tag]))
+            luaG_runerror(L, "can't clone a userdata with a destructor");
+
+        Udata* res = luaU_newudata(L, u->len, u->tag);
+        memcpy(res->data, u->data, u->len);
+        return obj2gco(res);
+    }
+    case LUA_TBUFFER:
+    {
+        Buffer* b = gco2buf(o);
+        Buffer* res = luaB_newbuffer(L, b->len);
+        memcpy(res->data, b->data, b->len);
+        return obj2gco(res);
+    }
+    case LUA_TTHREAD:
+    {
+        lua_State* th = gco2th(o);
+        checkthread(cs, th);
+
+        return obj2gco(luaE_newthread(L));
+    }
+    case LUA_TPROTO:
+        return obj2gco(luaF_newproto(L));
+
+    case LUA_TUPVAL:
+    {
+        UpVal* uv = gco2uv(o);
+        LUAU_ASSERT(!upisopen(uv)); // threads with open upvalues are rejected by checkthread
+
+        UpVal* res = luaM_newgco(L, UpVal, sizeof(UpVal), L->activememcat);
+        luaC_init(L, res, LUA_TUPVAL);
+        res->markedopen = 0;
+        res->v = &res->u.value;
+        setnilvalue(res->v);
+        return obj2gco(res);
+    }
+    default:
+        LUAU_ASSERT(!"Unexpected object type");
+        return NULL;
+    }
+}
+
+static GCObject* cloneobj(CloneState* cs, GCObject* o)
+{
+    lua_State* L = cs->L;
+
+    TValue key;
+    setpvalue(&key, o);
+
+    const TValue* res = luaH_get(cs->map, &key);
+
+    if (!ttisnil(res))
+        return gcvalue(res);
+
+    // copies keep the memory category of the source object
+    uint8_t activememcat = L->activememcat;
+    L->activememcat = o->gch.memcat;
+    GCObject* c = allocobj(cs, o);
+    L->activememcat = activememcat;
+
+    TValue* slot = luaH_set(L, cs->map, &key);
+    slot->value.gc = c;
+    slot->tt = o->gch.tt;
+
+    // strings and buffers don't refer to other objects
+    if (o->gch.tt != LUA_TSTRING && o->gch.tt != LUA_TBUFFER)
+    {
+        TValue* item = luaH_setnum(L, cs->queue, ++cs->queuesize);
+        setpvalue(item, o);
+    }
+
+    return c;
+}
+
+static void fillstack(CloneState* cs, lua_State* to, lua_State* from)
+{
+    int n = cast_int(from->top - from->base);
+
+    luaD_checkstack(to, n);
+
+    for (int i = 0; i < n; ++i)
+        clonevalue(cs, to->top + i, from->base + i);
+
+    to->top += n;
+}
+
+static void filltable(CloneState* cs, Table* to, Table* from)
+{
+    lua_State* L = cs->L;
+
+    if (from->numarray)
+    {
+        LUAU_ASSERT(to->numarray && to->sizearray == from->sizearray);
+        if (from->sizearray)
+            memcpy(to->narray, from->narray, from->sizearray * sizeof(double));
+    }
+    else
+    {
+        for (int i = 0; i < from->sizearray; ++i)
+            clonevalue(cs, &to->array[i], &from->array[i]);
+    }
+
+    if (from->shaped)
+    {
+        // the copy gets the keys in the same order, so tables with the same shape get the same shape in the new state
+        TableSlots* ts = tslots(from);
+
+        for (int i = 0; i < ts->shape->count; ++i)
+        {
+            if (ttisnil(&ts->slots[i]))
+                continue;
+
+            TValue key, val;
+            setsvalue(L, &key, ts->shape->keys[i]);
+            clonevalue(cs, &key, &key);
+            clonevalue(cs, &val, &ts->slots[i]);
+
+            setobj2t(L, luaH_set(L, to, &key), &val);
+        }
+    }
+    else if (from->node != &luaH_dummynode)
+    {
+        for (int i = 0; i < sizenode(from); ++i)
+        {
+            LuaNode* n = gnode(from, i);
+
+            // nodes with nil values may have dead keys
+            if (ttisnil(gval(n)))
+                continue;
+
+            TValue key, val;
+            getnodekey(L, &key, n);
+            clonevalue(cs, &key, &key);
+            clonevalue(cs, &val, gval(n));
+
+            setobj2t(L, luaH_set(L, to, &key), &val);
+        }
+    }
+
+    to->metatable = clonetable(cs, from->metatable);
+    to->tmcache = from->tmcache;
+    to->readonly = from->readonly;
+    to->safeenv = from->safeenv;
+}
+
+// functions of a lazy chunk share its bytecode, so the chunk is copied once and the copy is shared as well
+static LazyChunk* clonechunk(CloneState* cs, LazyChunk* chunk)
+{
+    lua_State* L = cs->L;
+
+    TValue key;
+    setpvalue(&key, chunk);
+
+    const TValue* res = luaH_get(cs->map, &key);
+
+    if (!ttisnil(res))
+        return (LazyChunk*)pvalue(res);
+
+    LazyChunk* c = luaV_clonechunk(L, chunk);
+    setpvalue(luaH_set(L, cs->map, &key), c);
+
+    return c;
+}
+
+static void fillproto(CloneState* cs, Proto* to, Proto* from)
+{
+    lua_State* L = cs->L;
+    uint8_t memcat = to->memcat;
+
+    to->nups = from->nups;
+    to->numparams = from->numparams;
+    to->is_vararg = from->is_vararg;
+    to->maxstacksize = from->maxstacksize;
+    to->linedefined = from->linedefined;
+    to->linegaplog2 = from->linegaplog2;
+
+    to->source = clonestr(cs, from->source);
+    to->debugname = clonestr(cs, from->debugname);
+
+    // functions that haven't been decoded yet are decoded from the copy of the chunk in the new state
+    if (from->lazy)
+    {
+        to->lazy = clonechunk(cs, from->lazy);
+        to->lazyoffset = from->lazyoffset;
+        to->lazy->refs++;
+    }
+
+    to->bytecodeid = from->bytecodeid;
+    to->debughash = from->debughash;
+
+    // code owned by a bytecode image stays shared with it
+    if (from->sharedcode)
+    {
+        to->sharedcode = 1;
+        to->code = from->code;
+        to->sizecode = from->sizecode;
+        to->lineinfo = from->lineinfo;
+        to->abslineinfo = from->abslineinfo;
+        to->sizelineinfo = from->sizelineinfo;
+    }
+    else if (!from->lazy)
+    {
+        to->code = luaM_newarray(L, from->sizecode, Instruction, memcat);
+        to->sizecode = from->sizecode;
+        memcpy(to->code, from->code, sizeof(Instruction) * from->sizecode);
+
+        if (from->lineinfo)
+        {
+            to->lineinfo = luaM_newarray(L, from->sizelineinfo, uint8_t, memcat);
+            to->sizelineinfo = from->sizelineinfo;
+            memcpy(to->lineinfo, from->lineinfo, from->sizelineinfo);
+            to->abslineinfo = (int*)(to->lineinfo + ((uint8_t*)from->abslineinfo - from->lineinfo));
+        }
+    }
+
+    if (from->debuginsn)
+    {
+        to->debuginsn = luaM_newarray(L, from->sizecode, uint8_t, memcat);
+        memcpy(to->debuginsn, from->debuginsn, from->sizecode);
+    }
+
+    // inline caches refer to tables of the source state, so the copy starts with empty ones
+    if (from->sizeic)
+    {
+        to->ic = luaM_newarray(L, from->sizeic, LuaInlineCache, memcat);
+        to->sizeic = from->sizeic;
+        memset(to->ic, 0, sizeof(LuaInlineCache) * from->sizeic);
+    }
+
+    if (from->typeinfo)
+    {
+        to->typeinfo = luaM_newarray(L, from->sizetypeinfo, uint8_t, memcat);
+        to->sizetypeinfo = from->sizetypeinfo;
+        memcpy(to->typeinfo, from->typeinfo, from->sizetypeinfo);
+    }
+
+    to->k = luaM_newarray(L, from->sizek, TValue, memcat);
+    for (int i = 0; i < from->sizek; ++i)
+        setnilvalue(&to->k[i]);
+    to->sizek = from->sizek;
+
+    for (int i = 0; i < from->sizek; ++i)
+        clonevalue(cs, &to->k[i], &from->k[i]);
+
+    to->p = luaM_newarray(L, from->sizep, Proto*, memcat);
+    for (int i = 0; i < from->sizep; ++i)
+        to->p[i] = NULL;
+    to->sizep = from->sizep;
+
+    for (int i = 0; i < from->sizep; ++i)
+        to->p[i] = gco2p(cloneobj(cs, obj2gco(from->p[i])));
+
+    to->locvars = luaM_newarray(L, from->sizelocvars, LocVar, memcat);
+    for (int i = 0; i < from->sizelocvars; ++i)
+    {
+        to->locvars[i] = from->locvars[i];
+        to->locvars[i].varname = NULL;
+    }
+    to->sizelocvars = from->sizelocvars;
+
+    for (int i = 0; i < from->sizelocvars; ++i)
+        to->locvars[i].varname = clonestr(cs, from->locvars[i].varname);
+
+    to->upvalues = luaM_newarray(L, from->sizeupvalues, TString*, memcat);
+    for (int i = 0; i < from->sizeupvalues; ++i)
+        to->upvalues[i] = NULL;
+    to->sizeupvalues = from->sizeupvalues;
+
+    for (int i = 0; i < from->sizeupvalues; ++i)
+        to->upvalues[i] = clonestr(cs, from->upvalues[i]);
+}
+
+static void fillobj(CloneState* cs, GCObject* to, GCObject* from)
+{
+    lua_State* L = cs->L;
+
+    switch (from->gch.tt)
+    {
+    case LUA_TTABLE:
+        filltable(cs, gco2h(to), gco2h(from));
+        break;
+
+    case LUA_TFUNCTION:
+    {
+        Closure* cl = gco2cl(to);
+        Closure* fcl = gco2cl(from);
+
+        cl->env = clonetable(cs, fcl->env);
+        cl->stacksize = fcl->stacksize;
+        cl->preload = fcl->preload;
+
+        if (fcl->isC)
+        {
+            cl->c.f = fcl->c.f;
+            cl->c.cont = fcl->c.cont;
+            cl->c.debugname = fcl->c.debugname;
+
+            for (int i = 0; i < fcl->nupvalues; ++i)
+                clonevalue(cs, &cl->c.upvals[i], &fcl->c.upvals[i]);
+        }
+        else
+        {
+            for (int i = 0; i < fcl->nupvalues; ++i)
+                clonevalue(cs, &cl->l.uprefs[i], &fcl->l.uprefs[i]);
+        }
+        break;
+    }
+
+    case LUA_TUSERDATA:
+        gco2u(to)->metatable = clonetable(cs, gco2u(from)->metatable);
+        break;
+
+    case LUA_TTHREAD:
+    {
+        lua_State* th = gco2th(to);
+        lua_State* fth = gco2th(from);
+
+        th->gt = clonetable(cs, fth->gt);
+        th->singlestep = fth->singlestep;
+        th->userdata = fth->userdata;
+        fillstack(cs, th, fth);
+
+        if (L->global->cb.userthread)
+            L->global->cb.userthread(L, th);
+        break;
+    }
+
+    case LUA_TPROTO:
+        fillproto(cs, gco2p(to), gco2p(from));
+        break;
+
+    case LUA_TUPVAL:
+        clonevalue(cs, gco2uv(to)->v, gco2uv(from)->v);
+        break;
+
+    default:
+        LUAU_ASSERT(!"Unexpected object type");
+    }
+}
+
+static void clonestate(lua_State* L, void* ud)
+{
+    CloneState* cs = (CloneState*)ud;
+    lua_State* from = cs->from;
+    global_State* g = L->global;
+    global_State* fg = from->global;
+
+    checkthread(cs, from);
+
+    // map and queue are anchored on the stack until the copy is complete
+    cs->map = luaH_new(L, 0, 0);
+    sethvalue(L, L->top, cs->map);
+    incr_top(L);
+
+    cs->queue = luaH_new(L, 0, 0);
+    sethvalue(L, L->top, cs->queue);
+    incr_top(L);
+
+    TValue key;
+    setpvalue(&key, from);
+    setthvalue(L, luaH_set(L, cs->map, &key), L);
+
+    // copy the roots; everything else is reached from them
+    TValue registry;
+    clonevalue(cs, &registry, &fg->registry);
+    setobj(L, &g->registry, &registry);
+
+    L->gt = clonetable(cs, from->gt);
+
+    for (int i = 0; i < LUA_T_COUNT; ++i)
+        g->mt[i] = clonetable(cs, fg->mt[i]);
+
+    fillstack(cs, L, from);
+
+    // the queue grows while it's processed
+    for (int i = 1; i <= cs->queuesize; ++i)
+    {
+        GCObject* o = cast_to(GCObject*, pvalue(luaH_getnum(cs->queue, i)));
+
+        TValue okey;
+        setpvalue(&okey, o);
+
+        fillobj(cs, gcvalue(luaH_get(cs->map, &okey)), o);
+    }
+
+    // drop the anchors below the copied stack values
+    for (StkId o = L->base + 2; o < L->top; ++o)
+        setobj2s(L, o - 2, o);
+
+    L->top -= 2;
+}
+
+lua_State* lua_clonestate(lua_State* from)
+{
+    global_State* fg = from->global;
+
+    lua_State* L = lua_newstate(fg->frealloc, fg->ud);
+    if (!L)
+        return NULL;
+
+    global_State* g = L->global;
+
+    g->cb = fg->cb;
+    g->gcgoal = fg->gcgoal;
+    g->gcstepmul = fg->gcstepmul;
+    g->gcstepsize = fg->gcstepsize;
+    g->gcgenminormul = fg->gcgenminormul;
+    g->gcgenmajormul = fg->gcgenmajormul;
+    g->pagecachelimit = fg->pagecachelimit;
+    g->registryfree = fg->registryfree;
+    g->rngstate = fg->rngstate;
+    memcpy(g->ptrenckey, fg->ptrenckey, sizeof(g->ptrenckey));
+    memcpy(g->udatagc, fg->udatagc, sizeof(g->udatagc));
+
+    L->userdata = fg->mainthread->userdata;
+    L->singlestep = fg->mainthread->singlestep;
+
+    // pause GC for the duration of the copy - some objects we're creating aren't filled yet
+    size_t GCthreshold = g->GCthreshold;
+    g->GCthreshold = SIZE_MAX;
+
+    CloneState cs = {fg->mainthread, L};
+
+    if (luaD_rawrunprotected(L, clonestate, &cs) != 0)
+    {
+        lua_close(L);
+        return NULL;
+    }
+
+    g->GCthreshold = GCthreshold;
+
+    if (fg->gckind != g->gckind)
+        luaC_changemode(L, fg->gckind);
+
+    return L;
+}
@@ -8,6 +8,7 @@
 #include "lgc.h"
 #include "ldo.h"
 #include "lbytecode.h"
+#include "lvm.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -21,7 +22,10 @@ static int currentpc(lua_State* L, CallInfo* ci)
 
 static int currentline(lua_State* L, CallInfo* ci)
 {
-    return luaG_getline(ci_func(ci)->l.p, currentpc(L, ci));
+    Proto* p = ci_func(ci)->l.p;
+    luaV_checkdebuginfo(L, p);
+
+    return luaG_getline(p, currentpc(L, ci));
 }
 
 static Proto* getluaproto(CallInfo* ci)
@@ -64,6 +68,8 @@ const char* lua_getlocal(lua_State* L, int level, int n)
 
     CallInfo* ci = L->ci - level;
     Proto* fp = getluaproto(ci);
+    if (fp)
+        luaV_checkdebuginfo(L, fp);
     const LocVar* var = fp ? luaF_getlocal(fp, n, currentpc(L, ci)) : NULL;
     if (var)
     {
@@ -81,6 +87,8 @@ const char* lua_setlocal(lua_State* L, int level, int n)
 
     CallInfo* ci = L->ci - level;
     Proto* fp = getluaproto(ci);
+    if (fp)
+        luaV_checkdebuginfo(L, fp);
     const LocVar* var = fp ? luaF_getlocal(fp, n, currentpc(L, ci)) : NULL;
     if (var)
         setobjs2s(L, ci->base + var->reg, L->top - 1);
@@ -314,7 +322,10 @@ void luaG_pusherror(lua_State* L, const char* error)
 
 void luaG_breakpoint(lua_State* L, Proto* p, int line, bool enable)
 {
-    if (p->lineinfo)
+    luaV_checkdebuginfo(L, p);
+
+    // code shared with a bytecode image is read-only
+    if (p->lineinfo && !p->sharedcode)
     {
         for (int i = 0; i < p->sizecode; ++i)
         {
@@ -379,8 +390,10 @@ void lua_singlestep(lua_State* L, int enabled)
     L->singlestep = bool(enabled);
 }
 
-static int getmaxline(Proto* p)
+static int getmaxline(lua_State* L, Proto* p)
 {
+    luaV_checkdebuginfo(L, p);
+
     int result = -1;
 
     for (int i = 0; i < p->sizecode; ++i)
@@ -391,7 +404,7 @@ static int getmaxline(Proto* p)
 
     for (int i = 0; i < p->sizep; ++i)
     {
-        int psize = getmaxline(p->p[i]);
+        int psize = getmaxline(L, p->p[i]);
         result = result < psize ? psize : result;
     }
 
@@ -400,8 +413,10 @@ static int getmaxline(Proto* p)
 
 // Find the line number with instructions. If the provided line doesn't have any instruction, it should return the next line number with
 // instructions.
-static int getnextline(Proto* p, int line)
+static int getnextline(lua_State* L, Proto* p, int line)
 {
+    luaV_checkdebuginfo(L, p);
+
     int closest = -1;
     if (p->lineinfo)
     {
@@ -423,7 +438,7 @@ static int getnextline(Proto* p, int line)
     for (int i = 0; i < p->sizep; ++i)
     {
         // Find the closest line number to the intended one.
-        int candidate = getnextline(p->p[i], line);
+        int candidate = getnextline(L, p->p[i], line);
         if (closest == -1 || (candidate >= line && candidate < closest))
         {
             closest = candidate;
@@ -438,9 +453,13 @@ int lua_breakpoint(lua_State* L, int funcindex, int line, int enabled)
     const TValue* func = luaA_toobject(L, funcindex);
     api_check(L, ttisfunction(func) && !clvalue(func)->isC);
 
+    // breakpoints are set in nested functions as well, so all of them need to be decoded
+    luaV_materialize(L, clvalue(func)->l.p, clvalue(func)->env, /* recursive= */ true);
+    func = luaA_toobject(L, funcindex);
+
     Proto* p = clvalue(func)->l.p;
     // Find line number to add the breakpoint to.
-    int target = getnextline(p, line);
+    int target = getnextline(L, p, line);
 
     if (target != -1)
     {
@@ -482,9 +501,12 @@ void lua_getcoverage(lua_State* L, int funcindex, void* context, lua_Coverage ca
     const TValue* func = luaA_toobject(L, funcindex);
     api_check(L, ttisfunction(func) && !clvalue(func)->isC);
 
+    luaV_materialize(L, clvalue(func)->l.p, clvalue(func)->env, /* recursive= */ true);
+    func = luaA_toobject(L, funcindex);
+
     Proto* p = clvalue(func)->l.p;
 
-    size_t size = getmaxline(p) + 1;
+    size_t size = getmaxline(L, p) + 1;
     if (size == 0)
         return;
 
@@ -495,6 +517,18 @@ void lua_getcoverage(lua_State* L, int funcindex, void* context, lua_Coverage ca
     luaM_freearray(L, buffer, size, int, 0);
 }
 
+void lua_getopstats(lua_State* L, void* context, lua_OpStats callback)
+{
+#ifdef LUAI_OPSTATS
+    global_State* g = L->global;
+
+    for (int op = 0; op < LOP__COUNT; ++op)
+        for (int nextop = 0; nextop < LOP__COUNT; ++nextop)
+            if (uint64_t count = g->opstats[op][nextop])
+                callback(context, op, nextop, count);
+#endif
+}
+
 static size_t append(char* buf, size_t bufsize, size_t offset, const char* data)
 {
     size_t size = strlen(data);
@@ -5,6 +5,7 @@
 #include "lstate.h"
 #include "lmem.h"
 #include "lgc.h"
+#include "lvm.h"
 
 Proto* luaF_newproto(lua_State* L)
 {
@@ -22,6 +23,7 @@ Proto* luaF_newproto(lua_State* L)
     f->numparams = 0;
     f->is_vararg = 0;
     f->maxstacksize = 0;
+    f->sharedcode = 0;
     f->sizelineinfo = 0;
     f->linegaplog2 = 0;
     f->lineinfo = NULL;
@@ -31,6 +33,15 @@ Proto* luaF_newproto(lua_State* L)
     f->source = NULL;
     f->debugname = NULL;
     f->debuginsn = NULL;
+    f->execdata = NULL;
+    f->ic = NULL;
+    f->sizeic = 0;
+    f->typeinfo = NULL;
+    f->sizetypeinfo = 0;
+    f->lazy = NULL;
+    f->lazyoffset = 0;
+    f->bytecodeid = 0;
+    f->debughash = 0;
     return f;
 }
 
@@ -140,15 +151,29 @@ void luaF_closeupval(lua_State* L, UpVal* uv, bool dead)
 
 void luaF_freeproto(lua_State* L, Proto* f, lua_Page* page)
 {
-    luaM_freearray(L, f->code, f->sizecode, Instruction, f->memcat);
+    if (!f->sharedcode)
+        luaM_freearray(L, f->code, f->sizecode, Instruction, f->memcat);
     luaM_freearray(L, f->p, f->sizep, Proto*, f->memcat);
     luaM_freearray(L, f->k, f->sizek, TValue, f->memcat);
-    if (f->lineinfo)
+    if (f->lineinfo && !f->sharedcode)
         luaM_freearray(L, f->lineinfo, f->sizelineinfo, uint8_t, f->memcat);
     luaM_freearray(L, f->locvars, f->sizelocvars, struct LocVar, f->memcat);
     luaM_freearray(L, f->upvalues, f->sizeupvalues, TString*, f->memcat);
     if (f->debuginsn)
         luaM_freearray(L, f->debuginsn, f->sizecode, uint8_t, f->memcat);
+    luaM_freearray(L, f->ic, f->sizeic, LuaInlineCache, f->memcat);
+    luaM_freearray(L, f->typeinfo, f->sizetypeinfo, uint8_t, f->memcat);
+    if (f->lazy)
+        luaV_releasechunk(L, f->lazy);
+
+#if LUA_CUSTOM_EXECUTION
+    if (f->execdata)
+    {
+        LUAU_ASSERT(L->global->ecb.destroy);
+        L->global->ecb.destroy(L, f);
+    }
+#endif
+
     luaM_freegco(L, f, sizeof(Proto), f->memcat, page);
 }
 
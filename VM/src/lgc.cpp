@@ -10,13 +10,14 @@
 #include "ldo.h"
 #include "lmem.h"
 #include "ludata.h"
+#include "lbuffer.h"
 
 #include <string.h>
 
 LUAU_FASTFLAGVARIABLE(LuauBetterThreadMark, false)
 
 /*
- * Luau uses an incremental non-generational non-moving mark&sweep garbage collector.
+ * Luau uses an incremental non-moving mark&sweep garbage collector, with an optional generational mode (see below).
  *
  * The collector runs in three stages: mark, atomic and sweep. Mark and sweep are incremental and try to do a limited amount
  * of work every GC step; atomic is ran once per the GC cycle and is indivisible. In either case, the work happens during GC
@@ -116,6 +117,19 @@ LUAU_FASTFLAGVARIABLE(LuauBetterThreadMark, false)
  * as black (doing so would violate the GC invariant), and they are kept in a special global list (global_State::uvhead) which is traversed
  * during atomic phase. This is needed because an open upvalue might point to a stack location in a dead thread that never marked the stack
  * slot - upvalues like this are identified since they don't have `markedopen` bit set during thread traversal and closed in `clearupvals`.
+ *
+ * In generational mode (global_State::gckind is KGC_GEN), the collector relies on the fact that most objects die young. Objects that
+ * survived a collection keep their marks ("sticky" mark bits) instead of being painted white during sweep, so any non-white object
+ * is old and any white object is young, having been allocated after the last collection. Since the invariant holds between collections,
+ * the existing barriers act as a remembered set: forward barriers mark young objects that are stored into old ones (queueing them on
+ * the gray list), and backward barriers put modified old objects on the `grayagain` list. Active threads and weak tables stay gray after
+ * a collection and are kept in `grayagain` as well, since their contents aren't tracked by barriers.
+ *
+ * A minor collection marks from the roots, gray and `grayagain` lists without traversing old black objects, and sweeps only the pages
+ * that received new objects since the last collection (see lmem.cpp). A major collection paints all objects white and runs a full mark
+ * and sweep; it is triggered when the heap grows sufficiently compared to its size after the last major collection. Both minor and major
+ * collections run to completion in a single step. Open upvalues of old threads keep their `markedopen` bit until the next major
+ * collection, since a minor collection might not traverse the thread they belong to.
  */
 
 LUAU_FASTFLAGVARIABLE(LuauFasterSweep, false)
@@ -253,6 +267,21 @@ static void reallymarkobject(global_State* g, GCObject* o)
             markobject(g, mt);
         return;
     }
+    case LUA_TBUFFER:
+    {
+        gray2black(o); // buffers are never gray
+        return;
+    }
+    case LUA_TSHAPE:
+    {
+        Shape* s = gco2sh(o);
+        gray2black(o); // shapes are never gray
+        for (int i = 0; i < s->count; i++)
+            stringmark(s->keys[i]);
+        if (s->parent)
+            markobject(g, s->parent);
+        return;
+    }
     case LUA_TUPVAL:
     {
         UpVal* uv = gco2uv(o);
@@ -307,6 +336,9 @@ static int traversetable(global_State* g, Table* h)
     int weakvalue = 0;
     if (h->metatable)
         markobject(g, cast_to(Table*, h->metatable));
+    // keys in shapes are never weak
+    if (h->shaped)
+        markobject(g, tslots(h)->shape);
 
     // is there a weak mode?
     if (const char* modev = gettablemode(g, h))
@@ -322,12 +354,21 @@ static int traversetable(global_State* g, Table* h)
 
     if (weakkey && weakvalue)
         return 1;
-    if (!weakvalue)
+    // packed number arrays have nothing to mark
+    if (!weakvalue && !h->numarray)
     {
         i = h->sizearray;
         while (i--)
             markvalue(g, &h->array[i]);
     }
+    if (h->shaped)
+    {
+        TableSlots* ts = tslots(h);
+        i = weakvalue ? 0 : ts->shape->count;
+        while (i--)
+            markvalue(g, &ts->slots[i]);
+        return weakkey || weakvalue;
+    }
     i = sizenode(h);
     while (i--)
     {
@@ -351,7 +392,7 @@ static int traversetable(global_State* g, Table* h)
 ** All marks are conditional because a GC may happen while the
 ** prototype is still being created
 */
-static void traverseproto(global_State* g, Proto* f)
+static int traverseproto(global_State* g, Proto* f)
 {
     int i;
     if (f->source)
@@ -375,6 +416,14 @@ static void traverseproto(global_State* g, Proto* f)
         if (f->locvars[i].varname)
             stringmark(f->locvars[i].varname);
     }
+    // inline caches don't keep the objects they refer to alive; entries with collected objects are cleared after GC
+    if (f->sizeic)
+    {
+        f->gclist = g->weak;
+        g->weak = obj2gco(f);
+        return 1;
+    }
+    return 0;
 }
 
 static void traverseclosure(global_State* g, Closure* cl)
@@ -459,7 +508,7 @@ static size_t propagatemark(global_State* g)
         g->gray = h->gclist;
         if (traversetable(g, h)) // table is weak?
             black2gray(o);       // keep it gray
-        return sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h);
+        return sizeof(Table) + (h->numarray ? 0 : sizeof(TValue) * h->sizearray) + hashbytes(h);
     }
     case LUA_TFUNCTION:
     {
@@ -530,9 +579,11 @@ static size_t propagatemark(global_State* g)
     {
         Proto* p = gco2p(o);
         g->gray = p->gclist;
-        traverseproto(g, p);
+        if (traverseproto(g, p)) // proto has inline caches?
+            black2gray(o);       // keep it gray
         return sizeof(Proto) + sizeof(Instruction) * p->sizecode + sizeof(Proto*) * p->sizep + sizeof(TValue) * p->sizek + p->sizelineinfo +
-               sizeof(LocVar) * p->sizelocvars + sizeof(TString*) * p->sizeupvalues;
+               sizeof(LocVar) * p->sizelocvars + sizeof(TString*) * p->sizeupvalues + sizeof(LuaInlineCache) * p->sizeic +
+               p->sizetypeinfo;
     }
     default:
         LUAU_ASSERT(0);
@@ -569,24 +620,60 @@ static int isobjcleared(GCObject* o)
 
 #define iscleared(o) (iscollectable(o) && isobjcleared(gcvalue(o)))
 
+static size_t clearproto(Proto* f)
+{
+    for (int i = 0; i < f->sizeic; i++)
+    {
+        LuaInlineCache* ic = &f->ic[i];
+
+        if ((ic->metatable && iswhite(obj2gco(ic->metatable))) || (ic->holder && iswhite(obj2gco(ic->holder))) ||
+            (ic->shape && iswhite(obj2gco(ic->shape))))
+            memset(ic, 0, sizeof(LuaInlineCache));
+    }
+    return sizeof(LuaInlineCache) * f->sizeic;
+}
+
+static GCObject** getweakgclist(GCObject* o)
+{
+    return o->gch.tt == LUA_TPROTO ? &gco2p(o)->gclist : &gco2h(o)->gclist;
+}
+
 /*
-** clear collected entries from weaktables
+** clear collected entries from weaktables and inline caches
 */
 static size_t cleartable(lua_State* L, GCObject* l)
 {
     size_t work = 0;
     while (l)
     {
+        if (l->gch.tt == LUA_TPROTO)
+        {
+            work += clearproto(gco2p(l));
+            l = gco2p(l)->gclist;
+            continue;
+        }
+
         Table* h = gco2h(l);
-        work += sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h);
+        work += sizeof(Table) + (h->numarray ? 0 : sizeof(TValue) * h->sizearray) + hashbytes(h);
 
-        int i = h->sizearray;
+        int i = h->numarray ? 0 : h->sizearray;
         while (i--)
         {
             TValue* o = &h->array[i];
             if (iscleared(o))   // value was collected?
                 setnilvalue(o); // remove value
         }
+        if (h->shaped)
+        {
+            TableSlots* ts = tslots(h);
+            for (i = 0; i < ts->shape->count; i++)
+            {
+                if (iscleared(&ts->slots[i]))
+                    setnilvalue(&ts->slots[i]);
+            }
+            l = h->gclist;
+            continue;
+        }
         i = sizenode(h);
         int activevalues = 0;
         while (i--)
@@ -651,6 +738,12 @@ static void freeobj(lua_State* L, GCObject* o, lua_Page* page)
     case LUA_TUSERDATA:
         luaU_freeudata(L, gco2u(o), page);
         break;
+    case LUA_TBUFFER:
+        luaB_freebuffer(L, gco2buf(o), page);
+        break;
+    case LUA_TSHAPE:
+        luaH_freeshape(L, gco2sh(o), page);
+        break;
     default:
         LUAU_ASSERT(0);
     }
@@ -692,8 +785,11 @@ void luaC_freeall(lua_State* L)
 
     for (int i = 0; i < g->strt.size; i++) // free all string lists
         LUAU_ASSERT(g->strt.hash[i] == NULL);
+    for (int i = g->strt.rehashpos; i < g->strt.oldsize; i++)
+        LUAU_ASSERT(g->strt.oldhash[i] == NULL);
 
     LUAU_ASSERT(L->global->strt.nuse == 0);
+    LUAU_ASSERT(L->global->shapet.nuse == 0);
 }
 
 static void markmt(global_State* g)
@@ -757,7 +853,9 @@ static size_t clearupvals(lua_State* L)
         {
             // upvalue is still open (belongs to alive thread)
             LUAU_ASSERT(isgray(obj2gco(uv)));
-            uv->markedopen = 0; // for next cycle
+            // in generational mode the owning thread might not be traversed by the next minor collection, so the bit is reset in major ones
+            if (g->gckind == KGC_INC)
+                uv->markedopen = 0; // for next cycle
             uv = uv->u.open.next;
         }
         else
@@ -815,6 +913,20 @@ static size_t atomic(lua_State* L)
 
     // remove collected objects from weak tables
     work += cleartable(L, g->weak);
+
+    // weak tables and inline caches stay gray and are not protected by barriers, so in generational mode they have to be rescanned by the
+    // next collection
+    if (g->gckind == KGC_GEN)
+    {
+        for (GCObject* o = g->weak; o;)
+        {
+            GCObject** gclist = getweakgclist(o);
+            GCObject* next = *gclist;
+            *gclist = g->grayagain;
+            g->grayagain = o;
+            o = next;
+        }
+    }
     g->weak = NULL;
 
 #ifdef LUAI_GCMETRICS
@@ -927,6 +1039,45 @@ static int sweepgcopage(lua_State* L, lua_Page* page)
     return int(end - start) / blockSize;
 }
 
+// a version of sweepgcopage for generational mode that keeps the marks of surviving objects
+static int sweepgcopagegen(lua_State* L, lua_Page* page)
+{
+    char* start;
+    char* end;
+    int busyBlocks;
+    int blockSize;
+    luaM_getpagewalkinfo(page, &start, &end, &busyBlocks, &blockSize);
+
+    LUAU_ASSERT(busyBlocks > 0);
+
+    global_State* g = L->global;
+
+    int deadmask = otherwhite(g);
+    LUAU_ASSERT(testbit(deadmask, FIXEDBIT)); // make sure we never sweep fixed objects
+
+    for (char* pos = start; pos != end; pos += blockSize)
+    {
+        GCObject* gco = (GCObject*)pos;
+
+        // skip memory blocks that are already freed
+        if (gco->gch.tt == LUA_TNIL)
+            continue;
+
+        // dead objects are freed; the rest become (or stay) old
+        if (!((gco->gch.marked ^ WHITEBITS) & deadmask))
+        {
+            LUAU_ASSERT(isdead(g, gco));
+            freeobj(L, gco, page);
+
+            // if the last block was removed, page would be removed as well
+            if (--busyBlocks == 0)
+                return int(pos - start) / blockSize + 1;
+        }
+    }
+
+    return int(end - start) / blockSize;
+}
+
 static size_t gcstep(lua_State* L, size_t limit)
 {
     size_t cost = 0;
@@ -1031,6 +1182,119 @@ static size_t gcstep(lua_State* L, size_t limit)
     return cost;
 }
 
+// finish the current collection cycle without marking anything, leaving all alive objects white
+static void clearmarks(lua_State* L)
+{
+    global_State* g = L->global;
+
+    // all pages are going to be swept so there's no need to keep track of the young ones
+    while (g->younggcopages)
+        luaM_popyounggcopage(L);
+
+    // reset collector lists; besides the lists of a mark in progress, barriers that run during the sweep may have left objects in grayagain,
+    // and those objects become white below
+    g->gray = NULL;
+    g->grayagain = NULL;
+    g->weak = NULL;
+
+    if (keepinvariant(g))
+    {
+        // reset sweep marks to sweep all elements (returning them to white)
+        g->sweepgcopage = g->allgcopages;
+        g->gcstate = GCSsweep;
+    }
+    LUAU_ASSERT(g->gcstate == GCSpause || g->gcstate == GCSsweep);
+    // finish any pending sweep phase
+    while (g->gcstate != GCSpause)
+    {
+        LUAU_ASSERT(g->gcstate == GCSsweep);
+        gcstep(L, SIZE_MAX);
+    }
+
+    // clear markedopen bits for all open upvalues; these might be stuck from half-finished mark prior to full gc
+    for (UpVal* uv = g->uvhead.u.open.next; uv != &g->uvhead; uv = uv->u.open.next)
+    {
+        LUAU_ASSERT(upisopen(uv));
+        uv->markedopen = 0;
+    }
+}
+
+// perform a complete collection in generational mode; a minor collection only visits young objects, objects in the gray lists and pages with
+// young objects, whereas a major collection expects all objects to be white beforehand (see clearmarks) and visits everything
+static size_t gencollect(lua_State* L, bool major)
+{
+    global_State* g = L->global;
+    LUAU_ASSERT(g->gckind == KGC_GEN && g->gcstate == GCSpause);
+
+    // unlike markroot, we keep the gray lists intact since they contain young objects marked by forward barriers and old objects
+    // that were modified or are not tracked by barriers
+    markobject(g, g->mainthread);
+    markobject(g, g->mainthread->gt);
+    markvalue(g, registry(L));
+    markmt(g);
+
+    g->gcstate = GCSpropagate;
+
+    size_t work = propagateall(g);
+
+    g->gcstate = GCSatomic;
+
+    g->gcstats.atomicstarttimestamp = lua_clock();
+    g->gcstats.atomicstarttotalsizebytes = g->totalbytes;
+
+    work += atomic(L);
+
+    LUAU_ASSERT(g->gcstate == GCSsweep);
+
+    if (major)
+    {
+        LUAU_ASSERT(!g->younggcopages);
+
+        for (lua_Page* page = g->allgcopages; page;)
+        {
+            lua_Page* next = luaM_getnextgcopage(page); // page sweep might destroy the page
+
+            work += sweepgcopagegen(L, page) * GC_SWEEPPAGESTEPCOST;
+
+            page = next;
+        }
+    }
+    else
+    {
+        // objects in other pages survived the last collection and can't be dead
+        while (lua_Page* page = luaM_popyounggcopage(L))
+            work += sweepgcopagegen(L, page) * GC_SWEEPPAGESTEPCOST;
+    }
+
+    // main thread is never collected and keeps its mark, just like other old objects
+    LUAU_ASSERT(!isdead(g, obj2gco(g->mainthread)));
+
+    shrinkbuffers(L);
+
+    g->sweepgcopage = NULL;
+    g->gcstate = GCSpause;
+
+    return work;
+}
+
+static size_t genstep(lua_State* L)
+{
+    global_State* g = L->global;
+
+    // minor collections can't free old objects, so we need a major one once the heap grows enough compared to the last major collection
+    if (g->totalbytes > g->gcmajorbytes / 100 * (100 + g->gcgenmajormul))
+    {
+        clearmarks(L);
+
+        size_t work = gencollect(L, /* major= */ true);
+
+        g->gcmajorbytes = g->totalbytes;
+        return work;
+    }
+
+    return gencollect(L, /* major= */ false);
+}
+
 static int64_t getheaptriggererroroffset(global_State* g)
 {
     // adjust for error using Proportional-Integral controller
@@ -1108,7 +1372,7 @@ size_t luaC_step(lua_State* L, bool assist)
 
     int lastgcstate = g->gcstate;
 
-    size_t work = gcstep(L, lim);
+    size_t work = g->gckind == KGC_GEN ? genstep(L) : gcstep(L, lim);
 
 #ifdef LUAI_GCMETRICS
     recordGcStateStep(g, lastgcstate, lua_clock() - lasttimestamp, assist, work);
@@ -1119,11 +1383,23 @@ size_t luaC_step(lua_State* L, bool assist)
     // at the end of the last cycle
     if (g->gcstate == GCSpause)
     {
-        // at the end of a collection cycle, set goal based on gcgoal setting
-        size_t heapgoal = (g->totalbytes / 100) * g->gcgoal;
-        size_t heaptrigger = getheaptrigger(g, heapgoal);
+        size_t heapgoal;
+
+        if (g->gckind == KGC_GEN)
+        {
+            // in generational mode, the next minor collection runs once the young generation grows enough
+            heapgoal = g->totalbytes + (g->totalbytes / 100) * g->gcgenminormul;
 
-        g->GCthreshold = heaptrigger;
+            g->GCthreshold = heapgoal;
+        }
+        else
+        {
+            // at the end of a collection cycle, set goal based on gcgoal setting
+            heapgoal = (g->totalbytes / 100) * g->gcgoal;
+            size_t heaptrigger = getheaptrigger(g, heapgoal);
+
+            g->GCthreshold = heaptrigger;
+        }
 
         g->gcstats.heapgoalsizebytes = heapgoal;
         g->gcstats.endtimestamp = lua_clock();
@@ -1156,30 +1432,7 @@ void luaC_fullgc(lua_State* L)
         startGcCycleMetrics(g);
 #endif
 
-    if (keepinvariant(g))
-    {
-        // reset sweep marks to sweep all elements (returning them to white)
-        g->sweepgcopage = g->allgcopages;
-        // reset other collector lists
-        g->gray = NULL;
-        g->grayagain = NULL;
-        g->weak = NULL;
-        g->gcstate = GCSsweep;
-    }
-    LUAU_ASSERT(g->gcstate == GCSpause || g->gcstate == GCSsweep);
-    // finish any pending sweep phase
-    while (g->gcstate != GCSpause)
-    {
-        LUAU_ASSERT(g->gcstate == GCSsweep);
-        gcstep(L, SIZE_MAX);
-    }
-
-    // clear markedopen bits for all open upvalues; these might be stuck from half-finished mark prior to full gc
-    for (UpVal* uv = g->uvhead.u.open.next; uv != &g->uvhead; uv = uv->u.open.next)
-    {
-        LUAU_ASSERT(upisopen(uv));
-        uv->markedopen = 0;
-    }
+    clearmarks(L);
 
 #ifdef LUAI_GCMETRICS
     finishGcCycleMetrics(g);
@@ -1187,14 +1440,35 @@ void luaC_fullgc(lua_State* L)
 #endif
 
     // run a full collection cycle
-    markroot(L);
-    while (g->gcstate != GCSpause)
+    if (g->gckind == KGC_GEN)
     {
-        gcstep(L, SIZE_MAX);
+        gencollect(L, /* major= */ true);
+
+        g->gcmajorbytes = g->totalbytes;
+    }
+    else
+    {
+        markroot(L);
+        while (g->gcstate != GCSpause)
+        {
+            gcstep(L, SIZE_MAX);
+        }
     }
     // reclaim as much buffer memory as possible (shrinkbuffers() called during sweep is incremental)
     shrinkbuffersfull(L);
 
+    if (g->gckind == KGC_GEN)
+    {
+        // next minor collection is paced the same way as it would be after a regular step
+        g->GCthreshold = g->totalbytes + (g->totalbytes / 100) * g->gcgenminormul;
+        g->gcstats.heapgoalsizebytes = g->GCthreshold;
+
+#ifdef LUAI_GCMETRICS
+        finishGcCycleMetrics(g);
+#endif
+        return;
+    }
+
     size_t heapgoalsizebytes = (g->totalbytes / 100) * g->gcgoal;
 
     // trigger cannot be correctly adjusted after a forced full GC.
@@ -1215,11 +1489,34 @@ void luaC_fullgc(lua_State* L)
 #endif
 }
 
+void luaC_changemode(lua_State* L, int kind)
+{
+    global_State* g = L->global;
+    LUAU_ASSERT(kind == KGC_INC || kind == KGC_GEN);
+
+    if (g->gckind == kind)
+        return;
+
+    // marks are interpreted differently between modes, so we start from a heap with all objects white
+    clearmarks(L);
+
+    g->gckind = uint8_t(kind);
+
+    // entering generational mode requires a full collection to make all surviving objects old
+    if (kind == KGC_GEN)
+    {
+        gencollect(L, /* major= */ true);
+
+        g->gcmajorbytes = g->totalbytes;
+        g->GCthreshold = g->totalbytes + (g->totalbytes / 100) * g->gcgenminormul;
+    }
+}
+
 void luaC_barrierf(lua_State* L, GCObject* o, GCObject* v)
 {
     global_State* g = L->global;
     LUAU_ASSERT(isblack(o) && iswhite(v) && !isdead(g, v) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gckind == KGC_GEN);
     // must keep invariant?
     if (keepinvariant(g))
         reallymarkobject(g, v); // restore invariant
@@ -1241,7 +1538,7 @@ void luaC_barriertable(lua_State* L, Table* t, GCObject* v)
     }
 
     LUAU_ASSERT(isblack(o) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gckind == KGC_GEN);
     black2gray(o); // make table gray (again)
     t->gclist = g->grayagain;
     g->grayagain = o;
@@ -1251,7 +1548,7 @@ void luaC_barrierback(lua_State* L, GCObject* o, GCObject** gclist)
 {
     global_State* g = L->global;
     LUAU_ASSERT(isblack(o) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gckind == KGC_GEN);
 
     black2gray(o); // make object gray (again)
     *gclist = g->grayagain;
@@ -13,6 +13,9 @@
 #define LUAI_GCSTEPMUL 200 // GC runs 'twice the speed' of memory allocation
 #define LUAI_GCSTEPSIZE 1  // GC runs every KB of memory allocation
 
+#define LUAI_GCGENMINORMUL 20  // minor collection runs after the heap grows by 20% of its size
+#define LUAI_GCGENMAJORMUL 100 // major collection runs after the heap grows by 100% since the last major collection
+
 /*
 ** Possible states of the Garbage Collector
 */
@@ -22,14 +25,24 @@
 #define GCSatomic 3
 #define GCSsweep 4
 
+/*
+** Kinds of garbage collection
+*/
+#define KGC_INC 0 // incremental
+#define KGC_GEN 1 // generational
+
 /*
 ** macro to tell when main invariant (white objects cannot point to black
 ** ones) must be kept. During a collection, the sweep
 ** phase may break the invariant, as objects turned white may point to
 ** still-black objects. The invariant is restored when sweep ends and
 ** all objects are white again.
+** In generational mode, marks survive between collections and the invariant
+** is kept during the pause as well.
 */
-#define keepinvariant(g) ((g)->gcstate == GCSpropagate || (g)->gcstate == GCSpropagateagain || (g)->gcstate == GCSatomic)
+#define keepinvariant(g) \
+    ((g)->gcstate == GCSpropagate || (g)->gcstate == GCSpropagateagain || (g)->gcstate == GCSatomic || \
+        ((g)->gcstate == GCSpause && (g)->gckind == KGC_GEN))
 
 /*
 ** some useful bit tricks
@@ -127,6 +140,7 @@
 LUAI_FUNC void luaC_freeall(lua_State* L);
 LUAI_FUNC size_t luaC_step(lua_State* L, bool assist);
 LUAI_FUNC void luaC_fullgc(lua_State* L);
+LUAI_FUNC void luaC_changemode(lua_State* L, int kind);
 LUAI_FUNC void luaC_initobj(lua_State* L, GCObject* o, uint8_t tt);
 LUAI_FUNC void luaC_upvalclosed(lua_State* L, UpVal* uv);
 LUAI_FUNC void luaC_barrierf(lua_State* L, GCObject* o, GCObject* v);
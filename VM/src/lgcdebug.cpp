@@ -9,6 +9,7 @@
 #include "lstring.h"
 #include "ltable.h"
 #include "ludata.h"
+#include "lbuffer.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -42,8 +43,27 @@ static void validatetable(global_State* g, Table* h)
     if (h->metatable)
         validateobjref(g, obj2gco(h), obj2gco(h->metatable));
 
-    for (int i = 0; i < h->sizearray; ++i)
-        validateref(g, obj2gco(h), &h->array[i]);
+    if (!h->numarray)
+    {
+        for (int i = 0; i < h->sizearray; ++i)
+            validateref(g, obj2gco(h), &h->array[i]);
+    }
+
+    if (h->shaped)
+    {
+        TableSlots* ts = tslots(h);
+
+        LUAU_ASSERT(sizenode == 1 && h->nodemask8 == 0);
+        LUAU_ASSERT(ts->shape->count <= ts->size && ts->size <= LUAI_MAXSHAPEKEYS);
+        LUAU_ASSERT(ttisnil(&ts->nilkey) && ts->nilkey.next == 0);
+
+        validateobjref(g, obj2gco(h), obj2gco(ts->shape));
+
+        for (int i = 0; i < ts->shape->count; ++i)
+            validateref(g, obj2gco(h), &ts->slots[i]);
+
+        return;
+    }
 
     for (int i = 0; i < sizenode; ++i)
     {
@@ -133,6 +153,28 @@ static void validateproto(global_State* g, Proto* f)
     for (int i = 0; i < f->sizelocvars; i++)
         if (f->locvars[i].varname)
             validateobjref(g, obj2gco(f), obj2gco(f->locvars[i].varname));
+
+    for (int i = 0; i < f->sizeic; i++)
+    {
+        if (f->ic[i].metatable)
+            validateobjref(g, obj2gco(f), obj2gco(f->ic[i].metatable));
+        if (f->ic[i].holder)
+            validateobjref(g, obj2gco(f), obj2gco(f->ic[i].holder));
+        if (f->ic[i].shape)
+            validateobjref(g, obj2gco(f), obj2gco(f->ic[i].shape));
+    }
+}
+
+static void validateshape(global_State* g, Shape* s)
+{
+    LUAU_ASSERT(s->count <= LUAI_MAXSHAPEKEYS);
+    LUAU_ASSERT(s->parent ? s->parent->count + 1 == s->count : s->count == 0);
+
+    if (s->parent)
+        validateobjref(g, obj2gco(s), obj2gco(s->parent));
+
+    for (int i = 0; i < s->count; ++i)
+        validateobjref(g, obj2gco(s), obj2gco(s->keys[i]));
 }
 
 static void validateobj(global_State* g, GCObject* o)
@@ -162,6 +204,9 @@ static void validateobj(global_State* g, GCObject* o)
             validateobjref(g, o, obj2gco(gco2u(o)->metatable));
         break;
 
+    case LUA_TBUFFER:
+        break;
+
     case LUA_TTHREAD:
         validatestack(g, gco2th(o));
         break;
@@ -174,6 +219,10 @@ static void validateobj(global_State* g, GCObject* o)
         validateref(g, o, gco2uv(o)->v);
         break;
 
+    case LUA_TSHAPE:
+        validateshape(g, gco2sh(o));
+        break;
+
     default:
         LUAU_ASSERT(!"unexpected object type");
     }
@@ -288,11 +337,42 @@ static void dumpstring(FILE* f, TString* ts)
 
 static void dumptable(FILE* f, Table* h)
 {
-    size_t size = sizeof(Table) + (h->node == &luaH_dummynode ? 0 : sizenode(h) * sizeof(LuaNode)) + h->sizearray * sizeof(TValue);
+    size_t size = sizeof(Table) + hashbytes(h) + arraybytes(h);
 
     fprintf(f, "{\"type\":\"table\",\"cat\":%d,\"size\":%d", h->memcat, int(size));
 
-    if (h->node != &luaH_dummynode)
+    if (h->shaped)
+    {
+        TableSlots* ts = tslots(h);
+
+        fprintf(f, ",\"shape\":");
+        dumpref(f, obj2gco(ts->shape));
+
+        fprintf(f, ",\"pairs\":[");
+
+        bool first = true;
+
+        for (int i = 0; i < ts->shape->count; ++i)
+        {
+            if (!ttisnil(&ts->slots[i]))
+            {
+                if (!first)
+                    fputc(',', f);
+                first = false;
+
+                dumpref(f, obj2gco(ts->shape->keys[i]));
+                fputc(',', f);
+
+                if (iscollectable(&ts->slots[i]))
+                    dumpref(f, gcvalue(&ts->slots[i]));
+                else
+                    fprintf(f, "null");
+            }
+        }
+
+        fprintf(f, "]");
+    }
+    else if (h->node != &luaH_dummynode)
     {
         fprintf(f, ",\"pairs\":[");
 
@@ -324,7 +404,7 @@ static void dumptable(FILE* f, Table* h)
 
         fprintf(f, "]");
     }
-    if (h->sizearray)
+    if (h->sizearray && !h->numarray)
     {
         fprintf(f, ",\"array\":[");
         dumprefs(f, h->array, h->sizearray);
@@ -387,6 +467,11 @@ static void dumpudata(FILE* f, Udata* u)
     fprintf(f, "}");
 }
 
+static void dumpbuffer(FILE* f, Buffer* b)
+{
+    fprintf(f, "{\"type\":\"buffer\",\"cat\":%d,\"size\":%d}", b->memcat, int(sizebuffer(b->len)));
+}
+
 static void dumpthread(FILE* f, lua_State* th)
 {
     size_t size = sizeof(lua_State) + sizeof(TValue) * th->stacksize + sizeof(CallInfo) * th->size_ci;
@@ -476,7 +561,8 @@ static void dumpthread(FILE* f, lua_State* th)
 static void dumpproto(FILE* f, Proto* p)
 {
     size_t size = sizeof(Proto) + sizeof(Instruction) * p->sizecode + sizeof(Proto*) * p->sizep + sizeof(TValue) * p->sizek + p->sizelineinfo +
-                  sizeof(LocVar) * p->sizelocvars + sizeof(TString*) * p->sizeupvalues;
+                  sizeof(LocVar) * p->sizelocvars + sizeof(TString*) * p->sizeupvalues + sizeof(LuaInlineCache) * p->sizeic +
+                  p->sizetypeinfo;
 
     fprintf(f, "{\"type\":\"proto\",\"cat\":%d,\"size\":%d", p->memcat, int(size));
 
@@ -522,6 +608,31 @@ static void dumpupval(FILE* f, UpVal* uv)
     fprintf(f, "}");
 }
 
+static void dumpshape(FILE* f, Shape* s)
+{
+    fprintf(f, "{\"type\":\"shape\",\"cat\":%d,\"size\":%d", s->memcat, int(sizeshape(s->count)));
+
+    if (s->parent)
+    {
+        fprintf(f, ",\"parent\":");
+        dumpref(f, obj2gco(s->parent));
+    }
+
+    if (s->count)
+    {
+        fprintf(f, ",\"keys\":[");
+        for (int i = 0; i < s->count; ++i)
+        {
+            if (i)
+                fputc(',', f);
+            dumpref(f, obj2gco(s->keys[i]));
+        }
+        fprintf(f, "]");
+    }
+
+    fprintf(f, "}");
+}
+
 static void dumpobj(FILE* f, GCObject* o)
 {
     switch (o->gch.tt)
@@ -538,6 +649,9 @@ static void dumpobj(FILE* f, GCObject* o)
     case LUA_TUSERDATA:
         return dumpudata(f, gco2u(o));
 
+    case LUA_TBUFFER:
+        return dumpbuffer(f, gco2buf(o));
+
     case LUA_TTHREAD:
         return dumpthread(f, gco2th(o));
 
@@ -547,6 +661,9 @@ static void dumpobj(FILE* f, GCObject* o)
     case LUA_TUPVAL:
         return dumpupval(f, gco2uv(o));
 
+    case LUA_TSHAPE:
+        return dumpshape(f, gco2sh(o));
+
     default:
         LUAU_ASSERT(0);
     }
@@ -13,6 +13,7 @@ static const luaL_Reg lualibs[] = {
     {LUA_MATHLIBNAME, luaopen_math},
     {LUA_DBLIBNAME, luaopen_debug},
     {LUA_UTF8LIBNAME, luaopen_utf8},
+    {LUA_BUFFERLIBNAME, luaopen_buffer},
     {LUA_BITLIBNAME, luaopen_bit32},
     {NULL, NULL},
 };
@@ -5,6 +5,7 @@
 #include "lstate.h"
 #include "ldo.h"
 #include "ldebug.h"
+#include "lgc.h"
 
 #include <string.h>
 
@@ -67,9 +68,14 @@
  * size up to reduce the chance that we'll allocate pages that have very few allocated blocks. The size
  * class strategy is determined by SizeClassConfig constructor.
  *
- * Note that when the last block in a page is freed, we immediately free the page with frealloc - the
- * memory manager doesn't currently attempt to keep unused memory around. This can result in excessive
- * allocation traffic and can be mitigated by adding a page cache in the future.
+ * When the last block in a page is freed, the page is either returned to frealloc or, if it's a regular
+ * size class page, kept in a small page cache (global_State::pagecache) for reuse by any size class of either
+ * kind. This reduces allocation traffic for workloads that repeatedly allocate and free a lot of objects. The
+ * number of cached pages is bounded by global_State::pagecachelimit (see LUA_GCSETPAGECACHE).
+ *
+ * When the collector runs in generational mode, GCO pages that receive a new object are additionally linked
+ * into a list of young pages (global_State::younggcopages). Minor collections only need to sweep these pages,
+ * since all objects in other pages survived the previous collection and are old.
  *
  * For both GCO and non-GCO pages, the per-page block allocation combines bump pointer style allocation
  * (lua_Page::freeNext) and per-page free list (lua_Page::freeList). We use the bump allocator to allocate
@@ -182,6 +188,10 @@ struct lua_Page
     lua_Page* gcolistprev;
     lua_Page* gcolistnext;
 
+    // list of gco pages with young objects (generational mode only)
+    lua_Page* younglistnext;
+    bool young;
+
     int pageSize;  // page size in bytes, including page header
     int blockSize; // block size in bytes, including block header (for non-GCO)
 
@@ -208,9 +218,25 @@ static lua_Page* newpage(lua_State* L, lua_Page** gcopageset, int pageSize, int
 
     LUAU_ASSERT(pageSize - int(offsetof(lua_Page, data)) >= blockSize * blockCount);
 
-    lua_Page* page = (lua_Page*)(*g->frealloc)(g->ud, NULL, 0, pageSize);
-    if (!page)
-        luaD_throw(L, LUA_ERRMEM);
+    lua_Page* page;
+
+    if (pageSize == int(kPageSize) && g->pagecache)
+    {
+        // reuse a previously freed page
+        page = g->pagecache;
+        g->pagecache = page->next;
+        g->pagecachesize--;
+        g->pagecachehits++;
+    }
+    else
+    {
+        if (pageSize == int(kPageSize))
+            g->pagecachemisses++;
+
+        page = (lua_Page*)(*g->frealloc)(g->ud, NULL, 0, pageSize);
+        if (!page)
+            luaD_throw(L, LUA_ERRMEM);
+    }
 
     ASAN_POISON_MEMORY_REGION(page->data, blockSize * blockCount);
 
@@ -221,6 +247,9 @@ static lua_Page* newpage(lua_State* L, lua_Page** gcopageset, int pageSize, int
     page->gcolistprev = NULL;
     page->gcolistnext = NULL;
 
+    page->younglistnext = NULL;
+    page->young = false;
+
     page->pageSize = pageSize;
     page->blockSize = blockSize;
 
@@ -272,6 +301,17 @@ static void freepage(lua_State* L, lua_Page** gcopageset, lua_Page* page)
             *gcopageset = page->gcolistnext;
     }
 
+    // keep regular pages around for reuse if the cache has room
+    if (page->pageSize == int(kPageSize) && g->pagecachesize < g->pagecachelimit)
+    {
+        ASAN_POISON_MEMORY_REGION(page->data, page->pageSize - offsetof(lua_Page, data));
+
+        page->next = g->pagecache;
+        g->pagecache = page;
+        g->pagecachesize++;
+        return;
+    }
+
     // so long
     (*g->frealloc)(g->ud, page, page->pageSize, 0);
 }
@@ -338,6 +378,17 @@ static void* newblock(lua_State* L, int sizeClass)
     return (char*)block + kBlockHeader;
 }
 
+static void markyounggcopage(global_State* g, lua_Page* page)
+{
+    // in generational mode, minor collections only sweep pages that received new objects
+    if (g->gckind == KGC_GEN && !page->young)
+    {
+        page->young = true;
+        page->younglistnext = g->younggcopages;
+        g->younggcopages = page;
+    }
+}
+
 static void* newgcoblock(lua_State* L, int sizeClass)
 {
     global_State* g = L->global;
@@ -380,6 +431,8 @@ static void* newgcoblock(lua_State* L, int sizeClass)
         page->next = NULL;
     }
 
+    markyounggcopage(g, page);
+
     return block;
 }
 
@@ -494,6 +547,8 @@ GCObject* luaM_newgco_(lua_State* L, size_t nsize, uint8_t memcat)
 
         page->freeNext -= page->blockSize;
         page->busyBlocks++;
+
+        markyounggcopage(g, page);
     }
 
     if (block == NULL && nsize > 0)
@@ -603,6 +658,39 @@ lua_Page* luaM_getnextgcopage(lua_Page* page)
     return page->gcolistnext;
 }
 
+lua_Page* luaM_popyounggcopage(lua_State* L)
+{
+    global_State* g = L->global;
+
+    lua_Page* page = g->younggcopages;
+
+    if (page)
+    {
+        LUAU_ASSERT(page->young);
+        g->younggcopages = page->younglistnext;
+
+        page->younglistnext = NULL;
+        page->young = false;
+    }
+
+    return page;
+}
+
+void luaM_trimpagecache(lua_State* L, int limit)
+{
+    global_State* g = L->global;
+
+    while (g->pagecachesize > limit)
+    {
+        lua_Page* page = g->pagecache;
+        g->pagecache = page->next;
+        g->pagecachesize--;
+
+        ASAN_UNPOISON_MEMORY_REGION(page->data, page->pageSize - offsetof(lua_Page, data));
+        (*g->frealloc)(g->ud, page, page->pageSize, 0);
+    }
+}
+
 void luaM_visitpage(lua_Page* page, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco))
 {
     char* start;
@@ -4,6 +4,9 @@
 
 #include "lua.h"
 
+// number of free pages kept by the page allocator for reuse
+#define LUAI_PAGECACHE 16
+
 struct lua_Page;
 union GCObject;
 
@@ -27,6 +30,8 @@ LUAI_FUNC l_noret luaM_toobig(lua_State* L);
 
 LUAI_FUNC void luaM_getpagewalkinfo(lua_Page* page, char** start, char** end, int* busyBlocks, int* blockSize);
 LUAI_FUNC lua_Page* luaM_getnextgcopage(lua_Page* page);
+LUAI_FUNC lua_Page* luaM_popyounggcopage(lua_State* L);
+LUAI_FUNC void luaM_trimpagecache(lua_State* L, int limit);
 
 LUAI_FUNC void luaM_visitpage(lua_Page* page, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco));
 LUAI_FUNC void luaM_visitgco(lua_State* L, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco));
@@ -60,6 +60,7 @@ typedef struct lua_TValue
 #define ttisthread(o) (ttype(o) == LUA_TTHREAD)
 #define ttislightuserdata(o) (ttype(o) == LUA_TLIGHTUSERDATA)
 #define ttisvector(o) (ttype(o) == LUA_TVECTOR)
+#define ttisbuffer(o) (ttype(o) == LUA_TBUFFER)
 #define ttisupval(o) (ttype(o) == LUA_TUPVAL)
 
 // Macros to access values
@@ -74,6 +75,7 @@ typedef struct lua_TValue
 #define hvalue(o) check_exp(ttistable(o), &(o)->value.gc->h)
 #define bvalue(o) check_exp(ttisboolean(o), (o)->value.b)
 #define thvalue(o) check_exp(ttisthread(o), &(o)->value.gc->th)
+#define bufvalue(o) check_exp(ttisbuffer(o), &(o)->value.gc->buf)
 #define upvalue(o) check_exp(ttisupval(o), &(o)->value.gc->uv)
 
 #define l_isfalse(o) (ttisnil(o) || (ttisboolean(o) && bvalue(o) == 0))
@@ -156,6 +158,14 @@ typedef struct lua_TValue
         checkliveness(L->global, i_o); \
     }
 
+#define setbufvalue(L, obj, x) \
+    { \
+        TValue* i_o = (obj); \
+        i_o->value.gc = cast_to(GCObject*, (x)); \
+        i_o->tt = LUA_TBUFFER; \
+        checkliveness(L->global, i_o); \
+    }
+
 #define setclvalue(L, obj, x) \
     { \
         TValue* i_o = (obj); \
@@ -260,6 +270,34 @@ typedef struct Udata
     };
 } Udata;
 
+typedef struct Buffer
+{
+    CommonHeader;
+
+    unsigned int len;
+
+    union
+    {
+        char data[1];      // buffer is allocated right after the header
+        L_Umaxalign dummy; // ensures maximum alignment for data
+    };
+} Buffer;
+
+/*
+** Inline caches for GETTABLEKS/SETTABLEKS/NAMECALL
+*/
+
+typedef struct LuaInlineCache
+{
+    int slot;   // node index of the key in the table, or in 'holder' when 'metatable' is set
+    int mtslot; // node index of __index in 'metatable'
+
+    struct Table* metatable; // tables with this metatable that don't have the key get it from 'holder' via __index
+    struct Table* holder;
+
+    struct Shape* shape; // tables with this shape have the key at 'slot' when 'metatable' is not set
+} LuaInlineCache;
+
 /*
 ** Function Prototypes
 */
@@ -281,6 +319,14 @@ typedef struct Proto
     TString* debugname;
     uint8_t* debuginsn; // a copy of code[] array with just opcodes
 
+    void* execdata;     // data owned by the custom execution callbacks (lua_ExecutionCallbacks), typically native code
+
+    LuaInlineCache* ic; // inline caches of table access instructions, indexed by pc & (sizeic - 1); large functions may share entries
+
+    uint8_t* typeinfo;  // parameter types from annotations (see LuauBytecodeType); not checked by the compiler, so only usable as a hint
+
+    struct LazyChunk* lazy; // bytecode to decode the function from on first use (see luau_loadlazy); NULL once the function is decoded
+
     GCObject* gclist;
 
 
@@ -289,15 +335,22 @@ typedef struct Proto
     int sizelocvars;
     int sizeupvalues;
     int sizek;
+    int sizeic;
+    int sizetypeinfo;
     int sizelineinfo;
     int linegaplog2;
     int linedefined;
+    int lazyoffset; // offset of the function body in the lazy chunk
+    int bytecodeid; // index of the function in the bytecode it was loaded from
+
+    unsigned int debughash; // hash of the bytecode to request the debug info sidecar with (see lua_Callbacks::debuginfo); 0 if there's nothing to request
 
 
     uint8_t nups; // number of upvalues
     uint8_t numparams;
     uint8_t is_vararg;
     uint8_t maxstacksize;
+    uint8_t sharedcode; // code and lineinfo are owned by a bytecode image and must not be modified or freed
 } Proto;
 // clang-format on
 
@@ -424,7 +477,9 @@ typedef struct Table
     uint8_t tmcache;    // 1<<p means tagmethod(p) is not present
     uint8_t readonly;   // sandboxing feature to prohibit writes to table
     uint8_t safeenv;    // environment doesn't share globals with other scripts
-    uint8_t lsizenode;  // log2 of size of `node' array
+    uint8_t numarray : 1;  // `array' part stores unboxed numbers, see ltable.cpp
+    uint8_t shaped : 1;    // `node' points to TableSlots, see ltable.cpp
+    uint8_t lsizenode : 6; // log2 of size of `node' array
     uint8_t nodemask8; // (1<<lsizenode)-1, truncated to 8 bits
 
     int sizearray; // size of `array' array
@@ -436,12 +491,45 @@ typedef struct Table
 
 
     struct Table* metatable;
-    TValue* array;  // array part
+    union
+    {
+        TValue* array;  // array part
+        double* narray; // array part when numarray is set
+    };
     LuaNode* node;
     GCObject* gclist;
 } Table;
 // clang-format on
 
+/*
+** Shapes describe the string keys of tables that store their values in slots, see ltable.cpp
+*/
+
+typedef struct Shape
+{
+    CommonHeader;
+
+    uint8_t count; // number of keys
+
+    unsigned int hash; // hash of the parent and the last key, for the transition table
+
+    struct Shape* parent; // shape without the last key; NULL for the empty shape
+    struct Shape* next;   // next shape in the transition table bucket
+
+    TString* keys[1]; // keys in slot order; keys are allocated right after the header
+} Shape;
+
+// hash part of a table that has a shape; its header takes the place of a node with a nil key, so node lookups don't find anything
+typedef struct TableSlots
+{
+    Shape* shape;
+    int size; // number of allocated slots
+
+    TKey nilkey;
+
+    TValue slots[1]; // slots are allocated right after the header
+} TableSlots;
+
 /*
 ** `module' operation for hashing (size is always a power of 2)
 */
@@ -10,6 +10,8 @@
 #include "ldo.h"
 #include "ldebug.h"
 
+#include <string.h>
+
 /*
 ** Main thread combines a thread state and the global state
 */
@@ -54,6 +56,7 @@ static void f_luaopen(lua_State* L, void* ud)
 {
     global_State* g = L->global;
     stack_init(L, L);                             // init stack
+    luaH_initshapes(L);                           // shapes for tables with string keys
     L->gt = luaH_new(L, 0, 2);                    // table of globals
     sethvalue(L, registry(L), luaH_new(L, 0, 2)); // registry
     luaS_resize(L, LUA_MINSTRTABSIZE);            // initial size of string table
@@ -88,8 +91,16 @@ static void close_state(lua_State* L)
     luaF_close(L, L->stack); // close all upvalues for this thread
     luaC_freeall(L);         // collect all objects
     LUAU_ASSERT(g->strt.nuse == 0);
+    LUAU_ASSERT(g->shapet.nuse == 0);
+#if LUA_CUSTOM_EXECUTION
+    if (g->ecb.close)
+        g->ecb.close(L);
+#endif
     luaM_freearray(L, L->global->strt.hash, L->global->strt.size, TString*, 0);
+    luaM_freearray(L, L->global->strt.oldhash, L->global->strt.oldsize, TString*, 0);
+    luaM_freearray(L, L->global->shapet.hash, L->global->shapet.size, Shape*, 0);
     freestack(L, L);
+    luaM_trimpagecache(L, 0);
     for (int i = 0; i < LUA_SIZECLASSES; i++)
     {
         LUAU_ASSERT(g->freepages[i] == NULL);
@@ -185,9 +196,17 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     g->strt.size = 0;
     g->strt.nuse = 0;
     g->strt.hash = NULL;
+    g->strt.oldhash = NULL;
+    g->strt.oldsize = 0;
+    g->strt.rehashpos = 0;
+    g->shapet.size = 0;
+    g->shapet.nuse = 0;
+    g->shapet.hash = NULL;
+    g->rootshape = NULL;
     setnilvalue(&g->pseudotemp);
     setnilvalue(registry(L));
     g->gcstate = GCSpause;
+    g->gckind = KGC_INC;
     g->gray = NULL;
     g->grayagain = NULL;
     g->weak = NULL;
@@ -195,6 +214,9 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     g->gcgoal = LUAI_GCGOAL;
     g->gcstepmul = LUAI_GCSTEPMUL;
     g->gcstepsize = LUAI_GCSTEPSIZE << 10;
+    g->gcgenminormul = LUAI_GCGENMINORMUL;
+    g->gcgenmajormul = LUAI_GCGENMAJORMUL;
+    g->gcmajorbytes = 0;
     for (i = 0; i < LUA_SIZECLASSES; i++)
     {
         g->freepages[i] = NULL;
@@ -202,6 +224,12 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     }
     g->allgcopages = NULL;
     g->sweepgcopage = NULL;
+    g->younggcopages = NULL;
+    g->pagecache = NULL;
+    g->pagecachesize = 0;
+    g->pagecachelimit = LUAI_PAGECACHE;
+    g->pagecachehits = 0;
+    g->pagecachemisses = 0;
     for (i = 0; i < LUA_T_COUNT; i++)
         g->mt[i] = NULL;
     for (i = 0; i < LUA_UTAG_LIMIT; i++)
@@ -212,12 +240,20 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     g->memcatbytes[0] = sizeof(LG);
 
     g->cb = lua_Callbacks();
+
+#if LUA_CUSTOM_EXECUTION
+    g->ecb = lua_ExecutionCallbacks();
+#endif
     g->gcstats = GCStats();
 
 #ifdef LUAI_GCMETRICS
     g->gcmetrics = GCMetrics();
 #endif
 
+#ifdef LUAI_OPSTATS
+    memset(g->opstats, 0, sizeof(g->opstats));
+#endif
+
     if (luaD_rawrunprotected(L, f_luaopen, NULL) != 0)
     {
         // memory allocation error: free partial state
@@ -5,6 +5,10 @@
 #include "lobject.h"
 #include "ltm.h"
 
+#ifdef LUAI_OPSTATS
+#include "lbytecode.h"
+#endif
+
 // registry
 #define registry(L) (&L->global->registry)
 
@@ -22,9 +26,22 @@ typedef struct stringtable
     TString** hash;
     uint32_t nuse; // number of elements
     int size;
+
+    // while the table is being resized, strings from buckets of the previous array that are below rehashpos have been moved to hash
+    TString** oldhash;
+    int oldsize;
+    int rehashpos;
 } stringtable;
 // clang-format on
 
+// transition table of shapes, keyed by the parent shape and the key that the shape adds
+typedef struct shapetable
+{
+    Shape** hash;
+    uint32_t nuse; // number of elements
+    int size;
+} shapetable;
+
 /*
 ** informations about a call
 **
@@ -146,6 +163,19 @@ struct GCMetrics
 };
 #endif
 
+#if LUA_CUSTOM_EXECUTION
+/*
+** Callbacks that can be used to redirect code execution from Luau bytecode VM to a custom implementation (AoT/JiT/sandboxing/...)
+*/
+typedef struct lua_ExecutionCallbacks
+{
+    void* context;
+    void (*close)(lua_State* L);                        // called when global VM state is closed
+    void (*destroy)(lua_State* L, struct Proto* proto); // called when function is destroyed
+    int (*enter)(lua_State* L, struct Proto* proto);    // called when function is about to start or continue after a call (when execdata is present), return 1 to resume VM at L->ci->savedpc
+} lua_ExecutionCallbacks;
+#endif
+
 /*
 ** `global state', shared by all threads of this state
 */
@@ -153,6 +183,8 @@ struct GCMetrics
 typedef struct global_State
 {
     stringtable strt; // hash table for strings
+    shapetable shapet; // transition table for shapes
+    Shape* rootshape;  // shape without keys
 
 
     lua_Alloc frealloc;   // function to reallocate memory
@@ -161,11 +193,12 @@ typedef struct global_State
 
     uint8_t currentwhite;
     uint8_t gcstate; // state of garbage collector
+    uint8_t gckind;  // kind of garbage collection (KGC_INC or KGC_GEN)
 
 
     GCObject* gray;      // list of gray objects
     GCObject* grayagain; // list of objects to be traversed atomically
-    GCObject* weak;     // list of weak tables (to be cleared)
+    GCObject* weak;     // list of weak tables and protos with inline caches (to be cleared)
 
 
     size_t GCthreshold;                       // when totalbytes > GCthreshold, run GC step
@@ -173,11 +206,21 @@ typedef struct global_State
     int gcgoal;                               // see LUAI_GCGOAL
     int gcstepmul;                            // see LUAI_GCSTEPMUL
     int gcstepsize;                          // see LUAI_GCSTEPSIZE
+    int gcgenminormul;                        // see LUAI_GCGENMINORMUL
+    int gcgenmajormul;                        // see LUAI_GCGENMAJORMUL
+    size_t gcmajorbytes;                      // number of bytes in use after the last major collection (generational mode only)
 
     struct lua_Page* freepages[LUA_SIZECLASSES]; // free page linked list for each size class for non-collectable objects
     struct lua_Page* freegcopages[LUA_SIZECLASSES]; // free page linked list for each size class for collectable objects
     struct lua_Page* allgcopages; // page linked list with all pages for all classes
     struct lua_Page* sweepgcopage; // position of the sweep in `allgcopages'
+    struct lua_Page* younggcopages; // page linked list with all pages that received new objects since the last collection (generational mode only)
+
+    struct lua_Page* pagecache; // free page linked list of empty pages kept for reuse by any size class
+    int pagecachesize;          // number of pages in pagecache
+    int pagecachelimit;         // see LUAI_PAGECACHE
+    size_t pagecachehits;       // number of page allocations served from pagecache
+    size_t pagecachemisses;     // number of page allocations that required a new page
 
     size_t memcatbytes[LUA_MEMORY_CATEGORIES]; // total amount of memory used by each memory category
 
@@ -202,11 +245,19 @@ typedef struct global_State
 
     lua_Callbacks cb;
 
+#if LUA_CUSTOM_EXECUTION
+    lua_ExecutionCallbacks ecb;
+#endif
+
     GCStats gcstats;
 
 #ifdef LUAI_GCMETRICS
     GCMetrics gcmetrics;
 #endif
+
+#ifdef LUAI_OPSTATS
+    uint64_t opstats[LOP__COUNT][LOP__COUNT]; // number of times the interpreter dispatched the second opcode right after the first one
+#endif
 } global_State;
 // clang-format on
 
@@ -265,10 +316,12 @@ union GCObject
     GCheader gch;
     struct TString ts;
     struct Udata u;
+    struct Buffer buf;
     struct Closure cl;
     struct Table h;
     struct Proto p;
     struct UpVal uv;
+    struct Shape sh;
     struct lua_State th; // thread
 };
 
@@ -280,6 +333,8 @@ union GCObject
 #define gco2p(o) check_exp((o)->gch.tt == LUA_TPROTO, &((o)->p))
 #define gco2uv(o) check_exp((o)->gch.tt == LUA_TUPVAL, &((o)->uv))
 #define gco2th(o) check_exp((o)->gch.tt == LUA_TTHREAD, &((o)->th))
+#define gco2buf(o) check_exp((o)->gch.tt == LUA_TBUFFER, &((o)->buf))
+#define gco2sh(o) check_exp((o)->gch.tt == LUA_TSHAPE, &((o)->sh))
 
 // macro to convert any Lua object into a GCObject
 #define obj2gco(v) check_exp(iscollectable(v), cast_to(GCObject*, (v) + 0))
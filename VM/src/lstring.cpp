@@ -42,30 +42,100 @@ unsigned int luaS_hash(const char* str, size_t len)
     return h;
 }
 
-void luaS_resize(lua_State* L, int newsize)
+// moves up to 'steps' buckets of the previous array to the current one; frees the previous array once all buckets have been moved
+static void rehashstep(lua_State* L, stringtable* tb, int steps)
 {
-    TString** newhash = luaM_newarray(L, newsize, TString*, 0);
-    stringtable* tb = &L->global->strt;
-    for (int i = 0; i < newsize; i++)
-        newhash[i] = NULL;
-    // rehash
-    for (int i = 0; i < tb->size; i++)
+    int end = (steps < tb->oldsize - tb->rehashpos) ? tb->rehashpos + steps : tb->oldsize;
+
+    for (int i = tb->rehashpos; i < end; i++)
     {
-        TString* p = tb->hash[i];
+        TString* p = tb->oldhash[i];
         while (p)
         {                            // for each node in the list
             TString* next = p->next; // save next
             unsigned int h = p->hash;
-            int h1 = lmod(h, newsize); // new position
-            LUAU_ASSERT(cast_int(h % newsize) == lmod(h, newsize));
-            p->next = newhash[h1]; // chain it
-            newhash[h1] = p;
+            int h1 = lmod(h, tb->size); // new position
+            LUAU_ASSERT(cast_int(h % tb->size) == lmod(h, tb->size));
+            p->next = tb->hash[h1]; // chain it
+            tb->hash[h1] = p;
             p = next;
         }
+        tb->oldhash[i] = NULL;
     }
-    luaM_freearray(L, tb->hash, tb->size, TString*, 0);
-    tb->size = newsize;
+
+    tb->rehashpos = end;
+
+    if (tb->rehashpos == tb->oldsize)
+    {
+        luaM_freearray(L, tb->oldhash, tb->oldsize, TString*, 0);
+        tb->oldhash = NULL;
+        tb->oldsize = 0;
+        tb->rehashpos = 0;
+    }
+}
+
+// the bucket that holds strings with hash 'h' in the previous array, if it hasn't been moved yet
+static TString** oldbucket(stringtable* tb, unsigned int h)
+{
+    if (!tb->oldhash)
+        return NULL;
+
+    int bucket = lmod(h, tb->oldsize);
+    return bucket >= tb->rehashpos ? &tb->oldhash[bucket] : NULL;
+}
+
+static TString* findstr(lua_State* L, const char* str, size_t l, unsigned int h)
+{
+    stringtable* tb = &L->global->strt;
+
+    for (TString* el = tb->hash[lmod(h, tb->size)]; el != NULL; el = el->next)
+    {
+        if (el->len == l && (memcmp(str, getstr(el), l) == 0))
+            return el;
+    }
+
+    if (TString** old = oldbucket(tb, h))
+    {
+        for (TString* el = *old; el != NULL; el = el->next)
+        {
+            if (el->len == l && (memcmp(str, getstr(el), l) == 0))
+                return el;
+        }
+    }
+
+    return NULL;
+}
+
+static void growstrtab(lua_State* L, stringtable* tb)
+{
+    tb->nuse++;
+    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
+        luaS_resize(L, tb->size * 2); // too crowded
+    else if (tb->oldhash)
+        rehashstep(L, tb, LUAI_STRTABREHASHSTEP);
+}
+
+// the new array replaces the current one right away, but existing strings are moved to it incrementally as new strings are
+// created, so that the string table doesn't have to be rehashed all at once when it grows
+void luaS_resize(lua_State* L, int newsize)
+{
+    TString** newhash = luaM_newarray(L, newsize, TString*, 0);
+    stringtable* tb = &L->global->strt;
+    for (int i = 0; i < newsize; i++)
+        newhash[i] = NULL;
+
+    // finish moving the strings of the previous resize; each insertion moves enough buckets to make this rare
+    if (tb->oldhash)
+        rehashstep(L, tb, tb->oldsize);
+
+    tb->oldhash = tb->hash;
+    tb->oldsize = tb->size;
+    tb->rehashpos = 0;
     tb->hash = newhash;
+    tb->size = newsize;
+
+    if (tb->oldsize == 0)
+        tb->oldhash = NULL;
 }
 
 static TString* newlstr(lua_State* L, const char* str, size_t l, unsigned int h)
@@ -87,9 +157,7 @@ static TString* newlstr(lua_State* L, const char* str, size_t l, unsigned int h)
     ts->next = tb->hash[h]; // chain new entry
     tb->hash[h] = ts;
 
-    tb->nuse++;
-    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
-        luaS_resize(L, tb->size * 2); // too crowded
+    growstrtab(L, tb);
 
     return ts;
 }
@@ -114,32 +182,28 @@ TString* luaS_buffinish(lua_State* L, TString* ts)
 {
     unsigned int h = luaS_hash(ts->data, ts->len);
     stringtable* tb = &L->global->strt;
-    int bucket = lmod(h, tb->size);
 
     // search if we already have this string in the hash table
-    for (TString* el = tb->hash[bucket]; el != NULL; el = el->next)
+    if (TString* el = findstr(L, ts->data, ts->len, h))
     {
-        if (el->len == ts->len && memcmp(el->data, ts->data, ts->len) == 0)
-        {
-            // string may be dead
-            if (isdead(L->global, obj2gco(el)))
-                changewhite(obj2gco(el));
+        // string may be dead
+        if (isdead(L->global, obj2gco(el)))
+            changewhite(obj2gco(el));
 
-            return el;
-        }
+        return el;
     }
 
     LUAU_ASSERT(ts->next == NULL);
 
+    int bucket = lmod(h, tb->size);
+
     ts->hash = h;
     ts->data[ts->len] = '\0'; // ending 0
     ts->atom = ATOM_UNDEF;
     ts->next = tb->hash[bucket]; // chain new entry
     tb->hash[bucket] = ts;
 
-    tb->nuse++;
-    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
-        luaS_resize(L, tb->size * 2); // too crowded
+    growstrtab(L, tb);
 
     return ts;
 }
@@ -147,15 +211,12 @@ TString* luaS_buffinish(lua_State* L, TString* ts)
 TString* luaS_newlstr(lua_State* L, const char* str, size_t l)
 {
     unsigned int h = luaS_hash(str, l);
-    for (TString* el = L->global->strt.hash[lmod(h, L->global->strt.size)]; el != NULL; el = el->next)
+    if (TString* el = findstr(L, str, l, h))
     {
-        if (el->len == l && (memcmp(str, getstr(el), l) == 0))
-        {
-            // string may be dead
-            if (isdead(L->global, obj2gco(el)))
-                changewhite(obj2gco(el));
-            return el;
-        }
+        // string may be dead
+        if (isdead(L->global, obj2gco(el)))
+            changewhite(obj2gco(el));
+        return el;
     }
     return newlstr(L, str, l, h); // not found
 }
@@ -179,6 +240,22 @@ static bool unlinkstr(lua_State* L, TString* ts)
         }
     }
 
+    // the string may still be in the previous array if the table is being resized
+    p = oldbucket(&g->strt, ts->hash);
+
+    while (TString* curr = p ? *p : NULL)
+    {
+        if (curr == ts)
+        {
+            *p = curr->next;
+            return true;
+        }
+        else
+        {
+            p = &curr->next;
+        }
+    }
+
     return false;
 }
 
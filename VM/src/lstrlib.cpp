@@ -648,6 +648,438 @@ static void reprepstate(MatchState* ms)
     LUAU_ASSERT(ms->matchdepth == LUAI_MAXCCALLS);
 }
 
+/*
+** Patterns without back-references and balance items are compiled into a list of items, with every character class
+** expanded into a 256-bit set. 'pmatch' follows the same steps as 'match' over these items, so results, captures and
+** errors are the same, but classes are tested with a single lookup and the pattern is never parsed again.
+** Compiled patterns are kept in a cache with weak values that is shared by all functions that match patterns.
+*/
+
+// maximum number of characters that every match has to start with, used to find where a match can start
+#define MAX_PATTERN_PREFIX 16
+
+enum PatternItemKind
+{
+    PI_SINGLE,      // single character class, optionally followed by '*', '+', '-' or '?'
+    PI_CAPSTART,    // '('
+    PI_CAPPOSITION, // '()'
+    PI_CAPEND,      // ')'
+    PI_END,         // '$' at the end of the pattern
+    PI_FRONTIER,    // '%f[set]'
+};
+
+typedef struct PatternItem
+{
+    unsigned char kind;
+    char rep;              // repetition suffix of a single character class, or 0
+    unsigned char set[32]; // characters that match the class
+} PatternItem;
+
+typedef struct PatternProgram
+{
+    int compiled; // 0 if the pattern has to be interpreted by 'match'
+    int anchor;   // pattern starts with '^'; items don't include it
+    int size;
+    int first;     // single class that has to match the first character of every match, or -1
+    int prefixlen; // characters that every match starts with
+    char prefix[MAX_PATTERN_PREFIX];
+    PatternItem items[1];
+} PatternProgram;
+
+static int inset(const PatternItem* item, int c)
+{
+    return (item->set[c >> 3] >> (c & 7)) & 1;
+}
+
+// same as 'classend', but returns NULL for malformed patterns so that 'match' can report the error when it gets there
+static const char* compileclassend(const char* p, const char* p_end)
+{
+    switch (*p++)
+    {
+    case L_ESC:
+        return p == p_end ? NULL : p + 1;
+    case '[':
+    {
+        if (*p == '^')
+            p++;
+        do
+        { // look for a `]'
+            if (p == p_end)
+                return NULL;
+            if (*(p++) == L_ESC && p < p_end)
+                p++; // skip escapes (e.g. `%]')
+        } while (*p != ']');
+        return p + 1;
+    }
+    default:
+        return p;
+    }
+}
+
+static void compileclass(PatternItem* item, const char* p, const char* ep, int frontier)
+{
+    memset(item->set, 0, sizeof(item->set));
+    for (int c = 0; c < 256; c++)
+    {
+        int res;
+        if (frontier)
+            res = matchbracketclass(c, p, ep - 1);
+        else
+        {
+            switch (*p)
+            {
+            case '.':
+                res = 1;
+                break;
+            case L_ESC:
+                res = match_class(c, uchar(*(p + 1)));
+                break;
+            case '[':
+                res = matchbracketclass(c, p, ep - 1);
+                break;
+            default:
+                res = (uchar(*p) == c);
+                break;
+            }
+        }
+        if (res)
+            item->set[c >> 3] |= 1 << (c & 7);
+    }
+}
+
+// parses the pattern into 'items' if it's not NULL; returns the number of items, or -1 if the pattern can't be compiled
+static int compilepattern(const char* p, const char* p_end, PatternItem* items)
+{
+    int size = 0;
+    int captures = 0;
+    int open = 0;
+    while (p != p_end)
+    {
+        PatternItem* item = items ? &items[size] : NULL;
+        int kind = PI_SINGLE;
+        char rep = 0;
+        switch (*p)
+        {
+        case '(':
+        {
+            if (++captures > LUA_MAXCAPTURES)
+                return -1;
+            if (*(p + 1) == ')')
+            {
+                kind = PI_CAPPOSITION;
+                p += 2;
+            }
+            else
+            {
+                kind = PI_CAPSTART;
+                open++;
+                p++;
+            }
+            break;
+        }
+        case ')':
+        {
+            if (open-- == 0)
+                return -1;
+            kind = PI_CAPEND;
+            p++;
+            break;
+        }
+        case '$':
+        {
+            if ((p + 1) != p_end)
+                goto dflt;
+            kind = PI_END;
+            p++;
+            break;
+        }
+        case L_ESC:
+        {
+            if (*(p + 1) == 'b' || isdigit(uchar(*(p + 1))))
+                return -1;
+            if (*(p + 1) != 'f')
+                goto dflt;
+            p += 2;
+            const char* ep = *p == '[' ? compileclassend(p, p_end) : NULL;
+            if (!ep)
+                return -1;
+            kind = PI_FRONTIER;
+            if (item)
+                compileclass(item, p, ep, 1);
+            p = ep;
+            break;
+        }
+        default:
+        dflt:
+        {
+            const char* ep = compileclassend(p, p_end);
+            if (!ep)
+                return -1;
+            if (ep != p_end && (*ep == '*' || *ep == '+' || *ep == '-' || *ep == '?'))
+                rep = *ep;
+            if (item)
+                compileclass(item, p, ep, 0);
+            p = rep ? ep + 1 : ep;
+            break;
+        }
+        }
+        if (item)
+        {
+            item->kind = (unsigned char)kind;
+            item->rep = rep;
+        }
+        size++;
+    }
+    return size;
+}
+
+// returns the only character of a single class, or -1
+static int singlechar(const PatternItem* item)
+{
+    int result = -1;
+    for (int c = 0; c < 256; c++)
+    {
+        if (inset(item, c))
+        {
+            if (result >= 0)
+                return -1;
+            result = c;
+        }
+    }
+    return result;
+}
+
+static void compileprefix(PatternProgram* prog)
+{
+    int first = 0;
+    while (first < prog->size && (prog->items[first].kind == PI_CAPSTART || prog->items[first].kind == PI_CAPPOSITION))
+        first++;
+    if (first == prog->size || prog->items[first].kind != PI_SINGLE || (prog->items[first].rep != 0 && prog->items[first].rep != '+'))
+        return;
+    prog->first = first;
+    // captures don't consume characters, so the prefix continues after them
+    for (int i = first; i < prog->size && prog->prefixlen < MAX_PATTERN_PREFIX; i++)
+    {
+        const PatternItem* item = &prog->items[i];
+        if (item->kind == PI_CAPSTART || item->kind == PI_CAPPOSITION || item->kind == PI_CAPEND)
+            continue;
+        if (item->kind != PI_SINGLE || (item->rep != 0 && item->rep != '+'))
+            break;
+        int c = singlechar(item);
+        if (c < 0)
+            break;
+        prog->prefix[prog->prefixlen++] = char(c);
+        if (item->rep == '+')
+            break;
+    }
+}
+
+// returns the compiled form of the pattern at 'arg', which is left on the stack to keep it alive
+static const PatternProgram* getpattern(lua_State* L, int arg)
+{
+    lua_pushvalue(L, arg);
+    lua_rawget(L, lua_upvalueindex(1));
+    if (const PatternProgram* prog = (const PatternProgram*)lua_touserdata(L, -1))
+        return prog;
+    lua_pop(L, 1);
+
+    size_t lp;
+    const char* p = lua_tolstring(L, arg, &lp);
+    const char* p_end = p + lp;
+    int anchor = (*p == '^');
+    if (anchor)
+        p++;
+    int size = compilepattern(p, p_end, NULL);
+    PatternProgram* prog =
+        (PatternProgram*)lua_newuserdata(L, offsetof(PatternProgram, items) + (size > 0 ? size : 0) * sizeof(PatternItem));
+    memset(prog, 0, offsetof(PatternProgram, items));
+    prog->compiled = size >= 0;
+    prog->anchor = anchor;
+    prog->first = -1;
+    if (size > 0)
+    {
+        prog->size = compilepattern(p, p_end, prog->items);
+        compileprefix(prog);
+    }
+
+    lua_pushvalue(L, arg);
+    lua_pushvalue(L, -2);
+    lua_rawset(L, lua_upvalueindex(1));
+    return prog;
+}
+
+static const char* pmatch(MatchState* ms, const PatternProgram* prog, const char* s, int i);
+
+// if the item after a repetition has to match a character, positions where it can't match don't need to be tried
+static const PatternItem* nextrequired(MatchState* ms, const PatternProgram* prog, int i)
+{
+    // the call that is skipped could fail with 'pattern too complex'
+    if (i + 1 == prog->size || ms->matchdepth == 0)
+        return NULL;
+    const PatternItem* next = &prog->items[i + 1];
+    return next->kind == PI_SINGLE && (next->rep == 0 || next->rep == '+') ? next : NULL;
+}
+
+static const char* pmax_expand(MatchState* ms, const PatternProgram* prog, const char* s, int i)
+{
+    const PatternItem* item = &prog->items[i];
+    const PatternItem* next = nextrequired(ms, prog, i);
+    ptrdiff_t n = 0; // counts maximum expand for item
+    while (s + n < ms->src_end && inset(item, uchar(s[n])))
+        n++;
+    // keeps trying to match with the maximum repetitions
+    while (n >= 0)
+    {
+        if (!next || (s + n < ms->src_end && inset(next, uchar(s[n]))))
+        {
+            const char* res = pmatch(ms, prog, s + n, i + 1);
+            if (res)
+                return res;
+        }
+        n--; // else didn't match; reduce 1 repetition to try again
+    }
+    return NULL;
+}
+
+static const char* pmin_expand(MatchState* ms, const PatternProgram* prog, const char* s, int i)
+{
+    const PatternItem* item = &prog->items[i];
+    const PatternItem* next = nextrequired(ms, prog, i);
+    for (;;)
+    {
+        if (!next || (s < ms->src_end && inset(next, uchar(*s))))
+        {
+            const char* res = pmatch(ms, prog, s, i + 1);
+            if (res != NULL)
+                return res;
+        }
+        if (s < ms->src_end && inset(item, uchar(*s)))
+            s++; // try with one more repetition
+        else
+            return NULL;
+    }
+}
+
+static const char* pmatch(MatchState* ms, const PatternProgram* prog, const char* s, int i)
+{
+    if (ms->matchdepth-- == 0)
+        luaL_error(ms->L, "pattern too complex");
+init: // using goto's to optimize tail recursion
+    if (i != prog->size)
+    { // end of pattern?
+        const PatternItem* item = &prog->items[i];
+        switch (item->kind)
+        {
+        case PI_CAPSTART:
+        case PI_CAPPOSITION:
+        { // start capture; compiled patterns don't have more than LUA_MAXCAPTURES captures
+            const char* res;
+            int level = ms->level;
+            ms->capture[level].init = s;
+            ms->capture[level].len = item->kind == PI_CAPPOSITION ? CAP_POSITION : CAP_UNFINISHED;
+            ms->level = level + 1;
+            if ((res = pmatch(ms, prog, s, i + 1)) == NULL) // match failed?
+                ms->level--;                                // undo capture
+            s = res;
+            break;
+        }
+        case PI_CAPEND:
+        { // end capture
+            int l = capture_to_close(ms);
+            const char* res;
+            ms->capture[l].len = s - ms->capture[l].init;   // close capture
+            if ((res = pmatch(ms, prog, s, i + 1)) == NULL) // match failed?
+                ms->capture[l].len = CAP_UNFINISHED;        // undo capture
+            s = res;
+            break;
+        }
+        case PI_END:
+        {
+            s = (s == ms->src_end) ? s : NULL; // check end of string
+            break;
+        }
+        case PI_FRONTIER:
+        {
+            int previous = (s == ms->src_init) ? 0 : uchar(*(s - 1));
+            int current = (s < ms->src_end) ? uchar(*s) : 0;
+            if (!inset(item, previous) && inset(item, current))
+            {
+                i++;
+                goto init; // return pmatch(ms, prog, s, i + 1);
+            }
+            s = NULL; // match failed
+            break;
+        }
+        default:
+        { // single character class plus optional suffix
+            // does not match at least once?
+            if (s >= ms->src_end || !inset(item, uchar(*s)))
+            {
+                if (item->rep == '*' || item->rep == '?' || item->rep == '-')
+                { // accept empty?
+                    i++;
+                    goto init; // return pmatch(ms, prog, s, i + 1);
+                }
+                else          // '+' or no suffix
+                    s = NULL; // fail
+            }
+            else
+            { // matched once
+                switch (item->rep)
+                { // handle optional suffix
+                case '?':
+                { // optional
+                    const char* res;
+                    if ((res = pmatch(ms, prog, s + 1, i + 1)) != NULL)
+                        s = res;
+                    else
+                    {
+                        i++;
+                        goto init; // else return pmatch(ms, prog, s, i + 1);
+                    }
+                    break;
+                }
+                case '+': // 1 or more repetitions
+                    s++;  // 1 match already done
+                          // go through
+                case '*': // 0 or more repetitions
+                    s = pmax_expand(ms, prog, s, i);
+                    break;
+                case '-': // 0 or more repetitions (minimum)
+                    s = pmin_expand(ms, prog, s, i);
+                    break;
+                default: // no suffix
+                    s++;
+                    i++;
+                    goto init; // return pmatch(ms, prog, s + 1, i + 1);
+                }
+            }
+            break;
+        }
+        }
+    }
+    ms->matchdepth++;
+    return s;
+}
+
+// matches the pattern at 's' using its compiled form when there is one
+static const char* domatch(MatchState* ms, const PatternProgram* prog, const char* s, const char* p)
+{
+    return prog && prog->compiled ? pmatch(ms, prog, s, 0) : match(ms, s, p);
+}
+
+// returns the first position at or after 's' where the pattern can match, or NULL if there is none
+static const char* findstart(MatchState* ms, const PatternProgram* prog, const char* s)
+{
+    if (prog->prefixlen > 0)
+        return lmemfind(s, ms->src_end - s, prog->prefix, prog->prefixlen);
+
+    const PatternItem* item = &prog->items[prog->first];
+    while (s < ms->src_end && !inset(item, uchar(*s)))
+        s++;
+    return s < ms->src_end ? s : NULL;
+}
+
 static int str_find_aux(lua_State* L, int find)
 {
     size_t ls, lp;
@@ -677,7 +1109,9 @@ static int str_find_aux(lua_State* L, int find)
     {
         MatchState ms;
         const char* s1 = s + init - 1;
+        const PatternProgram* prog = getpattern(L, 2);
         int anchor = (*p == '^');
+        int skip = !anchor && prog->first >= 0;
         if (anchor)
         {
             p++;
@@ -687,8 +1121,10 @@ static int str_find_aux(lua_State* L, int find)
         do
         {
             const char* res;
+            if (skip && (s1 = findstart(&ms, prog, s1)) == NULL)
+                break;
             reprepstate(&ms);
-            if ((res = match(&ms, s1, p)) != NULL)
+            if ((res = domatch(&ms, prog, s1, p)) != NULL)
             {
                 if (find)
                 {
@@ -721,13 +1157,17 @@ static int gmatch_aux(lua_State* L)
     size_t ls, lp;
     const char* s = lua_tolstring(L, lua_upvalueindex(1), &ls);
     const char* p = lua_tolstring(L, lua_upvalueindex(2), &lp);
+    const PatternProgram* prog = (const PatternProgram*)lua_touserdata(L, lua_upvalueindex(4));
+    int skip = prog && prog->first >= 0;
     const char* src;
     prepstate(&ms, L, s, ls, p, lp);
     for (src = s + (size_t)lua_tointeger(L, lua_upvalueindex(3)); src <= ms.src_end; src++)
     {
         const char* e;
+        if (skip && (src = findstart(&ms, prog, src)) == NULL)
+            break;
         reprepstate(&ms);
-        if ((e = match(&ms, src, p)) != NULL)
+        if ((e = domatch(&ms, prog, src, p)) != NULL)
         {
             int newstart = (int)(e - s);
             if (e == src)
@@ -746,7 +1186,13 @@ static int gmatch(lua_State* L)
     luaL_checkstring(L, 2);
     lua_settop(L, 2);
     lua_pushinteger(L, 0);
-    lua_pushcclosure(L, gmatch_aux, NULL, 3);
+    // gmatch doesn't treat '^' as an anchor, so these patterns are left to 'match'
+    if (getpattern(L, 2)->anchor)
+    {
+        lua_pop(L, 1);
+        lua_pushnil(L);
+    }
+    lua_pushcclosure(L, gmatch_aux, NULL, 4);
     return 1;
 }
 
@@ -828,6 +1274,8 @@ static int str_gsub(lua_State* L)
     MatchState ms;
     luaL_Buffer b;
     luaL_argexpected(L, tr == LUA_TNUMBER || tr == LUA_TSTRING || tr == LUA_TFUNCTION || tr == LUA_TTABLE, 3, "string/function/table");
+    const PatternProgram* prog = getpattern(L, 2);
+    int skip = !anchor && prog->first >= 0;
     luaL_buffinit(L, &b);
     if (anchor)
     {
@@ -838,8 +1286,16 @@ static int str_gsub(lua_State* L)
     while (n < max_s)
     {
         const char* e;
+        if (skip)
+        { // copy the part that can't match
+            const char* start = findstart(&ms, prog, src);
+            if (!start)
+                start = ms.src_end;
+            luaL_addlstring(&b, src, start - src);
+            src = start;
+        }
         reprepstate(&ms);
-        e = match(&ms, src, p);
+        e = domatch(&ms, prog, src, p);
         if (e)
         {
             n++;
@@ -1623,13 +2079,9 @@ static int str_unpack(lua_State* L)
 static const luaL_Reg strlib[] = {
     {"byte", str_byte},
     {"char", str_char},
-    {"find", str_find},
     {"format", str_format},
-    {"gmatch", gmatch},
-    {"gsub", str_gsub},
     {"len", str_len},
     {"lower", str_lower},
-    {"match", str_match},
     {"rep", str_rep},
     {"reverse", str_reverse},
     {"sub", str_sub},
@@ -1641,6 +2093,31 @@ static const luaL_Reg strlib[] = {
     {NULL, NULL},
 };
 
+// functions that match patterns share the cache of compiled patterns
+static const luaL_Reg patternlib[] = {
+    {"find", str_find},
+    {"gmatch", gmatch},
+    {"gsub", str_gsub},
+    {"match", str_match},
+    {NULL, NULL},
+};
+
+static void createpatternlib(lua_State* L)
+{
+    lua_createtable(L, 0, 0); // cache of compiled patterns
+    lua_createtable(L, 0, 1);
+    lua_pushliteral(L, "v");
+    lua_setfield(L, -2, "__mode"); // unused compiled patterns are collected and compiled again when needed
+    lua_setmetatable(L, -2);
+    for (const luaL_Reg* l = patternlib; l->name; l++)
+    {
+        lua_pushvalue(L, -1);
+        lua_pushcclosure(L, l->func, l->name, 1);
+        lua_setfield(L, -3, l->name);
+    }
+    lua_pop(L, 1); // pop cache
+}
+
 static void createmetatable(lua_State* L)
 {
     lua_createtable(L, 0, 1); // create metatable for strings
@@ -1659,6 +2136,7 @@ static void createmetatable(lua_State* L)
 int luaopen_string(lua_State* L)
 {
     luaL_register(L, LUA_STRLIBNAME, strlib);
+    createpatternlib(L);
     createmetatable(L);
 
     return 1;
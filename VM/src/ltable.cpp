@@ -21,6 +21,24 @@
  * invariant where the boundary must be in the array part - this enforces a consistent iteration order through the
  * prefix of the table when using pairs(), and allows to implement algorithms that access elements in 1..#t range
  * more efficiently.
+ *
+ * While all values stored in the array part are numbers, the array part is kept as a packed array of doubles
+ * (see Table::numarray) with nil represented by a reserved NaN; this halves the memory used by numeric arrays and
+ * doesn't require any work from the GC. The first store of any other value converts the array part to TValues for
+ * the rest of the lifetime of the table. Functions that return pointers to table slots can't refer to packed
+ * elements, so luaH_getnum/luaH_get must not be used for keys in the packed array part (luaH_getvalue can), and
+ * luaH_set/luaH_setnum convert the array part before returning the slot.
+ *
+ * With LuauTableShapes, tables that only have string keys in the hash part keep them in a shape (see
+ * Table::shaped): the keys are stored once in an immutable Shape that is shared by all tables that received the
+ * same keys in the same order, and the values are stored in a dense slot array (TableSlots) in key order. Adding a
+ * key moves the table to the child shape that the global transition table maps the current shape and the key to, so
+ * tables created by the same code end up with the same shape, and inline caches can find a field with a shape
+ * comparison and an indexed load. Removed fields keep their slot with a nil value so that traversals are stable;
+ * once the table gets another key, it switches to a regular node hash, as it does when it receives a key of another
+ * type or more than LUAI_MAXSHAPEKEYS keys. The TableSlots header reads as a single node with a nil key, so code
+ * that looks for string keys in node slots (slot predictions of instructions) simply misses. Shapes change the
+ * traversal order of such tables to the order in which the keys were added, which is why they are opt-in.
  */
 
 #include "ltable.h"
@@ -33,11 +51,15 @@
 
 #include <string.h>
 
+LUAU_FASTFLAGVARIABLE(LuauTableShapes, false)
+
 // max size of both array and hash part is 2^MAXBITS
 #define MAXBITS 26
 #define MAXSIZE (1 << MAXBITS)
 
 static_assert(offsetof(LuaNode, val) == 0, "Unexpected Node memory layout, pointer cast in gval2slot is incorrect");
+static_assert(offsetof(TableSlots, nilkey) == offsetof(LuaNode, key), "TableSlots header must read as a node with a nil key");
+static_assert(LUAI_MAXSHAPEKEYS < 256, "shape key count must fit into Shape::count");
 
 // TKey is bitpacked for memory efficiency so we need to validate bit counts for worst case
 static_assert(TKey{{NULL}, {0}, LUA_TDEADKEY, 0}.tt == LUA_TDEADKEY, "not enough bits for tt");
@@ -52,6 +74,9 @@ const LuaNode luaH_dummynode = {
 
 #define dummynode (&luaH_dummynode)
 
+// the hash part doesn't have number keys
+#define nonumkeys(t) ((t)->node == dummynode || (t)->shaped)
+
 // hash is always reduced mod 2^k
 #define hashpow2(t, n) (gnode(t, lmod((n), sizenode(t))))
 
@@ -161,6 +186,197 @@ static int arrayindex(double key)
     return luai_numeq(cast_num(i), key) ? i : -1;
 }
 
+static void setnodevector(lua_State* L, Table* t, int size);
+static TValue* newkey(lua_State* L, Table* t, const TValue* key);
+
+/*
+** {=============================================================
+** Shapes
+** ==============================================================
+*/
+
+static unsigned int shapehash(const Shape* parent, TString* key)
+{
+    unsigned int h = unsigned(uintptr_t(parent)) ^ key->hash;
+
+    // MurmurHash3 32-bit finalizer
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+
+    return h;
+}
+
+static Shape* newshape(lua_State* L, Shape* parent, TString* key, unsigned int h)
+{
+    int count = parent ? parent->count + 1 : 0;
+    Shape* s = luaM_newgco(L, Shape, sizeshape(count), L->activememcat);
+    luaC_init(L, s, LUA_TSHAPE);
+    s->count = cast_byte(count);
+    s->hash = h;
+    s->parent = parent;
+    s->next = NULL;
+    if (parent)
+    {
+        memcpy(s->keys, parent->keys, parent->count * sizeof(TString*));
+        s->keys[parent->count] = key;
+    }
+    return s;
+}
+
+static void resizeshapes(lua_State* L, int newsize)
+{
+    global_State* g = L->global;
+    Shape** newhash = luaM_newarray(L, newsize, Shape*, 0);
+    for (int i = 0; i < newsize; i++)
+        newhash[i] = NULL;
+    for (int i = 0; i < g->shapet.size; i++)
+    {
+        Shape* s = g->shapet.hash[i];
+        while (s)
+        {
+            Shape* next = s->next;
+            int h1 = lmod(s->hash, newsize);
+            s->next = newhash[h1];
+            newhash[h1] = s;
+            s = next;
+        }
+    }
+    luaM_freearray(L, g->shapet.hash, g->shapet.size, Shape*, 0);
+    g->shapet.hash = newhash;
+    g->shapet.size = newsize;
+}
+
+/*
+** returns the shape that adds `key' to `parent', creating it on first use
+*/
+static Shape* getshape(lua_State* L, Shape* parent, TString* key)
+{
+    global_State* g = L->global;
+    unsigned int h = shapehash(parent, key);
+    for (Shape* s = g->shapet.hash[lmod(h, g->shapet.size)]; s; s = s->next)
+    {
+        if (s->parent == parent && s->keys[parent->count] == key)
+        {
+            // the shape might be dead but not collected yet; the parent and the keys are alive, so it can be resurrected
+            if (isdead(g, obj2gco(s)))
+                changewhite(obj2gco(s));
+            return s;
+        }
+    }
+    if (g->shapet.nuse >= cast_to(uint32_t, g->shapet.size))
+        resizeshapes(L, g->shapet.size * 2); // too crowded
+    Shape* s = newshape(L, parent, key, h);
+    int h1 = lmod(h, g->shapet.size);
+    s->next = g->shapet.hash[h1];
+    g->shapet.hash[h1] = s;
+    g->shapet.nuse++;
+    return s;
+}
+
+void luaH_initshapes(lua_State* L)
+{
+    global_State* g = L->global;
+    resizeshapes(L, LUA_MINSTRTABSIZE);
+    g->rootshape = newshape(L, NULL, NULL, 0);
+    l_setbit(g->rootshape->marked, FIXEDBIT); // shapes of all tables lead to the root shape, so it's never collected
+}
+
+void luaH_freeshape(lua_State* L, Shape* s, lua_Page* page)
+{
+    // the root shape isn't in the transition table
+    if (s->parent)
+    {
+        global_State* g = L->global;
+        Shape** p = &g->shapet.hash[lmod(s->hash, g->shapet.size)];
+        while (*p != s)
+            p = &(*p)->next;
+        *p = s->next;
+        g->shapet.nuse--;
+    }
+    luaM_freegco(L, s, sizeshape(s->count), s->memcat, page);
+}
+
+static void setslots(lua_State* L, Table* t, Shape* shape, int size)
+{
+    TableSlots* ts = cast_to(TableSlots*, luaM_new_(L, sizeslots(size), t->memcat));
+    ts->shape = shape;
+    ts->size = size;
+    setnilvalue(&ts->nilkey);
+    ts->nilkey.next = 0;
+    for (int i = 0; i < size; i++)
+        setnilvalue(&ts->slots[i]);
+    t->node = cast_to(LuaNode*, ts);
+    t->shaped = 1;
+    t->lsizenode = 0;
+    t->nodemask8 = 0;
+    t->lastfree = 0;
+}
+
+/*
+** adds a slot for `key' to a table that has a shape; returns NULL if the table needs to switch to a node hash instead
+*/
+static TValue* newslot(lua_State* L, Table* t, TString* key)
+{
+    TableSlots* ts = tslots(t);
+    Shape* shape = ts->shape;
+    int count = shape->count;
+
+    if (count == LUAI_MAXSHAPEKEYS)
+        return NULL;
+
+    // the table had fields removed
+    for (int i = 0; i < count; i++)
+        if (ttisnil(&ts->slots[i]))
+            return NULL;
+
+    Shape* child = getshape(L, shape, key);
+
+    if (count == ts->size)
+    {
+        int size = count * 2 < LUAI_MAXSHAPEKEYS ? count * 2 : LUAI_MAXSHAPEKEYS;
+        ts = cast_to(TableSlots*, luaM_realloc_(L, ts, sizeslots(count), sizeslots(size), t->memcat));
+        ts->size = size;
+        for (int i = count; i < size; i++)
+            setnilvalue(&ts->slots[i]);
+        t->node = cast_to(LuaNode*, ts);
+    }
+
+    ts->shape = child;
+    luaC_objbarrier(L, t, child);
+    return &ts->slots[count];
+}
+
+/*
+** moves the fields of a table with a shape into a node hash
+*/
+void luaH_unshape(lua_State* L, Table* t)
+{
+    TableSlots* ts = tslots(t);
+    int nuse = 0;
+    for (int i = 0; i < ts->shape->count; i++)
+        if (!ttisnil(&ts->slots[i]))
+            nuse++;
+    setnodevector(L, t, nuse);
+    t->shaped = 0;
+    for (int i = 0; i < ts->shape->count; i++)
+    {
+        if (!ttisnil(&ts->slots[i]))
+        {
+            TValue k;
+            setsvalue(L, &k, ts->shape->keys[i]);
+            setobj2t(L, newkey(L, t, &k), &ts->slots[i]);
+        }
+    }
+    luaM_free_(L, ts, sizeslots(ts->size), t->memcat);
+}
+
+/*
+** }=============================================================
+*/
+
 /*
 ** returns the index of a `key' for table traversals. First goes all
 ** elements in the array part, then elements in the hash part. The
@@ -174,6 +390,14 @@ static int findindex(lua_State* L, Table* t, StkId key)
     i = ttisnumber(key) ? arrayindex(nvalue(key)) : -1;
     if (0 < i && i <= t->sizearray) // is `key' inside array part?
         return i - 1;               // yes; that's the index (corrected to C)
+    else if (t->shaped)
+    {
+        int slot = ttisstring(key) ? luaH_shapeslot(tslots(t)->shape, tsvalue(key)) : -1;
+        if (slot < 0)
+            luaG_runerror(L, "invalid key to 'next'"); // key not found
+        // slots are numbered after array elements
+        return slot + t->sizearray;
+    }
     else
     {
         LuaNode* n = mainposition(t, key);
@@ -199,13 +423,27 @@ int luaH_next(lua_State* L, Table* t, StkId key)
     int i = findindex(L, t, key); // find original element
     for (i++; i < t->sizearray; i++)
     { // try first array part
-        if (!ttisnil(&t->array[i]))
+        if (!arrayisnil(t, i))
         { // a non-nil value?
             setnvalue(key, cast_num(i + 1));
-            setobj2s(L, key + 1, &t->array[i]);
+            getarrayvalue(L, key + 1, t, i);
             return 1;
         }
     }
+    if (t->shaped)
+    { // then slots
+        TableSlots* ts = tslots(t);
+        for (i -= t->sizearray; i < ts->shape->count; i++)
+        {
+            if (!ttisnil(&ts->slots[i]))
+            {
+                setsvalue(L, key, ts->shape->keys[i]);
+                setobj2s(L, key + 1, &ts->slots[i]);
+                return 1;
+            }
+        }
+        return 0;
+    }
     for (i -= t->sizearray; i < sizenode(t); i++)
     { // then hash part
         if (!ttisnil(gval(gnode(t, i))))
@@ -289,7 +527,7 @@ static int numusearray(const Table* t, int* nums)
         // count elements in range (2^(lg-1), 2^lg]
         for (; i <= lim; i++)
         {
-            if (!ttisnil(&t->array[i - 1]))
+            if (!arrayisnil(t, i - 1))
                 lc++;
         }
         nums[lg] += lc;
@@ -302,6 +540,14 @@ static int numusehash(const Table* t, int* nums, int* pnasize)
 {
     int totaluse = 0; // total number of elements
     int ause = 0;     // summation of `nums'
+    if (t->shaped)
+    { // slots only have string keys
+        TableSlots* ts = tslots(t);
+        for (int i = 0; i < ts->shape->count; i++)
+            if (!ttisnil(&ts->slots[i]))
+                totaluse++;
+        return totaluse;
+    }
     int i = sizenode(t);
     while (i--)
     {
@@ -321,10 +567,21 @@ static void setarrayvector(lua_State* L, Table* t, int size)
 {
     if (size > MAXSIZE)
         luaG_runerror(L, "table overflow");
-    luaM_reallocarray(L, t->array, t->sizearray, size, TValue, t->memcat);
-    TValue* array = t->array;
-    for (int i = t->sizearray; i < size; i++)
-        setnilvalue(&array[i]);
+    if (t->numarray)
+    {
+        luaM_reallocarray(L, t->narray, t->sizearray, size, double, t->memcat);
+        double* array = t->narray;
+        double nil = luaH_numnil();
+        for (int i = t->sizearray; i < size; i++)
+            array[i] = nil;
+    }
+    else
+    {
+        luaM_reallocarray(L, t->array, t->sizearray, size, TValue, t->memcat);
+        TValue* array = t->array;
+        for (int i = t->sizearray; i < size; i++)
+            setnilvalue(&array[i]);
+    }
     t->sizearray = size;
 }
 
@@ -357,9 +614,11 @@ static void setnodevector(lua_State* L, Table* t, int size)
     t->lastfree = size; // all positions are free
 }
 
-static TValue* newkey(lua_State* L, Table* t, const TValue* key);
-
-static TValue* arrayornewkey(lua_State* L, Table* t, const TValue* key)
+/*
+** returns the zero-based index of `key' in the array part, or -1 if the key
+** doesn't belong to the array part
+*/
+static int arrayslot(const Table* t, const TValue* key)
 {
     if (ttisnumber(key))
     {
@@ -367,16 +626,64 @@ static TValue* arrayornewkey(lua_State* L, Table* t, const TValue* key)
         double n = nvalue(key);
         luai_num2int(k, n);
         if (luai_numeq(cast_num(k), n) && cast_to(unsigned int, k - 1) < cast_to(unsigned int, t->sizearray))
-            return &t->array[k - 1];
+            return k - 1;
+    }
+
+    return -1;
+}
+
+static TValue* arrayornewkey(lua_State* L, Table* t, const TValue* key)
+{
+    int index = arrayslot(t, key);
+    if (index >= 0)
+    {
+        // the caller may store any value into the slot
+        if (t->numarray)
+            luaH_unpackarray(L, t);
+        return &t->array[index];
     }
 
     return newkey(L, t, key);
 }
 
+/*
+** checks that all elements of the hash part that would move into an array
+** part of size `nasize' can be stored in a packed number array
+*/
+static bool packablehash(const Table* t, int nasize)
+{
+    for (int i = 0; i < sizenode(t); i++)
+    {
+        const LuaNode* n = gnode(t, i);
+        if (ttisnumber(gkey(n)) && !luaH_ispackable(gval(n)))
+        {
+            int k = arrayindex(nvalue(gkey(n)));
+            if (0 < k && k <= nasize)
+                return false;
+        }
+    }
+    return true;
+}
+
 static void resize(lua_State* L, Table* t, int nasize, int nhsize)
 {
     if (nasize > MAXSIZE || nhsize > MAXSIZE)
         luaG_runerror(L, "table overflow");
+    // slots of a table with a shape stay in place while the array part grows; elements of a shrinking array part need a node hash
+    if (t->shaped)
+    {
+        if (nasize >= t->sizearray)
+        {
+            if (nasize > t->sizearray)
+                setarrayvector(L, t, nasize);
+            t->lastfree = 0;
+            return;
+        }
+        luaH_unshape(L, t);
+    }
+    // elements that move from the hash part into a packed array part must be numbers
+    if (t->numarray && nasize > t->sizearray && !packablehash(t, nasize))
+        luaH_unpackarray(L, t);
     int oldasize = t->sizearray;
     int oldhsize = t->lsizenode;
     LuaNode* nold = t->node; // save old hash ...
@@ -392,15 +699,26 @@ static void resize(lua_State* L, Table* t, int nasize, int nhsize)
         // re-insert elements from vanishing slice
         for (int i = nasize; i < oldasize; i++)
         {
-            if (!ttisnil(&t->array[i]))
+            if (!arrayisnil(t, i))
             {
                 TValue ok;
                 setnvalue(&ok, cast_num(i + 1));
-                setobjt2t(L, newkey(L, t, &ok), &t->array[i]);
+                TValue* slot = newkey(L, t, &ok);
+                if (t->numarray)
+                {
+                    setnvalue(slot, t->narray[i]);
+                }
+                else
+                {
+                    setobjt2t(L, slot, &t->array[i]);
+                }
             }
         }
         // shrink array
-        luaM_reallocarray(L, t->array, oldasize, nasize, TValue, t->memcat);
+        if (t->numarray)
+            luaM_reallocarray(L, t->narray, oldasize, nasize, double, t->memcat);
+        else
+            luaM_reallocarray(L, t->array, oldasize, nasize, TValue, t->memcat);
     }
     // used for the migration check at the end
     TValue* anew = t->array;
@@ -412,7 +730,14 @@ static void resize(lua_State* L, Table* t, int nasize, int nhsize)
         {
             TValue ok;
             getnodekey(L, &ok, old);
-            setobjt2t(L, arrayornewkey(L, t, &ok), gval(old));
+            int index = t->numarray ? arrayslot(t, &ok) : -1;
+            if (index >= 0)
+            {
+                LUAU_ASSERT(ttisnumber(gval(old)));
+                t->narray[index] = nvalue(gval(old));
+            }
+            else
+                setobjt2t(L, arrayornewkey(L, t, &ok), gval(old));
         }
     }
 
@@ -424,12 +749,21 @@ static void resize(lua_State* L, Table* t, int nasize, int nhsize)
         luaM_freearray(L, nold, twoto(oldhsize), LuaNode, t->memcat); // free old array
 }
 
+static bool isnilnum(Table* t, int key)
+{
+    // (1 <= key && key <= t->sizearray)
+    if (cast_to(unsigned int, key - 1) < cast_to(unsigned int, t->sizearray))
+        return arrayisnil(t, key - 1);
+    else
+        return ttisnil(luaH_getnum(t, key));
+}
+
 static int adjustasize(Table* t, int size, const TValue* ek)
 {
-    bool tbound = t->node != dummynode || size < t->sizearray;
+    bool tbound = !nonumkeys(t) || size < t->sizearray;
     int ekindex = ek && ttisnumber(ek) ? arrayindex(nvalue(ek)) : -1;
     // move the array size up until the boundary is guaranteed to be inside the array part
-    while (size + 1 == ekindex || (tbound && !ttisnil(luaH_getnum(t, size + 1))))
+    while (size + 1 == ekindex || (tbound && !isnilnum(t, size + 1)))
         size++;
     return size;
 }
@@ -484,19 +818,29 @@ Table* luaH_new(lua_State* L, int narray, int nhash)
     t->readonly = 0;
     t->safeenv = 0;
     t->nodemask8 = 0;
+    // preallocated array parts are filled by table constructors which usually store values of other types
+    t->numarray = narray == 0;
+    t->shaped = 0;
     t->node = cast_to(LuaNode*, dummynode);
     if (narray > 0)
         setarrayvector(L, t, narray);
-    if (nhash > 0)
+    // preallocated hash parts usually receive string keys from table constructors
+    if (nhash > 0 && nhash <= LUAI_MAXSHAPEKEYS && FFlag::LuauTableShapes)
+        setslots(L, t, L->global->rootshape, nhash);
+    else if (nhash > 0)
         setnodevector(L, t, nhash);
     return t;
 }
 
 void luaH_free(lua_State* L, Table* t, lua_Page* page)
 {
-    if (t->node != dummynode)
+    if (t->shaped)
+        luaM_free_(L, t->node, sizeslots(tslots(t)->size), t->memcat);
+    else if (t->node != dummynode)
         luaM_freearray(L, t->node, sizenode(t), LuaNode, t->memcat);
-    if (t->array)
+    if (t->array && t->numarray)
+        luaM_freearray(L, t->narray, t->sizearray, double, t->memcat);
+    else if (t->array)
         luaM_freearray(L, t->array, t->sizearray, TValue, t->memcat);
     luaM_freegco(L, t, sizeof(Table), t->memcat, page);
 }
@@ -532,6 +876,21 @@ static TValue* newkey(lua_State* L, Table* t, const TValue* key)
         return arrayornewkey(L, t, key);
     }
 
+    if (t->shaped)
+    {
+        if (TValue* slot = ttisstring(key) ? newslot(L, t, tsvalue(key)) : NULL)
+            return slot;
+
+        luaH_unshape(L, t);
+    }
+
+    // string keys of empty hash parts start out in a shape
+    if (t->node == dummynode && ttisstring(key) && FFlag::LuauTableShapes)
+    {
+        setslots(L, t, L->global->rootshape, 1);
+        return newslot(L, t, tsvalue(key));
+    }
+
     LuaNode* mp = mainposition(t, key);
     if (!ttisnil(gval(mp)) || mp == dummynode)
     {
@@ -585,7 +944,10 @@ const TValue* luaH_getnum(Table* t, int key)
 {
     // (1 <= key && key <= t->sizearray)
     if (cast_to(unsigned int, key - 1) < cast_to(unsigned int, t->sizearray))
+    {
+        LUAU_ASSERT(!t->numarray);
         return &t->array[key - 1];
+    }
     else if (t->node != dummynode)
     {
         double nk = cast_num(key);
@@ -609,6 +971,13 @@ const TValue* luaH_getnum(Table* t, int key)
 */
 const TValue* luaH_getstr(Table* t, TString* key)
 {
+    if (t->shaped)
+    {
+        TableSlots* ts = tslots(t);
+        int slot = luaH_shapeslot(ts->shape, key);
+        return slot >= 0 ? &ts->slots[slot] : luaO_nilobject;
+    }
+
     LuaNode* n = hashstr(t, key);
     for (;;)
     { // check whether `key' is somewhere in the chain
@@ -657,8 +1026,39 @@ const TValue* luaH_get(Table* t, const TValue* key)
     }
 }
 
+/*
+** search functions that also support packed number arrays; their elements are loaded into `tmp'
+*/
+const TValue* luaH_getnumvalue(Table* t, int key, TValue* tmp)
+{
+    // (1 <= key && key <= t->sizearray)
+    if (t->numarray && cast_to(unsigned int, key - 1) < cast_to(unsigned int, t->sizearray))
+    {
+        setnumarrayvalue(tmp, t->narray[key - 1]);
+        return tmp;
+    }
+
+    return luaH_getnum(t, key);
+}
+
+const TValue* luaH_getvalue(Table* t, const TValue* key, TValue* tmp)
+{
+    int index = t->numarray ? arrayslot(t, key) : -1;
+    if (index >= 0)
+    {
+        setnumarrayvalue(tmp, t->narray[index]);
+        return tmp;
+    }
+
+    return luaH_get(t, key);
+}
+
 TValue* luaH_set(lua_State* L, Table* t, const TValue* key)
 {
+    // the caller may store any value into the slot
+    if (t->numarray && arrayslot(t, key) >= 0)
+        luaH_unpackarray(L, t);
+
     const TValue* p = luaH_get(t, key);
     invalidateTMcache(t);
     if (p != luaO_nilobject)
@@ -682,7 +1082,12 @@ TValue* luaH_setnum(lua_State* L, Table* t, int key)
 {
     // (1 <= key && key <= t->sizearray)
     if (cast_to(unsigned int, key - 1) < cast_to(unsigned int, t->sizearray))
+    {
+        // the caller may store any value into the slot
+        if (t->numarray)
+            luaH_unpackarray(L, t);
         return &t->array[key - 1];
+    }
     // hash fallback
     const TValue* p = luaH_getnum(t, key);
     if (p != luaO_nilobject)
@@ -695,6 +1100,60 @@ TValue* luaH_setnum(lua_State* L, Table* t, int key)
     }
 }
 
+/*
+** stores a number or nil into a table with a packed number array without
+** converting the array part; returns false if the generic path is needed
+*/
+bool luaH_setpacked(lua_State* L, Table* t, const TValue* key, const TValue* val)
+{
+    LUAU_ASSERT(t->numarray && ttisnumber(key));
+
+    if (!luaH_ispackable(val))
+        return false;
+
+    int k = arrayindex(nvalue(key));
+
+    // (1 <= k && k <= t->sizearray)
+    if (cast_to(unsigned int, k - 1) >= cast_to(unsigned int, t->sizearray))
+    {
+        // appends grow the array part the same way newkey does; all other keys outside of the array part take the generic path
+        if (k != t->sizearray + 1 || ttisnil(val) || !ttisnil(luaH_getnum(t, k)))
+            return false;
+
+        rehash(L, t, key); // grow table
+
+        // after rehash, the key might be in the hash part, and elements that migrated from the hash part might have required converting the array part
+        if (!t->numarray || cast_to(unsigned int, k - 1) >= cast_to(unsigned int, t->sizearray))
+        {
+            setnvalue(arrayornewkey(L, t, key), nvalue(val));
+            return true;
+        }
+    }
+
+    setnumarrayobj(t, k - 1, val);
+    return true;
+}
+
+void luaH_unpackarray(lua_State* L, Table* t)
+{
+    LUAU_ASSERT(t->numarray);
+
+    TValue* array = NULL;
+
+    if (t->sizearray)
+    {
+        array = luaM_newarray(L, t->sizearray, TValue, t->memcat);
+
+        for (int i = 0; i < t->sizearray; i++)
+            setnumarrayvalue(&array[i], t->narray[i]);
+
+        luaM_freearray(L, t->narray, t->sizearray, double, t->memcat);
+    }
+
+    t->array = array;
+    t->numarray = 0;
+}
+
 TValue* luaH_setstr(lua_State* L, Table* t, TString* key)
 {
     const TValue* p = luaH_getstr(t, key);
@@ -711,15 +1170,15 @@ TValue* luaH_setstr(lua_State* L, Table* t, TString* key)
 
 static int updateaboundary(Table* t, int boundary)
 {
-    if (boundary < t->sizearray && ttisnil(&t->array[boundary - 1]))
+    if (boundary < t->sizearray && arrayisnil(t, boundary - 1))
     {
-        if (boundary >= 2 && !ttisnil(&t->array[boundary - 2]))
+        if (boundary >= 2 && !arrayisnil(t, boundary - 2))
         {
             maybesetaboundary(t, boundary - 1);
             return boundary - 1;
         }
     }
-    else if (boundary + 1 < t->sizearray && !ttisnil(&t->array[boundary]) && ttisnil(&t->array[boundary + 1]))
+    else if (boundary + 1 < t->sizearray && !arrayisnil(t, boundary) && arrayisnil(t, boundary + 1))
     {
         maybesetaboundary(t, boundary + 1);
         return boundary + 1;
@@ -738,9 +1197,9 @@ int luaH_getn(Table* t)
 
     if (boundary > 0)
     {
-        if (!ttisnil(&t->array[t->sizearray - 1]) && t->node == dummynode)
+        if (!arrayisnil(t, t->sizearray - 1) && nonumkeys(t))
             return t->sizearray; // fast-path: the end of the array in `t' already refers to a boundary
-        if (boundary < t->sizearray && !ttisnil(&t->array[boundary - 1]) && ttisnil(&t->array[boundary]))
+        if (boundary < t->sizearray && !arrayisnil(t, boundary - 1) && arrayisnil(t, boundary))
             return boundary; // fast-path: boundary already refers to a boundary in `t'
 
         int foundboundary = updateaboundary(t, boundary);
@@ -750,25 +1209,25 @@ int luaH_getn(Table* t)
 
     int j = t->sizearray;
 
-    if (j > 0 && ttisnil(&t->array[j - 1]))
+    if (j > 0 && arrayisnil(t, j - 1))
     {
         // "branchless" binary search from Array Layouts for Comparison-Based Searching, Paul Khuong, Pat Morin, 2017.
         // note that clang is cmov-shy on cmovs around memory operands, so it will compile this to a branchy loop.
-        TValue* base = t->array;
+        int base = 0;
         int rest = j;
         while (int half = rest >> 1)
         {
-            base = ttisnil(&base[half]) ? base : base + half;
+            base = arrayisnil(t, base + half) ? base : base + half;
             rest -= half;
         }
-        int boundary = !ttisnil(base) + int(base - t->array);
+        int boundary = !arrayisnil(t, base) + base;
         maybesetaboundary(t, boundary);
         return boundary;
     }
     else
     {
         // validate boundary invariant
-        LUAU_ASSERT(t->node == dummynode || ttisnil(luaH_getnum(t, j + 1)));
+        LUAU_ASSERT(nonumkeys(t) || ttisnil(luaH_getnum(t, j + 1)));
         return j;
     }
 }
@@ -785,19 +1244,32 @@ Table* luaH_clone(lua_State* L, Table* tt)
     t->nodemask8 = 0;
     t->readonly = 0;
     t->safeenv = 0;
+    t->numarray = tt->numarray;
+    t->shaped = 0;
     t->node = cast_to(LuaNode*, dummynode);
     t->lastfree = 0;
 
     if (tt->sizearray)
     {
-        t->array = luaM_newarray(L, tt->sizearray, TValue, t->memcat);
+        if (t->numarray)
+            t->narray = luaM_newarray(L, tt->sizearray, double, t->memcat);
+        else
+            t->array = luaM_newarray(L, tt->sizearray, TValue, t->memcat);
         maybesetaboundary(t, getaboundary(tt));
         t->sizearray = tt->sizearray;
 
-        memcpy(t->array, tt->array, t->sizearray * sizeof(TValue));
+        memcpy(t->array, tt->array, arraybytes(t));
     }
 
-    if (tt->node != dummynode)
+    if (tt->shaped)
+    {
+        // the copy shares the shape
+        size_t size = sizeslots(tslots(tt)->size);
+        t->node = cast_to(LuaNode*, luaM_new_(L, size, t->memcat));
+        t->shaped = 1;
+        memcpy(t->node, tt->node, size);
+    }
+    else if (tt->node != dummynode)
     {
         int size = 1 << tt->lsizenode;
         t->node = luaM_newarray(L, size, LuaNode, t->memcat);
@@ -813,15 +1285,30 @@ Table* luaH_clone(lua_State* L, Table* tt)
 void luaH_clear(Table* tt)
 {
     // clear array part
-    for (int i = 0; i < tt->sizearray; ++i)
+    if (tt->numarray)
+    {
+        double nil = luaH_numnil();
+        for (int i = 0; i < tt->sizearray; ++i)
+            tt->narray[i] = nil;
+    }
+    else
     {
-        setnilvalue(&tt->array[i]);
+        for (int i = 0; i < tt->sizearray; ++i)
+        {
+            setnilvalue(&tt->array[i]);
+        }
     }
 
     maybesetaboundary(tt, 0);
 
-    // clear hash part
-    if (tt->node != dummynode)
+    // clear hash part; cleared slots switch the table to a node hash when it gets a new key
+    if (tt->shaped)
+    {
+        TableSlots* ts = tslots(tt);
+        for (int i = 0; i < ts->size; ++i)
+            setnilvalue(&ts->slots[i]);
+    }
+    else if (tt->node != dummynode)
     {
         int size = sizenode(tt);
         tt->lastfree = size;
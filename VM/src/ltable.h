@@ -4,23 +4,115 @@
 
 #include "lobject.h"
 
+#include <string.h>
+
 #define gnode(t, i) (&(t)->node[i])
 #define gkey(n) (&(n)->key)
 #define gval(n) (&(n)->val)
 #define gnext(n) ((n)->key.next)
 
-#define gval2slot(t, v) int(cast_to(LuaNode*, static_cast<const TValue*>(v)) - t->node)
+#define gval2slot(t, v) \
+    ((t)->shaped ? int(static_cast<const TValue*>(v) - tslots(t)->slots) : int(cast_to(LuaNode*, static_cast<const TValue*>(v)) - (t)->node))
+
+#define tslots(t) check_exp((t)->shaped, cast_to(TableSlots*, (t)->node))
+
+#define sizeshape(n) (offsetof(Shape, keys) + sizeof(TString*) * (n))
+#define sizeslots(n) (offsetof(TableSlots, slots) + sizeof(TValue) * (n))
+
+#define hashbytes(t) ((t)->shaped ? sizeslots(tslots(t)->size) : (t)->node == &luaH_dummynode ? 0 : sizeof(LuaNode) * sizenode(t))
 
 // reset cache of absent metamethods, cache is updated in luaT_gettm
 #define invalidateTMcache(t) t->tmcache = 0
 
+// nil elements of packed number arrays are stored as a NaN with a payload that arithmetic never produces
+#define NUMARRAY_NIL 0x7ff8deadbeef0001ull
+
+inline bool luaH_isnumnil(double v)
+{
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits == NUMARRAY_NIL;
+}
+
+inline double luaH_numnil()
+{
+    uint64_t bits = NUMARRAY_NIL;
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+// values that can be stored in a packed number array
+#define luaH_ispackable(o) (ttisnumber(o) ? !luaH_isnumnil(nvalue(o)) : ttisnil(o))
+
+#define arrayisnil(t, i) ((t)->numarray ? luaH_isnumnil((t)->narray[i]) : ttisnil(&(t)->array[i]))
+
+#define arraybytes(t) (size_t((t)->sizearray) * ((t)->numarray ? sizeof(double) : sizeof(TValue)))
+
+// load an element of a packed number array
+#define setnumarrayvalue(obj, v) \
+    { \
+        double v_ = (v); \
+        if (luaH_isnumnil(v_)) \
+            setnilvalue(obj); \
+        else \
+            setnvalue(obj, v_); \
+    }
+
+// store a value that passes luaH_ispackable into an element of a packed number array
+#define setnumarrayobj(t, i, obj) ((t)->narray[i] = ttisnil(obj) ? luaH_numnil() : nvalue(obj))
+
+// load an element of the array part in either representation
+#define getarrayvalue(L, obj, t, i) \
+    { \
+        if ((t)->numarray) \
+            setnumarrayvalue(obj, (t)->narray[i]) \
+        else \
+            setobj2s(L, obj, &(t)->array[i]); \
+    }
+
+// slot of the key in tables with the shape, or -1 when the shape doesn't have the key
+inline int luaH_shapeslot(const Shape* s, TString* key)
+{
+    for (int i = 0; i < s->count; i++)
+        if (s->keys[i] == key)
+            return i;
+    return -1;
+}
+
+// value at the slot of a table recorded by an inline cache, when the slot still holds the key
+inline TValue* luaH_getslot(Table* t, int slot, TString* key)
+{
+    if (t->shaped)
+    {
+        TableSlots* ts = tslots(t);
+
+        if (unsigned(slot) < ts->shape->count && ts->shape->keys[slot] == key)
+            return &ts->slots[slot];
+
+        return NULL;
+    }
+
+    LuaNode* n = gnode(t, slot & (sizenode(t) - 1));
+
+    // note: GCObject is incomplete here, so the key is compared as a pointer
+    if (ttisstring(gkey(n)) && gcvalue(gkey(n)) == cast_to(GCObject*, key))
+        return gval(n);
+
+    return NULL;
+}
+
 LUAI_FUNC const TValue* luaH_getnum(Table* t, int key);
 LUAI_FUNC TValue* luaH_setnum(lua_State* L, Table* t, int key);
 LUAI_FUNC const TValue* luaH_getstr(Table* t, TString* key);
 LUAI_FUNC TValue* luaH_setstr(lua_State* L, Table* t, TString* key);
 LUAI_FUNC const TValue* luaH_get(Table* t, const TValue* key);
+LUAI_FUNC const TValue* luaH_getvalue(Table* t, const TValue* key, TValue* tmp);
+LUAI_FUNC const TValue* luaH_getnumvalue(Table* t, int key, TValue* tmp);
 LUAI_FUNC TValue* luaH_set(lua_State* L, Table* t, const TValue* key);
 LUAI_FUNC TValue* luaH_newkey(lua_State* L, Table* t, const TValue* key);
+LUAI_FUNC bool luaH_setpacked(lua_State* L, Table* t, const TValue* key, const TValue* val);
+LUAI_FUNC void luaH_unpackarray(lua_State* L, Table* t);
 LUAI_FUNC Table* luaH_new(lua_State* L, int narray, int lnhash);
 LUAI_FUNC void luaH_resizearray(lua_State* L, Table* t, int nasize);
 LUAI_FUNC void luaH_resizehash(lua_State* L, Table* t, int nhsize);
@@ -29,6 +121,9 @@ LUAI_FUNC int luaH_next(lua_State* L, Table* t, StkId key);
 LUAI_FUNC int luaH_getn(Table* t);
 LUAI_FUNC Table* luaH_clone(lua_State* L, Table* tt);
 LUAI_FUNC void luaH_clear(Table* tt);
+LUAI_FUNC void luaH_unshape(lua_State* L, Table* t);
+LUAI_FUNC void luaH_initshapes(lua_State* L);
+LUAI_FUNC void luaH_freeshape(lua_State* L, Shape* s, struct lua_Page* page);
 
 #define luaH_setslot(L, t, slot, key) (invalidateTMcache(t), (slot == luaO_nilobject ? luaH_newkey(L, t, key) : cast_to(TValue*, slot)))
 
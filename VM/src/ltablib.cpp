@@ -83,10 +83,17 @@ static void moveelements(lua_State* L, int srct, int dstt, int f, int e, int t)
 
     int n = e - f + 1; // number of elements to move
 
-    if (cast_to(unsigned int, f - 1) < cast_to(unsigned int, src->sizearray) &&
-        cast_to(unsigned int, t - 1) < cast_to(unsigned int, dst->sizearray) &&
-        cast_to(unsigned int, f - 1 + n) <= cast_to(unsigned int, src->sizearray) &&
-        cast_to(unsigned int, t - 1 + n) <= cast_to(unsigned int, dst->sizearray))
+    bool inarray = cast_to(unsigned int, f - 1) < cast_to(unsigned int, src->sizearray) &&
+                   cast_to(unsigned int, t - 1) < cast_to(unsigned int, dst->sizearray) &&
+                   cast_to(unsigned int, f - 1 + n) <= cast_to(unsigned int, src->sizearray) &&
+                   cast_to(unsigned int, t - 1 + n) <= cast_to(unsigned int, dst->sizearray);
+
+    if (inarray && src->numarray && dst->numarray)
+    {
+        // packed number arrays don't need a barrier, and memmove handles overlapping ranges
+        memmove(&dst->narray[t - 1], &src->narray[f - 1], n * sizeof(double));
+    }
+    else if (inarray && !src->numarray && !dst->numarray)
     {
         TValue* srcarray = src->array;
         TValue* dstarray = dst->array;
@@ -282,8 +289,16 @@ static int tunpack(lua_State* L)
     // fast-path: direct array-to-stack copy
     if (i == 1 && int(n) <= t->sizearray)
     {
-        for (i = 0; i < int(n); i++)
-            setobj2s(L, L->top + i, &t->array[i]);
+        if (t->numarray)
+        {
+            for (i = 0; i < int(n); i++)
+                setnumarrayvalue(L->top + i, t->narray[i]);
+        }
+        else
+        {
+            for (i = 0; i < int(n); i++)
+                setobj2s(L, L->top + i, &t->array[i]);
+        }
         L->top += n;
     }
     else
@@ -427,7 +442,20 @@ static int tcreate(lua_State* L)
     if (size < 0)
         luaL_argerror(L, 1, "size out of range");
 
-    if (!lua_isnoneornil(L, 2))
+    if (!lua_isnoneornil(L, 2) && luaH_ispackable(L->base + 1))
+    {
+        // tables that start out filled with a number get a packed number array
+        lua_createtable(L, 0, 0);
+        Table* t = hvalue(L->top - 1);
+
+        luaH_resizearray(L, t, size);
+
+        double v = nvalue(L->base + 1);
+
+        for (int i = 0; i < size; ++i)
+            t->narray[i] = v;
+    }
+    else if (!lua_isnoneornil(L, 2))
     {
         lua_createtable(L, size, 0);
         Table* t = hvalue(L->top - 1);
@@ -461,7 +489,8 @@ static int tfind(lua_State* L)
 
     for (int i = init;; ++i)
     {
-        const TValue* e = luaH_getnum(t, i);
+        TValue tmp;
+        const TValue* e = luaH_getnumvalue(t, i, &tmp);
         if (ttisnil(e))
             break;
 
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "lobject.h"
+#include "lstate.h"
+#include "ltable.h"
+#include "lgc.h"
 #include "ltm.h"
 
 #define tostring(L, o) ((ttype(o) == LUA_TSTRING) || (luaV_tostring(L, o)))
@@ -23,7 +26,125 @@ LUAI_FUNC int luaV_tostring(lua_State* L, StkId obj);
 LUAI_FUNC void luaV_gettable(lua_State* L, const TValue* t, TValue* key, StkId val);
 LUAI_FUNC void luaV_settable(lua_State* L, const TValue* t, TValue* key, StkId val);
 LUAI_FUNC void luaV_concat(lua_State* L, int total, int last);
+LUAI_FUNC void luaV_concatacc(lua_State* L, int a, int b, int c, int acc);
+LUAI_FUNC void luaV_flushacc(lua_State* L, int a, int acc);
 LUAI_FUNC void luaV_getimport(lua_State* L, Table* env, TValue* k, uint32_t id, bool propagatenil);
+LUAI_FUNC const TValue* luaV_icfill(lua_State* L, Proto* p, LuaInlineCache* ic, Table* h, Table* mt, TString* key);
+
+// bytecode of a chunk loaded with luau_loadlazy; functions that haven't been decoded yet keep a reference to it
+struct LazyChunk
+{
+    int refs;          // number of functions that refer to the chunk
+    uint8_t memcat;    // memory category of the allocation
+    uint8_t version;   // bytecode version
+    uint32_t* strings; // offset of each string table entry in data
+    unsigned int stringcount;
+    char* data;
+    size_t size;
+};
+
+LUAI_FUNC void luaV_materialize(lua_State* L, Proto* p, Table* env, bool recursive);
+LUAI_FUNC LazyChunk* luaV_clonechunk(lua_State* L, const LazyChunk* chunk);
+LUAI_FUNC void luaV_releasechunk(lua_State* L, LazyChunk* chunk);
+
+LUAI_FUNC void luaV_loaddebuginfo(lua_State* L, Proto* p);
+
+// requests the debug info sidecar of the function if it's missing line info and local names
+#define luaV_checkdebuginfo(L, p) ((p)->debughash ? luaV_loaddebuginfo(L, p) : (void)0)
+
+// inline cache of the table access instruction at pc
+#define luaV_ic(p, pc) (&(p)->ic[((pc) - (p)->code) & ((p)->sizeic - 1)])
+
+// value of the key in the table, when it's at a slot that 8-bit slot predictions of instructions can't encode or the table has the cached shape
+inline TValue* luaV_icslot(const LuaInlineCache* ic, Table* h, TString* key)
+{
+    if (ic->metatable)
+        return NULL;
+
+    if (h->shaped)
+    {
+        TableSlots* ts = tslots(h);
+
+        // note: instructions can share inline caches, so the key needs to be checked as well
+        if (ts->shape == ic->shape && ts->shape->keys[ic->slot] == key && !ttisnil(&ts->slots[ic->slot]))
+            return &ts->slots[ic->slot];
+
+        return NULL;
+    }
+
+    LuaNode* n = gnode(h, ic->slot & (sizenode(h) - 1));
+
+    if (ttisstring(gkey(n)) && tsvalue(gkey(n)) == key && !ttisnil(gval(n)))
+        return gval(n);
+
+    return NULL;
+}
+
+// value of the key in the __index table of the metatable, when both are the ones recorded by the inline cache
+inline const TValue* luaV_icindex(lua_State* L, const LuaInlineCache* ic, Table* mt, TString* key)
+{
+    if (mt != ic->metatable || !mt)
+        return NULL;
+
+    const TValue* index = luaH_getslot(mt, ic->mtslot, L->global->tmname[TM_INDEX]);
+
+    if (!index || !ttistable(index) || hvalue(index) != ic->holder)
+        return NULL;
+
+    const TValue* res = luaH_getslot(ic->holder, ic->slot, key);
+
+    if (res && !ttisnil(res))
+        return res;
+
+    return NULL;
+}
+
+// value of the key in the table, using the inline cache; the key can only come from __index when the table doesn't have it
+inline const TValue* luaV_icget(lua_State* L, const LuaInlineCache* ic, Table* h, TString* key)
+{
+    if (TValue* v = luaV_icslot(ic, h, key))
+        return v;
+
+    if (h->metatable != ic->metatable || !h->metatable)
+        return NULL;
+
+    if (h->shaped)
+    {
+        // the key is absent iff the shape doesn't have it or its slot is nil
+        TableSlots* ts = tslots(h);
+        int slot = luaH_shapeslot(ts->shape, key);
+
+        if (slot >= 0 && !ttisnil(&ts->slots[slot]))
+            return NULL;
+    }
+    else
+    {
+        // the key is absent iff the chain from its main position is a single node that doesn't hold it
+        LuaNode* n = gnode(h, key->hash & (sizenode(h) - 1));
+
+        if (gnext(n) != 0 || (ttisstring(gkey(n)) && tsvalue(gkey(n)) == key && !ttisnil(gval(n))))
+            return NULL;
+    }
+
+    return luaV_icindex(L, ic, h->metatable, key);
+}
+
+// records a slot that 8-bit slot predictions can't encode, or the slot of a table with a shape
+inline void luaV_icsetslot(lua_State* L, Proto* p, LuaInlineCache* ic, Table* h, int slot)
+{
+    if (h->shaped || slot > 255)
+    {
+        ic->slot = slot;
+        ic->mtslot = 0;
+        ic->metatable = NULL;
+        ic->holder = NULL;
+        ic->shape = h->shaped ? tslots(h)->shape : NULL;
+
+        // entries are weak, but a proto that was traversed before it got its caches isn't rescanned until the next cycle
+        if (ic->shape)
+            luaC_objbarrier(L, p, ic->shape);
+    }
+}
 
 LUAI_FUNC void luau_execute(lua_State* L);
 LUAI_FUNC int luau_precall(lua_State* L, struct lua_TValue* func, int nresults);
@@ -63,8 +63,11 @@
 #define VM_KV(i) (LUAU_ASSERT(unsigned(i) < unsigned(cl->l.p->sizek)), &k[i])
 #define VM_UV(i) (LUAU_ASSERT(unsigned(i) < unsigned(cl->nupvalues)), &cl->l.uprefs[i])
 
-#define VM_PATCH_C(pc, slot) *const_cast<Instruction*>(pc) = ((uint8_t(slot) << 24) | (0x00ffffffu & *(pc)))
-#define VM_PATCH_E(pc, slot) *const_cast<Instruction*>(pc) = ((uint32_t(slot) << 8) | (0x000000ffu & *(pc)))
+// note: code shared with a bytecode image is read-only, so it keeps the slot predictions from the compiler
+#define VM_PATCH_C(pc, slot) \
+    (cl->l.p->sharedcode ? void() : void(*const_cast<Instruction*>(pc) = ((uint8_t(slot) << 24) | (0x00ffffffu & *(pc)))))
+#define VM_PATCH_E(pc, slot) \
+    (cl->l.p->sharedcode ? void() : void(*const_cast<Instruction*>(pc) = ((uint32_t(slot) << 8) | (0x000000ffu & *(pc)))))
 
 #define VM_INTERRUPT() \
     { \
@@ -103,7 +106,10 @@
         VM_DISPATCH_OP(LOP_LOADKX), VM_DISPATCH_OP(LOP_JUMPX), VM_DISPATCH_OP(LOP_FASTCALL), VM_DISPATCH_OP(LOP_COVERAGE), \
         VM_DISPATCH_OP(LOP_CAPTURE), VM_DISPATCH_OP(LOP_DEP_JUMPIFEQK), VM_DISPATCH_OP(LOP_DEP_JUMPIFNOTEQK), VM_DISPATCH_OP(LOP_FASTCALL1), \
         VM_DISPATCH_OP(LOP_FASTCALL2), VM_DISPATCH_OP(LOP_FASTCALL2K), VM_DISPATCH_OP(LOP_FORGPREP), VM_DISPATCH_OP(LOP_JUMPXEQKNIL), \
-        VM_DISPATCH_OP(LOP_JUMPXEQKB), VM_DISPATCH_OP(LOP_JUMPXEQKN), VM_DISPATCH_OP(LOP_JUMPXEQKS),
+        VM_DISPATCH_OP(LOP_JUMPXEQKB), VM_DISPATCH_OP(LOP_JUMPXEQKN), VM_DISPATCH_OP(LOP_JUMPXEQKS), VM_DISPATCH_OP(LOP_MOVE_MOVE), \
+        VM_DISPATCH_OP(LOP_MOVE_CALL), VM_DISPATCH_OP(LOP_GETUPVAL_CALL), VM_DISPATCH_OP(LOP_GETTABLE_GETTABLE), VM_DISPATCH_OP(LOP_GETTABLE_ADD), \
+        VM_DISPATCH_OP(LOP_ADDK_GETTABLE), VM_DISPATCH_OP(LOP_MUL_ADD), VM_DISPATCH_OP(LOP_CONCATACC), \
+        VM_DISPATCH_OP(LOP_FLUSHACC),
 
 #if defined(__GNUC__) || defined(__clang__)
 #define VM_USE_CGOTO 1
@@ -121,7 +127,11 @@
  */
 #if VM_USE_CGOTO
 #define VM_CASE(op) CASE_##op:
+#ifdef LUAI_OPSTATS
+#define VM_NEXT() goto dispatch
+#else
 #define VM_NEXT() goto*(SingleStep ? &&dispatch : kDispatchTable[LUAU_INSN_OP(*pc)])
+#endif
 #define VM_CONTINUE(op) goto* kDispatchTable[uint8_t(op)]
 #else
 #define VM_CASE(op) case op:
@@ -131,6 +141,16 @@
     goto dispatchContinue
 #endif
 
+/**
+ * VM_NEXT_FUSED(op) is used by fused instructions to run the next instruction, which is known to be op (or a fused instruction that starts with
+ * op), without looking it up in the dispatch table. Single-step mode and opcode statistics need every instruction to go through dispatch.
+ */
+#if VM_USE_CGOTO && !defined(LUAI_OPSTATS)
+#define VM_NEXT_FUSED(op) goto*(SingleStep ? &&dispatch : &&CASE_##op)
+#else
+#define VM_NEXT_FUSED(op) VM_NEXT()
+#endif
+
 LUAU_NOINLINE static void luau_prepareFORN(lua_State* L, StkId plimit, StkId pstep, StkId pinit)
 {
     if (!ttisnumber(pinit) && !luaV_tonumber(pinit, pinit))
@@ -234,6 +254,9 @@ LUAU_NOINLINE void luau_callhook(lua_State* L, lua_Hook hook, void* userdata)
 
     Closure* cl = clvalue(L->ci->func);
 
+    if (!cl->isC)
+        luaV_checkdebuginfo(L, cl->l.p);
+
     lua_Debug ar;
     ar.currentline = cl->isC ? -1 : luaG_getline(cl->l.p, pcRel(L->ci->savedpc, cl->l.p));
     ar.userdata = userdata;
@@ -280,6 +303,11 @@ static void luau_execute(lua_State* L)
     TValue* k;
     const Instruction* pc;
 
+#ifdef LUAI_OPSTATS
+    // opcode pairs are only recorded within a single interpreter invocation
+    int lastop = -1;
+#endif
+
     LUAU_ASSERT(isLua(L->ci));
     LUAU_ASSERT(L->isactive);
     LUAU_ASSERT(!isblack(obj2gco(L))); // we don't use luaC_threadbarrier because active threads never turn black
@@ -289,6 +317,18 @@ static void luau_execute(lua_State* L)
     base = L->base;
     k = cl->l.p->k;
 
+#if LUA_CUSTOM_EXECUTION
+    // when the function is entered from the start, custom execution callbacks can run it up to a point where the interpreter takes over
+    if (!SingleStep && cl->l.p->execdata && pc == cl->l.p->code)
+    {
+        if (L->global->ecb.enter(L, cl->l.p) == 1)
+        {
+            pc = L->ci->savedpc;
+            base = L->base;
+        }
+    }
+#endif
+
     VM_NEXT(); // starts the interpreter "loop"
 
     {
@@ -298,6 +338,14 @@ static void luau_execute(lua_State* L)
         LUAU_ASSERT(base == L->base && L->base == L->ci->base);
         LUAU_ASSERT(base <= L->top && L->top <= L->stack + L->stacksize);
 
+        // ... except for opcode statistics, which force every instruction to be dispatched here
+#ifdef LUAI_OPSTATS
+        if (lastop >= 0)
+            L->global->opstats[lastop][LUAU_INSN_OP(*pc)]++;
+
+        lastop = LUAU_INSN_OP(*pc);
+#endif
+
         // ... and singlestep logic :)
         if (SingleStep)
         {
@@ -315,6 +363,10 @@ static void luau_execute(lua_State* L)
 #endif
         }
 
+#if VM_USE_CGOTO && defined(LUAI_OPSTATS)
+        VM_CONTINUE(LUAU_INSN_OP(*pc));
+#endif
+
 #if !VM_USE_CGOTO
         size_t dispatchOp = LUAU_INSN_OP(*pc);
 
@@ -524,6 +576,12 @@ static void luau_execute(lua_State* L)
                         setobj2s(L, ra, gval(n));
                         VM_NEXT();
                     }
+                    // fast-path: value is in the slot recorded by the inline cache, or in the __index table of the cached metatable
+                    else if (const TValue* res = luaV_icget(L, luaV_ic(cl->l.p, pc - 2), h, tsvalue(kv)))
+                    {
+                        setobj2s(L, ra, res);
+                        VM_NEXT();
+                    }
                     else if (!h->metatable)
                     {
                         // fast-path: value is not in expected slot, but the table lookup doesn't involve metatable
@@ -534,11 +592,18 @@ static void luau_execute(lua_State* L)
                             int cachedslot = gval2slot(h, res);
                             // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
                             VM_PATCH_C(pc - 2, cachedslot);
+                            luaV_icsetslot(L, cl->l.p, luaV_ic(cl->l.p, pc - 2), h, cachedslot);
                         }
 
                         setobj2s(L, ra, res);
                         VM_NEXT();
                     }
+                    // fast-path: value is in the __index table of the metatable, which the inline cache remembers for future lookups
+                    else if (const TValue* res = luaV_icfill(L, cl->l.p, luaV_ic(cl->l.p, pc - 2), h, h->metatable, tsvalue(kv)))
+                    {
+                        setobj2s(L, ra, res);
+                        VM_NEXT();
+                    }
                     else
                     {
                         // slow-path, may invoke Lua calls via __index metamethod
@@ -642,6 +707,13 @@ static void luau_execute(lua_State* L)
                         luaC_barriert(L, h, ra);
                         VM_NEXT();
                     }
+                    // fast-path: value is in the slot recorded by the inline cache
+                    else if (TValue* icv = luaV_icslot(luaV_ic(cl->l.p, pc - 2), h, tsvalue(kv)); icv && !h->readonly)
+                    {
+                        setobj2t(L, icv, ra);
+                        luaC_barriert(L, h, ra);
+                        VM_NEXT();
+                    }
                     else if (fastnotm(h->metatable, TM_NEWINDEX) && !h->readonly)
                     {
                         VM_PROTECT_PC(); // set may fail
@@ -650,6 +722,7 @@ static void luau_execute(lua_State* L)
                         int cachedslot = gval2slot(h, res);
                         // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
                         VM_PATCH_C(pc - 2, cachedslot);
+                        luaV_icsetslot(L, cl->l.p, luaV_ic(cl->l.p, pc - 2), h, cachedslot);
                         setobj2t(L, res, ra);
                         luaC_barriert(L, h, ra);
                         VM_NEXT();
@@ -712,7 +785,7 @@ static void luau_execute(lua_State* L)
                     // index has to be an exact integer and in-bounds for the array portion
                     if (LUAU_LIKELY(unsigned(index - 1) < unsigned(h->sizearray) && !h->metatable && double(index) == indexd))
                     {
-                        setobj2s(L, ra, &h->array[unsigned(index - 1)]);
+                        getarrayvalue(L, ra, h, unsigned(index - 1));
                         VM_NEXT();
                     }
 
@@ -742,9 +815,17 @@ static void luau_execute(lua_State* L)
                     // index has to be an exact integer and in-bounds for the array portion
                     if (LUAU_LIKELY(unsigned(index - 1) < unsigned(h->sizearray) && !h->metatable && !h->readonly && double(index) == indexd))
                     {
-                        setobj2t(L, &h->array[unsigned(index - 1)], ra);
-                        luaC_barriert(L, h, ra);
-                        VM_NEXT();
+                        if (LUAU_LIKELY(!h->numarray))
+                        {
+                            setobj2t(L, &h->array[unsigned(index - 1)], ra);
+                            luaC_barriert(L, h, ra);
+                            VM_NEXT();
+                        }
+                        else if (luaH_ispackable(ra))
+                        {
+                            setnumarrayobj(h, unsigned(index - 1), ra);
+                            VM_NEXT();
+                        }
                     }
 
                     // fall through to slow path
@@ -769,7 +850,7 @@ static void luau_execute(lua_State* L)
 
                     if (LUAU_LIKELY(unsigned(c) < unsigned(h->sizearray) && !h->metatable))
                     {
-                        setobj2s(L, ra, &h->array[c]);
+                        getarrayvalue(L, ra, h, c);
                         VM_NEXT();
                     }
 
@@ -797,9 +878,17 @@ static void luau_execute(lua_State* L)
 
                     if (LUAU_LIKELY(unsigned(c) < unsigned(h->sizearray) && !h->metatable && !h->readonly))
                     {
-                        setobj2t(L, &h->array[c], ra);
-                        luaC_barriert(L, h, ra);
-                        VM_NEXT();
+                        if (LUAU_LIKELY(!h->numarray))
+                        {
+                            setobj2t(L, &h->array[c], ra);
+                            luaC_barriert(L, h, ra);
+                            VM_NEXT();
+                        }
+                        else if (luaH_ispackable(ra))
+                        {
+                            setnumarrayobj(h, c, ra);
+                            VM_NEXT();
+                        }
                     }
 
                     // fall through to slow path
@@ -868,8 +957,8 @@ static void luau_execute(lua_State* L)
                     // for predictive lookups
                     LuaNode* n = &h->node[tsvalue(kv)->hash & (sizenode(h) - 1)];
 
-                    const TValue* mt = 0;
-                    const LuaNode* mtn = 0;
+                    LuaInlineCache* ic = luaV_ic(cl->l.p, pc - 2);
+                    const TValue* res = 0;
 
                     // fast-path: key is in the table in expected slot
                     if (ttisstring(gkey(n)) && tsvalue(gkey(n)) == tsvalue(kv) && !ttisnil(gval(n)))
@@ -878,14 +967,22 @@ static void luau_execute(lua_State* L)
                         setobj2s(L, ra + 1, rb);
                         setobj2s(L, ra, gval(n));
                     }
-                    // fast-path: key is absent from the base, table has an __index table, and it has the result in the expected slot
-                    else if (gnext(n) == 0 && (mt = fasttm(L, hvalue(rb)->metatable, TM_INDEX)) && ttistable(mt) &&
-                             (mtn = &hvalue(mt)->node[LUAU_INSN_C(insn) & hvalue(mt)->nodemask8]) && ttisstring(gkey(mtn)) &&
-                             tsvalue(gkey(mtn)) == tsvalue(kv) && !ttisnil(gval(mtn)))
+                    // fast-path: key is absent from the base, and the inline cache has the __index table of its metatable
+                    // if the cache doesn't match, it's updated when the key is in the __index table of the metatable
+                    else if ((res = luaV_icget(L, ic, h, tsvalue(kv))) || (res = luaV_icfill(L, cl->l.p, ic, h, h->metatable, tsvalue(kv))))
                     {
                         // note: order of copies allows rb to alias ra+1 or ra
                         setobj2s(L, ra + 1, rb);
-                        setobj2s(L, ra, gval(mtn));
+                        setobj2s(L, ra, res);
+                    }
+                    // fast-path: the table lookup doesn't involve metatable; the inline cache remembers slots of tables with a shape
+                    else if (!h->metatable && !ttisnil(res = luaH_getstr(h, tsvalue(kv))))
+                    {
+                        luaV_icsetslot(L, cl->l.p, ic, h, gval2slot(h, res));
+
+                        // note: order of copies allows rb to alias ra+1 or ra
+                        setobj2s(L, ra + 1, rb);
+                        setobj2s(L, ra, res);
                     }
                     else
                     {
@@ -904,7 +1001,9 @@ static void luau_execute(lua_State* L)
                 else
                 {
                     Table* mt = ttisuserdata(rb) ? uvalue(rb)->metatable : L->global->mt[ttype(rb)];
-                    const TValue* tmi = 0;
+
+                    LuaInlineCache* ic = luaV_ic(cl->l.p, pc - 2);
+                    const TValue* res = 0;
 
                     // fast-path: metatable with __namecall
                     if (const TValue* fn = fasttm(L, mt, TM_NAMECALL))
@@ -915,36 +1014,16 @@ static void luau_execute(lua_State* L)
 
                         L->namecall = tsvalue(kv);
                     }
-                    else if ((tmi = fasttm(L, mt, TM_INDEX)) && ttistable(tmi))
+                    // fast-path: metatable with __index table that has the method, recorded by the inline cache
+                    else if ((res = luaV_icindex(L, ic, mt, tsvalue(kv))) || (res = luaV_icfill(L, cl->l.p, ic, NULL, mt, tsvalue(kv))))
                     {
-                        Table* h = hvalue(tmi);
-                        int slot = LUAU_INSN_C(insn) & h->nodemask8;
-                        LuaNode* n = &h->node[slot];
-
-                        // fast-path: metatable with __index that has method in expected slot
-                        if (LUAU_LIKELY(ttisstring(gkey(n)) && tsvalue(gkey(n)) == tsvalue(kv) && !ttisnil(gval(n))))
-                        {
-                            // note: order of copies allows rb to alias ra+1 or ra
-                            setobj2s(L, ra + 1, rb);
-                            setobj2s(L, ra, gval(n));
-                        }
-                        else
-                        {
-                            // slow-path: handles slot mismatch
-                            setobj2s(L, ra + 1, rb);
-                            L->cachedslot = slot;
-                            VM_PROTECT(luaV_gettable(L, rb, kv, ra));
-                            // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
-                            VM_PATCH_C(pc - 2, L->cachedslot);
-                            // recompute ra since stack might have been reallocated
-                            ra = VM_REG(LUAU_INSN_A(insn));
-                            if (ttisnil(ra))
-                                luaG_methoderror(L, ra + 1, tsvalue(kv));
-                        }
+                        // note: order of copies allows rb to alias ra+1 or ra
+                        setobj2s(L, ra + 1, rb);
+                        setobj2s(L, ra, res);
                     }
                     else
                     {
-                        // slow-path: handles non-table __index
+                        // slow-path: handles non-table __index and methods that aren't in the __index table
                         setobj2s(L, ra + 1, rb);
                         VM_PROTECT(luaV_gettable(L, rb, kv, ra));
                         // recompute ra since stack might have been reallocated
@@ -980,6 +1059,17 @@ static void luau_execute(lua_State* L)
                 Closure* ccl = clvalue(ra);
                 L->ci->savedpc = pc;
 
+                // functions loaded with luau_loadlazy are decoded on first call; this can reallocate the stack
+                if (LUAU_UNLIKELY(!ccl->isC && ccl->l.p->lazy))
+                {
+                    ptrdiff_t rasave = savestack(L, ra);
+                    ptrdiff_t argtopsave = savestack(L, argtop);
+                    L->top = argtop;
+                    VM_PROTECT(luaV_materialize(L, ccl->l.p, ccl->env, /* recursive= */ false));
+                    ra = restorestack(L, rasave);
+                    argtop = restorestack(L, argtopsave);
+                }
+
                 CallInfo* ci = incr_ci(L);
                 ci->func = ra;
                 ci->base = ra + 1;
@@ -1014,6 +1104,20 @@ static void luau_execute(lua_State* L)
                     cl = ccl;
                     base = L->base;
                     k = p->k;
+
+#if LUA_CUSTOM_EXECUTION
+                    if (!SingleStep && p->execdata)
+                    {
+                        L->ci->savedpc = pc;
+
+                        if (L->global->ecb.enter(L, p) == 1)
+                        {
+                            pc = L->ci->savedpc;
+                            base = L->base;
+                        }
+                    }
+#endif
+
                     VM_NEXT();
                 }
                 else
@@ -1047,6 +1151,19 @@ static void luau_execute(lua_State* L)
                     L->top = (nresults == LUA_MULTRET) ? res : cip->top;
 
                     base = L->base; // stack may have been reallocated, so we need to refresh base ptr
+
+#if LUA_CUSTOM_EXECUTION
+                    // after a C function returns, the caller can continue in custom execution from the next instruction
+                    if (!SingleStep && cl->l.p->execdata)
+                    {
+                        if (L->global->ecb.enter(L, cl->l.p) == 1)
+                        {
+                            pc = L->ci->savedpc;
+                            base = L->base;
+                        }
+                    }
+#endif
+
                     VM_NEXT();
                 }
             }
@@ -1097,6 +1214,18 @@ static void luau_execute(lua_State* L)
                 cl = clvalue(cip->func);
                 base = L->base;
                 k = cl->l.p->k;
+
+#if LUA_CUSTOM_EXECUTION
+                if (!SingleStep && cl->l.p->execdata)
+                {
+                    if (L->global->ecb.enter(L, cl->l.p) == 1)
+                    {
+                        pc = L->ci->savedpc;
+                        base = L->base;
+                    }
+                }
+#endif
+
                 VM_NEXT();
             }
 
@@ -1169,6 +1298,7 @@ static void luau_execute(lua_State* L)
                     case LUA_TSTRING:
                     case LUA_TFUNCTION:
                     case LUA_TTHREAD:
+                    case LUA_TBUFFER:
                         pc += gcvalue(ra) == gcvalue(rb) ? LUAU_INSN_D(insn) : 1;
                         LUAU_ASSERT(unsigned(pc - cl->l.p->code) < unsigned(cl->l.p->sizecode));
                         VM_NEXT();
@@ -1281,6 +1411,7 @@ static void luau_execute(lua_State* L)
                     case LUA_TSTRING:
                     case LUA_TFUNCTION:
                     case LUA_TTHREAD:
+                    case LUA_TBUFFER:
                         pc += gcvalue(ra) != gcvalue(rb) ? LUAU_INSN_D(insn) : 1;
                         LUAU_ASSERT(unsigned(pc - cl->l.p->code) < unsigned(cl->l.p->sizecode));
                         VM_NEXT();
@@ -2125,12 +2256,33 @@ static void luau_execute(lua_State* L)
                 if (last > h->sizearray)
                     luaH_resizearray(L, h, last);
 
-                TValue* array = h->array;
+                // packed number arrays can only stay packed if all values are numbers
+                if (h->numarray)
+                {
+                    for (int i = 0; i < c; ++i)
+                    {
+                        if (!luaH_ispackable(rb + i))
+                        {
+                            luaH_unpackarray(L, h);
+                            break;
+                        }
+                    }
+                }
+
+                if (h->numarray)
+                {
+                    for (int i = 0; i < c; ++i)
+                        setnumarrayobj(h, index + i - 1, rb + i);
+                }
+                else
+                {
+                    TValue* array = h->array;
 
-                for (int i = 0; i < c; ++i)
-                    setobj2t(L, &array[index + i - 1], rb + i);
+                    for (int i = 0; i < c; ++i)
+                        setobj2t(L, &array[index + i - 1], rb + i);
 
-                luaC_barrierfast(L, h);
+                    luaC_barrierfast(L, h);
+                }
                 VM_NEXT();
             }
 
@@ -2265,7 +2417,7 @@ static void luau_execute(lua_State* L)
                             setnilvalue(ra + 3 + i);
 
                     // terminate ipairs-style traversal early when encountering nil
-                    if (int(aux) < 0 && (unsigned(index) >= unsigned(sizearray) || ttisnil(&h->array[index])))
+                    if (int(aux) < 0 && (unsigned(index) >= unsigned(sizearray) || arrayisnil(h, index)))
                     {
                         pc++;
                         VM_NEXT();
@@ -2274,13 +2426,11 @@ static void luau_execute(lua_State* L)
                     // first we advance index through the array portion
                     while (unsigned(index) < unsigned(sizearray))
                     {
-                        TValue* e = &h->array[index];
-
-                        if (!ttisnil(e))
+                        if (!arrayisnil(h, index))
                         {
                             setpvalue(ra + 2, reinterpret_cast<void*>(uintptr_t(index + 1)));
                             setnvalue(ra + 3, double(index + 1));
-                            setobj2s(L, ra + 4, e);
+                            getarrayvalue(L, ra + 4, h, index);
 
                             pc += LUAU_INSN_D(insn);
                             LUAU_ASSERT(unsigned(pc - cl->l.p->code) < unsigned(cl->l.p->sizecode));
@@ -2290,6 +2440,35 @@ static void luau_execute(lua_State* L)
                         index++;
                     }
 
+                    // tables with a shape keep the values in the order of the keys of the shape
+                    if (h->shaped)
+                    {
+                        TableSlots* ts = tslots(h);
+                        Shape* shape = ts->shape;
+
+                        while (unsigned(index - sizearray) < unsigned(shape->count))
+                        {
+                            TValue* v = &ts->slots[index - sizearray];
+
+                            if (!ttisnil(v))
+                            {
+                                setpvalue(ra + 2, reinterpret_cast<void*>(uintptr_t(index + 1)));
+                                setsvalue(L, ra + 3, shape->keys[index - sizearray]);
+                                setobj2s(L, ra + 4, v);
+
+                                pc += LUAU_INSN_D(insn);
+                                LUAU_ASSERT(unsigned(pc - cl->l.p->code) < unsigned(cl->l.p->sizecode));
+                                VM_NEXT();
+                            }
+
+                            index++;
+                        }
+
+                        // fallthrough to exit
+                        pc++;
+                        VM_NEXT();
+                    }
+
                     int sizenode = 1 << h->lsizenode;
 
                     // then we advance index through the hash portion
@@ -2838,6 +3017,138 @@ static void luau_execute(lua_State* L)
                 VM_NEXT();
             }
 
+            // fused instructions only implement the fast path of the first instruction; everything else is handled by the regular instruction
+            VM_CASE(LOP_MOVE_MOVE)
+            {
+                Instruction insn = *pc++;
+                StkId ra = VM_REG(LUAU_INSN_A(insn));
+                StkId rb = VM_REG(LUAU_INSN_B(insn));
+
+                setobj2s(L, ra, rb);
+                VM_NEXT_FUSED(LOP_MOVE);
+            }
+
+            VM_CASE(LOP_MOVE_CALL)
+            {
+                Instruction insn = *pc++;
+                StkId ra = VM_REG(LUAU_INSN_A(insn));
+                StkId rb = VM_REG(LUAU_INSN_B(insn));
+
+                setobj2s(L, ra, rb);
+                VM_NEXT_FUSED(LOP_CALL);
+            }
+
+            VM_CASE(LOP_GETUPVAL_CALL)
+            {
+                Instruction insn = *pc++;
+                StkId ra = VM_REG(LUAU_INSN_A(insn));
+                TValue* ur = VM_UV(LUAU_INSN_B(insn));
+                TValue* v = ttisupval(ur) ? upvalue(ur)->v : ur;
+
+                setobj2s(L, ra, v);
+                VM_NEXT_FUSED(LOP_CALL);
+            }
+
+            VM_CASE(LOP_GETTABLE_GETTABLE)
+            {
+                Instruction insn = *pc;
+                StkId rb = VM_REG(LUAU_INSN_B(insn));
+                StkId rc = VM_REG(LUAU_INSN_C(insn));
+
+                if (ttistable(rb) && ttisnumber(rc))
+                {
+                    Table* h = hvalue(rb);
+
+                    double indexd = nvalue(rc);
+                    int index = int(indexd);
+
+                    if (LUAU_LIKELY(unsigned(index - 1) < unsigned(h->sizearray) && !h->metatable && double(index) == indexd))
+                    {
+                        getarrayvalue(L, VM_REG(LUAU_INSN_A(insn)), h, unsigned(index - 1));
+                        pc++;
+                        VM_NEXT_FUSED(LOP_GETTABLE);
+                    }
+                }
+
+                VM_CONTINUE(LOP_GETTABLE);
+            }
+
+            VM_CASE(LOP_GETTABLE_ADD)
+            {
+                Instruction insn = *pc;
+                StkId rb = VM_REG(LUAU_INSN_B(insn));
+                StkId rc = VM_REG(LUAU_INSN_C(insn));
+
+                if (ttistable(rb) && ttisnumber(rc))
+                {
+                    Table* h = hvalue(rb);
+
+                    double indexd = nvalue(rc);
+                    int index = int(indexd);
+
+                    if (LUAU_LIKELY(unsigned(index - 1) < unsigned(h->sizearray) && !h->metatable && double(index) == indexd))
+                    {
+                        getarrayvalue(L, VM_REG(LUAU_INSN_A(insn)), h, unsigned(index - 1));
+                        pc++;
+                        VM_NEXT_FUSED(LOP_ADD);
+                    }
+                }
+
+                VM_CONTINUE(LOP_GETTABLE);
+            }
+
+            VM_CASE(LOP_ADDK_GETTABLE)
+            {
+                Instruction insn = *pc;
+                StkId rb = VM_REG(LUAU_INSN_B(insn));
+                TValue* kv = VM_KV(LUAU_INSN_C(insn));
+
+                if (ttisnumber(rb))
+                {
+                    setnvalue(VM_REG(LUAU_INSN_A(insn)), nvalue(rb) + nvalue(kv));
+                    pc++;
+                    VM_NEXT_FUSED(LOP_GETTABLE);
+                }
+
+                VM_CONTINUE(LOP_ADDK);
+            }
+
+            VM_CASE(LOP_MUL_ADD)
+            {
+                Instruction insn = *pc;
+                StkId rb = VM_REG(LUAU_INSN_B(insn));
+                StkId rc = VM_REG(LUAU_INSN_C(insn));
+
+                if (ttisnumber(rb) && ttisnumber(rc))
+                {
+                    setnvalue(VM_REG(LUAU_INSN_A(insn)), nvalue(rb) * nvalue(rc));
+                    pc++;
+                    VM_NEXT_FUSED(LOP_ADD);
+                }
+
+                VM_CONTINUE(LOP_MUL);
+            }
+
+            VM_CASE(LOP_CONCATACC)
+            {
+                Instruction insn = *pc++;
+                uint32_t aux = *pc++;
+
+                // This call may realloc the stack! So we need to query args further down
+                VM_PROTECT(luaV_concatacc(L, LUAU_INSN_A(insn), LUAU_INSN_B(insn), LUAU_INSN_C(insn), aux));
+                VM_PROTECT(luaC_checkGC(L));
+                VM_NEXT();
+            }
+
+            VM_CASE(LOP_FLUSHACC)
+            {
+                Instruction insn = *pc++;
+
+                VM_PROTECT(luaV_flushacc(L, LUAU_INSN_A(insn), LUAU_INSN_B(insn)));
+                VM_PROTECT(luaC_checkGC(L));
+                VM_NEXT();
+            }
+
 #if !VM_USE_CGOTO
         default:
             LUAU_ASSERT(!"Unknown opcode");
@@ -2867,6 +3178,14 @@ int luau_precall(lua_State* L, StkId func, int nresults)
 
     Closure* ccl = clvalue(func);
 
+    // functions loaded with luau_loadlazy are decoded on first call; this can reallocate the stack
+    if (LUAU_UNLIKELY(!ccl->isC && ccl->l.p->lazy))
+    {
+        ptrdiff_t funcsave = savestack(L, func);
+        luaV_materialize(L, ccl->l.p, ccl->env, /* recursive= */ false);
+        func = restorestack(L, funcsave);
+    }
+
     CallInfo* ci = incr_ci(L);
     ci->func = func;
     ci->base = func + 1;
@@ -11,6 +11,7 @@
 #include "lbytecode.h"
 #include "lapi.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 // TODO: RAII deallocation doesn't work for longjmp builds if a memory error happens
@@ -100,6 +101,34 @@ static TString* readString(TempBuffer<TString*>& strings, const char* data, size
     return id == 0 ? NULL : strings[id - 1];
 }
 
+// strings of lazy chunks are created when the functions that use them are decoded
+static TString* readLazyString(lua_State* L, const LazyChunk* chunk, size_t& offset)
+{
+    unsigned int id = readVarInt(chunk->data, chunk->size, offset);
+
+    if (id == 0)
+        return NULL;
+
+    size_t stroffset = chunk->strings[id - 1];
+    unsigned int length = readVarInt(chunk->data, chunk->size, stroffset);
+
+    return luaS_newlstr(L, chunk->data + stroffset, length);
+}
+
+// matches BytecodeBuilder::getBytecodeHash
+static unsigned int hashbytecode(const char* data, size_t size)
+{
+    uint32_t hash = 2166136261;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= uint8_t(data[i]);
+        hash *= 16777619;
+    }
+
+    return hash ? hash : 1;
+}
+
 static void resolveImportSafe(lua_State* L, Table* env, TValue* k, uint32_t id)
 {
     struct ResolveImport
@@ -139,11 +168,152 @@ static void resolveImportSafe(lua_State* L, Table* env, TValue* k, uint32_t id)
     }
 }
 
-int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size, int env)
+// inline caches are indexed by pc, so we look for the smallest table that gives every table access instruction its own entry;
+// instructions may share entries in large functions, which only makes the cache miss more often since every use is validated
+static void initinlinecaches(lua_State* L, Proto* p)
 {
-    size_t offset = 0;
+    int count = 0;
+
+    for (int i = 0; i < p->sizecode; i += getOpLength(LuauOpcode(LUAU_INSN_OP(p->code[i]))))
+    {
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(p->code[i]));
+        count += (op == LOP_GETTABLEKS || op == LOP_SETTABLEKS || op == LOP_NAMECALL);
+    }
+
+    if (count == 0)
+        return;
+
+    TempBuffer<int> pcs(L, count);
+    count = 0;
+
+    for (int i = 0; i < p->sizecode; i += getOpLength(LuauOpcode(LUAU_INSN_OP(p->code[i]))))
+    {
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(p->code[i]));
+        if (op == LOP_GETTABLEKS || op == LOP_SETTABLEKS || op == LOP_NAMECALL)
+            pcs[count++] = i;
+    }
+
+    int size = 1;
+    while (size < count)
+        size *= 2;
+
+    // sizes over 4x of the instruction count aren't worth the memory
+    int maxsize = size * 4;
+
+    TempBuffer<uint8_t> used(L, maxsize);
+
+    for (; size < maxsize; size *= 2)
+    {
+        memset(used.data, 0, size);
+
+        bool collision = false;
+
+        for (int i = 0; i < count && !collision; ++i)
+            collision = used[pcs[i] & (size - 1)]++ != 0;
+
+        if (!collision)
+            break;
+    }
+
+    p->ic = luaM_newarray(L, size, LuaInlineCache, p->memcat);
+    p->sizeic = size;
+
+    memset(p->ic, 0, sizeof(LuaInlineCache) * size);
+}
+
+// bytecode images keep a copy of the bytecode followed by the code and line info arrays of every function in the layout Proto uses, so that
+// the protos loaded from the image can reference them instead of allocating their own copies
+#define LUAU_IMAGE_MAGIC "LBCI"
+#define LUAU_IMAGE_VERSION 1
+
+struct ImageHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t bytecodeoffset;
+    uint32_t bytecodesize;
+    uint32_t protocount;
+};
+
+// offsets of the arrays from the start of the image; lineinfo is 0 for functions without line info
+struct ImageProto
+{
+    uint32_t code;
+    uint32_t lineinfo;
+};
+
+static_assert(sizeof(ImageHeader) % 4 == 0 && sizeof(ImageProto) % 4 == 0, "image arrays must stay aligned");
+
+struct Image
+{
+    const char* data;
+    const ImageProto* protos;
+    uint32_t protocount;
+};
+
+static void skipConstants(const char* data, size_t size, size_t& offset, unsigned int sizek)
+{
+    for (unsigned int j = 0; j < sizek && offset <= size; ++j)
+    {
+        switch (read<uint8_t>(data, size, offset))
+        {
+        case LBC_CONSTANT_NIL:
+            break;
+
+        case LBC_CONSTANT_BOOLEAN:
+            offset += 1;
+            break;
+
+        case LBC_CONSTANT_NUMBER:
+            offset += sizeof(double);
+            break;
+
+        case LBC_CONSTANT_STRING:
+        case LBC_CONSTANT_CLOSURE:
+            readVarInt(data, size, offset);
+            break;
+
+        case LBC_CONSTANT_IMPORT:
+            offset += sizeof(uint32_t);
+            break;
+
+        case LBC_CONSTANT_TABLE:
+        {
+            unsigned int keys = readVarInt(data, size, offset);
+            for (unsigned int k = 0; k < keys && offset <= size; ++k)
+                readVarInt(data, size, offset);
+            break;
+        }
+
+        default:
+            offset = size + 1; // malformed bytecode
+        }
+    }
+}
+
+static void skipDebugInfo(const char* data, size_t size, size_t& offset)
+{
+    if (read<uint8_t>(data, size, offset))
+    {
+        unsigned int sizelocvars = readVarInt(data, size, offset);
 
-    uint8_t version = read<uint8_t>(data, size, offset);
+        for (unsigned int j = 0; j < sizelocvars && offset <= size; ++j)
+        {
+            readVarInt(data, size, offset);
+            readVarInt(data, size, offset);
+            readVarInt(data, size, offset);
+            offset += 1;
+        }
+
+        unsigned int sizeupvalues = readVarInt(data, size, offset);
+        for (unsigned int j = 0; j < sizeupvalues && offset <= size; ++j)
+            readVarInt(data, size, offset);
+    }
+}
+
+static int checkVersion(lua_State* L, const char* chunkname, const char* data, size_t size, size_t& offset, uint8_t& version)
+{
+    version = read<uint8_t>(data, size, offset);
 
     // 0 means the rest of the bytecode is the error message
     if (version == 0)
@@ -162,6 +332,235 @@ int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size
         return 1;
     }
 
+    return 0;
+}
+
+static void readHeader(lua_State* L, Proto* p, uint8_t version, const char* data, size_t size, size_t& offset)
+{
+    p->maxstacksize = read<uint8_t>(data, size, offset);
+    p->numparams = read<uint8_t>(data, size, offset);
+    p->nups = read<uint8_t>(data, size, offset);
+    p->is_vararg = read<uint8_t>(data, size, offset);
+
+    if (version >= 4)
+    {
+        p->sizetypeinfo = readVarInt(data, size, offset);
+
+        if (p->sizetypeinfo)
+        {
+            p->typeinfo = luaM_newarray(L, p->sizetypeinfo, uint8_t, p->memcat);
+            memcpy(p->typeinfo, data + offset, p->sizetypeinfo);
+            offset += p->sizetypeinfo;
+        }
+    }
+}
+
+static void readCode(lua_State* L, Proto* p, const char* data, size_t size, size_t& offset, const Image* image, unsigned int id)
+{
+    int sizecode = readVarInt(data, size, offset);
+
+    if (image)
+    {
+        LUAU_ASSERT(id < image->protocount);
+        p->sharedcode = 1;
+        p->code = (Instruction*)(image->data + image->protos[id].code);
+        offset += sizeof(Instruction) * sizecode;
+    }
+    else
+    {
+        p->code = luaM_newarray(L, sizecode, Instruction, p->memcat);
+        for (int j = 0; j < sizecode; ++j)
+            p->code[j] = read<uint32_t>(data, size, offset);
+    }
+
+    p->sizecode = sizecode;
+
+    initinlinecaches(L, p);
+}
+
+// the proto can already be reachable, so every collectable value is stored with a barrier
+template<typename GetString, typename GetProto>
+static void readConstants(lua_State* L, Proto* p, Table* envt, const char* data, size_t size, size_t& offset, GetString getString, GetProto getProto)
+{
+    int sizek = readVarInt(data, size, offset);
+    p->k = luaM_newarray(L, sizek, TValue, p->memcat);
+
+    // GC can run while imports are resolved, so the array is filled with nil before it's exposed
+    for (int j = 0; j < sizek; ++j)
+    {
+        setnilvalue(&p->k[j]);
+    }
+
+    p->sizek = sizek;
+
+    for (int j = 0; j < p->sizek; ++j)
+    {
+        switch (read<uint8_t>(data, size, offset))
+        {
+        case LBC_CONSTANT_NIL:
+            setnilvalue(&p->k[j]);
+            break;
+
+        case LBC_CONSTANT_BOOLEAN:
+        {
+            uint8_t v = read<uint8_t>(data, size, offset);
+            setbvalue(&p->k[j], v);
+            break;
+        }
+
+        case LBC_CONSTANT_NUMBER:
+        {
+            double v = read<double>(data, size, offset);
+            setnvalue(&p->k[j], v);
+            break;
+        }
+
+        case LBC_CONSTANT_STRING:
+        {
+            TString* v = getString(offset);
+            setsvalue2n(L, &p->k[j], v);
+            break;
+        }
+
+        case LBC_CONSTANT_IMPORT:
+        {
+            uint32_t iid = read<uint32_t>(data, size, offset);
+            resolveImportSafe(L, envt, p->k, iid);
+            setobj(L, &p->k[j], L->top - 1);
+            L->top--;
+            break;
+        }
+
+        case LBC_CONSTANT_TABLE:
+        {
+            int keys = readVarInt(data, size, offset);
+            Table* h = luaH_new(L, 0, keys);
+            for (int i = 0; i < keys; ++i)
+            {
+                int key = readVarInt(data, size, offset);
+                TValue* val = luaH_set(L, h, &p->k[key]);
+                setnvalue(val, 0.0);
+            }
+            sethvalue(L, &p->k[j], h);
+            break;
+        }
+
+        case LBC_CONSTANT_CLOSURE:
+        {
+            uint32_t fid = readVarInt(data, size, offset);
+            Proto* fp = getProto(fid);
+            Closure* cl = luaF_newLclosure(L, fp->nups, envt, fp);
+            cl->preload = (cl->nupvalues > 0);
+            setclvalue(L, &p->k[j], cl);
+            break;
+        }
+
+        default:
+            LUAU_ASSERT(!"Unexpected constant kind");
+        }
+
+        luaC_barrier(L, p, &p->k[j]);
+    }
+}
+
+static void readLineInfo(lua_State* L, Proto* p, const char* data, size_t size, size_t& offset, const Image* image, unsigned int id)
+{
+    uint8_t lineinfo = read<uint8_t>(data, size, offset);
+
+    if (lineinfo)
+    {
+        p->linegaplog2 = read<uint8_t>(data, size, offset);
+
+        int intervals = ((p->sizecode - 1) >> p->linegaplog2) + 1;
+        int absoffset = (p->sizecode + 3) & ~3;
+
+        int sizelineinfo = absoffset + intervals * sizeof(int);
+
+        if (image)
+        {
+            LUAU_ASSERT(image->protos[id].lineinfo != 0);
+            p->lineinfo = (uint8_t*)(image->data + image->protos[id].lineinfo);
+            p->abslineinfo = (int*)(p->lineinfo + absoffset);
+            offset += p->sizecode + intervals * sizeof(int32_t);
+        }
+        else
+        {
+            p->lineinfo = luaM_newarray(L, sizelineinfo, uint8_t, p->memcat);
+            p->abslineinfo = (int*)(p->lineinfo + absoffset);
+
+            uint8_t lastoffset = 0;
+            for (int j = 0; j < p->sizecode; ++j)
+            {
+                lastoffset += read<uint8_t>(data, size, offset);
+                p->lineinfo[j] = lastoffset;
+            }
+
+            int lastline = 0;
+            for (int j = 0; j < intervals; ++j)
+            {
+                lastline += read<int32_t>(data, size, offset);
+                p->abslineinfo[j] = lastline;
+            }
+        }
+
+        p->sizelineinfo = sizelineinfo;
+    }
+}
+
+template<typename GetString>
+static void readDebugInfo(lua_State* L, Proto* p, const char* data, size_t size, size_t& offset, GetString getString)
+{
+    uint8_t debuginfo = read<uint8_t>(data, size, offset);
+
+    if (debuginfo)
+    {
+        int sizelocvars = readVarInt(data, size, offset);
+        p->locvars = luaM_newarray(L, sizelocvars, LocVar, p->memcat);
+
+        for (int j = 0; j < sizelocvars; ++j)
+            p->locvars[j].varname = NULL;
+
+        p->sizelocvars = sizelocvars;
+
+        for (int j = 0; j < p->sizelocvars; ++j)
+        {
+            TString* varname = getString(offset);
+            p->locvars[j].varname = varname;
+            p->locvars[j].startpc = readVarInt(data, size, offset);
+            p->locvars[j].endpc = readVarInt(data, size, offset);
+            p->locvars[j].reg = read<uint8_t>(data, size, offset);
+
+            if (varname)
+                luaC_objbarrier(L, p, varname);
+        }
+
+        int sizeupvalues = readVarInt(data, size, offset);
+        p->upvalues = luaM_newarray(L, sizeupvalues, TString*, p->memcat);
+
+        for (int j = 0; j < sizeupvalues; ++j)
+            p->upvalues[j] = NULL;
+
+        p->sizeupvalues = sizeupvalues;
+
+        for (int j = 0; j < p->sizeupvalues; ++j)
+        {
+            TString* name = getString(offset);
+            p->upvalues[j] = name;
+
+            if (name)
+                luaC_objbarrier(L, p, name);
+        }
+    }
+}
+
+static int loadbytecode(lua_State* L, const char* chunkname, const char* data, size_t size, int env, const Image* image)
+{
+    size_t offset = 0;
+
+    uint8_t version = 0;
+    if (checkVersion(L, chunkname, data, size, offset, version))
+        return 1;
+
     // pause GC for the duration of deserialization - some objects we're creating aren't rooted
     // TODO: if an allocation error happens mid-load, we do not unpause GC!
     size_t GCthreshold = L->global->GCthreshold;
@@ -172,6 +571,9 @@ int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size
 
     TString* source = luaS_new(L, chunkname);
 
+    // debug info sidecars are identified by the hash of the bytecode; images keep line info in shared memory, so they don't use sidecars
+    unsigned int debughash = (L->global->cb.debuginfo && !image) ? hashbytecode(data, size) : 0;
+
     // string table
     unsigned int stringCount = readVarInt(data, size, offset);
     TempBuffer<TString*> strings(L, stringCount);
@@ -184,102 +586,157 @@ int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size
         offset += length;
     }
 
+    auto getString = [&](size_t& stroffset) {
+        return readString(strings, data, size, stroffset);
+    };
+
     // proto table
     unsigned int protoCount = readVarInt(data, size, offset);
     TempBuffer<Proto*> protos(L, protoCount);
 
+    auto getProto = [&](uint32_t fid) {
+        return protos[fid];
+    };
+
     for (unsigned int i = 0; i < protoCount; ++i)
     {
         Proto* p = luaF_newproto(L);
         p->source = source;
+        p->bytecodeid = int(i);
+        p->debughash = debughash;
 
-        p->maxstacksize = read<uint8_t>(data, size, offset);
-        p->numparams = read<uint8_t>(data, size, offset);
-        p->nups = read<uint8_t>(data, size, offset);
-        p->is_vararg = read<uint8_t>(data, size, offset);
-
-        p->sizecode = readVarInt(data, size, offset);
-        p->code = luaM_newarray(L, p->sizecode, Instruction, p->memcat);
-        for (int j = 0; j < p->sizecode; ++j)
-            p->code[j] = read<uint32_t>(data, size, offset);
-
-        p->sizek = readVarInt(data, size, offset);
-        p->k = luaM_newarray(L, p->sizek, TValue, p->memcat);
+        readHeader(L, p, version, data, size, offset);
+        readCode(L, p, data, size, offset, image, i);
+        readConstants(L, p, envt, data, size, offset, getString, getProto);
 
-#ifdef HARDMEMTESTS
-        // this is redundant during normal runs, but resolveImportSafe can trigger GC checks under HARDMEMTESTS
-        // because p->k isn't fully formed at this point, we pre-fill it with nil to make subsequent setup safe
-        for (int j = 0; j < p->sizek; ++j)
+        p->sizep = readVarInt(data, size, offset);
+        p->p = luaM_newarray(L, p->sizep, Proto*, p->memcat);
+        for (int j = 0; j < p->sizep; ++j)
         {
-            setnilvalue(&p->k[j]);
+            uint32_t fid = readVarInt(data, size, offset);
+            p->p[j] = protos[fid];
         }
-#endif
 
-        for (int j = 0; j < p->sizek; ++j)
-        {
-            switch (read<uint8_t>(data, size, offset))
-            {
-            case LBC_CONSTANT_NIL:
-                setnilvalue(&p->k[j]);
-                break;
+        p->linedefined = readVarInt(data, size, offset);
+        p->debugname = readString(strings, data, size, offset);
 
-            case LBC_CONSTANT_BOOLEAN:
-            {
-                uint8_t v = read<uint8_t>(data, size, offset);
-                setbvalue(&p->k[j], v);
-                break;
-            }
+        readLineInfo(L, p, data, size, offset, image, i);
+        readDebugInfo(L, p, data, size, offset, getString);
 
-            case LBC_CONSTANT_NUMBER:
-            {
-                double v = read<double>(data, size, offset);
-                setnvalue(&p->k[j], v);
-                break;
-            }
+        protos[i] = p;
+    }
 
-            case LBC_CONSTANT_STRING:
-            {
-                TString* v = readString(strings, data, size, offset);
-                setsvalue2n(L, &p->k[j], v);
-                break;
-            }
+    // "main" proto is pushed to Lua stack
+    uint32_t mainid = readVarInt(data, size, offset);
+    Proto* main = protos[mainid];
 
-            case LBC_CONSTANT_IMPORT:
-            {
-                uint32_t iid = read<uint32_t>(data, size, offset);
-                resolveImportSafe(L, envt, p->k, iid);
-                setobj(L, &p->k[j], L->top - 1);
-                L->top--;
-                break;
-            }
+    luaC_threadbarrier(L);
 
-            case LBC_CONSTANT_TABLE:
-            {
-                int keys = readVarInt(data, size, offset);
-                Table* h = luaH_new(L, 0, keys);
-                for (int i = 0; i < keys; ++i)
-                {
-                    int key = readVarInt(data, size, offset);
-                    TValue* val = luaH_set(L, h, &p->k[key]);
-                    setnvalue(val, 0.0);
-                }
-                sethvalue(L, &p->k[j], h);
-                break;
-            }
+    Closure* cl = luaF_newLclosure(L, 0, envt, main);
+    setclvalue(L, L->top, cl);
+    incr_top(L);
 
-            case LBC_CONSTANT_CLOSURE:
-            {
-                uint32_t fid = readVarInt(data, size, offset);
-                Closure* cl = luaF_newLclosure(L, protos[fid]->nups, envt, protos[fid]);
-                cl->preload = (cl->nupvalues > 0);
-                setclvalue(L, &p->k[j], cl);
-                break;
-            }
+    L->global->GCthreshold = GCthreshold;
 
-            default:
-                LUAU_ASSERT(!"Unexpected constant kind");
-            }
-        }
+    return 0;
+}
+
+int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size, int env)
+{
+    return loadbytecode(L, chunkname, data, size, env, NULL);
+}
+
+static LazyChunk* newchunk(lua_State* L, const char* data, size_t size, unsigned int stringcount, uint8_t version)
+{
+    // the chunk, string offsets and bytecode share one allocation
+    size_t total = sizeof(LazyChunk) + sizeof(uint32_t) * stringcount + size;
+    char* block = luaM_newarray(L, total, char, L->activememcat);
+
+    LazyChunk* chunk = (LazyChunk*)block;
+    chunk->refs = 0;
+    chunk->memcat = L->activememcat;
+    chunk->version = version;
+    chunk->strings = (uint32_t*)(block + sizeof(LazyChunk));
+    chunk->stringcount = stringcount;
+    chunk->data = block + sizeof(LazyChunk) + sizeof(uint32_t) * stringcount;
+    chunk->size = size;
+
+    memcpy(chunk->data, data, size);
+
+    return chunk;
+}
+
+LazyChunk* luaV_clonechunk(lua_State* L, const LazyChunk* chunk)
+{
+    LazyChunk* result = newchunk(L, chunk->data, chunk->size, chunk->stringcount, chunk->version);
+    memcpy(result->strings, chunk->strings, sizeof(uint32_t) * chunk->stringcount);
+
+    return result;
+}
+
+void luaV_releasechunk(lua_State* L, LazyChunk* chunk)
+{
+    LUAU_ASSERT(chunk->refs > 0);
+
+    if (--chunk->refs == 0)
+    {
+        size_t total = sizeof(LazyChunk) + sizeof(uint32_t) * chunk->stringcount + chunk->size;
+        luaM_freearray(L, (char*)chunk, total, char, chunk->memcat);
+    }
+}
+
+int luau_loadlazy(lua_State* L, const char* chunkname, const char* data, size_t size, int env)
+{
+    size_t offset = 0;
+
+    uint8_t version = 0;
+    if (checkVersion(L, chunkname, data, size, offset, version))
+        return 1;
+
+    // pause GC for the duration of deserialization - some objects we're creating aren't rooted
+    size_t GCthreshold = L->global->GCthreshold;
+    L->global->GCthreshold = SIZE_MAX;
+
+    Table* envt = (env == 0) ? L->gt : hvalue(luaA_toobject(L, env));
+
+    TString* source = luaS_new(L, chunkname);
+
+    unsigned int debughash = L->global->cb.debuginfo ? hashbytecode(data, size) : 0;
+
+    // string table is only indexed here; strings are created as the functions that use them are decoded
+    unsigned int stringCount = readVarInt(data, size, offset);
+    LazyChunk* chunk = newchunk(L, data, size, stringCount, version);
+
+    for (unsigned int i = 0; i < stringCount; ++i)
+    {
+        chunk->strings[i] = uint32_t(offset);
+
+        unsigned int length = readVarInt(data, size, offset);
+        offset += length;
+    }
+
+    // proto table; functions only get the fields needed to link them together and to describe them in stack traces
+    unsigned int protoCount = readVarInt(data, size, offset);
+    TempBuffer<Proto*> protos(L, protoCount);
+
+    for (unsigned int i = 0; i < protoCount; ++i)
+    {
+        Proto* p = luaF_newproto(L);
+        p->source = source;
+        p->bytecodeid = int(i);
+        p->debughash = debughash;
+
+        readHeader(L, p, version, data, size, offset);
+
+        p->lazy = chunk;
+        p->lazyoffset = int(offset);
+        chunk->refs++;
+
+        int sizecode = readVarInt(data, size, offset);
+        offset += sizeof(Instruction) * sizecode;
+
+        unsigned int sizek = readVarInt(data, size, offset);
+        skipConstants(data, size, offset, sizek);
 
         p->sizep = readVarInt(data, size, offset);
         p->p = luaM_newarray(L, p->sizep, Proto*, p->memcat);
@@ -290,74 +747,439 @@ int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size
         }
 
         p->linedefined = readVarInt(data, size, offset);
-        p->debugname = readString(strings, data, size, offset);
+        p->debugname = readLazyString(L, chunk, offset);
+
+        if (read<uint8_t>(data, size, offset))
+        {
+            int linegaplog2 = read<uint8_t>(data, size, offset);
+            int intervals = ((sizecode - 1) >> linegaplog2) + 1;
+            offset += sizecode + intervals * sizeof(int32_t);
+        }
+
+        skipDebugInfo(data, size, offset);
+
+        protos[i] = p;
+    }
+
+    uint32_t mainid = readVarInt(data, size, offset);
+    Proto* main = protos[mainid];
+
+    luaC_threadbarrier(L);
+
+    Closure* cl = luaF_newLclosure(L, 0, envt, main);
+    setclvalue(L, L->top, cl);
+    incr_top(L);
+
+    L->global->GCthreshold = GCthreshold;
+
+    return 0;
+}
+
+// releases the arrays of a decode that failed with an error, so that it can be retried
+static void resetlazy(lua_State* L, Proto* p)
+{
+    luaM_freearray(L, p->code, p->sizecode, Instruction, p->memcat);
+    p->code = NULL;
+    p->sizecode = 0;
+
+    luaM_freearray(L, p->ic, p->sizeic, LuaInlineCache, p->memcat);
+    p->ic = NULL;
+    p->sizeic = 0;
+
+    luaM_freearray(L, p->k, p->sizek, TValue, p->memcat);
+    p->k = NULL;
+    p->sizek = 0;
+
+    if (p->lineinfo)
+        luaM_freearray(L, p->lineinfo, p->sizelineinfo, uint8_t, p->memcat);
+    p->lineinfo = NULL;
+    p->abslineinfo = NULL;
+    p->sizelineinfo = 0;
+
+    luaM_freearray(L, p->locvars, p->sizelocvars, LocVar, p->memcat);
+    p->locvars = NULL;
+    p->sizelocvars = 0;
+
+    luaM_freearray(L, p->upvalues, p->sizeupvalues, TString*, p->memcat);
+    p->upvalues = NULL;
+    p->sizeupvalues = 0;
+}
+
+void luaV_materialize(lua_State* L, Proto* p, Table* env, bool recursive)
+{
+    if (LazyChunk* chunk = p->lazy)
+    {
+        const char* data = chunk->data;
+        size_t size = chunk->size;
+        size_t offset = p->lazyoffset;
+
+        resetlazy(L, p);
 
-        uint8_t lineinfo = read<uint8_t>(data, size, offset);
+        readCode(L, p, data, size, offset, NULL, 0);
 
-        if (lineinfo)
+        // closure constants refer to the functions by their index in the chunk, which is only recorded in the list of child functions
+        size_t constoffset = offset;
+        unsigned int sizek = readVarInt(data, size, offset);
+        skipConstants(data, size, offset, sizek);
+
+        size_t childoffset = offset;
+
+        auto getString = [&](size_t& stroffset) {
+            return readLazyString(L, chunk, stroffset);
+        };
+
+        auto getProto = [&](uint32_t fid) {
+            size_t idoffset = childoffset;
+            int sizep = readVarInt(data, size, idoffset);
+
+            for (int j = 0; j < sizep; ++j)
+                if (readVarInt(data, size, idoffset) == fid)
+                    return p->p[j];
+
+            LUAU_ASSERT(!"Closure constant refers to a function that isn't a child");
+            return p;
+        };
+
+        readConstants(L, p, env, data, size, constoffset, getString, getProto);
+
+        // child functions, linedefined and debugname were read on load
+        unsigned int sizep = readVarInt(data, size, offset);
+        for (unsigned int j = 0; j < sizep; ++j)
+            readVarInt(data, size, offset);
+
+        readVarInt(data, size, offset);
+        readVarInt(data, size, offset);
+
+        readLineInfo(L, p, data, size, offset, NULL, 0);
+        readDebugInfo(L, p, data, size, offset, getString);
+
+        p->lazy = NULL;
+        luaV_releasechunk(L, chunk);
+    }
+
+    if (recursive)
+    {
+        for (int i = 0; i < p->sizep; ++i)
+            luaV_materialize(L, p->p[i], env, recursive);
+    }
+}
+
+void luaV_loaddebuginfo(lua_State* L, Proto* p)
+{
+    // functions that haven't been decoded yet don't have code to attribute lines to; the sidecar is requested once they are
+    if (p->lazy)
+        return;
+
+    unsigned int hash = p->debughash;
+
+    // the sidecar is only requested once, even if it's missing or doesn't match the bytecode
+    p->debughash = 0;
+
+    // bytecode that was compiled without a sidecar may still have inline debug info
+    if (p->lineinfo || p->locvars || p->upvalues)
+        return;
+
+    size_t size = 0;
+    const char* data = L->global->cb.debuginfo ? L->global->cb.debuginfo(L, getstr(p->source), hash, &size) : NULL;
+
+    size_t offset = 0;
+
+    if (!data || size < 5 || read<uint8_t>(data, size, offset) != LBC_DEBUGINFO_VERSION || read<uint32_t>(data, size, offset) != hash)
+        return;
+
+    // string table is only indexed; the names are created for the entries of this function
+    unsigned int stringCount = readVarInt(data, size, offset);
+    TempBuffer<size_t> strings(L, stringCount);
+
+    for (unsigned int i = 0; i < stringCount && offset <= size; ++i)
+    {
+        strings[i] = offset;
+
+        unsigned int length = readVarInt(data, size, offset);
+        offset += length;
+    }
+
+    if (offset > size)
+        return;
+
+    unsigned int protoCount = readVarInt(data, size, offset);
+    size_t entries = offset + sizeof(uint32_t) * protoCount;
+
+    if (unsigned(p->bytecodeid) >= protoCount || entries > size)
+        return;
+
+    offset += sizeof(uint32_t) * p->bytecodeid;
+    offset = entries + read<uint32_t>(data, size, offset);
+
+    if (offset >= size || int(readVarInt(data, size, offset)) != p->sizecode)
+        return;
+
+    // sidecars come from outside of the bytecode, so string references are validated instead of trusted
+    bool validstrings = true;
+
+    auto getString = [&](size_t& stroffset) -> TString* {
+        unsigned int id = readVarInt(data, size, stroffset);
+
+        if (id == 0 || id > stringCount)
         {
-            p->linegaplog2 = read<uint8_t>(data, size, offset);
+            validstrings = false;
+            return NULL;
+        }
 
-            int intervals = ((p->sizecode - 1) >> p->linegaplog2) + 1;
-            int absoffset = (p->sizecode + 3) & ~3;
+        size_t nameoffset = strings[id - 1];
+        unsigned int length = readVarInt(data, size, nameoffset);
 
-            p->sizelineinfo = absoffset + intervals * sizeof(int);
-            p->lineinfo = luaM_newarray(L, p->sizelineinfo, uint8_t, p->memcat);
-            p->abslineinfo = (int*)(p->lineinfo + absoffset);
+        return luaS_newlstr(L, data + nameoffset, length);
+    };
+
+    readLineInfo(L, p, data, size, offset, NULL, 0);
+    readDebugInfo(L, p, data, size, offset, getString);
+
+    // locals and upvalues are expected to have names, so a sidecar with broken references only provides line info
+    if (!validstrings)
+    {
+        luaM_freearray(L, p->locvars, p->sizelocvars, LocVar, p->memcat);
+        p->locvars = NULL;
+        p->sizelocvars = 0;
+
+        luaM_freearray(L, p->upvalues, p->sizeupvalues, TString*, p->memcat);
+        p->upvalues = NULL;
+        p->sizeupvalues = 0;
+    }
+}
+
+static size_t alignimage(size_t offset)
+{
+    return (offset + 3) & ~size_t(3);
+}
+
+struct ImageProtoInfo
+{
+    size_t code;
+    size_t lineinfo;
+    int sizecode;
+    int linegaplog2;
+    bool haslineinfo;
+};
+
+// size of the line info array of a function, including the absolute line info that follows the offsets
+static size_t imagelineinfosize(const ImageProtoInfo& info)
+{
+    int intervals = ((info.sizecode - 1) >> info.linegaplog2) + 1;
+    return ((info.sizecode + 3) & ~3) + intervals * sizeof(int);
+}
+
+// finds the code and line info arrays of every function; error chunks and unsupported versions have no functions, so that loading them reports the
+// error. returns false if the bytecode is malformed; infos is allocated with calloc and has to be freed by the caller
+static bool scanimageprotos(const char* data, size_t size, ImageProtoInfo*& infos, unsigned int& protoCount)
+{
+    infos = NULL;
+    protoCount = 0;
+
+    size_t offset = 0;
+    uint8_t version = size > 0 ? read<uint8_t>(data, size, offset) : 0;
+
+    if (version < LBC_VERSION_MIN || version > LBC_VERSION_MAX)
+        return true;
+
+    unsigned int stringCount = readVarInt(data, size, offset);
+
+    for (unsigned int i = 0; i < stringCount && offset <= size; ++i)
+    {
+        unsigned int length = readVarInt(data, size, offset);
+        offset += length;
+    }
+
+    protoCount = readVarInt(data, size, offset);
+    infos = offset <= size ? (ImageProtoInfo*)calloc(protoCount, sizeof(ImageProtoInfo)) : NULL;
+
+    if (!infos)
+        return false;
+
+    for (unsigned int i = 0; i < protoCount && offset <= size; ++i)
+    {
+        ImageProtoInfo& info = infos[i];
+
+        offset += 4; // maxstacksize, numparams, nups, is_vararg
+
+        if (version >= 4)
+        {
+            unsigned int sizetypeinfo = readVarInt(data, size, offset);
+            offset += sizetypeinfo;
+        }
+
+        info.sizecode = readVarInt(data, size, offset);
+        info.code = offset;
+        offset += sizeof(Instruction) * info.sizecode;
+
+        unsigned int sizek = readVarInt(data, size, offset);
+        skipConstants(data, size, offset, sizek);
+
+        unsigned int sizep = readVarInt(data, size, offset);
+        for (unsigned int j = 0; j < sizep && offset <= size; ++j)
+            readVarInt(data, size, offset);
+
+        readVarInt(data, size, offset); // linedefined
+        readVarInt(data, size, offset); // debugname
+
+        info.haslineinfo = read<uint8_t>(data, size, offset) != 0;
+
+        if (info.haslineinfo)
+        {
+            info.linegaplog2 = read<uint8_t>(data, size, offset);
+            info.lineinfo = offset;
+
+            int intervals = ((info.sizecode - 1) >> info.linegaplog2) + 1;
+            offset += info.sizecode + intervals * sizeof(int32_t);
+        }
+
+        skipDebugInfo(data, size, offset);
+    }
+
+    readVarInt(data, size, offset); // mainid
+
+    return offset <= size;
+}
+
+char* luau_buildimage(const char* data, size_t size, size_t* outsize)
+{
+    ImageProtoInfo* infos = NULL;
+    unsigned int protoCount = 0;
+
+    if (!scanimageprotos(data, size, infos, protoCount))
+    {
+        free(infos);
+        return NULL;
+    }
+
+    // layout: header, function table, bytecode, then the code and line info arrays of each function
+    size_t bytecodeoffset = sizeof(ImageHeader) + sizeof(ImageProto) * protoCount;
+    size_t imagesize = alignimage(bytecodeoffset + size);
+
+    for (unsigned int i = 0; i < protoCount; ++i)
+    {
+        const ImageProtoInfo& info = infos[i];
+
+        imagesize += sizeof(Instruction) * info.sizecode;
+
+        if (info.haslineinfo)
+            imagesize += imagelineinfosize(info);
+    }
+
+    if (imagesize > UINT32_MAX)
+    {
+        free(infos);
+        return NULL;
+    }
+
+    char* image = (char*)calloc(1, imagesize);
+
+    if (!image)
+    {
+        free(infos);
+        return NULL;
+    }
+
+    ImageHeader* header = (ImageHeader*)image;
+    memcpy(header->magic, LUAU_IMAGE_MAGIC, sizeof(header->magic));
+    header->version = LUAU_IMAGE_VERSION;
+    header->bytecodeoffset = uint32_t(bytecodeoffset);
+    header->bytecodesize = uint32_t(size);
+    header->protocount = protoCount;
+
+    memcpy(image + bytecodeoffset, data, size);
+
+    ImageProto* protos = (ImageProto*)(image + sizeof(ImageHeader));
+    size_t arrayoffset = alignimage(bytecodeoffset + size);
+
+    for (unsigned int i = 0; i < protoCount; ++i)
+    {
+        const ImageProtoInfo& info = infos[i];
+
+        protos[i].code = uint32_t(arrayoffset);
+        memcpy(image + arrayoffset, data + info.code, sizeof(Instruction) * info.sizecode);
+        arrayoffset += sizeof(Instruction) * info.sizecode;
+
+        if (info.haslineinfo)
+        {
+            int intervals = ((info.sizecode - 1) >> info.linegaplog2) + 1;
+            int absoffset = (info.sizecode + 3) & ~3;
+
+            protos[i].lineinfo = uint32_t(arrayoffset);
+
+            uint8_t* lineinfo = (uint8_t*)(image + arrayoffset);
+            size_t lineoffset = info.lineinfo;
 
             uint8_t lastoffset = 0;
-            for (int j = 0; j < p->sizecode; ++j)
+            for (int j = 0; j < info.sizecode; ++j)
             {
-                lastoffset += read<uint8_t>(data, size, offset);
-                p->lineinfo[j] = lastoffset;
+                lastoffset += read<uint8_t>(data, size, lineoffset);
+                lineinfo[j] = lastoffset;
             }
 
             int lastline = 0;
             for (int j = 0; j < intervals; ++j)
             {
-                lastline += read<int32_t>(data, size, offset);
-                p->abslineinfo[j] = lastline;
+                lastline += read<int32_t>(data, size, lineoffset);
+                memcpy(lineinfo + absoffset + j * sizeof(int), &lastline, sizeof(int));
             }
+
+            arrayoffset += imagelineinfosize(info);
         }
+    }
 
-        uint8_t debuginfo = read<uint8_t>(data, size, offset);
+    LUAU_ASSERT(arrayoffset == imagesize);
 
-        if (debuginfo)
-        {
-            p->sizelocvars = readVarInt(data, size, offset);
-            p->locvars = luaM_newarray(L, p->sizelocvars, LocVar, p->memcat);
+    free(infos);
 
-            for (int j = 0; j < p->sizelocvars; ++j)
-            {
-                p->locvars[j].varname = readString(strings, data, size, offset);
-                p->locvars[j].startpc = readVarInt(data, size, offset);
-                p->locvars[j].endpc = readVarInt(data, size, offset);
-                p->locvars[j].reg = read<uint8_t>(data, size, offset);
-            }
+    *outsize = imagesize;
+    return image;
+}
 
-            p->sizeupvalues = readVarInt(data, size, offset);
-            p->upvalues = luaM_newarray(L, p->sizeupvalues, TString*, p->memcat);
+// the image is trusted as little as the bytecode in it: every array has to be aligned and fit in the image
+static bool checkimage(const char* data, size_t size)
+{
+    const ImageHeader* header = (const ImageHeader*)data;
 
-            for (int j = 0; j < p->sizeupvalues; ++j)
-            {
-                p->upvalues[j] = readString(strings, data, size, offset);
-            }
-        }
+    if (uintptr_t(data) % 4 != 0 || size < sizeof(ImageHeader) || memcmp(header->magic, LUAU_IMAGE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != LUAU_IMAGE_VERSION || header->bytecodeoffset + size_t(header->bytecodesize) > size ||
+        sizeof(ImageHeader) + sizeof(ImageProto) * size_t(header->protocount) > header->bytecodeoffset)
+        return false;
 
-        protos[i] = p;
+    ImageProtoInfo* infos = NULL;
+    unsigned int protoCount = 0;
+
+    bool valid = scanimageprotos(data + header->bytecodeoffset, header->bytecodesize, infos, protoCount) && protoCount == header->protocount;
+
+    const ImageProto* protos = (const ImageProto*)(data + sizeof(ImageHeader));
+
+    for (unsigned int i = 0; i < protoCount && valid; ++i)
+    {
+        const ImageProtoInfo& info = infos[i];
+
+        if (protos[i].code % 4 != 0 || protos[i].code + sizeof(Instruction) * size_t(info.sizecode) > size)
+            valid = false;
+        else if (info.haslineinfo && (protos[i].lineinfo == 0 || protos[i].lineinfo % 4 != 0 || protos[i].lineinfo + imagelineinfosize(info) > size))
+            valid = false;
     }
 
-    // "main" proto is pushed to Lua stack
-    uint32_t mainid = readVarInt(data, size, offset);
-    Proto* main = protos[mainid];
+    free(infos);
 
-    luaC_threadbarrier(L);
+    return valid;
+}
 
-    Closure* cl = luaF_newLclosure(L, 0, envt, main);
-    setclvalue(L, L->top, cl);
-    incr_top(L);
+int luau_loadimage(lua_State* L, const char* chunkname, const char* data, size_t size, int env)
+{
+    if (!checkimage(data, size))
+    {
+        char chunkid[LUA_IDSIZE];
+        luaO_chunkid(chunkid, chunkname, LUA_IDSIZE);
+        lua_pushfstring(L, "%s: bytecode image is malformed or has a different version", chunkid);
+        return 1;
+    }
 
-    L->global->GCthreshold = GCthreshold;
+    const ImageHeader* header = (const ImageHeader*)data;
+    Image image = {data, (const ImageProto*)(data + sizeof(ImageHeader)), header->protocount};
 
-    return 0;
+    return loadbytecode(L, chunkname, data + header->bytecodeoffset, header->bytecodesize, env, &image);
 }
@@ -6,6 +6,7 @@
 #include "lstring.h"
 #include "ltable.h"
 #include "lgc.h"
+#include "lbuffer.h"
 #include "ldo.h"
 #include "lnumutils.h"
 
@@ -103,9 +104,10 @@ void luaV_gettable(lua_State* L, const TValue* t, TValue* key, StkId val)
         { // `t' is a table?
             Table* h = hvalue(t);
 
-            const TValue* res = luaH_get(h, key); // do a primitive get
+            TValue tmp;
+            const TValue* res = luaH_getvalue(h, key, &tmp); // do a primitive get
 
-            if (res != luaO_nilobject)
+            if (res != luaO_nilobject && res != &tmp)
                 L->cachedslot = gval2slot(h, res); // remember slot to accelerate future lookups
 
             if (!ttisnil(res) // result is no nil?
@@ -139,6 +141,15 @@ void luaV_settable(lua_State* L, const TValue* t, TValue* key, StkId val)
         { // `t' is a table?
             Table* h = hvalue(t);
 
+            // numbers are stored into packed number arrays directly, unless __newindex might need to be called
+            if (h->numarray && ttisnumber(key) && !h->readonly && fasttm(L, h->metatable, TM_NEWINDEX) == NULL && luaH_setpacked(L, h, key, val))
+                return;
+
+            // luaH_get can't return slots of packed number arrays, so the generic path needs the array part to be converted
+            TValue tmp;
+            if (h->numarray && luaH_getvalue(h, key, &tmp) == &tmp)
+                luaH_unpackarray(L, h);
+
             const TValue* oldval = luaH_get(h, key);
 
             // should we assign the key? (if key is valid or __newindex is not set)
@@ -174,6 +185,54 @@ void luaV_settable(lua_State* L, const TValue* t, TValue* key, StkId val)
     luaG_runerror(L, "'__newindex' chain too long; possible loop");
 }
 
+const TValue* luaV_icfill(lua_State* L, Proto* p, LuaInlineCache* ic, Table* h, Table* mt, TString* key)
+{
+    // the receiver must not have the key, which inline cache lookups check via the main position of the key or the keys of the shape of the receiver
+    if (h && h->shaped)
+    {
+        const TValue* v = luaH_getstr(h, key);
+
+        // receivers with a shape can have the slot of the key remembered instead
+        if (!ttisnil(v))
+        {
+            luaV_icsetslot(L, p, ic, h, gval2slot(h, v));
+            return v;
+        }
+
+        LUAU_ASSERT(h->metatable == mt);
+    }
+    else if (h)
+    {
+        LuaNode* n = gnode(h, key->hash & (sizenode(h) - 1));
+
+        if (gnext(n) != 0 || (ttisstring(gkey(n)) && tsvalue(gkey(n)) == key && !ttisnil(gval(n))))
+            return NULL;
+
+        LUAU_ASSERT(h->metatable == mt);
+    }
+
+    const TValue* tm = mt ? luaH_getstr(mt, L->global->tmname[TM_INDEX]) : luaO_nilobject;
+    if (!ttistable(tm))
+        return NULL;
+
+    Table* holder = hvalue(tm);
+    const TValue* res = luaH_getstr(holder, key);
+    if (ttisnil(res))
+        return NULL;
+
+    ic->slot = gval2slot(holder, res);
+    ic->mtslot = gval2slot(mt, tm);
+    ic->metatable = mt;
+    ic->holder = holder;
+    ic->shape = NULL;
+
+    // entries are weak, but a proto that was traversed before it got its caches isn't rescanned until the next cycle
+    luaC_objbarrier(L, p, mt);
+    luaC_objbarrier(L, p, holder);
+
+    return res;
+}
+
 static int call_binTM(lua_State* L, const TValue* p1, const TValue* p2, StkId res, TMS event)
 {
     const TValue* tm = luaT_gettmbyobj(L, p1, event); // try first operand
@@ -362,6 +421,86 @@ void luaV_concat(lua_State* L, int total, int last)
     } while (total > 1); // repeat until only 1 result left
 }
 
+// string accumulators start with room for this many bytes and double the capacity when it runs out, so appends take amortized linear time
+#define MIN_ACCUMULATOR_SIZE 64
+
+void luaV_concatacc(lua_State* L, int a, int b, int c, int acc)
+{
+    StkId base = L->base;
+    StkId ra = base + a;
+    StkId racc = base + acc;
+
+    bool active = ttisbuffer(racc);
+
+    // numbers are only converted once all values are known to be strings or numbers, so that __concat receives them unchanged
+    bool append = active || ttisstring(ra);
+
+    for (int i = b + 1; i <= c && append; i++)
+        append = ttisstring(base + i) || ttisnumber(base + i);
+
+    if (append)
+    {
+        size_t len = active ? size_t(nvalue(racc + 1)) : tsvalue(ra)->len;
+        size_t tl = len;
+
+        for (int i = b + 1; i <= c; i++)
+        {
+            (void)tostring(L, base + i);
+
+            size_t l = tsvalue(base + i)->len;
+            if (l > MAXSSIZE - tl)
+                luaG_runerror(L, "string length overflow");
+            tl += l;
+        }
+
+        Buffer* buf = active ? bufvalue(racc) : NULL;
+
+        if (!buf || tl > buf->len)
+        {
+            size_t size = tl < MAX_BUFFER_SIZE / 2 ? tl * 2 : MAX_BUFFER_SIZE;
+            if (size < MIN_ACCUMULATOR_SIZE)
+                size = MIN_ACCUMULATOR_SIZE;
+
+            Buffer* nb = luaB_newbuffer(L, size);
+            memcpy(nb->data, buf ? buf->data : svalue(ra), len);
+            setbufvalue(L, racc, nb);
+            buf = nb;
+        }
+
+        for (int i = b + 1; i <= c; i++)
+        {
+            size_t l = tsvalue(base + i)->len;
+            memcpy(buf->data + len, svalue(base + i), l);
+            len += l;
+        }
+
+        setnvalue(racc + 1, double(len));
+        return;
+    }
+
+    // metamethods and errors need the actual string, so it's materialized and the rest is handled like CONCAT
+    luaV_flushacc(L, a, acc);
+
+    setobjs2s(L, base + b, base + a);
+    luaV_concat(L, c - b + 1, c);
+
+    base = L->base;
+    setobjs2s(L, base + a, base + b);
+}
+
+void luaV_flushacc(lua_State* L, int a, int acc)
+{
+    StkId racc = L->base + acc;
+
+    if (ttisbuffer(racc))
+    {
+        TString* ts = luaS_newlstr(L, bufvalue(racc)->data, size_t(nvalue(racc + 1)));
+
+        setsvalue2s(L, L->base + a, ts);
+        setnilvalue(racc);
+    }
+}
+
 void luaV_doarith(lua_State* L, StkId ra, const TValue* rb, const TValue* rc, TMS op)
 {
     TValue tempb, tempc;
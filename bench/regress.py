@@ -0,0 +1,346 @@
+#!/usr/bin/python
+# This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+import argparse
+import json
+import math
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+from color import colored, Color
+from tabulate import TablePrinter, Alignment
+
+scriptdir = os.path.dirname(os.path.realpath(__file__))
+defaultFolders = [os.path.join(scriptdir, folder) for folder in ['tests', 'micro_tests', 'gc']]
+
+argumentParser = argparse.ArgumentParser(description='Compare benchmark timings of two Luau executables and detect statistically significant regressions')
+
+argumentParser.add_argument('--baseline', dest='baseline', required=True, help='Lua executable to compare against')
+argumentParser.add_argument('--candidate', dest='candidate', required=True, help='Lua executable with the changes to evaluate')
+argumentParser.add_argument('--folder', dest='folders', action='append', help='Folder with tests; can be repeated (tests, micro_tests and gc by default)')
+argumentParser.add_argument('--run-test', action='store', default=None, help='Regex test filter')
+argumentParser.add_argument('--rounds', action='store', type=int, default=10, help='Number of interleaved runs of each executable per test (each run performs multiple iterations)')
+argumentParser.add_argument('--cpu', action='store', type=int, default=0, help='CPU to pin the benchmarks to, -1 to disable pinning')
+argumentParser.add_argument('--alpha', action='store', type=float, default=0.01, help='Significance level of the Mann-Whitney U test')
+argumentParser.add_argument('--threshold', action='store', type=float, default=1.0, help='Minimal change of the median in percent to report a regression or an improvement')
+argumentParser.add_argument('--counters', dest='counters', action='store_true', help='Collect instruction and cycle counts with perf (Linux only)')
+argumentParser.add_argument('--json', dest='json', help='Write verdicts and samples to a JSON file')
+argumentParser.add_argument('--markdown', dest='markdown', help='Write the summary table to a markdown file')
+argumentParser.add_argument('--show-commands', dest='show_commands', action='store_true', help='Show the command line used to launch the VM and tests')
+
+perfEvents = ['instructions:u', 'cycles:u']
+
+def getExtraArguments(filepath):
+    try:
+        with open(filepath) as f:
+            for i in f.readlines():
+                pos = i.find("--bench-args:")
+                if pos != -1:
+                    return i[pos + 13:].strip()
+    except:
+        pass
+
+    return ""
+
+def substituteArguments(cmd, extra):
+    if cmd.find("@EXTRA") != -1:
+        return cmd.replace("@EXTRA", extra)
+
+    return cmd + " " + extra
+
+def pinToCpu():
+    # runs in the child between fork and exec, so the shell and everything it launches inherit the affinity
+    try:
+        os.sched_setaffinity(0, { arguments.cpu })
+    except OSError:
+        pass
+
+def getPreexecFn():
+    # preexec_fn isn't supported on Windows, which doesn't have sched_setaffinity either
+    if arguments.cpu >= 0 and hasattr(os, "sched_setaffinity"):
+        return pinToCpu
+
+    return None
+
+def readPerfOutput(path):
+    counters = {}
+
+    with open(path) as f:
+        for line in f.readlines():
+            # perf stat -x, prints value,unit,event,...
+            fields = line.strip().split(',')
+
+            if len(fields) >= 3 and fields[0].isdigit():
+                counters[fields[2].split(':')[0]] = int(fields[0])
+
+    return counters
+
+def runVm(vm, filepath):
+    cmd = substituteArguments(vm, getExtraArguments(filepath)) + " " + filepath
+    perfPath = None
+
+    if arguments.counters:
+        perfFile, perfPath = tempfile.mkstemp(suffix=".perf")
+        os.close(perfFile)
+        cmd = "perf stat -x, -o " + perfPath + " -e " + ",".join(perfEvents) + " " + cmd
+
+    if arguments.show_commands:
+        print(f'{colored(Color.BLUE, "EXECUTING")}: {cmd}')
+
+    with subprocess.Popen(cmd, shell=True, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True, cwd=scriptdir, preexec_fn=getPreexecFn()) as p:
+        output = p.communicate()[0]
+
+    counters = {}
+
+    if perfPath:
+        counters = readPerfOutput(perfPath)
+        os.unlink(perfPath)
+
+    return output, counters
+
+def extractSamples(output):
+    # bench_support prints |><|name|><|time|><|time...||_|| for each benchmark in the file
+    results = {}
+
+    for el in output.split("||_||")[:-1]:
+        elements = el.split("|><|")[1:]
+
+        if len(elements) > 1:
+            results[elements[0]] = [float(v) for v in elements[1:]]
+
+    return results
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+
+    return values[mid] if len(values) % 2 == 1 else (values[mid - 1] + values[mid]) / 2
+
+def mannWhitney(a, b):
+    # two-sided Mann-Whitney U test with normal approximation and tie correction
+    n1 = len(a)
+    n2 = len(b)
+
+    combined = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    ranks = [0.0] * len(combined)
+    tieTerm = 0.0
+
+    i = 0
+    while i < len(combined):
+        j = i
+
+        while j + 1 < len(combined) and combined[j + 1][0] == combined[i][0]:
+            j += 1
+
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+
+        ties = j - i + 1
+        tieTerm += ties ** 3 - ties
+        i = j + 1
+
+    rankSumA = sum(rank for rank, (v, group) in zip(ranks, combined) if group == 0)
+    u = rankSumA - n1 * (n1 + 1) / 2
+
+    n = n1 + n2
+    sigma = math.sqrt(n1 * n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1))))
+
+    if sigma == 0:
+        return u, 1.0
+
+    z = (abs(u - n1 * n2 / 2) - 0.5) / sigma
+
+    return u, min(1.0, math.erfc(max(z, 0) / math.sqrt(2)))
+
+def medianRatioInterval(a, b, iterations=2000):
+    # 95% bootstrap confidence interval of median(b) / median(a)
+    rng = random.Random(42)
+    ratios = []
+
+    for _ in range(iterations):
+        ma = median([rng.choice(a) for _ in a])
+        mb = median([rng.choice(b) for _ in b])
+        ratios.append(mb / ma if ma > 0 else 1.0)
+
+    ratios.sort()
+
+    return ratios[int(iterations * 0.025)], ratios[int(iterations * 0.975) - 1]
+
+def analyze(name, baseline, candidate):
+    result = { 'name': name, 'baseline': baseline, 'candidate': candidate }
+
+    if len(baseline) < 2 or len(candidate) < 2:
+        result['verdict'] = 'failed'
+        return result
+
+    baselineMedian = median(baseline)
+    candidateMedian = median(candidate)
+
+    change = (candidateMedian / baselineMedian - 1) * 100 if baselineMedian > 0 else 0
+    low, high = medianRatioInterval(baseline, candidate)
+    u, p = mannWhitney(baseline, candidate)
+
+    if p < arguments.alpha and abs(change) >= arguments.threshold:
+        verdict = 'regression' if change > 0 else 'improvement'
+    else:
+        verdict = 'unchanged'
+
+    result.update({
+        'baselineMedian': baselineMedian,
+        'candidateMedian': candidateMedian,
+        'change': change,
+        'changeLow': (low - 1) * 100,
+        'changeHigh': (high - 1) * 100,
+        'u': u,
+        'p': p,
+        'verdict': verdict,
+    })
+
+    return result
+
+def runTest(filepath, results):
+    baselineSamples = {}
+    candidateSamples = {}
+    baselineCounters = {}
+    candidateCounters = {}
+
+    # iterations within a run aren't independent, so every run contributes a single sample: the median of its iterations
+    def collect(vm, samples, counters):
+        output, runCounters = runVm(vm, filepath)
+
+        for name, values in extractSamples(output).items():
+            samples.setdefault(name, []).append(median(values))
+
+        for event, value in runCounters.items():
+            counters.setdefault(event, []).append(value)
+
+    # interleave the runs, alternating which executable goes first, so that drift in machine state affects both equally
+    for i in range(arguments.rounds):
+        if i % 2 == 0:
+            collect(arguments.baseline, baselineSamples, baselineCounters)
+            collect(arguments.candidate, candidateSamples, candidateCounters)
+        else:
+            collect(arguments.candidate, candidateSamples, candidateCounters)
+            collect(arguments.baseline, baselineSamples, baselineCounters)
+
+    names = list(baselineSamples.keys()) + [name for name in candidateSamples.keys() if name not in baselineSamples]
+
+    if len(names) == 0:
+        print(colored(Color.RED, 'FAILED') + ": '" + filepath + "'")
+        results.append(analyze(os.path.basename(filepath)[:-4], [], []))
+        return
+
+    for name in names:
+        result = analyze(name, baselineSamples.get(name, []), candidateSamples.get(name, []))
+        result['file'] = os.path.relpath(filepath, scriptdir)
+
+        # counters are collected per process, so they are only attributed to files with a single benchmark
+        if len(names) == 1 and baselineCounters and candidateCounters:
+            result['counters'] = {}
+
+            for event in baselineCounters:
+                if event in candidateCounters:
+                    base = median(baselineCounters[event])
+                    cand = median(candidateCounters[event])
+                    result['counters'][event] = { 'baseline': base, 'candidate': cand, 'change': (cand / base - 1) * 100 if base > 0 else 0 }
+
+        results.append(result)
+
+        verdictColor = { 'regression': Color.RED, 'improvement': Color.GREEN }.get(result['verdict'], Color.YELLOW)
+
+        if result['verdict'] == 'failed':
+            print(colored(Color.RED, 'FAILED') + ': {:<40}'.format(name))
+        else:
+            print(colored(verdictColor, '{:<11}'.format(result['verdict'].upper())) + ': {:<40}'.format(name) + ": " +
+                '{:+7.2f}% [{:+.2f}%, {:+.2f}%] p={:.4f}'.format(result['change'], result['changeLow'], result['changeHigh'], result['p']))
+
+def formatRow(result):
+    if result['verdict'] == 'failed':
+        return [result['name'], '', '', '', '', '', 'failed']
+
+    instructions = ''
+
+    if 'counters' in result and 'instructions' in result['counters']:
+        instructions = '{:+.2f}%'.format(result['counters']['instructions']['change'])
+
+    return [
+        result['name'],
+        '{:.3f}ms'.format(result['baselineMedian']),
+        '{:.3f}ms'.format(result['candidateMedian']),
+        '{:+.2f}% [{:+.2f}%, {:+.2f}%]'.format(result['change'], result['changeLow'], result['changeHigh']),
+        '{:.4f}'.format(result['p']),
+        instructions,
+        result['verdict'],
+    ]
+
+columns = ['Test', 'Baseline', 'Candidate', 'Change (95% CI)', 'p', 'Instructions', 'Verdict']
+
+def writeMarkdown(path, results):
+    with open(path, 'w') as f:
+        f.write('| ' + ' | '.join(columns) + ' |\n')
+        f.write('|' + '|'.join(['---'] * len(columns)) + '|\n')
+
+        for result in results:
+            f.write('| ' + ' | '.join(formatRow(result)) + ' |\n')
+
+def getVmPath(vm):
+    # tests run from the bench folder, so relative paths to executables are resolved before that
+    executable, sep, rest = vm.partition(" ")
+
+    if os.path.isfile(executable):
+        return os.path.abspath(executable) + sep + rest
+
+    return vm
+
+def main():
+    global arguments
+    arguments = argumentParser.parse_args()
+    arguments.baseline = getVmPath(arguments.baseline)
+    arguments.candidate = getVmPath(arguments.candidate)
+
+    if arguments.counters and not shutil.which("perf"):
+        print("Warning: perf is not available, hardware counters will not be collected")
+        arguments.counters = False
+
+    folders = arguments.folders or defaultFolders
+    results = []
+
+    for folder in folders:
+        allFiles = [subdir + os.sep + filename for subdir, dirs, files in os.walk(folder) for filename in files]
+
+        for filepath in sorted(allFiles):
+            filename = os.path.basename(filepath)
+
+            if filename.endswith(".lua") and (arguments.run_test == None or re.match(arguments.run_test, filename[:-4])):
+                runTest(os.path.abspath(filepath), results)
+
+    resultPrinter = TablePrinter([{'label': label, 'align': Alignment.LEFT if label in ('Test', 'Verdict') else Alignment.RIGHT} for label in columns])
+
+    for result in results:
+        resultPrinter.add_row(dict(zip(columns, formatRow(result))))
+
+    print()
+    resultPrinter.print(summary=False)
+
+    if arguments.markdown:
+        writeMarkdown(arguments.markdown, results)
+
+    if arguments.json:
+        with open(arguments.json, 'w') as f:
+            json.dump({ 'baseline': arguments.baseline, 'candidate': arguments.candidate, 'alpha': arguments.alpha,
+                'threshold': arguments.threshold, 'results': results }, f, indent=2)
+
+    regressions = [result['name'] for result in results if result['verdict'] in ('regression', 'failed')]
+
+    if regressions:
+        print(colored(Color.RED, 'REGRESSED') + ': ' + ', '.join(regressions))
+        return 1
+
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
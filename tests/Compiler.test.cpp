@@ -1,12 +1,16 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #include "Luau/Compiler.h"
 #include "Luau/BytecodeBuilder.h"
+#include "Luau/Parser.h"
+#include "Luau/RequireTracer.h"
 #include "Luau/StringUtils.h"
 
 #include "ScopedFlags.h"
 
 #include "doctest.h"
 
+#include <map>
+#include <memory>
 #include <sstream>
 #include <string_view>
 
@@ -17,12 +21,13 @@ std::string rep(const std::string& s, size_t n);
 
 using namespace Luau;
 
-static std::string compileFunction(const char* source, uint32_t id, int optimizationLevel = 1)
+static std::string compileFunction(const char* source, uint32_t id, int optimizationLevel = 1, int debugLevel = 1)
 {
     Luau::BytecodeBuilder bcb;
     bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
     Luau::CompileOptions options;
     options.optimizationLevel = optimizationLevel;
+    options.debugLevel = debugLevel;
     Luau::compileOrThrow(bcb, source, options);
 
     return bcb.dumpFunction(id);
@@ -4742,9 +4747,8 @@ LOADN R0 3
 LOADN R1 1
 FORNPREP R0 L1
 L0: MOVE R3 R2
-LOADN R3 3
+LOADN R5 3
 GETIMPORT R4 1
-MOVE R5 R3
 CALL R4 1 0
 FORNLOOP R0 L0
 L1: RETURN R0 0
@@ -4970,8 +4974,7 @@ return x
 )",
                         1, 2),
         R"(
-DUPCLOSURE R0 K0
-MOVE R1 R0
+DUPCLOSURE R1 K0
 CALL R1 0 1
 RETURN R1 1
 )");
@@ -5071,8 +5074,7 @@ return x
         R"(
 DUPCLOSURE R0 K0
 LOADN R2 42
-ORK R2 R2 K1
-MOVE R1 R2
+ORK R1 R2 K1
 RETURN R1 1
 )");
 
@@ -5111,7 +5113,7 @@ DUPCLOSURE R0 K0
 GETVARARGS R1 1
 LOADNIL R1
 MOVE R3 R1
-MOVE R2 R3
+MOVE R2 R1
 RETURN R2 1
 )");
 
@@ -5128,9 +5130,7 @@ return x
 )",
                         1, 2),
         R"(
-DUPCLOSURE R0 K0
-MOVE R0 R0
-MOVE R1 R0
+DUPCLOSURE R1 K0
 LOADN R2 42
 CALL R1 1 1
 RETURN R1 1
@@ -5154,8 +5154,7 @@ end
 )",
                         1, 2),
         R"(
-GETUPVAL R1 0
-MOVE R0 R1
+GETUPVAL R0 0
 RETURN R0 1
 )");
 
@@ -5257,8 +5256,7 @@ return y
         R"(
 DUPCLOSURE R0 K0
 LOADNIL R1
-LOADN R1 42
-MOVE R3 R1
+LOADN R3 42
 NEWCLOSURE R2 P1
 CAPTURE VAL R3
 RETURN R2 1
@@ -5390,8 +5388,7 @@ return foo()
 )",
                         1, 2),
         R"(
-DUPCLOSURE R0 K0
-MOVE R1 R0
+DUPCLOSURE R1 K0
 CALL R1 0 -1
 RETURN R1 -1
 )");
@@ -5486,8 +5483,7 @@ return x
         R"(
 DUPCLOSURE R0 K0
 LOADNIL R2
-LOADN R2 42
-MOVE R1 R2
+LOADN R1 42
 RETURN R1 1
 )");
 }
@@ -5568,8 +5564,7 @@ return (foo())
 )",
                         1, 2),
         R"(
-DUPCLOSURE R0 K0
-MOVE R1 R0
+DUPCLOSURE R1 K0
 CALL R1 0 1
 RETURN R1 1
 )");
@@ -5584,8 +5579,7 @@ return (foo())
 )",
                         1, 2),
         R"(
-DUPCLOSURE R0 K0
-MOVE R1 R0
+DUPCLOSURE R1 K0
 CALL R1 0 1
 RETURN R1 1
 )");
@@ -5789,8 +5783,7 @@ return y
 DUPCLOSURE R0 K0
 GETVARARGS R1 1
 MOVE R3 R1
-LOADN R3 42
-MOVE R2 R3
+LOADN R2 42
 RETURN R2 1
 )");
 
@@ -5814,10 +5807,9 @@ GETVARARGS R1 1
 NEWCLOSURE R2 P1
 CAPTURE REF R1
 SETGLOBAL R2 K1
-MOVE R3 R1
+MOVE R2 R1
 GETGLOBAL R4 K1
 CALL R4 0 0
-MOVE R2 R3
 CLOSEUPVALS R1
 RETURN R2 1
 )");
@@ -5835,8 +5827,7 @@ return foo(42)
 )",
                         1, 2),
         R"(
-DUPCLOSURE R0 K0
-MOVE R1 R0
+DUPCLOSURE R1 K0
 LOADN R2 42
 CALL R1 1 -1
 RETURN R1 -1
@@ -5905,8 +5896,7 @@ return foo(42)
 )",
                         1, 2),
         R"(
-DUPCLOSURE R0 K0
-MOVE R1 R0
+DUPCLOSURE R1 K0
 LOADN R2 42
 CALL R1 1 -1
 RETURN R1 -1
@@ -6671,4 +6661,725 @@ L0: RETURN R1 -1
 )");
 }
 
+TEST_CASE("RegisterOptimization")
+{
+    const char* source = R"(
+local a, b = ...
+local c
+c = a + b
+local d = c
+local e = d.x
+a, b = nil
+while e.next do
+    local n = e.next
+    e = n
+end
+return e, print, print
+)";
+
+    // copies are propagated into their uses, temporaries are merged into the registers they are moved to and repeated imports are reused
+    CHECK_EQ("\n" + compileFunction(source, 0, 2), R"(
+GETVARARGS R0 2
+LOADNIL R2
+ADD R2 R0 R1
+MOVE R3 R2
+GETTABLEKS R4 R2 K0
+LOADNIL R0
+LOADNIL R1
+L0: GETTABLEKS R5 R4 K1
+JUMPIFNOT R5 L1
+GETTABLEKS R4 R4 K1
+JUMPBACK L0
+L1: MOVE R5 R4
+GETIMPORT R6 3
+MOVE R7 R6
+RETURN R5 3
+)");
+
+    // registers of locals must stay intact when debug info describes them
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+
+    Luau::CompileOptions options;
+    options.optimizationLevel = 2;
+    options.debugLevel = 2;
+    Luau::compileOrThrow(bcb, source, options);
+
+    CHECK_EQ(bcb.dumpFunction(0), compileFunction(source, 0, 1));
+}
+
+TEST_CASE("LoopInvariantFields")
+{
+    // fields of local tables that aren't modified in the loop are loaded once before the loop; imports are loaded on every iteration
+    CHECK_EQ("\n" + compileFunction(R"(
+local t = {scale = 2}
+local s = 0
+for i = 1, 10 do
+    s += t.scale * i + t["scale"] + math.abs(i)
+    print(s, t[1])
+end
+return s
+)",
+                        0, 2),
+        R"(
+DUPTABLE R0 1
+LOADN R1 2
+SETTABLEKS R1 R0 K0
+LOADN R1 0
+GETTABLEKS R2 R0 K0
+GETTABLEN R3 R0 1
+LOADN R6 1
+LOADN R4 10
+LOADN R5 1
+FORNPREP R4 L2
+L0: MUL R9 R2 R6
+ADD R8 R9 R2
+FASTCALL1 2 R6 L1
+MOVE R10 R6
+GETIMPORT R9 4
+CALL R9 1 1
+L1: ADD R7 R8 R9
+ADD R1 R1 R7
+GETIMPORT R7 6
+MOVE R8 R1
+MOVE R9 R3
+CALL R7 2 0
+FORNLOOP R4 L0
+L2: RETURN R1 1
+)");
+
+    // loops aren't changed at lower optimization levels
+    CHECK_EQ("\n" + compileFunction(R"(
+local t = {scale = 2}
+local s = 0
+while s < 10 do
+    s += t.scale
+    print(s)
+end
+)",
+                        0, 1),
+        R"(
+DUPTABLE R0 1
+LOADN R1 2
+SETTABLEKS R1 R0 K0
+LOADN R1 0
+L0: LOADN R2 10
+JUMPIFNOTLT R1 R2 L1
+GETTABLEKS R2 R0 K0
+ADD R1 R1 R2
+GETIMPORT R2 3
+MOVE R3 R1
+CALL R2 1 0
+JUMPBACK L0
+L1: RETURN R0 0
+)");
+}
+
+TEST_CASE("LoopInvariantFieldsModified")
+{
+    // table fields are only hoisted when nothing in the loop can modify the table:
+    // a is modified in the loop, b escapes through a closure, c escapes through a call, e is a new table on every iteration
+    // debug level 2 keeps a, d and e from being replaced with registers
+    CHECK_EQ("\n" + compileFunction(R"(
+local a = {x = 1}
+local b = {x = 1}
+local c = {x = 1}
+local d = {x = 1}
+local function f() return b end
+d.x = 2
+local s = 0
+for i = 1, 10 do
+    a.x = i
+    s += a.x + b.x + c.x + d.x
+    local e = {x = i}
+    s += e.x
+    setmetatable(c, {})
+end
+return s
+)",
+                        1, 2, 2),
+        R"(
+DUPTABLE R0 1
+LOADN R1 1
+SETTABLEKS R1 R0 K0
+DUPTABLE R1 1
+LOADN R2 1
+SETTABLEKS R2 R1 K0
+DUPTABLE R2 1
+LOADN R3 1
+SETTABLEKS R3 R2 K0
+DUPTABLE R3 1
+LOADN R4 1
+SETTABLEKS R4 R3 K0
+DUPCLOSURE R4 K2
+CAPTURE VAL R1
+LOADN R5 2
+SETTABLEKS R5 R3 K0
+LOADN R5 0
+GETTABLEKS R6 R3 K0
+LOADN R9 1
+LOADN R7 10
+LOADN R8 1
+FORNPREP R7 L1
+L0: SETTABLEKS R9 R0 K0
+GETTABLEKS R13 R0 K0
+GETTABLEKS R14 R1 K0
+ADD R12 R13 R14
+GETTABLEKS R13 R2 K0
+ADD R11 R12 R13
+ADD R10 R11 R6
+ADD R5 R5 R10
+DUPTABLE R10 1
+SETTABLEKS R9 R10 K0
+GETTABLEKS R11 R10 K0
+ADD R5 R5 R11
+GETIMPORT R11 4
+MOVE R12 R2
+NEWTABLE R13 0 0
+CALL R11 2 0
+FORNLOOP R7 L0
+L1: RETURN R5 1
+)");
+
+    // stores from other functions can happen during any call, even when the call is inlined
+    CHECK_EQ("\n" + compileFunction(R"(
+local t = {n = 1}
+local function update() t.n += 1 end
+local s = 0
+while s < 10 do
+    update()
+    s += t.n
+end
+return s
+)",
+                        1, 2),
+        R"(
+DUPTABLE R0 1
+LOADN R1 1
+SETTABLEKS R1 R0 K0
+DUPCLOSURE R1 K2
+CAPTURE VAL R0
+LOADN R2 0
+L0: LOADN R3 10
+JUMPIFNOTLT R2 R3 L1
+GETTABLEKS R3 R0 K0
+ADDK R3 R3 K3
+SETTABLEKS R3 R0 K0
+GETTABLEKS R3 R0 K0
+ADD R2 R2 R3
+JUMPBACK L0
+L1: RETURN R2 1
+)");
+    // methods receive the table and can modify it
+    CHECK_EQ("\n" + compileFunction(R"(
+local t = {x = 0}
+function t.inc(self) self.x += 1 end
+local s = 0
+while s < 10 do
+    s += t.x
+    t:inc()
+end
+return s
+)",
+                        1, 2),
+        R"(
+DUPTABLE R0 1
+LOADN R1 0
+SETTABLEKS R1 R0 K0
+DUPCLOSURE R1 K2
+SETTABLEKS R1 R0 K3
+LOADN R1 0
+L0: LOADN R2 10
+JUMPIFNOTLT R1 R2 L1
+GETTABLEKS R2 R0 K0
+ADD R1 R1 R2
+NAMECALL R2 R0 K3
+CALL R2 1 0
+JUMPBACK L0
+L1: RETURN R1 1
+)");
+}
+
+TEST_CASE("ScalarReplacement")
+{
+    // tables that don't escape keep their fields in registers
+    CHECK_EQ("\n" + compileFunction(R"(
+local function f(a, b)
+    local p = {x = a, y = b}
+    p.x += 1
+    return p.x * p.y
+end
+)",
+                        0, 2),
+        R"(
+MOVE R2 R0
+MOVE R3 R1
+ADDK R2 R0 K0
+MUL R4 R2 R1
+RETURN R4 1
+)");
+
+    // this includes parameters of inlined functions that receive a new table
+    CHECK_EQ("\n" + compileFunction(R"(
+local function len(v) return v.x * v.x + v.y * v.y end
+local function f(a, b)
+    return len({x = a, y = b})
+end
+)",
+                        1, 2),
+        R"(
+MOVE R3 R0
+MOVE R4 R1
+MUL R5 R0 R0
+MUL R6 R1 R1
+ADD R2 R5 R6
+RETURN R2 1
+)");
+
+    // q escapes through a call and r escapes through a closure
+    CHECK_EQ("\n" + compileFunction(R"(
+local function f(a, b)
+    local p = {x = a, y = b}
+    local q = {x = a}
+    local r = {x = a}
+    local function g() return r.x end
+    print(q)
+    return p.x, q.x, g()
+end
+)",
+                        1, 2),
+        R"(
+MOVE R2 R0
+DUPTABLE R3 1
+SETTABLEKS R0 R3 K0
+DUPTABLE R4 1
+SETTABLEKS R0 R4 K0
+NEWCLOSURE R5 P0
+CAPTURE VAL R4
+GETIMPORT R6 3
+MOVE R7 R3
+CALL R6 1 0
+MOVE R6 R0
+GETTABLEKS R7 R3 K0
+GETTABLEKS R8 R4 K0
+RETURN R6 3
+)");
+
+    // debug level 2 keeps all tables so that debuggers can inspect them
+    CHECK_EQ("\n" + compileFunction(R"(
+local function f(a)
+    local p = {x = a}
+    return p.x
+end
+)",
+                        0, 2, 2),
+        R"(
+DUPTABLE R1 1
+SETTABLEKS R0 R1 K0
+GETTABLEKS R2 R1 K0
+RETURN R2 1
+)");
+}
+
+TEST_CASE("TypeInfoParameters")
+{
+    const char* source = R"(
+type Point = {x: number, y: number}
+type Id = Point
+
+local function f(a: number, b: string?, c: Point, d: Id, e: number | string, f, g: (number) -> number, h: boolean | nil)
+    return a + 1
+end
+
+local function g(a: number, b: number)
+    a += b
+    return a
+end
+
+local T = {}
+
+function T:m(x: number)
+    return x
+end
+)";
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code | Luau::BytecodeBuilder::Dump_Types);
+
+    Luau::CompileOptions options;
+    options.typeInfoLevel = 1;
+
+    Luau::compileOrThrow(bcb, source, options);
+
+    CHECK_EQ("\n" + bcb.dumpFunction(0), R"(
+function(number, string?, table, any, any, any, function, boolean?)
+ADDK R8 R0 K0
+RETURN R8 1
+)");
+
+    // parameters that are assigned to may hold values of other types later in the function
+    CHECK_EQ("\n" + bcb.dumpFunction(1), R"(
+function(any, number)
+ADD R0 R0 R1
+RETURN R0 1
+)");
+
+    CHECK_EQ("\n" + bcb.dumpFunction(2), R"(
+function(any, number)
+RETURN R1 1
+)");
+
+    // type information is only emitted on request
+    CHECK_EQ("\n" + compileFunction(source, 1), R"(
+ADD R0 R0 R1
+RETURN R0 1
+)");
+}
+
+TEST_CASE("ProfileGuidedInlining")
+{
+    const char* source = R"(
+local function foo(a, b)
+    local c = a * b + a - b * a + a / b
+    local d = c * c - b + c * a - c / b + a * c
+    local e = d * d - c + d * a - d / b + b * c
+    return d * 2 + c * d - a * b + c / d - e * b + e * a
+end
+
+local x = foo(...)
+local y = foo(...)
+local z = foo(...)
+for i = 1, 50 do x += i end
+return x, y, z
+)";
+
+    // line 9 has no profile data, line 10 never ran, and line 11 and the loop on line 12 are the hottest lines
+    int lineHits[] = {-1, 1, -1, -1, -1, -1, -1, -1, 1, -1, 0, 1000, 1000};
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Remarks | Luau::BytecodeBuilder::Dump_Code);
+
+    Luau::CompileOptions options;
+    options.optimizationLevel = 2;
+    options.lineHits = lineHits;
+    options.lineHitsCount = int(sizeof(lineHits) / sizeof(lineHits[0]));
+
+    Luau::compileOrThrow(bcb, source, options);
+
+    std::string result = bcb.dumpFunction(1);
+    std::string remarks;
+
+    for (size_t pos = result.find("REMARK"); pos != std::string::npos; pos = result.find("REMARK", pos + 1))
+        remarks += result.substr(pos, result.find('\n', pos) - pos + 1);
+
+    // the call without profile data uses the default budget that foo doesn't fit in
+    CHECK_EQ("\n" + remarks, R"(
+REMARK inlining failed: too expensive (cost 33, profit 1.09x)
+REMARK inlining failed: call site is cold
+REMARK inlining succeeded (cost 33, profit 1.09x, depth 0)
+REMARK loop unroll succeeded (iterations 50, cost 50, profit 2.00x)
+)");
+}
+
+TEST_CASE("FusedInstructions")
+{
+    const char* source = R"(
+local a, b, c = ...
+local t = {}
+local x = t[a] + t[b] * t[c]
+print(x, a)
+return t[a + 1], b * c + a
+)";
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+
+    Luau::CompileOptions options;
+    options.bytecodeVersion = 5;
+
+    Luau::compileOrThrow(bcb, source, options);
+
+    CHECK_EQ("\n" + bcb.dumpFunction(0), R"(
+GETVARARGS R0 3
+NEWTABLE R3 0 0
+GETTABLE_GETTABLE R5 R3 R0
+GETTABLE_GETTABLE R7 R3 R1
+GETTABLE R8 R3 R2
+MUL_ADD R6 R7 R8
+ADD R4 R5 R6
+GETIMPORT R5 1
+MOVE_MOVE R6 R4
+MOVE_CALL R7 R0
+CALL R5 2 0
+ADDK_GETTABLE R6 R0 K2
+GETTABLE R5 R3 R6
+MUL_ADD R7 R1 R2
+ADD R6 R7 R0
+RETURN R5 2
+)");
+
+    // fused instructions are only emitted for version 5
+    CHECK_EQ("\n" + compileFunction0(source), R"(
+GETVARARGS R0 3
+NEWTABLE R3 0 0
+GETTABLE R5 R3 R0
+GETTABLE R7 R3 R1
+GETTABLE R8 R3 R2
+MUL R6 R7 R8
+ADD R4 R5 R6
+GETIMPORT R5 1
+MOVE R6 R4
+MOVE R7 R0
+CALL R5 2 0
+ADDK R6 R0 K2
+GETTABLE R5 R3 R6
+MUL R7 R1 R2
+ADD R6 R7 R0
+RETURN R5 2
+)");
+}
+
+TEST_CASE("StringAccumulators")
+{
+    const char* source = R"(
+local n, sep = ...
+local s, t = "", ""
+for i = 1, n do
+    s = s .. i .. sep
+    for j = 1, i do
+        t ..= j
+    end
+    if #t > 100 then break end
+end
+local u = ""
+while #u < n do
+    u ..= "x"
+end
+return s, t, u
+)";
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+
+    Luau::CompileOptions options;
+    options.optimizationLevel = 2;
+    options.bytecodeVersion = 6;
+
+    Luau::compileOrThrow(bcb, source, options);
+
+    // t is read by the outer loop, so only the inner loop builds it in a buffer; u is read by the condition
+    CHECK_EQ("\n" + bcb.dumpFunction(0), R"(
+GETVARARGS R0 2
+LOADK R2 K0
+LOADK R3 K0
+LOADNIL R4
+LOADN R8 1
+MOVE R6 R0
+LOADN R7 1
+FORNPREP R6 L3
+L0: MOVE_MOVE R10 R8
+MOVE R11 R1
+CONCATACC R2 R9 R11 R4
+LOADNIL R9
+LOADN R13 1
+MOVE R11 R8
+LOADN R12 1
+FORNPREP R11 L2
+L1: MOVE R15 R13
+CONCATACC R3 R14 R15 R9
+FORNLOOP R11 L1
+L2: FLUSHACC R3 R9
+LENGTH R9 R3
+LOADN R10 100
+JUMPIFLT R10 R9 L3
+FORNLOOP R6 L0
+L3: FLUSHACC R2 R4
+LOADK R4 K0
+L4: LENGTH R5 R4
+JUMPIFNOTLT R5 R0 L5
+MOVE R5 R4
+LOADK R6 K1
+CONCAT R4 R5 R6
+JUMPBACK L4
+L5: RETURN R2 3
+)");
+
+    // accumulators are only used for version 6
+    options.bytecodeVersion = 5;
+
+    Luau::BytecodeBuilder bcb5;
+    bcb5.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+
+    Luau::compileOrThrow(bcb5, source, options);
+
+    CHECK(bcb5.dumpFunction(0).find("CONCATACC") == std::string::npos);
+}
+
+TEST_CASE("RequiredModuleInlining")
+{
+    struct Resolver : Luau::FileResolver
+    {
+        std::optional<Luau::SourceCode> readSource(const Luau::ModuleName& name) override
+        {
+            return std::nullopt;
+        }
+
+        std::optional<Luau::ModuleInfo> resolveModule(const Luau::ModuleInfo* context, Luau::AstExpr* expr) override
+        {
+            if (Luau::AstExprConstantString* str = expr->as<Luau::AstExprConstantString>())
+                return Luau::ModuleInfo{std::string(str->value.data, str->value.size)};
+
+            return std::nullopt;
+        }
+    };
+
+    std::map<std::string, std::string> sources = {
+        {"utils", R"(
+local M = {PI = 3.5}
+local scale = 4
+
+M.SCALE = scale * 2
+M.name = "utils"
+
+function M.clamp(x, lo, hi)
+    return math.max(lo, math.min(x, hi))
+end
+
+function M.scale(x)
+    return x * M.SCALE
+end
+
+return table.freeze(M)
+)"},
+        {"mutable", R"(
+local M = {value = 1}
+
+function M.set(v)
+    M.value = v
+end
+
+return table.freeze(M)
+)"},
+        {"early", R"(
+local M = {x = 1}
+
+if flag then
+    return table.freeze({x = 2})
+end
+
+return table.freeze(M)
+)"},
+    };
+
+    const char* source = R"(
+local utils = require("utils")
+local mutable = require("mutable")
+local early = require("early")
+local a, b = ...
+return utils.PI + utils.SCALE, utils.name, utils.clamp(a, 0, 1), utils.scale(b), mutable.value, early.x
+)";
+
+    Luau::Allocator allocator;
+    Luau::AstNameTable names(allocator);
+    Luau::ParseResult result = Luau::Parser::parse(source, strlen(source), names, allocator);
+    REQUIRE(result.errors.empty());
+
+    Resolver resolver;
+    Luau::RequireTraceResult requires = Luau::traceRequires(&resolver, result.root, "main");
+
+    std::vector<std::unique_ptr<Luau::AstNameTable>> moduleNames;
+    std::vector<Luau::RequiredModule> requiredModules;
+
+    for (const auto& [expr, info] : requires.exprs)
+    {
+        if (const Luau::AstExprCall* call = expr->as<Luau::AstExprCall>())
+        {
+            const std::string& dep = sources[info.name];
+
+            moduleNames.push_back(std::make_unique<Luau::AstNameTable>(allocator));
+
+            Luau::ParseResult module = Luau::Parser::parse(dep.c_str(), dep.size(), *moduleNames.back(), allocator);
+            REQUIRE(module.errors.empty());
+
+            requiredModules.push_back({const_cast<Luau::AstExprCall*>(call), module.root, moduleNames.back().get()});
+        }
+    }
+
+    REQUIRE(requiredModules.size() == 3);
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+
+    Luau::CompileOptions options;
+    options.optimizationLevel = 2;
+
+    Luau::compileOrThrow(bcb, result, names, options, requiredModules);
+
+    CHECK_EQ("\n" + bcb.dumpFunction(0), R"(
+GETIMPORT R0 1
+LOADK R1 K2
+CALL R0 1 1
+GETIMPORT R1 1
+LOADK R2 K3
+CALL R1 1 1
+GETIMPORT R2 1
+LOADK R3 K4
+CALL R2 1 1
+GETVARARGS R3 2
+LOADK R5 K5
+LOADK R6 K2
+LOADN R8 0
+FASTCALL2K 19 R3 K6 L0
+MOVE R10 R3
+LOADK R11 K6
+GETIMPORT R9 9
+CALL R9 2 -1
+L0: FASTCALL 18 L1
+GETIMPORT R7 11
+CALL R7 -1 1
+L1: GETTABLEKS R8 R0 K12
+MOVE R9 R4
+CALL R8 1 1
+GETTABLEKS R9 R1 K13
+GETTABLEKS R10 R2 K14
+RETURN R5 6
+)");
+
+    // exports are only used on optimization level 2
+    Luau::BytecodeBuilder bcb1;
+    bcb1.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+
+    options.optimizationLevel = 1;
+
+    Luau::compileOrThrow(bcb1, result, names, options, requiredModules);
+
+    CHECK_EQ("\n" + bcb1.dumpFunction(0), R"(
+GETIMPORT R0 1
+LOADK R1 K2
+CALL R0 1 1
+GETIMPORT R1 1
+LOADK R2 K3
+CALL R1 1 1
+GETIMPORT R2 1
+LOADK R3 K4
+CALL R2 1 1
+GETVARARGS R3 2
+GETTABLEKS R6 R0 K5
+GETTABLEKS R7 R0 K6
+ADD R5 R6 R7
+GETTABLEKS R6 R0 K7
+GETTABLEKS R7 R0 K8
+MOVE R8 R3
+LOADN R9 0
+LOADN R10 1
+CALL R7 3 1
+GETTABLEKS R8 R0 K9
+MOVE R9 R4
+CALL R8 1 1
+GETTABLEKS R9 R1 K10
+GETTABLEKS R10 R2 K11
+RETURN R5 6
+)");
+}
+
 TEST_SUITE_END();
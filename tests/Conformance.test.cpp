@@ -8,6 +8,8 @@
 #include "Luau/TypeInfer.h"
 #include "Luau/StringUtils.h"
 #include "Luau/BytecodeBuilder.h"
+#include "Luau/Compiler.h"
+#include "Luau/CodeGen.h"
 
 #include "doctest.h"
 #include "ScopedFlags.h"
@@ -18,6 +20,7 @@
 
 extern bool verbose;
 extern int optimizationLevel;
+extern bool codegen;
 
 static lua_CompileOptions defaultOptions()
 {
@@ -30,9 +33,10 @@ static lua_CompileOptions defaultOptions()
 
 static int lua_collectgarbage(lua_State* L)
 {
-    static const char* const opts[] = {"stop", "restart", "collect", "count", "isrunning", "step", "setgoal", "setstepmul", "setstepsize", nullptr};
-    static const int optsnum[] = {
-        LUA_GCSTOP, LUA_GCRESTART, LUA_GCCOLLECT, LUA_GCCOUNT, LUA_GCISRUNNING, LUA_GCSTEP, LUA_GCSETGOAL, LUA_GCSETSTEPMUL, LUA_GCSETSTEPSIZE};
+    static const char* const opts[] = {
+        "stop", "restart", "collect", "count", "isrunning", "step", "setgoal", "setstepmul", "setstepsize", "incremental", "generational", nullptr};
+    static const int optsnum[] = {LUA_GCSTOP, LUA_GCRESTART, LUA_GCCOLLECT, LUA_GCCOUNT, LUA_GCISRUNNING, LUA_GCSTEP, LUA_GCSETGOAL,
+        LUA_GCSETSTEPMUL, LUA_GCSETSTEPSIZE, LUA_GCINC, LUA_GCGEN};
 
     int o = luaL_checkoption(L, 1, "collect", opts);
     int ex = luaL_optinteger(L, 2, 0);
@@ -45,6 +49,12 @@ static int lua_collectgarbage(lua_State* L)
         lua_pushboolean(L, res);
         return 1;
     }
+    case LUA_GCINC:
+    case LUA_GCGEN:
+    {
+        lua_pushstring(L, res == LUA_GCGEN ? "generational" : "incremental");
+        return 1;
+    }
     default:
     {
         lua_pushnumber(L, res);
@@ -136,6 +146,9 @@ int lua_silence(lua_State* L)
 
 using StateRef = std::unique_ptr<lua_State, void (*)(lua_State*)>;
 
+// when set, scripts are loaded with luau_loadlazy so that their functions are decoded on first use
+static bool lazyLoad = false;
+
 static StateRef runConformance(const char* name, void (*setup)(lua_State* L) = nullptr, void (*yield)(lua_State* L) = nullptr,
     lua_State* initialLuaState = nullptr, lua_CompileOptions* options = nullptr)
 {
@@ -156,6 +169,9 @@ static StateRef runConformance(const char* name, void (*setup)(lua_State* L) = n
     StateRef globalState(initialLuaState, lua_close);
     lua_State* L = globalState.get();
 
+    if (codegen && Luau::CodeGen::isSupported())
+        Luau::CodeGen::create(L);
+
     luaL_openlibs(L);
 
     // Register a few global functions for conformance tests
@@ -204,9 +220,13 @@ static StateRef runConformance(const char* name, void (*setup)(lua_State* L) = n
 
     size_t bytecodeSize = 0;
     char* bytecode = luau_compile(source.data(), source.size(), &opts, &bytecodeSize);
-    int result = luau_load(L, chunkname.c_str(), bytecode, bytecodeSize, 0);
+    int result = lazyLoad ? luau_loadlazy(L, chunkname.c_str(), bytecode, bytecodeSize, 0)
+                          : luau_load(L, chunkname.c_str(), bytecode, bytecodeSize, 0);
     free(bytecode);
 
+    if (result == 0 && codegen && Luau::CodeGen::isSupported())
+        Luau::CodeGen::compile(L, -1);
+
     int status = (result == 0) ? lua_resume(L, nullptr, 0) : LUA_ERRSYNTAX;
 
     while (yield && (status == LUA_YIELD || status == LUA_BREAK))
@@ -247,11 +267,41 @@ TEST_CASE("Basic")
     runConformance("basic.lua");
 }
 
+TEST_CASE("CodegenX64")
+{
+    if (!Luau::CodeGen::isSupported())
+        return;
+
+    bool oldCodegen = codegen;
+    codegen = true;
+
+    runConformance("native.lua");
+
+    lua_CompileOptions copts = defaultOptions();
+    copts.typeInfoLevel = 1;
+
+    runConformance("native.lua", nullptr, nullptr, nullptr, &copts);
+
+    codegen = oldCodegen;
+}
+
 TEST_CASE("Math")
 {
     runConformance("math.lua");
 }
 
+TEST_CASE("FusedInstructions")
+{
+    lua_CompileOptions copts = defaultOptions();
+    copts.bytecodeVersion = 5;
+
+    runConformance("basic.lua", nullptr, nullptr, nullptr, &copts);
+    runConformance("math.lua", nullptr, nullptr, nullptr, &copts);
+    runConformance("calls.lua", nullptr, nullptr, nullptr, &copts);
+    runConformance("closure.lua", nullptr, nullptr, nullptr, &copts);
+    runConformance("sort.lua", nullptr, nullptr, nullptr, &copts);
+}
+
 TEST_CASE("Tables")
 {
     runConformance("tables.lua", [](lua_State* L) {
@@ -292,6 +342,28 @@ TEST_CASE("Strings")
     runConformance("strings.lua");
 }
 
+TEST_CASE("StringAccumulators")
+{
+    runConformance("concatacc.lua");
+
+    lua_CompileOptions copts = defaultOptions();
+    copts.optimizationLevel = 2;
+    copts.bytecodeVersion = 6;
+
+    runConformance("concatacc.lua", nullptr, nullptr, nullptr, &copts);
+    runConformance("strings.lua", nullptr, nullptr, nullptr, &copts);
+
+    if (Luau::CodeGen::isSupported())
+    {
+        bool oldCodegen = codegen;
+        codegen = true;
+
+        runConformance("concatacc.lua", nullptr, nullptr, nullptr, &copts);
+
+        codegen = oldCodegen;
+    }
+}
+
 TEST_CASE("StringInterp")
 {
     ScopedFastFlag sffInterpStrings{"LuauInterpolatedStringBaseSupport", true};
@@ -349,11 +421,118 @@ TEST_CASE("GC")
     runConformance("gc.lua");
 }
 
+TEST_CASE("GCGenerational")
+{
+    runConformance("gcgen.lua");
+}
+
+TEST_CASE("InlineCache")
+{
+    runConformance("inlinecache.lua");
+}
+
+TEST_CASE("GCPageCache")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    // allocates enough live tables to fill many pages and then releases all of them
+    auto churn = [](lua_State* L) {
+        lua_createtable(L, 10000, 0);
+        for (int i = 1; i <= 10000; i++)
+        {
+            lua_newtable(L);
+            lua_rawseti(L, -2, i);
+        }
+        lua_pop(L, 1);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    };
+
+    CHECK(lua_gc(L, LUA_GCSETPAGECACHE, 8) > 0);
+
+    // pages freed by the first collection are kept around and reused by the next batch of allocations
+    churn(L);
+
+    size_t hits = 0, misses = 0;
+    int pages = 0;
+    lua_pagecachestats(L, &hits, &misses, &pages);
+    CHECK(misses > 0);
+    CHECK(pages > 0);
+    CHECK(pages <= 8);
+
+    size_t oldhits = hits;
+    churn(L);
+    lua_pagecachestats(L, &hits, nullptr, nullptr);
+    CHECK(hits > oldhits);
+
+    // disabling the cache releases the cached pages
+    CHECK(lua_gc(L, LUA_GCSETPAGECACHE, 0) == 8);
+    lua_pagecachestats(L, nullptr, nullptr, &pages);
+    CHECK(pages == 0);
+
+    churn(L);
+    lua_pagecachestats(L, &oldhits, nullptr, &pages);
+    churn(L);
+    lua_pagecachestats(L, &hits, nullptr, &pages);
+    CHECK(hits == oldhits);
+    CHECK(pages == 0);
+}
+
 TEST_CASE("Bitwise")
 {
     runConformance("bitwise.lua");
 }
 
+TEST_CASE("Buffers")
+{
+    runConformance("buffers.lua");
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+    luaL_openlibs(L);
+
+    // native code writes into the buffer in place, and scripts see the change without a copy
+    char* data = (char*)lua_newbuffer(L, 4);
+    REQUIRE(data);
+    memcpy(data, "\x01\x02\x03\x04", 4);
+
+    size_t len = 0;
+    CHECK(lua_tobuffer(L, -1, &len) == data);
+    CHECK(len == 4);
+    CHECK(lua_isbuffer(L, -1));
+    CHECK(lua_objlen(L, -1) == 4);
+    CHECK(strcmp(luaL_typename(L, -1), "buffer") == 0);
+
+    lua_setglobal(L, "data");
+
+    const char* source = "buffer.writeu8(data, 0, 42) return buffer.readu32(data, 0)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=buffer", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+    CHECK(lua_tonumber(L, -1) == 0x0403022a);
+    CHECK(data[0] == 42);
+
+    lua_pushnumber(L, 1);
+    CHECK(lua_tobuffer(L, -1, &len) == nullptr);
+}
+
+TEST_CASE("NumArrays")
+{
+    runConformance("numarrays.lua");
+}
+
+TEST_CASE("Shapes")
+{
+    ScopedFastFlag sffTableShapes{"LuauTableShapes", true};
+
+    runConformance("shapes.lua");
+}
+
 TEST_CASE("UTF8")
 {
     runConformance("utf8.lua");
@@ -674,6 +853,11 @@ TEST_CASE("SameHash")
     CHECK(luaS_hash("luaubytecode", 12) == Luau::BytecodeBuilder::getStringHash({"luaubytecode", 12}));
     CHECK(luaS_hash("luaubytecodehash", 16) == Luau::BytecodeBuilder::getStringHash({"luaubytecodehash", 16}));
 
+    // Long strings use a different algorithm for the prefix
+    const char* longName = "luau_bytecode_builder_string_hash_of_a_long_identifier";
+    CHECK(luaS_hash(longName, 32) == Luau::BytecodeBuilder::getStringHash({longName, 32}));
+    CHECK(luaS_hash(longName, strlen(longName)) == Luau::BytecodeBuilder::getStringHash({longName, strlen(longName)}));
+
     // Also hash should work on unaligned source data even when hashing long strings
     char buf[128] = {};
     CHECK(luaS_hash(buf + 1, 120) == luaS_hash(buf + 2, 120));
@@ -1076,6 +1260,447 @@ TEST_CASE("StringConversion")
     runConformance("strconv.lua");
 }
 
+TEST_CASE("BytecodeImage")
+{
+    const char* source = R"(
+local Point = {}
+Point.__index = Point
+
+function Point.new(x, y) return setmetatable({x = x, y = y}, Point) end
+function Point:sum() return self.x + self.y end
+
+local ok, err = pcall(function() error("boom") end)
+return Point.new(...):sum(), string.upper("image"), err
+)";
+
+    lua_CompileOptions copts = defaultOptions();
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), &copts, &bytecodeSize);
+
+    size_t imageSize = 0;
+    std::unique_ptr<char, void (*)(void*)> image(luau_buildimage(bytecode, bytecodeSize, &imageSize), free);
+    free(bytecode);
+    REQUIRE(image);
+
+    std::string snapshot(image.get(), imageSize);
+
+    // every state uses the same image, and each can be closed independently
+    for (int i = 0; i < 3; ++i)
+    {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+        luaL_openlibs(L);
+
+        REQUIRE(luau_loadimage(L, "=image", image.get(), imageSize, 0) == 0);
+
+        // breakpoints are ignored since the code is shared
+        lua_breakpoint(L, -1, 6, true);
+
+        lua_pushinteger(L, i);
+        lua_pushinteger(L, 10);
+        REQUIRE(lua_pcall(L, 2, 3, 0) == 0);
+
+        CHECK(lua_tointeger(L, -3) == i + 10);
+        CHECK(std::string(lua_tostring(L, -2)) == "IMAGE");
+        CHECK(std::string(lua_tostring(L, -1)) == "image:8: boom");
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+
+    // slot predictions and breakpoints must not modify the image
+    CHECK(memcmp(snapshot.data(), image.get(), imageSize) == 0);
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    // compilation errors are reported when the image is loaded
+    char* errorBytecode = luau_compile("local", 5, &copts, &bytecodeSize);
+    std::unique_ptr<char, void (*)(void*)> errorImage(luau_buildimage(errorBytecode, bytecodeSize, &imageSize), free);
+    free(errorBytecode);
+    REQUIRE(errorImage);
+
+    CHECK(luau_loadimage(L, "=error", errorImage.get(), imageSize, 0) == 1);
+    CHECK(std::string(lua_tostring(L, -1)).find("error:1:") == 0);
+    lua_pop(L, 1);
+
+    // plain bytecode isn't an image
+    CHECK(luau_loadimage(L, "=bytecode", "\x03", 1, 0) == 1);
+    CHECK(std::string(lua_tostring(L, -1)) == "bytecode: bytecode image is malformed or has a different version");
+    lua_pop(L, 1);
+
+    // arrays of functions have to be aligned and inside of the image; the function table follows the 20 byte header
+    auto checkMalformed = [&](const std::string& data, size_t offset) {
+        std::vector<uint32_t> buffer(data.size() / 4 + 2);
+        memcpy(reinterpret_cast<char*>(buffer.data()) + offset, data.data(), data.size());
+
+        CHECK(luau_loadimage(L, "=malformed", reinterpret_cast<char*>(buffer.data()) + offset, data.size(), 0) == 1);
+        CHECK(std::string(lua_tostring(L, -1)) == "malformed: bytecode image is malformed or has a different version");
+        lua_pop(L, 1);
+    };
+
+    auto patchProto = [&](size_t field, uint32_t value) {
+        std::string data = snapshot;
+        memcpy(&data[20 + field * 4], &value, sizeof(value));
+        return data;
+    };
+
+    checkMalformed(snapshot.substr(0, snapshot.size() - 4), 0);
+    checkMalformed(snapshot, 1);
+    checkMalformed(patchProto(0, uint32_t(snapshot.size())), 0);
+    checkMalformed(patchProto(0, 2), 0);
+    checkMalformed(patchProto(1, uint32_t(snapshot.size() - 4)), 0);
+    checkMalformed(patchProto(1, 0), 0);
+}
+
+TEST_CASE("LazyLoad")
+{
+    lazyLoad = true;
+
+    runConformance("basic.lua");
+    runConformance("calls.lua");
+    runConformance("closure.lua");
+    runConformance("coroutine.lua");
+    runConformance("errors.lua");
+    runConformance("gc.lua");
+    runConformance("inlinecache.lua");
+
+    lazyLoad = false;
+
+    const char* source = R"(
+local prefix = "value: "
+
+function describe(v)
+    return prefix .. tostring(v)
+end
+
+function unused()
+    return string.rep("x", 3)
+end
+
+return describe(42)
+)";
+
+    lua_CompileOptions copts = defaultOptions();
+    copts.debugLevel = 2;
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), &copts, &bytecodeSize);
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+    luaL_openlibs(L);
+
+    REQUIRE(luau_loadlazy(L, "=lazy", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    // functions that haven't run yet can be described without decoding them
+    lua_Debug ar;
+    REQUIRE(lua_getinfo(L, -1, "s", &ar));
+    CHECK(std::string(ar.source) == "=lazy");
+
+    lua_pushvalue(L, -1);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+    CHECK(std::string(lua_tostring(L, -1)) == "value: 42");
+    lua_pop(L, 1);
+
+    // upvalue names come from the decoded function
+    lua_getglobal(L, "describe");
+    const char* upvalue = lua_getupvalue(L, -1, 1);
+    REQUIRE(upvalue);
+    CHECK(std::string(upvalue) == "prefix");
+    lua_pop(L, 2);
+
+    // the clone decodes 'unused' from its own copy of the bytecode
+    StateRef clone(lua_clonestate(L), lua_close);
+    REQUIRE(clone);
+
+    globalState.reset();
+
+    lua_getglobal(clone.get(), "unused");
+    REQUIRE(lua_pcall(clone.get(), 0, 1, 0) == 0);
+    CHECK(std::string(lua_tostring(clone.get(), -1)) == "xxx");
+    lua_pop(clone.get(), 1);
+
+    lua_gc(clone.get(), LUA_GCCOLLECT, 0);
+}
+
+TEST_CASE("DebugInfoSidecar")
+{
+    const char* source = R"(
+local upvalue = "up"
+
+function getupvalue()
+    return upvalue
+end
+
+local function fail(message)
+    local detail = message .. "!"
+    if localname() ~= "message" then detail = "no locals" end
+    error(detail)
+end
+
+return pcall(fail, "boom")
+)";
+
+    Luau::CompileOptions options;
+    options.debugLevel = 2;
+
+    Luau::BytecodeBuilder inlineBcb;
+    Luau::compileOrThrow(inlineBcb, source, options);
+
+    Luau::BytecodeBuilder bcb;
+    bcb.enableDebugInfoSidecar();
+    Luau::compileOrThrow(bcb, source, options);
+
+    static std::string sidecar;
+    static unsigned int sidecarHash;
+    sidecar = bcb.getDebugInfo();
+    sidecarHash = Luau::BytecodeBuilder::getBytecodeHash(bcb.getBytecode());
+
+    const std::string& bytecode = bcb.getBytecode();
+    CHECK(bytecode.size() < inlineBcb.getBytecode().size());
+    CHECK(bytecode.find("detail") == std::string::npos);
+
+    static int requests;
+    requests = 0;
+
+    for (bool withSidecar : {true, false})
+    {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+        luaL_openlibs(L);
+
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) -> int {
+                const char* name = lua_getlocal(L, 1, 1);
+                if (name)
+                    lua_pop(L, 1);
+                lua_pushstring(L, name ? name : "?");
+                return 1;
+            },
+            "localname");
+        lua_setglobal(L, "localname");
+
+        if (withSidecar)
+        {
+            lua_callbacks(L)->debuginfo = [](lua_State* L, const char* chunkname, unsigned int hash, size_t* size) -> const char* {
+                requests++;
+
+                if (strcmp(chunkname, "=sidecar") != 0 || hash != sidecarHash)
+                    return nullptr;
+
+                *size = sidecar.size();
+                return sidecar.data();
+            };
+        }
+
+        REQUIRE(luau_load(L, "=sidecar", bytecode.data(), bytecode.size(), 0) == 0);
+        REQUIRE(lua_pcall(L, 0, 2, 0) == 0);
+
+        CHECK(!lua_toboolean(L, -2));
+
+        if (withSidecar)
+            CHECK(std::string(lua_tostring(L, -1)) == "sidecar:11: boom!");
+        else
+            CHECK(std::string(lua_tostring(L, -1)) == "no locals");
+
+        lua_pop(L, 2);
+
+        lua_getglobal(L, "getupvalue");
+        const char* upvalue = lua_getupvalue(L, -1, 1);
+        CHECK(std::string(upvalue ? upvalue : "") == (withSidecar ? "upvalue" : ""));
+        lua_pop(L, upvalue ? 2 : 1);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+
+    // each function requests the sidecar once
+    CHECK(requests == 2);
+}
+
+TEST_CASE("DebugInfoSidecarWithMissingStrings")
+{
+    const char* source = R"(
+local function fail(message)
+    local detail = message .. "!"
+    if localname() ~= "?" then detail = "named" end
+    error(detail)
+end
+
+return pcall(fail, "boom")
+)";
+
+    Luau::CompileOptions options;
+    options.debugLevel = 2;
+
+    Luau::BytecodeBuilder bcb;
+    bcb.enableDebugInfoSidecar();
+    Luau::compileOrThrow(bcb, source, options);
+
+    std::string original = bcb.getDebugInfo();
+
+    auto readVarInt = [&](size_t& offset) {
+        unsigned int result = 0;
+        unsigned int shift = 0;
+        uint8_t byte;
+
+        do
+        {
+            byte = uint8_t(original[offset++]);
+            result |= (byte & 127) << shift;
+            shift += 7;
+        } while (byte & 128);
+
+        return result;
+    };
+
+    // drop the string table, so that every local and upvalue refers to a string that doesn't exist
+    size_t offset = 5;
+    unsigned int stringCount = readVarInt(offset);
+    REQUIRE(stringCount > 0);
+
+    for (unsigned int i = 0; i < stringCount; ++i)
+        offset += readVarInt(offset);
+
+    static std::string sidecar;
+    sidecar = original.substr(0, 5) + '\0' + original.substr(offset);
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+    luaL_openlibs(L);
+
+    lua_pushcfunction(
+        L,
+        [](lua_State* L) -> int {
+            const char* name = lua_getlocal(L, 1, 1);
+            if (name)
+                lua_pop(L, 1);
+            lua_pushstring(L, name ? name : "?");
+            return 1;
+        },
+        "localname");
+    lua_setglobal(L, "localname");
+
+    lua_callbacks(L)->debuginfo = [](lua_State* L, const char* chunkname, unsigned int hash, size_t* size) -> const char* {
+        *size = sidecar.size();
+        return sidecar.data();
+    };
+
+    const std::string& bytecode = bcb.getBytecode();
+
+    REQUIRE(luau_load(L, "=sidecar", bytecode.data(), bytecode.size(), 0) == 0);
+    REQUIRE(lua_pcall(L, 0, 2, 0) == 0);
+
+    // line info is still used, while the local is left without a name
+    CHECK(!lua_toboolean(L, -2));
+    CHECK(std::string(lua_tostring(L, -1)) == "sidecar:5: boom!");
+}
+
+TEST_CASE("CloneState")
+{
+    const char* source = R"(
+local counter = 0
+local function bump() counter += 1 return counter end
+
+Point = {}
+Point.__index = Point
+function Point.new(x, y) return setmetatable({x = x, y = y}, Point) end
+function Point:sum() return self.x + self.y end
+
+cycle = {}
+cycle.self = cycle
+cycle[cycle] = "key"
+cycle.list = {1, 2, 3, bump}
+cycle.frozen = table.freeze({answer = 42})
+cycle.co = coroutine.create(function(a) return a * 2 end)
+
+function check()
+    assert(Point.new(1, 2):sum() == 3)
+    assert(cycle.self == cycle and cycle[cycle] == "key")
+    assert(#cycle.list == 4 and cycle.list[4] == bump)
+    assert(table.isfrozen(cycle.frozen) and cycle.frozen.answer == 42)
+    assert(("abc"):upper() == "ABC")
+    return bump()
+end
+)";
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+    luaL_openlibs(L);
+
+    lua_CompileOptions copts = defaultOptions();
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), &copts, &bytecodeSize);
+    REQUIRE(luau_load(L, "=clone", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+    REQUIRE(lua_pcall(L, 0, 0, 0) == 0);
+
+    lua_pushstring(L, "stack value");
+    lua_newtable(L);
+    int ref = lua_ref(L, -1);
+    lua_pop(L, 1);
+
+    StateRef clone1(lua_clonestate(L), lua_close);
+    StateRef clone2(lua_clonestate(L), lua_close);
+    REQUIRE(clone1);
+    REQUIRE(clone2);
+
+    // the clones don't depend on the source state
+    globalState.reset();
+
+    for (lua_State* C : {clone1.get(), clone2.get()})
+    {
+        REQUIRE(lua_gettop(C) == 1);
+        CHECK(std::string(lua_tostring(C, 1)) == "stack value");
+
+        lua_getref(C, ref);
+        CHECK(lua_istable(C, -1));
+        lua_pop(C, 1);
+
+        lua_getglobal(C, "check");
+        REQUIRE(lua_pcall(C, 0, 1, 0) == 0);
+        CHECK(lua_tointeger(C, -1) == 1);
+        lua_pop(C, 1);
+
+        lua_getglobal(C, "cycle");
+        lua_getfield(C, -1, "co");
+        lua_State* co = lua_tothread(C, -1);
+        lua_pushinteger(co, 21);
+        REQUIRE(lua_resume(co, C, 1) == LUA_OK);
+        CHECK(lua_tointeger(co, -1) == 42);
+        lua_pop(C, 2);
+
+        lua_gc(C, LUA_GCCOLLECT, 0);
+    }
+
+    // each clone has its own copy of the upvalue
+    lua_getglobal(clone1.get(), "check");
+    REQUIRE(lua_pcall(clone1.get(), 0, 1, 0) == 0);
+    CHECK(lua_tointeger(clone1.get(), -1) == 2);
+
+    // threads that are suspended can't be cloned
+    StateRef source2(luaL_newstate(), lua_close);
+    lua_State* L2 = source2.get();
+    luaL_openlibs(L2);
+
+    lua_State* co = lua_newthread(L2);
+    lua_getglobal(co, "coroutine");
+    lua_getfield(co, -1, "yield");
+    lua_remove(co, -2);
+    REQUIRE(lua_resume(co, L2, 0) == LUA_YIELD);
+
+    CHECK(lua_clonestate(L2) == nullptr);
+
+    lua_pop(L2, 1);
+    lua_gc(L2, LUA_GCCOLLECT, 0);
+
+    // userdata with destructors can't be cloned
+    lua_newuserdatadtor(L2, 8, [](void*) {});
+    CHECK(lua_clonestate(L2) == nullptr);
+}
+
 TEST_CASE("GCDump")
 {
     // internal function, declared in lgc.h - not exposed via lua.h
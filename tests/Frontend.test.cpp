@@ -9,6 +9,9 @@
 #include "doctest.h"
 
 #include <algorithm>
+#include <thread>
+
+LUAU_FASTINT(LuauTypeInferIterationLimit);
 
 using namespace Luau;
 
@@ -43,6 +46,25 @@ struct NaiveModuleResolver : ModuleResolver
 
 NaiveModuleResolver naiveModuleResolver;
 
+struct InMemoryModuleCache : ModuleCache
+{
+    std::optional<std::string> readModuleInterface(const ModuleName& name) override
+    {
+        auto it = interfaces.find(name);
+        if (it == interfaces.end())
+            return std::nullopt;
+
+        return it->second;
+    }
+
+    void writeModuleInterface(const ModuleName& name, const std::string& data) override
+    {
+        interfaces[name] = data;
+    }
+
+    std::unordered_map<ModuleName, std::string> interfaces;
+};
+
 struct NaiveFileResolver : NullFileResolver
 {
     std::optional<ModuleInfo> resolveModule(const ModuleInfo* context, AstExpr* expr) override
@@ -1092,4 +1114,308 @@ TEST_CASE_FIXTURE(BuiltinsFixture, "reexport_type_alias")
     LUAU_REQUIRE_NO_ERRORS(result);
 }
 
+TEST_CASE_FIXTURE(FrontendFixture, "check_modules_attributes_errors_like_sequential_checks")
+{
+    fileResolver.source["game/A"] = R"(
+        local a: number = 'error in A'
+        return {a = 1}
+    )";
+
+    fileResolver.source["game/B"] = R"(
+        local A = require(script.Parent.A)
+        local b: string = A.a
+        return {b = A.a}
+    )";
+
+    fileResolver.source["game/C"] = R"(
+        local A = require(script.Parent.A)
+        local B = require(script.Parent.B)
+        local c: boolean = B.b
+        return {}
+    )";
+
+    std::vector<CheckResult> results = frontend.checkModules({"game/B", "game/C", "game/A"});
+    REQUIRE_EQ(3, results.size());
+
+    // errors in A are reported by the first module that required it
+    REQUIRE_EQ(2, results[0].errors.size());
+    CHECK_EQ("game/A", results[0].errors[0].moduleName);
+    CHECK_EQ("game/B", results[0].errors[1].moduleName);
+
+    REQUIRE_EQ(1, results[1].errors.size());
+    CHECK_EQ("game/C", results[1].errors[0].moduleName);
+
+    // A was already checked, so it reports all of its errors just like check does
+    REQUIRE_EQ(1, results[2].errors.size());
+    CHECK_EQ("game/A", results[2].errors[0].moduleName);
+
+    CHECK_EQ(3, frontend.stats.filesStrict + frontend.stats.filesNonstrict);
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "check_modules_in_parallel")
+{
+    // a diamond of dependencies with independent modules at each level
+    fileResolver.source["game/Base"] = "return {value = 1}";
+
+    for (int i = 0; i < 8; ++i)
+    {
+        fileResolver.source["game/Mid" + std::to_string(i)] = R"(
+            local Base = require(script.Parent.Base)
+            return {value = Base.value + 1, name = "mid"}
+        )";
+    }
+
+    fileResolver.source["game/Top"] = R"(
+        local Mid0 = require(script.Parent.Mid0)
+        local Mid7 = require(script.Parent.Mid7)
+        local s: string = Mid0.value
+        return {total = Mid0.value + Mid7.value}
+    )";
+
+    std::vector<ModuleName> names;
+    for (int i = 0; i < 8; ++i)
+        names.push_back("game/Mid" + std::to_string(i));
+    names.push_back("game/Top");
+
+    std::vector<std::thread> threads;
+    std::vector<CheckResult> results = frontend.checkModules(names, std::nullopt, [&](std::function<void()> task) {
+        threads.emplace_back(std::move(task));
+    });
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    CHECK_EQ(10, threads.size());
+
+    REQUIRE_EQ(9, results.size());
+    for (int i = 0; i < 8; ++i)
+        CHECK(results[i].errors.empty());
+
+    REQUIRE_EQ(1, results[8].errors.size());
+    CHECK_EQ("game/Top", results[8].errors[0].moduleName);
+
+    ModulePtr top = frontend.moduleResolver.modules["game/Top"];
+    REQUIRE(top != nullptr);
+    CHECK_EQ("{| total: number |}", toString(*first(top->getModuleScope()->returnType)));
+
+    for (const ModuleName& name : names)
+        CHECK(!frontend.isDirty(name));
+
+    CHECK_EQ(10, frontend.stats.filesStrict + frontend.stats.filesNonstrict);
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "check_modules_sequentially_with_lower_bounds_calculation")
+{
+    ScopedFastFlag sff{"LuauLowerBoundsCalculation", true};
+
+    fileResolver.source["game/A"] = "return {value = 1}";
+    fileResolver.source["game/B"] = "return {value = 'one'}";
+
+    size_t tasks = 0;
+    std::vector<CheckResult> results = frontend.checkModules({"game/A", "game/B"}, std::nullopt, [&](std::function<void()> task) {
+        tasks++;
+        task();
+    });
+
+    CHECK_EQ(0, tasks);
+
+    REQUIRE_EQ(2, results.size());
+    CHECK(results[0].errors.empty());
+    CHECK(results[1].errors.empty());
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "module_cache_restores_interfaces_of_unchanged_modules")
+{
+    InMemoryModuleCache moduleCache;
+    frontend.moduleCache = &moduleCache;
+    frontend.options.retainFullTypeGraphs = false;
+
+    fileResolver.source["game/A"] = R"(
+        export type Point = {x: number, y: number}
+        export type Pair<T, U = string> = {first: T, second: U}
+        export type Kind = "circle" | "square"
+
+        local A = {}
+
+        function A.make(x: number, y: number): Point
+            return {x = x, y = y}
+        end
+
+        function A.id<T>(value: T): T
+            return value
+        end
+
+        function A.describe(kind: Kind, ...: number): (string, number?)
+            return kind, nil
+        end
+
+        A.origin = A.make(0, 0)
+
+        return A
+    )";
+
+    fileResolver.source["game/B"] = R"(
+        local A = require(game.A)
+        return {point = A.make(1, 2), name = string.upper("b"), format = string.format}
+    )";
+
+    CheckResult result = frontend.check("game/B");
+    LUAU_REQUIRE_NO_ERRORS(result);
+
+    CHECK_EQ(0, frontend.stats.filesCached);
+    CHECK_EQ(2, moduleCache.interfaces.size());
+
+    std::string interfaceA = toString(frontend.moduleResolver.modules["game/A"]->getModuleScope()->returnType);
+    std::string interfaceB = toString(frontend.moduleResolver.modules["game/B"]->getModuleScope()->returnType);
+
+    frontend.clear();
+    frontend.clearStats();
+
+    fileResolver.source["game/C"] = R"(
+        local A = require(game.A)
+        local B = require(game.B)
+        local p: A.Point = A.make(1, 2)
+        local q: A.Pair<number> = {first = 1, second = "two"}
+        local k: A.Kind = "circle"
+        local n: number = A.id(5)
+        local d: string = A.describe(k, 1, 2)
+        local f: string = B.format("%d", B.point.x)
+        local s: string = A.origin.x
+    )";
+
+    result = frontend.check("game/C");
+
+    CHECK_EQ(2, frontend.stats.filesCached);
+    CHECK_EQ(interfaceA, toString(frontend.moduleResolver.modules["game/A"]->getModuleScope()->returnType));
+    CHECK_EQ(interfaceB, toString(frontend.moduleResolver.modules["game/B"]->getModuleScope()->returnType));
+
+    LUAU_REQUIRE_ERROR_COUNT(1, result);
+    CHECK_EQ("game/C", result.errors[0].moduleName);
+    CHECK_EQ("Type 'number' could not be converted into 'string'", toString(result.errors[0]));
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "module_cache_is_invalidated_by_changes_to_dependencies")
+{
+    InMemoryModuleCache moduleCache;
+    frontend.moduleCache = &moduleCache;
+    frontend.options.retainFullTypeGraphs = false;
+
+    fileResolver.source["game/A"] = "return {value = 1}";
+    fileResolver.source["game/B"] = R"(
+        local A = require(game.A)
+        return {value = A.value}
+    )";
+
+    frontend.check("game/B");
+    CHECK_EQ(2, moduleCache.interfaces.size());
+
+    // B itself didn't change, but its interface depends on A
+    frontend.clear();
+    frontend.clearStats();
+    fileResolver.source["game/A"] = "return {value = 'one'}";
+
+    frontend.check("game/B");
+    CHECK_EQ(0, frontend.stats.filesCached);
+    CHECK_EQ("{| value: string |}", toString(*first(frontend.moduleResolver.modules["game/B"]->getModuleScope()->returnType)));
+
+    frontend.clear();
+    frontend.clearStats();
+
+    frontend.check("game/B");
+    CHECK_EQ(2, frontend.stats.filesCached);
+    CHECK_EQ("{| value: string |}", toString(*first(frontend.moduleResolver.modules["game/B"]->getModuleScope()->returnType)));
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "module_cache_skips_modules_with_errors")
+{
+    InMemoryModuleCache moduleCache;
+    frontend.moduleCache = &moduleCache;
+    frontend.options.retainFullTypeGraphs = false;
+
+    fileResolver.source["game/A"] = R"(
+        local x: string = 1
+        return {}
+    )";
+
+    CheckResult result = frontend.check("game/A");
+    LUAU_REQUIRE_ERROR_COUNT(1, result);
+    CHECK(moduleCache.interfaces.empty());
+
+    frontend.clear();
+
+    result = frontend.check("game/A");
+    LUAU_REQUIRE_ERROR_COUNT(1, result);
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "module_cache_rejects_malformed_data")
+{
+    InMemoryModuleCache moduleCache;
+    frontend.moduleCache = &moduleCache;
+    frontend.options.retainFullTypeGraphs = false;
+
+    fileResolver.source["game/A"] = "return {value = 1}";
+
+    frontend.check("game/A");
+    REQUIRE_EQ(1, moduleCache.interfaces.size());
+
+    std::string& data = moduleCache.interfaces["game/A"];
+    data.resize(data.size() / 2);
+
+    frontend.clear();
+    frontend.clearStats();
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/A"));
+    CHECK_EQ(0, frontend.stats.filesCached);
+    CHECK_EQ("{| value: number |}", toString(*first(frontend.moduleResolver.modules["game/A"]->getModuleScope()->returnType)));
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "module_cache_is_invalidated_by_changes_to_definitions")
+{
+    InMemoryModuleCache moduleCache;
+    frontend.moduleCache = &moduleCache;
+    frontend.options.retainFullTypeGraphs = false;
+
+    loadDefinition("declare extra: number");
+
+    fileResolver.source["game/A"] = "return {value = extra}";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/A"));
+    REQUIRE_EQ(1, moduleCache.interfaces.size());
+
+    loadDefinition("declare extra: string");
+
+    frontend.clear();
+    frontend.clearStats();
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/A"));
+    CHECK_EQ(0, frontend.stats.filesCached);
+    CHECK_EQ("{| value: string |}", toString(*first(frontend.moduleResolver.modules["game/A"]->getModuleScope()->returnType)));
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "module_cache_is_invalidated_by_changes_to_flags")
+{
+    InMemoryModuleCache moduleCache;
+    frontend.moduleCache = &moduleCache;
+    frontend.options.retainFullTypeGraphs = false;
+
+    fileResolver.source["game/A"] = "return {value = 1}";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/A"));
+    REQUIRE_EQ(1, moduleCache.interfaces.size());
+
+    ScopedFastInt sfi{"LuauTypeInferIterationLimit", FInt::LuauTypeInferIterationLimit + 1};
+
+    frontend.clear();
+    frontend.clearStats();
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/A"));
+    CHECK_EQ(0, frontend.stats.filesCached);
+
+    frontend.clear();
+    frontend.clearStats();
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/A"));
+    CHECK_EQ(1, frontend.stats.filesCached);
+}
+
 TEST_SUITE_END();
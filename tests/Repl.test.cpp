@@ -3,9 +3,11 @@
 #include "lualib.h"
 
 #include "Repl.h"
+#include "FileUtils.h"
 
 #include "doctest.h"
 
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <set>
@@ -404,3 +406,102 @@ t60 = makeChainedTable(60)
 }
 
 TEST_SUITE_END();
+
+struct BatchFixture
+{
+    BatchFixture()
+    {
+        root = (std::filesystem::temp_directory_path() / ("luau-batch-" + std::to_string(uintptr_t(this)))).string();
+        source = joinPaths(root, "src");
+        output = joinPaths(root, "out");
+
+        std::filesystem::remove_all(root);
+        REQUIRE(createDirectories(source));
+    }
+
+    ~BatchFixture()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(root, ec);
+    }
+
+    std::string root;
+    std::string source;
+    std::string output;
+};
+
+TEST_SUITE_BEGIN("BatchCompile");
+
+TEST_CASE("OutputPaths")
+{
+    CHECK(getBatchOutputPath("a.lua") == "a.luauc");
+    CHECK(getBatchOutputPath("a.luau") == "a.luauc");
+    CHECK(getBatchOutputPath("a") == "a.luauc");
+    CHECK(getBatchOutputPath("dir/a.lua") == "dir/a.luauc");
+    CHECK(getBatchOutputPath("dir.x/a") == "dir.x/a.luauc");
+    CHECK(getBatchOutputPath("dir\\a.b.lua") == "dir\\a.b.luauc");
+}
+
+TEST_CASE("RelativePaths")
+{
+    CHECK(isMappableRelativePath("a.lua"));
+    CHECK(isMappableRelativePath("dir/a.lua"));
+    CHECK(isMappableRelativePath("a..b.lua"));
+    CHECK(isMappableRelativePath("..a/b.lua"));
+
+    CHECK(!isMappableRelativePath(""));
+    CHECK(!isMappableRelativePath("/a.lua"));
+    CHECK(!isMappableRelativePath("c:/a.lua"));
+    CHECK(!isMappableRelativePath("../a.lua"));
+    CHECK(!isMappableRelativePath("dir/../a.lua"));
+    CHECK(!isMappableRelativePath("dir\\..\\a.lua"));
+    CHECK(!isMappableRelativePath("dir/.."));
+}
+
+TEST_CASE_FIXTURE(BatchFixture, "RejectsPathsOutsideOfOutput")
+{
+    CHECK(compileBatch({"../a.lua"}, output, 1) == 1);
+    CHECK(compileBatch({"dir/../../a.lua"}, output, 1) == 1);
+    CHECK(!isDirectory(output));
+}
+
+TEST_CASE_FIXTURE(BatchFixture, "RejectsOutputCollisions")
+{
+    REQUIRE(writeFile(joinPaths(source, "a.lua"), "return 1"));
+    REQUIRE(writeFile(joinPaths(source, "a.luau"), "return 2"));
+
+    CHECK(compileBatch({source}, output, 2) == 1);
+    CHECK(!isFile(joinPaths(output, "a.luauc")));
+}
+
+TEST_CASE_FIXTURE(BatchFixture, "SkipsUnchangedFiles")
+{
+    std::string input = joinPaths(source, "dir/a.lua");
+    std::string result = joinPaths(output, "dir/a.luauc");
+
+    REQUIRE(createDirectories(joinPaths(source, "dir")));
+    REQUIRE(writeFile(input, "return 1"));
+
+    REQUIRE(compileBatch({source}, output, 1) == 0);
+    REQUIRE(isFile(result));
+    CHECK(isFile(joinPaths(output, "manifest.txt")));
+
+    // the manifest says the output is up to date, so it's left alone even though its contents are wrong
+    REQUIRE(writeFile(result, "stale"));
+
+    REQUIRE(compileBatch({source}, output, 1) == 0);
+    CHECK(readFile(result) == "stale");
+
+    REQUIRE(writeFile(input, "return 2"));
+
+    REQUIRE(compileBatch({source}, output, 1) == 0);
+    CHECK(readFile(result) != "stale");
+
+    // outputs that were deleted are recompiled even if the manifest has them
+    std::filesystem::remove(result);
+
+    REQUIRE(compileBatch({source}, output, 1) == 0);
+    CHECK(isFile(result));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,163 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing byte buffer library")
+
+local function ecall(fn, ...)
+  local ok, err = pcall(fn, ...)
+  assert(not ok)
+  return err:sub((err:find(": ") or -1) + 2, #err)
+end
+
+-- creation and basic properties
+do
+  local b = buffer.create(10)
+  assert(type(b) == "buffer")
+  assert(typeof(b) == "buffer")
+  assert(buffer.len(b) == 10)
+  assert(buffer.tostring(b) == string.rep("\0", 10))
+
+  assert(buffer.len(buffer.create(0)) == 0)
+  assert(ecall(buffer.create, -1) == "invalid argument #1 to 'create' (invalid size)")
+  assert(ecall(buffer.len, "string") == "invalid argument #1 to 'len' (buffer expected, got string)")
+
+  assert(buffer.tostring(buffer.fromstring("hello")) == "hello")
+
+  -- buffers are compared and hashed by reference
+  local c = buffer.create(10)
+  assert(b == b and b ~= c)
+
+  local t = {[b] = 1, [c] = 2}
+  assert(t[b] == 1 and t[c] == 2)
+
+  assert(tostring(b):match("^buffer: "))
+end
+
+-- integer reads and writes
+do
+  local b = buffer.create(16)
+
+  buffer.writei8(b, 0, -1)
+  assert(buffer.readi8(b, 0) == -1)
+  assert(buffer.readu8(b, 0) == 255)
+
+  buffer.writeu8(b, 1, 300)
+  assert(buffer.readu8(b, 1) == 44)
+
+  buffer.writei16(b, 2, -2)
+  assert(buffer.readi16(b, 2) == -2)
+  assert(buffer.readu16(b, 2) == 65534)
+
+  buffer.writeu16(b, 4, 0x1234)
+  assert(buffer.readu8(b, 4) == 0x34 and buffer.readu8(b, 5) == 0x12)
+
+  buffer.writei32(b, 8, -123456789)
+  assert(buffer.readi32(b, 8) == -123456789)
+  assert(buffer.readu32(b, 8) == 4294967296 - 123456789)
+
+  buffer.writeu32(b, 12, 0xdeadbeef)
+  assert(buffer.readu32(b, 12) == 0xdeadbeef)
+  assert(buffer.readi32(b, 12) == 0xdeadbeef - 4294967296)
+
+  -- offsets are truncated like other integer arguments
+  assert(buffer.readu32(b, 12.5) == 0xdeadbeef)
+end
+
+-- floating point reads and writes
+do
+  local b = buffer.create(12)
+
+  buffer.writef32(b, 0, 1.5)
+  assert(buffer.readf32(b, 0) == 1.5)
+
+  buffer.writef32(b, 0, 0.1)
+  assert(buffer.readf32(b, 0) ~= 0.1 and math.abs(buffer.readf32(b, 0) - 0.1) < 1e-7)
+
+  buffer.writef64(b, 4, math.pi)
+  assert(buffer.readf64(b, 4) == math.pi)
+
+  buffer.writef64(b, 4, math.huge)
+  assert(buffer.readf64(b, 4) == math.huge)
+
+  buffer.writef64(b, 4, 0/0)
+  local nan = buffer.readf64(b, 4)
+  assert(nan ~= nan)
+end
+
+-- bounds checks
+do
+  local b = buffer.create(8)
+
+  assert(ecall(buffer.readi32, b, 5) == "buffer access out of bounds")
+  assert(ecall(buffer.readi32, b, -1) == "buffer access out of bounds")
+  assert(ecall(buffer.writef64, b, 1, 0) == "buffer access out of bounds")
+  assert(ecall(buffer.writeu8, b, 8, 0) == "buffer access out of bounds")
+  assert(ecall(buffer.readstring, b, 4, 5) == "buffer access out of bounds")
+  assert(ecall(buffer.writestring, b, 6, "abc") == "buffer access out of bounds")
+
+  -- the last bytes are accessible
+  buffer.writeu8(b, 7, 1)
+  buffer.writei32(b, 4, 2)
+  assert(buffer.readi32(b, 4) == 2)
+end
+
+-- strings, copy and fill
+do
+  local b = buffer.create(10)
+
+  buffer.writestring(b, 2, "hello")
+  assert(buffer.readstring(b, 2, 5) == "hello")
+
+  buffer.writestring(b, 0, "xyz", 2)
+  assert(buffer.readstring(b, 0, 7) == "xyhello")
+  assert(ecall(buffer.writestring, b, 0, "xyz", 4) == "invalid argument #4 to 'writestring' (string length overflow)")
+
+  buffer.fill(b, 0, 0x41)
+  assert(buffer.tostring(b) == "AAAAAAAAAA")
+
+  buffer.fill(b, 2, 0x42, 3)
+  assert(buffer.tostring(b) == "AABBBAAAAA")
+
+  local c = buffer.fromstring("0123456789")
+
+  buffer.copy(b, 0, c)
+  assert(buffer.tostring(b) == "0123456789")
+
+  buffer.copy(b, 1, c, 5, 3)
+  assert(buffer.tostring(b) == "0567456789")
+
+  -- overlapping ranges of the same buffer
+  buffer.copy(c, 2, c, 0, 8)
+  assert(buffer.tostring(c) == "0101234567")
+
+  assert(ecall(buffer.copy, b, 5, c) == "buffer access out of bounds")
+end
+
+-- fast paths and fallbacks produce the same results
+do
+  local b = buffer.create(64)
+
+  for i = 0, 15 do
+    buffer.writei32(b, i * 4, i * 1000 - 5000)
+  end
+
+  local sum = 0
+  for i = 0, 15 do
+    sum += buffer.readi32(b, i * 4)
+  end
+  assert(sum == 40000)
+
+  for i = 0, 7 do
+    buffer.writef64(b, i * 8, i / 4)
+  end
+
+  local fsum = 0
+  for i = 0, 7 do
+    fsum += buffer.readf64(b, i * 8)
+  end
+  assert(fsum == 7)
+
+  -- non-buffer arguments go through the library function
+  assert(ecall(function() return buffer.readi32("abcd", 0) end) == "invalid argument #1 to 'readi32' (buffer expected, got string)")
+  assert(ecall(function() buffer.writei32(b, "x", 0) end) == "invalid argument #2 to 'writei32' (number expected, got string)")
+end
+
+return('OK')
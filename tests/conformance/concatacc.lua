@@ -0,0 +1,232 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing strings built up in loops")
+
+-- loop bounds that the compiler doesn't know, so that loops aren't unrolled
+local bounds = { 3, 4, 10, 100, 1000, 10000 }
+local three, four, ten, hundred, thousand = bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]
+
+-- appends in all kinds of loops
+do
+  local s = ""
+  for i = 1, ten do
+    s = s .. i .. ","
+  end
+  assert(s == "1,2,3,4,5,6,7,8,9,10,")
+
+  local n = ten
+  local t = "["
+  for i = 1, n do
+    t ..= tostring(i)
+  end
+  t ..= "]"
+  assert(t == "[12345678910]")
+
+  local w = "w"
+  local i = 0
+  while i < 5 do
+    i += 1
+    w ..= i
+  end
+  assert(w == "w12345")
+
+  local r = ""
+  repeat
+    r ..= "r"
+  until #w == 6 and i == 5
+  assert(r == "r")
+
+  local names = { "a", "b", "c" }
+  local g = ""
+  for k, v in ipairs(names) do
+    g = g .. k .. "=" .. v .. ";"
+  end
+  assert(g == "1=a;2=b;3=c;")
+
+  -- loops that don't run leave the string as is
+  local e = "e"
+  for _ = 1, n - 20 do
+    e ..= "x"
+  end
+  for _ in pairs({}) do
+    e ..= "x"
+  end
+  assert(e == "e")
+end
+
+-- break, continue, nested loops and several strings at once
+do
+  local function collect(n)
+    local a, b = "", ""
+    for i = 1, n do
+      if i % 2 == 0 then
+        continue
+      end
+      a ..= i
+      for j = 1, i do
+        b = b .. j
+      end
+      if i > 6 then
+        break
+      end
+    end
+    return a, b
+  end
+
+  local a, b = collect(hundred)
+  assert(a == "1357")
+  assert(b == "1" .. "123" .. "12345" .. "1234567")
+
+  local rows = {}
+  for i = 1, three do
+    local line = ""
+    for j = 1, three do
+      line ..= i * j .. " "
+    end
+    rows[i] = line
+  end
+  assert(rows[1] == "1 2 3 " and rows[2] == "2 4 6 " and rows[3] == "3 6 9 ")
+end
+
+-- numbers, empty strings and long strings
+do
+  local s = 1
+  for i = 2, four do
+    s = s .. i
+  end
+  assert(s == "1234")
+
+  local z = ""
+  for _ = 1, hundred do
+    z = z .. ""
+  end
+  assert(z == "")
+
+  local piece = string.rep("abcdefgh", 100)
+  local l = ""
+  for _ = 1, thousand do
+    l ..= piece
+  end
+  assert(#l == 800000 and l == string.rep(piece, 1000))
+
+  local f = ""
+  for i = 1, three do
+    f ..= i / 2
+  end
+  assert(f == "0.511.5")
+end
+
+-- values that aren't strings go through the regular rules, including __concat
+do
+  local mt = {
+    __concat = function(a, b)
+      local sa = type(a) == "table" and "<" .. a.v .. ">" or a
+      local sb = type(b) == "table" and "<" .. b.v .. ">" or b
+      return sa .. sb
+    end,
+  }
+
+  local s = "x"
+  for i = 1, four do
+    if i == 3 then
+      s = s .. setmetatable({ v = i }, mt)
+    else
+      s = s .. i
+    end
+  end
+  assert(s == "x12<3>4")
+
+  -- the string can stop being a string
+  local t = "a"
+  for i = 1, three do
+    t = t .. (i == 2 and setmetatable({ v = 0 }, { __concat = function() return setmetatable({ v = 1 }, mt) end }) or "b")
+  end
+  assert(t == "<1>b")
+
+  local ok, err = pcall(function()
+    local u = ""
+    for i = 1, three do
+      u = u .. (i == 2 and {} or "u")
+    end
+    return u
+  end)
+  assert(not ok and string.find(err, "attempt to concatenate"))
+
+  ok, err = pcall(function()
+    local u
+    for _ = 1, three do
+      u ..= "x"
+    end
+    return u
+  end)
+  assert(not ok and string.find(err, "attempt to concatenate"))
+end
+
+-- strings that other code can read are built as usual
+do
+  local s = ""
+  local reads = {}
+  for i = 1, three do
+    s ..= i
+    reads[i] = s
+  end
+  assert(reads[1] == "1" and reads[2] == "12" and reads[3] == "123")
+
+  local c = ""
+  local function get()
+    return c
+  end
+  local seen = {}
+  for i = 1, three do
+    c ..= i
+    seen[i] = get()
+  end
+  assert(seen[3] == "123" and c == "123")
+
+  local d = ""
+  local fns = {}
+  for i = 1, three do
+    d ..= i
+    fns[i] = function()
+      return d
+    end
+  end
+  assert(fns[1]() == "123")
+
+  local e = ""
+  local n = 0
+  while #e < 3 do
+    e ..= "e"
+    n += 1
+  end
+  assert(e == "eee" and n == 3)
+end
+
+-- the collector can run while strings are being built
+do
+  local s = ""
+  for i = 1, bounds[6] do
+    s ..= "x"
+    if i % 1000 == 0 then
+      collectgarbage()
+    end
+  end
+  assert(#s == 10000)
+end
+
+-- coroutines can yield while strings are being built
+do
+  local co = coroutine.wrap(function()
+    local s = ""
+    for i = 1, three do
+      s ..= coroutine.yield(i)
+    end
+    return s
+  end)
+
+  assert(co() == 1)
+  assert(co("a") == 2)
+  assert(co("b") == 3)
+  assert(co("c") == "abc")
+end
+
+return('OK')
@@ -0,0 +1,132 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print('testing generational garbage collection')
+
+assert(collectgarbage("generational") == "incremental")
+assert(collectgarbage("generational") == "generational")
+
+-- every step runs a complete (usually minor) collection
+local function minor()
+  assert(collectgarbage("step", 0) == true)
+end
+
+-- young garbage is reclaimed by minor collections
+do
+  collectgarbage()
+  local x = gcinfo()
+  for i=1,1000 do local t = {i, {}, tostring(i)} end
+  minor()
+  assert(gcinfo() <= x + 10)
+end
+
+-- young objects stored into old tables survive minor collections
+do
+  local old = {}
+  collectgarbage() -- 'old' is now old
+  for i=1,100 do
+    old[i] = {value = i}
+    old["k" .. i] = "v" .. i
+    minor()
+  end
+  for i=1,100 do
+    assert(old[i].value == i)
+    assert(old["k" .. i] == "v" .. i)
+  end
+
+  -- old objects that become unreachable are collected by major collections
+  local weak = setmetatable({}, {__mode = "v"})
+  weak[1] = old
+  old = nil
+  collectgarbage()
+  assert(weak[1] == nil)
+end
+
+-- young objects stored into upvalues of old closures
+do
+  local captured
+  local function set(v) captured = v end
+  local function get() return captured end
+  collectgarbage()
+  for i=1,50 do
+    set({i})
+    minor()
+    assert(get()[1] == i)
+  end
+end
+
+-- old weak tables are cleared of young objects
+do
+  local wk = setmetatable({}, {__mode = "k"})
+  local wv = setmetatable({}, {__mode = "v"})
+  collectgarbage()
+  local keep = {}
+  wk[keep] = 1
+  wv[1] = keep
+  -- the garbage is created in a call that can't be inlined so that no register of this frame keeps it alive
+  local young = {}
+  function young.fill(wk, wv) wk[{}] = 2; wv[2] = {} end
+  young.fill(wk, wv)
+  minor()
+  assert(wk[keep] == 1 and wv[1] == keep and wv[2] == nil)
+  local n = 0
+  for k in pairs(wk) do n = n + 1 end
+  assert(n == 1)
+end
+
+-- suspended threads become old and get young objects after being resumed
+do
+  local co = coroutine.wrap(function()
+    local acc = {}
+    local up = nil
+    local function f() return up end
+    while true do
+      up = {#acc}
+      table.insert(acc, {f})
+      coroutine.yield(acc)
+    end
+  end)
+  local acc
+  for i=1,100 do
+    acc = co()
+    if i % 10 == 0 then collectgarbage() else minor() end
+  end
+  assert(#acc == 100)
+  for i,v in ipairs(acc) do assert(type(v[1]) == "function") end
+  assert(acc[100][1]()[1] == 99)
+end
+
+-- dead threads with open upvalues
+do
+  local fs = {}
+  for i=1,20 do
+    local co = coroutine.create(function()
+      local x = {i}
+      fs[i] = function() return x end
+      coroutine.yield()
+    end)
+    coroutine.resume(co)
+    minor()
+  end
+  collectgarbage()
+  for i=1,20 do assert(fs[i]()[1] == i) end
+end
+
+-- stress: a long-lived structure with steady allocation of short-lived objects
+do
+  local live = {}
+  for i=1,200 do live[i] = {id = i, tag = "n" .. i} end
+  collectgarbage()
+  for iter=1,20000 do
+    local tmp = {iter, tostring(iter)}
+    local slot = iter % 200 + 1
+    if iter % 7 == 0 then
+      live[slot] = {id = slot, tag = "n" .. slot, tmp = tmp}
+    end
+  end
+  collectgarbage()
+  for i=1,200 do assert(live[i].id == i and live[i].tag == "n" .. i) end
+end
+
+assert(collectgarbage("incremental") == "generational")
+collectgarbage()
+
+return('OK')
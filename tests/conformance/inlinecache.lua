@@ -0,0 +1,160 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print('testing inline caches of table accesses')
+
+-- method calls and field reads through __index tables
+do
+  local Point = {}
+  Point.__index = Point
+
+  function Point.new(x, y) return setmetatable({x = x, y = y}, Point) end
+  function Point:len2() return self.x * self.x + self.y * self.y end
+  Point.kind = "point"
+
+  local function run(p)
+    return p:len2(), p.kind
+  end
+
+  for i = 1, 10 do
+    local l, k = run(Point.new(i, 1))
+    assert(l == i * i + 1 and k == "point")
+  end
+
+  -- instances can shadow the cached method or field
+  local p = Point.new(1, 2)
+  p.len2 = function() return -1 end
+  p.kind = "shadow"
+  local l, k = run(p)
+  assert(l == -1 and k == "shadow")
+
+  -- removing the shadowing field brings back the cached path
+  p.len2 = nil
+  p.kind = nil
+  l, k = run(p)
+  assert(l == 5 and k == "point")
+
+  -- the cached method can be replaced or removed
+  function Point:len2() return 42 end
+  assert(run(p) == 42)
+  Point.len2 = nil
+  assert(not pcall(run, p))
+  function Point:len2() return 7 end
+  assert(run(p) == 7)
+
+  -- the __index table of the metatable can be replaced
+  local Other = { len2 = function() return 8 end, kind = "other" }
+  Point.__index = Other
+  l, k = run(p)
+  assert(l == 8 and k == "other")
+
+  -- and __index can become a function
+  Point.__index = function(t, key) return key == "kind" and "fn" or function() return 9 end end
+  l, k = run(p)
+  assert(l == 9 and k == "fn")
+
+  -- a different metatable with the same __index table is a different cache entry
+  local Same = { __index = Other }
+  l, k = run(setmetatable({}, Same))
+  assert(l == 8 and k == "other")
+
+  -- rehashing the __index table moves the cached slot
+  for i = 1, 100 do Other["f" .. i] = i end
+  l, k = run(setmetatable({}, Same))
+  assert(l == 8 and k == "other")
+
+  -- two levels of __index aren't cached, but still work
+  local Base = { kind = "base", len2 = function() return 10 end }
+  local Derived = setmetatable({}, { __index = Base })
+  local obj = setmetatable({}, { __index = Derived })
+  for i = 1, 3 do
+    l, k = run(obj)
+    assert(l == 10 and k == "base")
+  end
+end
+
+-- fields of tables with more than 256 keys
+do
+  local t = {}
+  for i = 1, 1000 do t["k" .. i] = i end
+
+  local function get(t) return t.k1, t.k500, t.k1000 end
+  local function set(t, v) t.k1 = v; t.k500 = v; t.k1000 = v end
+
+  for i = 1, 10 do
+    local a, b, c = get(t)
+    assert(a == 1 and b == 500 and c == 1000)
+  end
+
+  set(t, 0)
+  local a, b, c = get(t)
+  assert(a == 0 and b == 0 and c == 0)
+
+  -- a different table with the same keys in other slots
+  local u = {}
+  for i = 1000, 1, -1 do u["k" .. i] = -i end
+  a, b, c = get(u)
+  assert(a == -1 and b == -500 and c == -1000)
+
+  -- cleared fields must not be read or written through the cache
+  t.k500 = nil
+  a, b, c = get(t)
+  assert(a == 0 and b == nil and c == 0)
+  set(t, 1)
+  assert(t.k500 == 1)
+
+  -- readonly tables can't be written through the cache
+  table.freeze(t)
+  assert(not pcall(set, t, 2))
+  assert(t.k1 == 1)
+end
+
+-- methods of values that aren't tables
+do
+  local function upper(s) return s:upper() end
+
+  for i = 1, 5 do
+    assert(upper("abc" .. i) == "ABC" .. i)
+  end
+
+  local ok, err = pcall(function(s) return s:nonexistent() end, "abc")
+  assert(not ok and err:find("nonexistent"))
+end
+
+-- caches don't keep the tables they have seen alive
+local function collected(mode)
+  local previous = collectgarbage(mode)
+  local function read(t) return t.value end
+  local weak = setmetatable({}, { __mode = "v" })
+
+  local holder = { value = 1 }
+  local mt = { __index = holder }
+  for i = 1, 3 do
+    assert(read(setmetatable({}, mt)) == 1)
+  end
+  weak.holder, weak.mt = holder, mt
+  holder, mt = nil, nil
+
+  local obj = { value = 2 }
+  for i = 1, 3 do
+    assert(read(obj) == 2)
+  end
+  weak.obj = obj
+  obj = nil
+
+  collectgarbage()
+  assert(weak.holder == nil and weak.mt == nil and weak.obj == nil)
+
+  -- cleared entries are filled again
+  local mt2 = { __index = { value = 3 } }
+  for i = 1, 3 do
+    assert(read(setmetatable({}, mt2)) == 3)
+    collectgarbage()
+  end
+  assert(read({ value = 4 }) == 4)
+
+  collectgarbage(previous)
+end
+
+collected("incremental")
+collected("generational")
+
+return('OK')
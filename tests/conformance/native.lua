@@ -0,0 +1,234 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing native code generation")
+
+-- numeric loops and arithmetic
+local function sum(n)
+  local s = 0
+  for i = 1, n do
+    s = s + i * 2 - 1
+  end
+  return s
+end
+
+assert(sum(0) == 0)
+assert(sum(10) == 100)
+assert(sum(1000) == 1000000)
+
+local function reverse(n)
+  local r = {}
+  for i = n, 1, -1 do
+    r[#r + 1] = i
+  end
+  return r
+end
+
+assert(table.concat(reverse(5), ",") == "5,4,3,2,1")
+
+-- loops with non-integer and NaN bounds
+local function count(a, b, c)
+  local n = 0
+  for i = a, b, c do
+    n = n + 1
+  end
+  return n
+end
+
+assert(count(1, 2, 0.25) == 5)
+assert(count(1, 0/0, 1) == 0)
+assert(count(0/0, 1, 1) == 0)
+assert(count("1", "3", "1") == 3)
+assert(pcall(count, {}, 1, 1) == false)
+
+-- arithmetic specializations
+local function arith(a, b)
+  return a + b, a - b, a * b, a / b, a % b, a ^ b, -a
+end
+
+assert(table.concat({arith(7, 2)}, ",") == "9,5,14,3.5,1,49,-7")
+assert(table.concat({arith(-7, 2)}, ",") == "-5,-9,-14,-3.5,1,49,7")
+assert(select(5, arith(5.5, -2)) == -0.5)
+
+local function arithk(a)
+  return a + 1, a - 1, a * 3, a / 4, a % 3, a ^ 2, a ^ 0.5, a ^ 3, a ^ 1.5
+end
+
+assert(table.concat({arithk(4)}, ",") == "5,3,12,1,1,16,2,64,8")
+
+local mt = { __add = function(a, b) return "add" end, __unm = function(a) return "unm" end, __lt = function(a, b) return true end }
+local obj = setmetatable({}, mt)
+assert(obj + 1 == "add")
+assert(1 + obj == "add")
+assert(-obj == "unm")
+assert((obj < obj) == true)
+
+assert(pcall(function() return {} + 1 end) == false)
+
+-- comparisons including NaN
+local function cmp(a, b)
+  return a < b, a <= b, a > b, a >= b, a == b, a ~= b
+end
+
+local function tostr(...)
+  local r = {}
+  for i = 1, select('#', ...) do
+    r[i] = tostring((select(i, ...)))
+  end
+  return table.concat(r, ",")
+end
+
+assert(tostr(cmp(1, 2)) == "true,true,false,false,false,true")
+assert(tostr(cmp(2, 2)) == "false,true,false,true,true,false")
+assert(tostr(cmp(0/0, 0/0)) == "false,false,false,false,false,true")
+assert(tostr(cmp(0/0, 1)) == "false,false,false,false,false,true")
+assert(tostr(cmp("a", "b")) == "true,true,false,false,false,true")
+
+local function eqk(a)
+  return a == nil, a == true, a == 1, a == "x"
+end
+
+assert(tostr(eqk(nil)) == "true,false,false,false")
+assert(tostr(eqk(true)) == "false,true,false,false")
+assert(tostr(eqk(1)) == "false,false,true,false")
+assert(tostr(eqk("x")) == "false,false,false,true")
+assert(tostr(eqk(0/0)) == "false,false,false,false")
+
+-- logical operators
+local function logic(a, b)
+  return a and b, a or b, not a, a and 1, a or 1
+end
+
+assert(tostr(logic(nil, 2)) == "nil,2,true,nil,1")
+assert(tostr(logic(false, 2)) == "false,2,true,false,1")
+assert(tostr(logic(0, 2)) == "2,0,false,1,0")
+
+-- table access
+local function fill(t, n)
+  for i = 1, n do
+    t[i] = i * i
+  end
+  return t
+end
+
+local function total(t)
+  local s = 0
+  for i = 1, #t do
+    s = s + t[i]
+  end
+  return s + t[1] + (t[100000] or 0)
+end
+
+assert(total(fill({}, 10)) == 386)
+assert(total(fill(table.create(10), 10)) == 386)
+
+local function fixed(t)
+  t[1] = "a"
+  t[2] = t[1]
+  return t[2], t[3]
+end
+
+assert(tostr(fixed({})) == "a,nil")
+assert(tostr(fixed(setmetatable({}, { __index = function() return "idx" end }))) == "a,idx")
+assert(pcall(fixed, table.freeze({})) == false)
+assert(pcall(fixed, nil) == false)
+
+local function fractional(t)
+  t[1.5] = 1
+  t[-1] = 2
+  return t[1.5] + t[-1]
+end
+
+assert(fractional({}) == 3)
+
+-- write barriers for table stores
+local function barrier(t)
+  for i = 1, 100 do
+    t[i] = {}
+  end
+  collectgarbage()
+  for i = 1, 100 do
+    t[i] = { i }
+  end
+  collectgarbage()
+  return t
+end
+
+assert(barrier({})[100][1] == 100)
+
+-- upvalues, globals, imports, fastcalls
+local up = 10
+
+local function upvals()
+  up = up + 1
+  return up, math.abs(-up), math.max(up, 20), math.floor(up + 0.5)
+end
+
+assert(tostr(upvals()) == "11,11,20,11")
+
+local function fastcalls(a)
+  return math.abs(a), math.sqrt(4), select('#', a, a), bit32.band(a, 3), type(a)
+end
+
+assert(tostr(fastcalls(-6)) == "6,2,2,2,number")
+assert(pcall(fastcalls, "x") == false)
+
+-- errors from native code have correct locations
+local function failing(t)
+  return t.x.y
+end
+
+local ok, err = pcall(failing, {})
+assert(not ok and err:find("native.lua:176") ~= nil)
+
+-- calls and returns interleave with native execution
+local function fib(n)
+  if n < 2 then return n end
+  return fib(n - 1) + fib(n - 2)
+end
+
+assert(fib(20) == 6765)
+
+local function concat(a, b)
+  return a .. b .. #a
+end
+
+assert(concat("ab", "cd") == "abcd2")
+
+-- coroutines
+local co = coroutine.wrap(function(n)
+  for i = 1, n do
+    coroutine.yield(i * 2)
+  end
+  return -1
+end)
+
+assert(co(3) == 2 and co() == 4 and co() == 6 and co() == -1)
+
+-- type annotations are only hints; arguments of other types must still work
+local function typedsum(t: {number}, n: number, scale: number)
+  local s = 0
+  for i = 1, n do
+    s += t[i] * scale
+  end
+  if n < 10 then
+    s += 1
+  end
+  return s + n
+end
+
+assert(typedsum({1, 2, 3}, 3, 2) == 16)
+assert(typedsum({1, 2, 3}, 3, "2") == 16)
+assert(typedsum(setmetatable({}, {__index = function(_, i) return i end}), 3, 2) == 16)
+
+local vmt = {__mul = function(a, b) return b end, __add = function(a, b) return 100 end}
+assert(typedsum({1, 2}, 2, setmetatable({}, vmt)) == 103)
+
+local function typedcall(n: number, f)
+  local r = n * 2
+  f()
+  return r + n
+end
+
+-- the annotated parameter is checked again when native code is resumed after a call
+assert(typedcall(2, function() end) == 6)
+
+return('OK')
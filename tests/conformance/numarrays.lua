@@ -0,0 +1,251 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+-- This file is based on Lua 5.x tests -- https://github.com/lua/lua/tree/master/testes
+print("testing packed number arrays")
+
+local function sum(t)
+  local s = 0
+  for i = 1, #t do
+    s += t[i]
+  end
+  return s
+end
+
+-- appends keep the array part packed, and reads see the stored values
+do
+  local t = {}
+  for i = 1, 1000 do
+    t[i] = i * 0.5
+  end
+  assert(#t == 1000)
+  assert(t[1] == 0.5 and t[1000] == 500)
+  assert(t[0] == nil and t[1001] == nil)
+  assert(sum(t) == 250250)
+
+  local n = 0
+  for k, v in ipairs(t) do
+    assert(v == k * 0.5)
+    n += 1
+  end
+  assert(n == 1000)
+
+  n = 0
+  for k, v in pairs(t) do
+    assert(v == k * 0.5)
+    n += 1
+  end
+  assert(n == 1000)
+
+  n = 0
+  local k, v = next(t)
+  while k do
+    assert(v == k * 0.5)
+    n += 1
+    k, v = next(t, k)
+  end
+  assert(n == 1000)
+end
+
+-- nil stores punch holes that behave the same way as in regular arrays
+do
+  local t = {}
+  for i = 1, 10 do
+    t[i] = i
+  end
+  t[10] = nil
+  assert(#t == 9)
+  t[5] = nil
+  assert(t[5] == nil)
+  local n = 0
+  for _ in pairs(t) do
+    n += 1
+  end
+  assert(n == 8)
+  local last = 0
+  for i in ipairs(t) do
+    last = i
+  end
+  assert(last == 4)
+end
+
+-- special numbers are stored as is
+do
+  local t = {}
+  t[1] = 0/0
+  t[2] = -0.0
+  t[3] = math.huge
+  t[4] = -math.huge
+  assert(t[1] ~= t[1])
+  assert(1 / t[2] == -math.huge)
+  assert(t[3] == math.huge and t[4] == -math.huge)
+  assert(#t == 4)
+
+  -- all NaN payloads survive, including the one that marks nil elements internally
+  local b = buffer.create(8)
+  for _, bits in ipairs({ 0x7ff80000, 0x7ff8dead, 0xfff80000, 0x7ff00001 }) do
+    buffer.writeu32(b, 0, 0xbeef0001)
+    buffer.writeu32(b, 4, bits)
+    local nan = buffer.readf64(b, 0)
+
+    local u = { 1, 2, 3 }
+    u[2] = nan
+    assert(u[2] ~= u[2])
+    assert(#u == 3)
+
+    local v = {}
+    v[1] = 1
+    v[2] = nan
+    v[3] = 3
+    assert(v[2] ~= v[2])
+    assert(#v == 3)
+
+    local w = table.create(3, nan)
+    assert(w[3] ~= w[3])
+    assert(#w == 3)
+
+    buffer.writef64(b, 0, v[2])
+    assert(buffer.readu32(b, 0) == 0xbeef0001 and buffer.readu32(b, 4) == bits)
+  end
+end
+
+-- the first store of another type converts the array part
+do
+  local t = {}
+  for i = 1, 100 do
+    t[i] = i
+  end
+  t[50] = "fifty"
+  assert(t[50] == "fifty")
+  assert(t[49] == 49 and t[51] == 51)
+  assert(#t == 100)
+  t[101] = true
+  assert(#t == 101 and t[101] == true)
+  t[50] = 50
+  assert(sum({table.unpack(t, 1, 100)}) == 5050)
+end
+
+-- elements that migrate from the hash part on resize
+do
+  local t = {}
+  t[3] = "three"
+  t[2] = 2
+  t[1] = 1
+  assert(t[1] == 1 and t[2] == 2 and t[3] == "three")
+  assert(#t == 3)
+
+  local u = {}
+  u[3] = 3
+  u[2] = 2
+  u[1] = 1
+  u[4] = 4
+  assert(#u == 4 and sum(u) == 10)
+
+  -- non-integer and out of range keys live in the hash part
+  u[1.5] = "x"
+  u[-1] = {}
+  u[100] = 100
+  assert(u[1.5] == "x" and type(u[-1]) == "table" and u[100] == 100)
+  assert(sum(u) == 10)
+end
+
+-- library functions
+do
+  local t = {}
+  for i = 1, 10 do
+    table.insert(t, i)
+  end
+  assert(#t == 10 and sum(t) == 55)
+
+  table.insert(t, 1, 0)
+  assert(t[1] == 0 and t[2] == 1 and #t == 11)
+  assert(table.remove(t, 1) == 0)
+  assert(table.remove(t) == 10)
+  assert(#t == 9 and sum(t) == 45)
+
+  table.move(t, 1, 5, 3)
+  assert(t[1] == 1 and t[2] == 2 and t[3] == 1 and t[7] == 5 and t[8] == 8)
+
+  local d = table.move(t, 1, 3, 1, {})
+  assert(#d == 3 and d[3] == 1)
+
+  local s = table.move({ "a", "b" }, 1, 2, 2, { 1 })
+  assert(s[1] == 1 and s[2] == "a" and s[3] == "b")
+
+  table.sort(t, function(a, b) return a > b end)
+  assert(t[1] == 9 and t[9] == 1)
+
+  assert(table.concat({ 1, 2, 3 }, ",") == "1,2,3")
+  assert(table.find(t, 5) ~= nil)
+  assert(table.find(t, 42) == nil)
+  assert(select("#", table.unpack(t)) == 9)
+  assert(select(2, unpack({ 10, 20, 30 })) == 20)
+
+  local c = table.clone(t)
+  assert(#c == 9 and sum(c) == sum(t))
+  c[1] = "x"
+  assert(t[1] == 9)
+
+  table.clear(t)
+  assert(#t == 0 and next(t) == nil)
+  t[1] = 1
+  assert(#t == 1)
+
+  local z = table.create(100, 0)
+  assert(#z == 100 and z[100] == 0 and sum(z) == 0)
+  z[100] = "x"
+  assert(z[100] == "x" and z[99] == 0)
+
+  assert(rawequal(rawset(t, 2, 2), t))
+  assert(rawget(t, 2) == 2 and rawget(t, 3) == nil)
+  rawset(t, 3, "three")
+  assert(rawget(t, 3) == "three")
+end
+
+-- metamethods see absent elements of packed arrays
+do
+  local log = {}
+  local t = setmetatable({}, {
+    __index = function(_, k) return -k end,
+    __newindex = function(t, k, v) table.insert(log, k) rawset(t, k, v) end,
+  })
+  t[1] = 1
+  t[2] = 2
+  assert(t[1] == 1 and t[3] == -3)
+  t[2] = nil
+  assert(t[2] == -2)
+  t[2] = 20
+  assert(rawget(t, 2) == 20)
+  assert(#log == 3)
+
+  local ro = table.create(3, 1)
+  table.freeze(ro)
+  assert(not pcall(function() ro[1] = 4 end))
+  assert(ro[1] == 1)
+end
+
+-- the packed array part takes 8 bytes per element and isn't traversed by the GC
+do
+  collectgarbage()
+  local before = collectgarbage("count")
+  local t = table.create(100000, 1)
+  local after = collectgarbage("count")
+  assert((after - before) * 1024 < 100000 * 12)
+
+  for i = 1, 10 do
+    local garbage = {}
+    for j = 1, 1000 do
+      garbage[j] = j
+    end
+    collectgarbage()
+  end
+  assert(#t == 100000 and t[100000] == 1)
+
+  -- weak tables
+  local w = setmetatable({}, { __mode = "v" })
+  for i = 1, 10 do
+    w[i] = i
+  end
+  collectgarbage()
+  assert(#w == 10)
+end
+
+return('OK')
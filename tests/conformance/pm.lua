@@ -314,4 +314,46 @@ assert(string.match("abc\0\0\0", "%\0%\0?") == "\0\0")
 assert(string.find("abc\0\0","\0.") == 4)
 assert(string.find("abcx\0\0abc\0abc","x\0\0abc\0a.") == 4)
 
+-- patterns are compiled once and reused; the results match the interpreted patterns with %b and back-references
+do
+  local text = "key=value; other = 42;name=x"
+  for i = 1, 3 do
+    local t = {}
+    for k, v in string.gmatch(text, "(%w+)%s*=%s*(%w+)") do
+      t[#t + 1] = k .. ":" .. v
+    end
+    assert(table.concat(t, ",") == "key:value,other:42,name:x")
+    collectgarbage()
+  end
+
+  -- search for the first characters of a match
+  local long = string.rep("x", 1000) .. "needle" .. string.rep("y", 1000)
+  assert(string.find(long, "ne+dle") == 1001)
+  assert(string.find(long, "needle%f[y]") == 1001)
+  assert(string.find(long, "(n)e(e)dle") == 1001)
+  assert(string.find(long, "needles") == nil)
+  assert(string.find(long, "nee.le", 1002) == nil)
+  assert(string.find(long, "%d") == nil)
+  assert(string.match(long, "()[ny]") == 1001)
+  assert(string.gsub(long, "ne*dle", "!") == string.rep("x", 1000) .. "!" .. string.rep("y", 1000))
+  assert(string.gsub("abcabc", "bc", "%0%0", 1) == "abcbcabc")
+  assert(string.gsub("a.b.c", "%.", "/") == "a/b/c")
+  assert(string.gsub("no dots", "%.", "/") == "no dots")
+
+  -- same patterns with anchors and without compiled forms
+  assert(string.find("hello", "^ell") == nil)
+  assert(string.find("hello", "ell") == 2)
+  local t = {}
+  for w in string.gmatch("^a ^b c", "^%a") do
+    t[#t + 1] = w
+  end
+  assert(table.concat(t) == "^a^b")
+  assert(string.match("f(a(b)c) g", "%b()") == "(a(b)c)")
+  assert(string.match("xyyx abba", "((%a)(%a)%3%2)") == "xyyx")
+
+  -- the depth limit applies the same way
+  assert(string.find(string.rep("a", 300), string.rep("a?", 199)) == 1)
+  assert(not pcall(string.find, string.rep("a", 300), string.rep("a?", 200)))
+end
+
 return('OK')
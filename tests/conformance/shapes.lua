@@ -0,0 +1,250 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing tables with shapes")
+
+local function count(t)
+  local n = 0
+  for _ in pairs(t) do
+    n += 1
+  end
+  return n
+end
+
+local function keys(t)
+  local r = {}
+  for k in pairs(t) do
+    table.insert(r, tostring(k))
+  end
+  return table.concat(r, ",")
+end
+
+-- objects created by the same constructor share the layout, and fields are traversed in the order they were added
+do
+  local function new(x, y)
+    local p = {}
+    p.x = x
+    p.y = y
+    p.name = "point"
+    return p
+  end
+
+  local points = {}
+  for i = 1, 100000 do
+    points[i] = new(i, -i)
+  end
+
+  local sx, sy = 0, 0
+  for _, p in ipairs(points) do
+    sx += p.x
+    sy += p.y
+    assert(p.name == "point")
+  end
+  assert(sx == 5000050000 and sy == -5000050000)
+  assert(keys(points[1]) == "x,y,name")
+  assert(keys({a = 1, b = 2, c = 3}) == "a,b,c")
+
+  for i = 1, 100000, 7 do
+    points[i].x = 0
+  end
+  assert(points[1].x == 0 and points[2].x == 2 and points[8].x == 0)
+
+  local k, v = next(points[2])
+  assert(k == "x" and v == 2)
+  k, v = next(points[2], k)
+  assert(k == "y" and v == -2)
+  k, v = next(points[2], k)
+  assert(k == "name" and v == "point")
+  assert(next(points[2], k) == nil)
+end
+
+-- tables with fields in different orders or different fields are read by the same instructions
+do
+  local function getxy(t)
+    return t.x + t.y
+  end
+
+  local objs = { {x = 1, y = 2}, {y = 3, x = 4}, {x = 5, z = 0, y = 6}, {x = 7, y = 8, [1] = 0}, setmetatable({}, {__index = {x = 9, y = 10}}) }
+  local sum = 0
+  for i = 1, 10 do
+    for _, o in ipairs(objs) do
+      sum += getxy(o)
+    end
+  end
+  assert(sum == 550)
+end
+
+-- methods through __index and instructions that share inline caches
+do
+  local Account = {}
+  Account.__index = Account
+
+  function Account.new(balance)
+    local self = setmetatable({}, Account)
+    self.balance = balance
+    self.history = 0
+    return self
+  end
+
+  function Account:deposit(v)
+    self.balance += v
+    self.history += 1
+  end
+
+  function Account:get()
+    return self.balance
+  end
+
+  local accs = {}
+  for i = 1, 100 do
+    accs[i] = Account.new(i)
+  end
+  for _, a in ipairs(accs) do
+    a:deposit(10)
+    a:deposit(-5)
+  end
+  assert(accs[1]:get() == 6 and accs[100]:get() == 105 and accs[50].history == 2)
+
+  -- a field shadows the method
+  accs[2].get = function() return "own" end
+  assert(accs[1]:get() == 6 and accs[2]:get() == "own" and accs[3]:get() == 8)
+
+  -- methods of tables without metatables
+  local obj = { value = 42 }
+  function obj:get() return self.value end
+  for i = 1, 10 do
+    assert(obj:get() == 42)
+  end
+  obj.get = nil
+  assert(not pcall(function() return obj:get() end))
+end
+
+-- removing fields keeps the traversal stable, and the next new key switches to a regular hash
+do
+  local t = {a = 1, b = 2, c = 3, d = 4}
+  for k in pairs(t) do
+    t[k] = nil
+  end
+  assert(next(t) == nil)
+
+  t = {a = 1, b = 2, c = 3}
+  t.b = nil
+  assert(t.a == 1 and t.b == nil and t.c == 3 and count(t) == 2)
+  t.b = 20
+  assert(t.b == 20 and count(t) == 3)
+  t.b = nil
+  t.e = 5
+  assert(t.a == 1 and t.b == nil and t.c == 3 and t.e == 5 and count(t) == 3)
+
+  -- the same instructions keep working after the table changes the representation
+  local function get(o)
+    return o.a
+  end
+  local u = {a = 1}
+  assert(get(u) == 1)
+  u.b = 2
+  u.b = nil
+  u.c = 3
+  assert(get(u) == 1 and u.c == 3)
+end
+
+-- too many keys and keys of other types
+do
+  local t = {}
+  for i = 1, 40 do
+    t["k" .. i] = i
+  end
+  local s = 0
+  for i = 1, 40 do
+    s += t["k" .. i]
+  end
+  assert(s == 820 and count(t) == 40)
+
+  local u = {a = 1, b = 2}
+  u[true] = 3
+  u[2.5] = 4
+  u[-1] = 5
+  assert(u.a == 1 and u.b == 2 and u[true] == 3 and u[2.5] == 4 and u[-1] == 5 and count(u) == 5)
+
+  local e = {}
+  e[""] = 1
+  e.x = 2
+  assert(e[""] == 1 and e.x == 2 and count(e) == 2)
+end
+
+-- array parts next to fields
+do
+  local t = {n = 0}
+  for i = 1, 100 do
+    t[i] = i
+    t.n = i
+  end
+  assert(#t == 100 and t.n == 100 and count(t) == 101)
+
+  local u = {1, 2, 3, name = "x"}
+  assert(#u == 3 and u.name == "x" and keys(u) == "1,2,3,name")
+  table.remove(u)
+  table.remove(u)
+  table.remove(u)
+  assert(#u == 0 and u.name == "x")
+end
+
+-- library functions
+do
+  local t = {x = 1, y = 2}
+  local c = table.clone(t)
+  assert(c.x == 1 and c.y == 2 and keys(c) == "x,y")
+  c.x = 10
+  c.z = 3
+  assert(t.x == 1 and t.z == nil and c.x == 10 and c.z == 3)
+
+  table.clear(t)
+  assert(next(t) == nil and t.x == nil)
+  t.y = 5
+  assert(t.y == 5 and count(t) == 1)
+
+  assert(rawequal(rawset(t, "w", 6), t))
+  assert(rawget(t, "w") == 6 and rawget(t, "x") == nil)
+
+  local f = table.freeze({x = 1})
+  assert(not pcall(function() f.x = 2 end))
+  assert(not pcall(function() f.y = 2 end))
+  assert(f.x == 1)
+
+  local log = {}
+  local p = setmetatable({x = 1}, {__newindex = function(t, k, v) table.insert(log, k) rawset(t, k, v) end})
+  p.x = 2
+  p.y = 3
+  assert(p.x == 2 and p.y == 3 and #log == 1 and log[1] == "y")
+end
+
+-- the GC keeps the layouts that are in use, and weak tables drop the values
+do
+  local objs = {}
+  for i = 1, 1000 do
+    local o = {}
+    o["f" .. (i % 10)] = i
+    o.v = i
+    objs[i] = o
+  end
+  collectgarbage()
+  for i = 1, 1000 do
+    assert(objs[i]["f" .. (i % 10)] == i and objs[i].v == i)
+  end
+  objs = nil
+  collectgarbage()
+
+  -- a layout can be reused after all tables that had it are collected
+  local t = {}
+  t.f1 = 1
+  t.v = 2
+  assert(keys(t) == "f1,v")
+
+  local wv = setmetatable({}, {__mode = "v"})
+  wv.a = {}
+  wv.b = 1
+  local wk = setmetatable({}, {__mode = "k"})
+  wk.a = {}
+  collectgarbage()
+  assert(wv.a == nil and wv.b == 1 and wk.a ~= nil)
+end
+
+return('OK')
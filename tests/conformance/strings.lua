@@ -208,6 +208,23 @@ assert(os.setlocale() == 'C')
 assert(os.setlocale(nil, "numeric") == 'C')
 ]]--
 
+-- strings stay interned while the string table grows and shrinks
+do
+  local t = {}
+  for i = 1, 50000 do
+    t[i] = "interned" .. i
+    assert(t[i] == "interned" .. i)
+  end
+  for i = 1, 50000, 7 do
+    assert(t[i] == "interned" .. i)
+  end
+  t = nil
+  collectgarbage()
+  for i = 1, 1000 do
+    assert(("interned" .. i) == ("interned" .. tostring(i)))
+  end
+end
+
 return('OK')
 
 
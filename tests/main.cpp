@@ -30,6 +30,9 @@ bool verbose = false;
 // Default optimization level for conformance test; can be overridden via -On
 int optimizationLevel = 1;
 
+// Run conformance tests with native code generation; can be enabled via --codegen
+bool codegen = false;
+
 static bool skipFastFlag(const char* flagName)
 {
     if (strncmp(flagName, "Test", 4) == 0)
@@ -252,6 +255,11 @@ int main(int argc, char** argv)
         verbose = true;
     }
 
+    if (doctest::parseFlag(argc, argv, "--codegen"))
+    {
+        codegen = true;
+    }
+
     int level = -1;
     if (doctest::parseIntOption(argc, argv, "-O", doctest::option_int, level))
     {
@@ -293,6 +301,7 @@ int main(int argc, char** argv)
         printf("Additional command line options:\n");
         printf(" -O[n]                                 Changes default optimization level (1) for conformance runs\n");
         printf(" --verbose                             Enables verbose output (e.g. lua 'print' statements)\n");
+        printf(" --codegen                             Execute conformance tests using native code generation\n");
         printf(" --fflags=                             Sets specified fast flags\n");
         printf(" --list-fflags                         List all fast flags\n");
     }
@@ -114,6 +114,8 @@ while offset < len(queue):
             queue.append((a, node))
         if "metatable" in obj:
             queue.append((obj["metatable"], node.child("__meta")))
+        if "shape" in obj:
+            queue.append((obj["shape"], node.child("__shape")))
     elif obj["type"] == "function":
         queue.append((obj["env"], node.child("__env")))
 
@@ -150,6 +152,11 @@ while offset < len(queue):
     elif obj["type"] == "upvalue":
         if "object" in obj:
             queue.append((obj["object"], node))
+    elif obj["type"] == "shape":
+        if "parent" in obj:
+            queue.append((obj["parent"], node))
+        for a in obj.get("keys", []):
+            queue.append((a, node))
 
 def annotateContainedCategories(node, start):
     for obj in node.objects: